@@ -1,5 +1,6 @@
 const express = require('express');
 const db = require('./db');
+const { createLiveStream } = require('./live-stream');
 const {
   saveMmrLog,
   getAllMmrLogs,
@@ -20,7 +21,17 @@ const {
   deletePreset,
   getSessions,
   saveSession,
+  getSkillIdsForTrainingPackCode,
   deleteSession,
+  saveSessionSummary,
+  getSessionSummaries,
+  saveMatchTimeline,
+  getMatchTimelines,
+  getReplay,
+  saveReplayProgress,
+  getIngestState,
+  ingestOnce,
+  runInTransaction,
   getSkillDurationSummary,
   getProfile,
   updateProfile,
@@ -95,15 +106,10 @@ function buildMmrExportCsv(records) {
   return lines.join('\n');
 }
 
-function broadcastServerUpdate(payload) {
-  const payloadWithTimestamp = {
-    ...payload,
-    timestamp: new Date().toISOString(),
-  };
-  const message = JSON.stringify(payloadWithTimestamp);
+function writeSseEvent(event, message) {
   for (const client of [...sseClients]) {
     try {
-      client.write('event: update\n');
+      client.write(`event: ${event}\n`);
       client.write(`data: ${message}\n\n`);
     } catch (error) {
       removeSseClient(client);
@@ -111,6 +117,21 @@ function broadcastServerUpdate(payload) {
   }
 }
 
+function broadcastServerUpdate(payload) {
+  const payloadWithTimestamp = {
+    ...payload,
+    timestamp: new Date().toISOString(),
+  };
+  writeSseEvent('update', JSON.stringify(payloadWithTimestamp));
+}
+
+// Live frames go out as their own event type: clients refetch data on 'update', and
+// a match in progress sends several frames a second.
+const liveStream = createLiveStream({
+  onState: (update) => writeSseEvent('live', JSON.stringify(update)),
+});
+app.liveStream = liveStream;
+
 if (typeof onChange === 'function') {
   onChange(broadcastServerUpdate);
 }
@@ -118,6 +139,13 @@ if (typeof onChange === 'function') {
 app.use(express.json());
 
 const { normalizePlaylist } = require('./playlist-normalize');
+const { validateTimeline } = require('./match-timeline');
+const { isValidReplayId, replayFilePath, writeReplayChunk } = require('./replay-store');
+
+const INSTALL_ID_PATTERN = /^[A-Za-z0-9-]{1,64}$/;
+const MAX_REPLAY_BYTES = 64 * 1024 * 1024;
+const importDocumentBody = express.text({ type: 'application/x-ndjson', limit: '20mb' });
+const replayChunkBody = express.raw({ type: 'application/octet-stream', limit: '2mb' });
 
 function normalizeHeader(value) {
   return (value || '').trim().toLowerCase();
@@ -216,6 +244,12 @@ app.get('/api/updates', (req, res) => {
   });
 });
 
+// The plugin streams to this path over a WebSocket (see live-stream.js); a plain GET
+// returns the latest state of every match streamed since the server started.
+app.get('/api/live', (_, res) => {
+  res.json({ matches: liveStream.snapshot() });
+});
+
 app.get('/api/v1/bakkes/favorites', (req, res) => {
   const userId = (req.header('x-user-id') || '').trim();
 
@@ -282,7 +316,60 @@ app.get('/api/history/export', (req, res) => {
   }
 });
 
-app.post('/api/history/import', (req, res) => {
+// Bulk form used by the plugin to drain a backlog: one mmr-log payload per line,
+// optionally gzip-compressed (body-parser inflates Content-Encoding), applied in a
+// single transaction.
+function importMmrLogDocument(req, res) {
+  const headerUserId = req.header('x-user-id') || '';
+  const summary = { imported: 0, duplicates: 0, errors: [], rejectedSeqs: [], receivedSeqs: [] };
+  let ackedSeq;
+
+  runInTransaction(() => {
+    req.body.split('\n').forEach((line, index) => {
+      if (!line.trim()) {
+        return;
+      }
+
+      let payload;
+      try {
+        payload = JSON.parse(line);
+      } catch (error) {
+        summary.errors.push(`Line ${index + 1}: invalid JSON`);
+        return;
+      }
+
+      const result = ingestMmrLog(payload, headerUserId);
+      if (result.ackedSeq !== undefined) {
+        ackedSeq = result.ackedSeq;
+      }
+
+      if (result.status === 400) {
+        summary.errors.push(`Line ${index + 1}: ${result.body.error}`);
+        if (Number.isInteger(payload?.clientSeq)) {
+          summary.rejectedSeqs.push(payload.clientSeq);
+        }
+      } else {
+        summary[result.body.duplicate ? 'duplicates' : 'imported'] += 1;
+        // Lines above a rejected one are held but not covered by the watermark.
+        if (result.ackedSeq !== undefined) {
+          summary.receivedSeqs.push(payload.clientSeq);
+        }
+      }
+    });
+  });
+
+  if (ackedSeq !== undefined) {
+    summary.ackedSeq = ackedSeq;
+    res.set('X-Acked-Seq', String(ackedSeq));
+  }
+  return res.json(summary);
+}
+
+app.post('/api/history/import', importDocumentBody, (req, res) => {
+  if (typeof req.body === 'string' && req.is('application/x-ndjson')) {
+    return importMmrLogDocument(req, res);
+  }
+
   const csvText = typeof req.body?.csv === 'string' ? req.body.csv.trim() : '';
 
   if (!csvText) {
@@ -346,9 +433,16 @@ app.post('/api/history/import', (req, res) => {
   return res.json(summary);
 });
 
-app.post('/api/mmr-log', (req, res) => {
-  const { timestamp, playlist, mmr, gamesPlayedDiff, source } = req.body;
+// Validates and stores one plugin match upload. Shared by POST /api/mmr-log and the
+// NDJSON form of /api/history/import so both apply the same rules and sequencing.
+function ingestMmrLog(payload, headerUserId = '') {
+  if (!payload || typeof payload !== 'object' || Array.isArray(payload)) {
+    return { status: 400, body: { error: 'payload must be a JSON object' } };
+  }
+
+  const { timestamp, playlist, mmr, gamesPlayedDiff, source, timeline, installId, clientSeq, oldestPendingSeq } = payload;
   const errors = [];
+  const sequenced = installId !== undefined || clientSeq !== undefined;
 
   if (!timestamp) {
     errors.push('timestamp is required');
@@ -366,24 +460,90 @@ app.post('/api/mmr-log', (req, res) => {
     errors.push('gamesPlayedDiff must be a number');
   }
 
+  if (timeline !== undefined) {
+    const timelineError = validateTimeline(timeline);
+    if (timelineError) {
+      errors.push(timelineError);
+    }
+  }
+
+  if (sequenced) {
+    if (typeof installId !== 'string' || !INSTALL_ID_PATTERN.test(installId)) {
+      errors.push('installId must be 1-64 letters, digits or dashes');
+    }
+    if (!Number.isInteger(clientSeq) || clientSeq <= 0) {
+      errors.push('clientSeq must be a positive integer');
+    }
+    if (oldestPendingSeq !== undefined && (!Number.isInteger(oldestPendingSeq) || oldestPendingSeq <= 0)) {
+      errors.push('oldestPendingSeq must be a positive integer');
+    }
+  }
+
   if (errors.length) {
-    return res.status(400).json({ error: errors.join('. ') });
+    return { status: 400, body: { error: errors.join('. ') } };
   }
 
   const normalizedPlaylist = normalizePlaylist(playlist);
   if (!normalizedPlaylist) {
-    return res.status(400).json({ error: 'unsupported playlist' });
+    return { status: 400, body: { error: 'unsupported playlist' } };
   }
 
-  saveMmrLog({
-    timestamp,
-    playlist: normalizedPlaylist,
-    mmr,
-    gamesPlayedDiff,
-    source,
-  });
+  const userId = (headerUserId || (typeof payload.userId === 'string' ? payload.userId : '')).trim();
+  const write = () => {
+    saveMmrLog({
+      timestamp,
+      playlist: normalizedPlaylist,
+      mmr,
+      gamesPlayedDiff,
+      source,
+    });
+
+    if (timeline !== undefined) {
+      saveMatchTimeline({
+        userId,
+        matchGuid: typeof timeline.guid === 'string' ? timeline.guid : '',
+        timestamp,
+        playlist: normalizedPlaylist,
+        players: timeline.players.map((player) => ({
+          name: typeof player?.name === 'string' ? player.name : '',
+          team: Number.isInteger(player?.team) ? player.team : null,
+        })),
+        events: timeline.events,
+      });
+    }
+  };
+
+  if (!sequenced) {
+    write();
+    return { status: 201, body: { saved: true } };
+  }
+
+  // A retried upload whose first attempt did land is acknowledged without writing again.
+  const { duplicate, ackedSeq } = ingestOnce(
+    { userId, installId, seq: clientSeq, floor: oldestPendingSeq ?? 1 },
+    write
+  );
+  return { status: duplicate ? 200 : 201, body: { saved: !duplicate, duplicate, ackedSeq }, ackedSeq };
+}
+
+app.post('/api/mmr-log', (req, res) => {
+  const result = ingestMmrLog(req.body, req.header('x-user-id') || '');
+  if (result.ackedSeq !== undefined) {
+    res.set('X-Acked-Seq', String(result.ackedSeq));
+  }
+  res.status(result.status).json(result.body);
+});
+
+app.get('/api/ingest/watermark', (req, res) => {
+  const installId = typeof req.query.installId === 'string' ? req.query.installId : '';
+  if (!INSTALL_ID_PATTERN.test(installId)) {
+    return res.status(400).json({ error: 'installId query parameter is required' });
+  }
 
-  res.status(201).json({ saved: true });
+  const userId = (req.header('x-user-id') || '').trim();
+  const state = getIngestState(userId, installId);
+  res.set('X-Acked-Seq', String(state.ackedSeq));
+  res.json(state);
 });
 
 app.get('/api/mmr', (req, res) => {
@@ -699,9 +859,18 @@ function normalizeSessionBlocks(blocks) {
       throw new Error('skillIds must be an array of numbers');
     }
 
+    if (block.packCode !== undefined && typeof block.packCode !== 'string') {
+      throw new Error('packCode must be a string');
+    }
+
+    // The plugin only knows which training pack was played; map it onto the
+    // skills that list that pack so captured sessions count toward them.
+    const skillIds =
+      block.skillIds.length === 0 && block.packCode ? getSkillIdsForTrainingPackCode(block.packCode) : block.skillIds;
+
     return {
       type: block.type,
-      skillIds: block.skillIds,
+      skillIds,
       plannedDuration: block.plannedDuration,
       actualDuration: block.actualDuration,
       notes: block.notes ?? null,
@@ -709,6 +878,136 @@ function normalizeSessionBlocks(blocks) {
   });
 }
 
+app.get('/api/match-timelines', (req, res) => {
+  const { from, to } = req.query;
+  const userId = (req.header('x-user-id') || '').trim();
+  res.json(getMatchTimelines({ userId, from, to }));
+});
+
+// Chunked, resumable replay upload. Chunks must arrive in order: a chunk whose
+// offset is not the acknowledged one gets 409 with `received`, and the plugin
+// continues from there.
+app.put('/api/replays/:id/chunks', replayChunkBody, (req, res) => {
+  const { id } = req.params;
+  const offset = Number(req.query.offset);
+  const size = Number(req.query.size);
+  const chunk = Buffer.isBuffer(req.body) ? req.body : null;
+
+  if (!isValidReplayId(id)) {
+    return res.status(400).json({ error: 'invalid replay id' });
+  }
+
+  if (!Number.isInteger(offset) || offset < 0 || !Number.isInteger(size) || size <= 0 || size > MAX_REPLAY_BYTES) {
+    return res.status(400).json({ error: `offset and size (at most ${MAX_REPLAY_BYTES} bytes) are required` });
+  }
+
+  if (!chunk || chunk.length === 0) {
+    return res.status(400).json({ error: 'chunk body must be application/octet-stream' });
+  }
+
+  const existing = getReplay(id);
+  if (existing && existing.size !== size) {
+    return res.status(409).json({ error: 'size does not match the replay being uploaded', received: existing.received });
+  }
+
+  if (existing && existing.complete) {
+    return res.json(existing);
+  }
+
+  const received = existing ? existing.received : 0;
+  if (offset !== received) {
+    return res.status(409).json({ error: 'offset does not match the acknowledged offset', received });
+  }
+
+  if (offset + chunk.length > size) {
+    return res.status(400).json({ error: 'chunk extends past the replay size' });
+  }
+
+  try {
+    writeReplayChunk(id, offset, chunk);
+  } catch (error) {
+    return res.status(500).json({ error: error.message, received });
+  }
+
+  const userId = (req.header('x-user-id') || '').trim();
+  res.json(saveReplayProgress({ id, userId, size, received: offset + chunk.length }));
+});
+
+app.get('/api/replays/:id', (req, res) => {
+  const replay = isValidReplayId(req.params.id) ? getReplay(req.params.id) : null;
+  if (!replay) {
+    return res.status(404).json({ error: 'replay not found' });
+  }
+  res.json(replay);
+});
+
+app.get('/api/replays/:id/file', (req, res) => {
+  const replay = isValidReplayId(req.params.id) ? getReplay(req.params.id) : null;
+  if (!replay) {
+    return res.status(404).json({ error: 'replay not found' });
+  }
+
+  if (!replay.complete) {
+    return res.status(409).json({ error: 'replay upload is incomplete', received: replay.received });
+  }
+
+  res.type('application/octet-stream');
+  res.sendFile(replayFilePath(replay.id));
+});
+
+app.get('/api/session-summaries', (req, res) => {
+  const { from, to } = req.query;
+  const userId = (req.header('x-user-id') || '').trim();
+  res.json(getSessionSummaries({ userId, from, to }));
+});
+
+app.post('/api/session-summaries', (req, res) => {
+  const { startedTime, finishedTime, matches, wins, losses, playlists } = req.body;
+  const userId = (req.header('x-user-id') || req.body.userId || '').trim();
+  const errors = [];
+  const isCount = (value) => Number.isInteger(value) && value >= 0;
+
+  if (!userId) {
+    errors.push('X-User-Id header or userId is required');
+  }
+
+  if (!startedTime || Number.isNaN(Date.parse(startedTime))) {
+    errors.push('startedTime must be a timestamp');
+  }
+
+  if (!finishedTime || Number.isNaN(Date.parse(finishedTime))) {
+    errors.push('finishedTime must be a timestamp');
+  }
+
+  if (!isCount(matches) || !isCount(wins) || !isCount(losses)) {
+    errors.push('matches, wins, and losses must be non-negative integers');
+  }
+
+  if (!Array.isArray(playlists)) {
+    errors.push('playlists must be an array');
+  }
+
+  if (errors.length) {
+    return res.status(400).json({ error: errors.join('. ') });
+  }
+
+  const normalizedPlaylists = playlists.map((entry) => ({
+    ...entry,
+    playlist: normalizePlaylist(entry?.playlist) ?? 'Unknown',
+  }));
+
+  const saved = saveSessionSummary({
+    userId,
+    startedTime,
+    finishedTime,
+    matches,
+    wins,
+    losses,
+    playlists: normalizedPlaylists,
+  });
+  res.status(201).json(saved);
+});
+
 app.get('/api/summary/skills', (req, res) => {
   const { from, to } = req.query;
   const summary = getSkillDurationSummary({ from, to });
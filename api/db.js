@@ -3,6 +3,7 @@ const { EventEmitter } = require('events');
 const Database = require('better-sqlite3');
 const zlib = require('zlib');
 const { normalizePlaylist } = require('./playlist-normalize');
+const { decodeTimelineEvents } = require('./match-timeline');
 
 const dbPath = process.env.DATABASE_PATH || path.join(__dirname, 'rocket_trainer.db');
 const db = new Database(dbPath);
@@ -138,6 +139,62 @@ db.prepare(
   );`
 ).run();
 
+db.prepare(
+  `CREATE TABLE IF NOT EXISTS session_summaries (
+    id INTEGER PRIMARY KEY AUTOINCREMENT,
+    user_id TEXT NOT NULL,
+    started_time TEXT NOT NULL,
+    finished_time TEXT NOT NULL,
+    matches INTEGER NOT NULL,
+    wins INTEGER NOT NULL,
+    losses INTEGER NOT NULL,
+    playlists TEXT NOT NULL
+  );`
+).run();
+
+db.prepare(
+  `CREATE TABLE IF NOT EXISTS match_timelines (
+    id INTEGER PRIMARY KEY AUTOINCREMENT,
+    user_id TEXT NOT NULL,
+    match_guid TEXT NOT NULL,
+    timestamp TEXT NOT NULL,
+    playlist TEXT NOT NULL,
+    players TEXT NOT NULL,
+    events TEXT NOT NULL
+  );`
+).run();
+
+db.prepare(
+  `CREATE TABLE IF NOT EXISTS replays (
+    id TEXT PRIMARY KEY,
+    user_id TEXT NOT NULL,
+    size INTEGER NOT NULL,
+    received INTEGER NOT NULL DEFAULT 0,
+    created_at TEXT NOT NULL,
+    updated_at TEXT NOT NULL,
+    completed_at TEXT
+  );`
+).run();
+
+db.prepare(
+  `CREATE TABLE IF NOT EXISTS ingest_watermarks (
+    user_id TEXT NOT NULL,
+    install_id TEXT NOT NULL,
+    acked_seq INTEGER NOT NULL DEFAULT 0,
+    updated_at TEXT NOT NULL,
+    PRIMARY KEY (user_id, install_id)
+  );`
+).run();
+
+db.prepare(
+  `CREATE TABLE IF NOT EXISTS ingest_receipts (
+    user_id TEXT NOT NULL,
+    install_id TEXT NOT NULL,
+    seq INTEGER NOT NULL,
+    PRIMARY KEY (user_id, install_id, seq)
+  );`
+).run();
+
 function ensureColumn(tableName, columnDefinition) {
   const columnName = columnDefinition.split(' ')[0];
   const existingColumns = db
@@ -228,6 +285,12 @@ const selectTrainingPacksForSkillIdsStmt = db.prepare(
    WHERE skill_id IN (SELECT value FROM json_each(?))
    ORDER BY skill_id ASC, order_index ASC, id ASC;`
 );
+const selectSkillIdsForPackCodeStmt = db.prepare(
+  `SELECT skill_id AS id FROM skill_training_packs WHERE code = ?
+   UNION
+   SELECT id FROM skills WHERE favorite_code = ?
+   ORDER BY id ASC;`
+);
 const insertSkillStmt = db.prepare(
   'INSERT INTO skills (name, category, tags, notes, favorite_code, favorite_name) VALUES (?, ?, ?, ?, ?, ?);'
 );
@@ -280,6 +343,47 @@ const updateMmrStmt = db.prepare(
 );
 const deleteMmrStmt = db.prepare('DELETE FROM mmr_logs WHERE id = ?;');
 const clearStmt = db.prepare('DELETE FROM mmr_logs;');
+const insertSessionSummaryStmt = db.prepare(
+  'INSERT INTO session_summaries (user_id, started_time, finished_time, matches, wins, losses, playlists) VALUES (?, ?, ?, ?, ?, ?, ?);'
+);
+const clearSessionSummariesStmt = db.prepare('DELETE FROM session_summaries;');
+const insertMatchTimelineStmt = db.prepare(
+  'INSERT INTO match_timelines (user_id, match_guid, timestamp, playlist, players, events) VALUES (?, ?, ?, ?, ?, ?);'
+);
+const updateMatchTimelineStmt = db.prepare('UPDATE match_timelines SET players = ?, events = ? WHERE id = ?;');
+const selectMatchTimelineByGuidStmt = db.prepare(
+  'SELECT id FROM match_timelines WHERE user_id = ? AND match_guid = ? LIMIT 1;'
+);
+const clearMatchTimelinesStmt = db.prepare('DELETE FROM match_timelines;');
+const selectReplayStmt = db.prepare(
+  'SELECT id, user_id AS userId, size, received, created_at AS createdAt, updated_at AS updatedAt, completed_at AS completedAt FROM replays WHERE id = ?;'
+);
+const insertReplayStmt = db.prepare(
+  'INSERT INTO replays (id, user_id, size, received, created_at, updated_at, completed_at) VALUES (?, ?, ?, ?, ?, ?, ?);'
+);
+const updateReplayProgressStmt = db.prepare(
+  'UPDATE replays SET received = ?, updated_at = ?, completed_at = ? WHERE id = ?;'
+);
+const clearReplaysStmt = db.prepare('DELETE FROM replays;');
+const selectWatermarkStmt = db.prepare(
+  'SELECT acked_seq AS ackedSeq FROM ingest_watermarks WHERE user_id = ? AND install_id = ?;'
+);
+const upsertWatermarkStmt = db.prepare(
+  `INSERT INTO ingest_watermarks (user_id, install_id, acked_seq, updated_at) VALUES (?, ?, ?, ?)
+   ON CONFLICT (user_id, install_id) DO UPDATE SET acked_seq = excluded.acked_seq, updated_at = excluded.updated_at;`
+);
+const selectReceiptStmt = db.prepare(
+  'SELECT 1 AS found FROM ingest_receipts WHERE user_id = ? AND install_id = ? AND seq = ?;'
+);
+const insertReceiptStmt = db.prepare('INSERT INTO ingest_receipts (user_id, install_id, seq) VALUES (?, ?, ?);');
+const selectReceiptsAboveStmt = db.prepare(
+  'SELECT seq FROM ingest_receipts WHERE user_id = ? AND install_id = ? AND seq > ? ORDER BY seq ASC;'
+);
+const deleteReceiptsThroughStmt = db.prepare(
+  'DELETE FROM ingest_receipts WHERE user_id = ? AND install_id = ? AND seq <= ?;'
+);
+const clearWatermarksStmt = db.prepare('DELETE FROM ingest_watermarks;');
+const clearReceiptsStmt = db.prepare('DELETE FROM ingest_receipts;');
 const selectFavoritesByUserStmt = db.prepare('SELECT name, code FROM bakkes_favorites WHERE user_id = ? ORDER BY id ASC;');
 const selectFavoriteByUserAndCodeStmt = db.prepare(
   'SELECT id FROM bakkes_favorites WHERE user_id = ? AND code = ? LIMIT 1;'
@@ -632,6 +736,15 @@ function attachTrainingPacksToSkill(skill) {
   };
 }
 
+function getSkillIdsForTrainingPackCode(code) {
+  const trimmed = typeof code === 'string' ? code.trim() : '';
+  if (!trimmed) {
+    return [];
+  }
+
+  return selectSkillIdsForPackCodeStmt.all(trimmed, trimmed).map((row) => row.id);
+}
+
 function getAllSkills() {
   const skills = selectSkillsStmt.all();
   if (!skills.length) {
@@ -1024,6 +1137,199 @@ function clearSessionTables() {
   });
 }
 
+function buildSessionSummaryResponse({ playlistsJson, ...summary }) {
+  return { ...summary, playlists: playlistsJson ? JSON.parse(playlistsJson) : [] };
+}
+
+function saveSessionSummary({ userId, startedTime, finishedTime, matches, wins, losses, playlists = [] }) {
+  const playlistsJson = JSON.stringify(playlists);
+  const info = insertSessionSummaryStmt.run(userId, startedTime, finishedTime, matches, wins, losses, playlistsJson);
+  const id = Number(info.lastInsertRowid);
+  emitDatabaseChange({
+    type: 'session-summary',
+    action: 'create',
+    id,
+    userId,
+  });
+  return buildSessionSummaryResponse({ id, userId, startedTime, finishedTime, matches, wins, losses, playlistsJson });
+}
+
+function getSessionSummaries({ userId, from, to } = {}) {
+  const conditions = [];
+  const params = [];
+
+  if (userId) {
+    conditions.push('user_id = ?');
+    params.push(userId);
+  }
+
+  if (from) {
+    conditions.push('started_time >= ?');
+    params.push(from);
+  }
+
+  if (to) {
+    conditions.push('started_time <= ?');
+    params.push(to);
+  }
+
+  const whereClause = conditions.length ? `WHERE ${conditions.join(' AND ')}` : '';
+  const query = `SELECT id, user_id AS userId, started_time AS startedTime, finished_time AS finishedTime, matches, wins, losses, playlists AS playlistsJson FROM session_summaries ${whereClause} ORDER BY started_time ASC;`;
+  return db.prepare(query).all(...params).map(buildSessionSummaryResponse);
+}
+
+function clearSessionSummaries() {
+  clearSessionSummariesStmt.run();
+  emitDatabaseChange({
+    type: 'session-summary',
+    action: 'clear',
+  });
+}
+
+// The plugin uploads the same match on both EventMatchEnded and Destroyed; keep one
+// row per match GUID and let the later (longer) timeline win.
+function saveMatchTimeline({ userId, matchGuid = '', timestamp, playlist, players = [], events = '' }) {
+  const playersJson = JSON.stringify(players);
+  const existing = matchGuid ? selectMatchTimelineByGuidStmt.get(userId, matchGuid) : null;
+  let id;
+  if (existing) {
+    updateMatchTimelineStmt.run(playersJson, events, existing.id);
+    id = existing.id;
+  } else {
+    const info = insertMatchTimelineStmt.run(userId, matchGuid, timestamp, playlist, playersJson, events);
+    id = Number(info.lastInsertRowid);
+  }
+
+  emitDatabaseChange({
+    type: 'match-timeline',
+    action: existing ? 'update' : 'create',
+    id,
+    userId,
+  });
+  return id;
+}
+
+function getMatchTimelines({ userId, from, to } = {}) {
+  const conditions = [];
+  const params = [];
+
+  if (userId) {
+    conditions.push('user_id = ?');
+    params.push(userId);
+  }
+
+  if (from) {
+    conditions.push('timestamp >= ?');
+    params.push(from);
+  }
+
+  if (to) {
+    conditions.push('timestamp <= ?');
+    params.push(to);
+  }
+
+  const whereClause = conditions.length ? `WHERE ${conditions.join(' AND ')}` : '';
+  const query = `SELECT id, user_id AS userId, match_guid AS matchGuid, timestamp, playlist, players AS playersJson, events FROM match_timelines ${whereClause} ORDER BY timestamp ASC;`;
+  return db
+    .prepare(query)
+    .all(...params)
+    .map(({ playersJson, events, ...timeline }) => {
+      const players = playersJson ? JSON.parse(playersJson) : [];
+      return { ...timeline, players, events: decodeTimelineEvents(events, players) };
+    });
+}
+
+function clearMatchTimelines() {
+  clearMatchTimelinesStmt.run();
+  emitDatabaseChange({
+    type: 'match-timeline',
+    action: 'clear',
+  });
+}
+
+function toReplayResponse(row) {
+  return row ? { ...row, complete: row.received >= row.size } : null;
+}
+
+function getReplay(id) {
+  return toReplayResponse(selectReplayStmt.get(id));
+}
+
+// Records the offset acknowledged for a replay upload; the first chunk creates the row.
+function saveReplayProgress({ id, userId = '', size, received }) {
+  const now = new Date().toISOString();
+  const completedAt = received >= size ? now : null;
+  const existing = selectReplayStmt.get(id);
+  if (existing) {
+    updateReplayProgressStmt.run(received, now, completedAt, id);
+  } else {
+    insertReplayStmt.run(id, userId, size, received, now, now, completedAt);
+  }
+
+  if (completedAt) {
+    emitDatabaseChange({
+      type: 'replay',
+      action: 'complete',
+      id,
+      userId: existing ? existing.userId : userId,
+    });
+  }
+  return getReplay(id);
+}
+
+function clearReplays() {
+  clearReplaysStmt.run();
+  emitDatabaseChange({
+    type: 'replay',
+    action: 'clear',
+  });
+}
+
+// Exactly-once ingestion for plugin uploads. Each install numbers its uploads; the
+// watermark is the highest sequence below which everything has been processed.
+// Sequences that arrive ahead of a gap (uploads run concurrently) are kept as
+// receipts until the gap fills. `floor` is the oldest sequence the client still
+// holds, so anything below it will never arrive and the watermark may skip it.
+function getIngestState(userId, installId) {
+  const ackedSeq = selectWatermarkStmt.get(userId, installId)?.ackedSeq ?? 0;
+  const receivedSeqs = selectReceiptsAboveStmt.all(userId, installId, ackedSeq).map((row) => row.seq);
+  return { installId, ackedSeq, receivedSeqs };
+}
+
+const ingestOnceTransaction = db.transaction(({ userId, installId, seq, floor }, write) => {
+  let ackedSeq = selectWatermarkStmt.get(userId, installId)?.ackedSeq ?? 0;
+  const duplicate = seq <= ackedSeq || Boolean(selectReceiptStmt.get(userId, installId, seq));
+  if (!duplicate) {
+    write();
+    insertReceiptStmt.run(userId, installId, seq);
+  }
+
+  ackedSeq = Math.max(ackedSeq, floor - 1);
+  for (const { seq: received } of selectReceiptsAboveStmt.all(userId, installId, ackedSeq)) {
+    if (received !== ackedSeq + 1) {
+      break;
+    }
+    ackedSeq = received;
+  }
+
+  deleteReceiptsThroughStmt.run(userId, installId, ackedSeq);
+  upsertWatermarkStmt.run(userId, installId, ackedSeq, new Date().toISOString());
+  return { duplicate, ackedSeq };
+});
+
+function ingestOnce({ userId = '', installId, seq, floor = 1 }, write) {
+  return ingestOnceTransaction({ userId, installId, seq, floor: Math.min(floor, seq) }, write);
+}
+
+function runInTransaction(work) {
+  return db.transaction(work)();
+}
+
+function clearIngestState() {
+  clearWatermarksStmt.run();
+  clearReceiptsStmt.run();
+}
+
 function ensureProfileSettingsRow() {
   const existing = selectProfileStmt.get();
   if (!existing) {
@@ -1441,6 +1747,7 @@ module.exports = {
   ensureFavoriteForUser,
   clearFavorites,
   getAllSkills,
+  getSkillIdsForTrainingPackCode,
   upsertSkill,
   deleteSkill,
   clearSkills,
@@ -1456,6 +1763,19 @@ module.exports = {
   saveSession,
   deleteSession,
   clearSessionTables,
+  saveSessionSummary,
+  getSessionSummaries,
+  clearSessionSummaries,
+  saveMatchTimeline,
+  getMatchTimelines,
+  clearMatchTimelines,
+  getReplay,
+  saveReplayProgress,
+  clearReplays,
+  getIngestState,
+  ingestOnce,
+  clearIngestState,
+  runInTransaction,
   getSkillDurationSummary,
   getProfile,
   updateProfile,
@@ -0,0 +1,273 @@
+// Live match state pushed by the BakkesMod plugin over a WebSocket on /api/live.
+// The plugin only sends, so this is the server half of RFC 6455 for unfragmented
+// text frames: the handshake, unmasking, ping and close. Each connection carries one
+// user's frames (X-User-Id on the upgrade request); the latest state per user is
+// kept in memory and handed to onState after every frame that changed it.
+
+const crypto = require('crypto');
+
+const LIVE_PATH = '/api/live';
+const WEBSOCKET_GUID = '258EAFA5-E914-47DA-95CA-C5AB0DC85B11';
+// Frames are a few dozen bytes; anything this large is not from the plugin.
+const MAX_FRAME_BYTES = 16 * 1024;
+const MAX_GOALS = 64;
+
+const OPCODE_TEXT = 0x1;
+const OPCODE_CLOSE = 0x8;
+const OPCODE_PING = 0x9;
+const OPCODE_PONG = 0xa;
+
+function acceptKey(key) {
+  return crypto.createHash('sha1').update(key + WEBSOCKET_GUID).digest('base64');
+}
+
+function isCount(value) {
+  return Number.isInteger(value) && value >= 0;
+}
+
+function isScore(value) {
+  return Array.isArray(value) && value.length === 2 && value.every(isCount);
+}
+
+// Only fields that pass validation are applied, so a bad frame leaves the rest alone.
+function applyFields(state, frame) {
+  if (isScore(frame.score)) {
+    state.score = [...frame.score];
+  }
+  if (isCount(frame.clock)) {
+    state.clock = frame.clock;
+  }
+  if (typeof frame.ot === 'boolean') {
+    state.overtime = frame.ot;
+  }
+  if (Number.isInteger(frame.boost) && frame.boost >= -1 && frame.boost <= 100) {
+    state.boost = frame.boost;
+  }
+}
+
+function encodeFrame(opcode, payload) {
+  const body = Buffer.isBuffer(payload) ? payload : Buffer.from(payload || '');
+  const header = body.length < 126 ? Buffer.alloc(2) : Buffer.alloc(4);
+  header[0] = 0x80 | opcode;
+  if (body.length < 126) {
+    header[1] = body.length;
+  } else {
+    header[1] = 126;
+    header.writeUInt16BE(body.length, 2);
+  }
+  return Buffer.concat([header, body]);
+}
+
+function closeFrame(code) {
+  const payload = Buffer.alloc(2);
+  payload.writeUInt16BE(code, 0);
+  return encodeFrame(OPCODE_CLOSE, payload);
+}
+
+function createLiveStream({ onState } = {}) {
+  const states = new Map();
+
+  // Returns the user's state after the frame, or null when the frame changed nothing.
+  function applyFrame(userId, frame) {
+    if (!frame || typeof frame !== 'object') {
+      return null;
+    }
+    const current = states.get(userId);
+
+    if (frame.type === 'key') {
+      if (typeof frame.match !== 'string' || !frame.match) {
+        return null;
+      }
+      const keepGoals = current && current.match === frame.match;
+      const state = {
+        match: frame.match,
+        playlist: isCount(frame.playlist) ? frame.playlist : 0,
+        team: Number.isInteger(frame.team) ? frame.team : -1,
+        score: [0, 0],
+        clock: 0,
+        overtime: false,
+        boost: -1,
+        goals: keepGoals ? current.goals : [],
+        ended: false,
+        updatedAt: new Date().toISOString(),
+      };
+      applyFields(state, frame);
+      states.set(userId, state);
+      return state;
+    }
+
+    if (!current) {
+      return null;
+    }
+    if (frame.type === 'state') {
+      if (current.ended) {
+        return null;
+      }
+      applyFields(current, frame);
+    } else if (frame.type === 'goal') {
+      if (frame.match !== current.match || !Number.isInteger(frame.team) || !isCount(frame.clock)) {
+        return null;
+      }
+      current.goals.push({ team: frame.team, clock: frame.clock });
+      if (current.goals.length > MAX_GOALS) {
+        current.goals.shift();
+      }
+    } else if (frame.type === 'end') {
+      if (frame.match !== current.match) {
+        return null;
+      }
+      current.ended = true;
+    } else {
+      return null;
+    }
+    current.updatedAt = new Date().toISOString();
+    return current;
+  }
+
+  function snapshot() {
+    return [...states.entries()].map(([userId, state]) => ({ userId, ...state }));
+  }
+
+  function handleText(userId, text) {
+    let frame;
+    try {
+      frame = JSON.parse(text);
+    } catch (error) {
+      return;
+    }
+    const state = applyFrame(userId, frame);
+    if (state && typeof onState === 'function') {
+      onState({ userId, type: frame.type, state });
+    }
+  }
+
+  function accept(socket, userId, head) {
+    let buffered = head && head.length > 0 ? Buffer.from(head) : Buffer.alloc(0);
+    let closed = false;
+
+    function fail(code) {
+      if (!closed) {
+        closed = true;
+        socket.end(closeFrame(code));
+      }
+    }
+
+    function drain() {
+      while (!closed && buffered.length >= 2) {
+        const fin = (buffered[0] & 0x80) !== 0;
+        const opcode = buffered[0] & 0x0f;
+        const masked = (buffered[1] & 0x80) !== 0;
+        let length = buffered[1] & 0x7f;
+        let offset = 2;
+        if (length === 126) {
+          if (buffered.length < 4) {
+            return;
+          }
+          length = buffered.readUInt16BE(2);
+          offset = 4;
+        } else if (length === 127) {
+          if (buffered.length < 10) {
+            return;
+          }
+          const wide = buffered.readBigUInt64BE(2);
+          length = wide > BigInt(MAX_FRAME_BYTES) ? MAX_FRAME_BYTES + 1 : Number(wide);
+          offset = 10;
+        }
+
+        // Clients must mask (RFC 6455 5.1); fragmented messages are never sent by the plugin.
+        if (!masked) {
+          fail(1002);
+          return;
+        }
+        if (!fin) {
+          fail(1003);
+          return;
+        }
+        if (length > MAX_FRAME_BYTES) {
+          fail(1009);
+          return;
+        }
+        if (buffered.length < offset + 4 + length) {
+          return;
+        }
+
+        const mask = buffered.subarray(offset, offset + 4);
+        const payload = Buffer.from(buffered.subarray(offset + 4, offset + 4 + length));
+        for (let i = 0; i < payload.length; i += 1) {
+          payload[i] ^= mask[i % 4];
+        }
+        buffered = buffered.subarray(offset + 4 + length);
+
+        if (opcode === OPCODE_TEXT) {
+          handleText(userId, payload.toString('utf8'));
+        } else if (opcode === OPCODE_PING) {
+          socket.write(encodeFrame(OPCODE_PONG, payload));
+        } else if (opcode === OPCODE_CLOSE) {
+          fail(1000);
+        } else if (opcode !== OPCODE_PONG) {
+          fail(1003);
+        }
+      }
+    }
+
+    socket.setNoDelay(true);
+    socket.on('data', (chunk) => {
+      buffered = buffered.length > 0 ? Buffer.concat([buffered, chunk]) : chunk;
+      drain();
+    });
+    // The HTTP server allows half-open sockets; finish closing one the plugin closed.
+    socket.on('end', () => {
+      closed = true;
+      socket.end();
+    });
+    socket.on('error', () => {
+      closed = true;
+    });
+    socket.on('close', () => {
+      closed = true;
+    });
+    drain();
+  }
+
+  // Answers an HTTP upgrade request; false when it is not for this endpoint.
+  function handleUpgrade(req, socket, head) {
+    const pathname = new URL(req.url, 'http://localhost').pathname;
+    if (pathname !== LIVE_PATH) {
+      return false;
+    }
+
+    const key = req.headers['sec-websocket-key'];
+    const upgrade = (req.headers.upgrade || '').toLowerCase();
+    if (upgrade !== 'websocket' || req.headers['sec-websocket-version'] !== '13' || !key) {
+      socket.end('HTTP/1.1 400 Bad Request\r\nConnection: close\r\n\r\n');
+      return true;
+    }
+    const userId = (req.headers['x-user-id'] || '').trim();
+    if (!userId) {
+      socket.end('HTTP/1.1 401 Unauthorized\r\nConnection: close\r\n\r\n');
+      return true;
+    }
+
+    socket.write(
+      'HTTP/1.1 101 Switching Protocols\r\n' +
+        'Upgrade: websocket\r\n' +
+        'Connection: Upgrade\r\n' +
+        `Sec-WebSocket-Accept: ${acceptKey(key)}\r\n\r\n`,
+    );
+    accept(socket, userId, head);
+    return true;
+  }
+
+  function attach(server) {
+    server.on('upgrade', (req, socket, head) => {
+      if (!handleUpgrade(req, socket, head)) {
+        socket.destroy();
+      }
+    });
+    return server;
+  }
+
+  return { attach, handleUpgrade, applyFrame, snapshot, clear: () => states.clear() };
+}
+
+module.exports = { createLiveStream, acceptKey, LIVE_PATH, MAX_FRAME_BYTES };
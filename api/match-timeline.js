@@ -0,0 +1,53 @@
+// Decoder for the compact match timeline the BakkesMod plugin attaches to match uploads.
+// events: "<dt>,<G|D|O>[,<team>,<actor>[,<other>]]" joined by ';', where dt is seconds
+// since the previous event and actor/other index the players array.
+
+const EVENTS_PATTERN = /^[0-9A-Z,;]*$/;
+const MAX_PLAYERS = 16;
+
+function validateTimeline(timeline) {
+  if (!timeline || typeof timeline !== 'object' || Array.isArray(timeline)) {
+    return 'timeline must be an object';
+  }
+
+  if (!Array.isArray(timeline.players) || timeline.players.length > MAX_PLAYERS) {
+    return `timeline.players must be an array of at most ${MAX_PLAYERS} players`;
+  }
+
+  if (typeof timeline.events !== 'string' || !EVENTS_PATTERN.test(timeline.events)) {
+    return 'timeline.events must be a compact event string';
+  }
+
+  return null;
+}
+
+function decodeTimelineEvents(events, players = []) {
+  if (!events) {
+    return [];
+  }
+
+  const playerName = (index) => {
+    if (index === undefined || index === '') return null;
+    const player = players[Number(index)];
+    return player && typeof player.name === 'string' ? player.name : null;
+  };
+
+  let seconds = 0;
+  const decoded = [];
+  events.split(';').forEach((token) => {
+    const [delta, code, team, actor, other] = token.split(',');
+    seconds += Number(delta) || 0;
+    const teamIndex = team === undefined || team === '' ? null : Number(team);
+
+    if (code === 'G') {
+      decoded.push({ seconds, type: 'goal', team: teamIndex, scorer: playerName(actor), assister: playerName(other) });
+    } else if (code === 'D') {
+      decoded.push({ seconds, type: 'demolish', team: teamIndex, attacker: playerName(actor), victim: playerName(other) });
+    } else if (code === 'O') {
+      decoded.push({ seconds, type: 'overtime' });
+    }
+  });
+  return decoded;
+}
+
+module.exports = { validateTimeline, decodeTimelineEvents };
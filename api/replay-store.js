@@ -0,0 +1,37 @@
+// On-disk storage for replay files uploaded in chunks by the BakkesMod plugin.
+// Progress (size and acknowledged offset) lives in the replays table; this module
+// only places bytes at the offset the route has already validated.
+
+const fs = require('fs');
+const path = require('path');
+
+const REPLAY_ID_PATTERN = /^[A-Za-z0-9_-]{1,64}$/;
+
+function isValidReplayId(id) {
+  return typeof id === 'string' && REPLAY_ID_PATTERN.test(id);
+}
+
+function replayDirectory() {
+  return process.env.REPLAY_STORAGE_PATH || path.join(__dirname, 'replays');
+}
+
+function replayFilePath(id) {
+  return path.join(replayDirectory(), `${id}.replay`);
+}
+
+function writeReplayChunk(id, offset, chunk) {
+  fs.mkdirSync(replayDirectory(), { recursive: true });
+  // The first chunk truncates whatever an abandoned upload left behind.
+  const fd = fs.openSync(replayFilePath(id), offset === 0 ? 'w' : 'r+');
+  try {
+    fs.writeSync(fd, chunk, 0, chunk.length, offset);
+  } finally {
+    fs.closeSync(fd);
+  }
+}
+
+function removeReplayFile(id) {
+  fs.rmSync(replayFilePath(id), { force: true });
+}
+
+module.exports = { isValidReplayId, replayFilePath, writeReplayChunk, removeReplayFile };
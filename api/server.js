@@ -1,6 +1,7 @@
 const app = require('./app');
 const PORT = process.env.PORT || 4000;
 
-app.listen(PORT, () => {
+const server = app.listen(PORT, () => {
   console.log(`API server listening on http://localhost:${PORT}`);
-});
\ No newline at end of file
+});
+app.liveStream.attach(server);
@@ -0,0 +1,121 @@
+process.env.DATABASE_PATH = ':memory:';
+
+const zlib = require('zlib');
+const request = require('supertest');
+const app = require('../app');
+const db = require('../db');
+
+beforeEach(() => {
+  db.clearMmrLogs();
+  db.clearIngestState();
+});
+
+describe('sequenced mmr-log ingestion', () => {
+  let mmr = 1000;
+
+  function upload(clientSeq, extra = {}) {
+    mmr += 7;
+    return request(app)
+      .post('/api/mmr-log')
+      .set('X-User-Id', 'player-1')
+      .send({
+        timestamp: '2025-11-20T18:00:00Z',
+        playlist: 'Ranked Doubles',
+        mmr,
+        gamesPlayedDiff: 1,
+        source: 'bakkes',
+        installId: 'install-a',
+        clientSeq,
+        ...extra,
+      });
+  }
+
+  it('stores a retried upload once and acknowledges it both times', async () => {
+    const first = await upload(1);
+    expect(first.statusCode).toBe(201);
+    expect(first.body).toEqual({ saved: true, duplicate: false, ackedSeq: 1 });
+    expect(first.headers['x-acked-seq']).toBe('1');
+
+    const retry = await request(app)
+      .post('/api/mmr-log')
+      .set('X-User-Id', 'player-1')
+      .send({ timestamp: '2025-11-20T18:05:00Z', playlist: 'Ranked Doubles', mmr: 1, gamesPlayedDiff: 1, installId: 'install-a', clientSeq: 1 });
+    expect(retry.statusCode).toBe(200);
+    expect(retry.body).toEqual({ saved: false, duplicate: true, ackedSeq: 1 });
+
+    const logs = await request(app).get('/api/mmr');
+    expect(logs.body).toHaveLength(1);
+  });
+
+  it('holds the watermark at a gap until the missing upload arrives', async () => {
+    await upload(1);
+    const ahead = await upload(3);
+    expect(ahead.body.ackedSeq).toBe(1);
+
+    const state = await request(app).get('/api/ingest/watermark?installId=install-a').set('X-User-Id', 'player-1');
+    expect(state.body).toEqual({ installId: 'install-a', ackedSeq: 1, receivedSeqs: [3] });
+
+    const filled = await upload(2);
+    expect(filled.body.ackedSeq).toBe(3);
+    expect((await upload(3)).body.duplicate).toBe(true);
+  });
+
+  it('skips sequences the client no longer holds', async () => {
+    await upload(1);
+    const response = await upload(5, { oldestPendingSeq: 5 });
+    expect(response.body.ackedSeq).toBe(5);
+  });
+
+  it('keeps watermarks separate per user and install', async () => {
+    await upload(1);
+    const other = await request(app).get('/api/ingest/watermark?installId=install-b').set('X-User-Id', 'player-1');
+    expect(other.body.ackedSeq).toBe(0);
+    const otherUser = await request(app).get('/api/ingest/watermark?installId=install-a').set('X-User-Id', 'player-2');
+    expect(otherUser.body.ackedSeq).toBe(0);
+  });
+
+  it('rejects malformed sequence fields', async () => {
+    const response = await upload(0, { installId: 'bad id' });
+    expect(response.statusCode).toBe(400);
+    expect(response.body.error).toMatch(/installId/);
+    expect(response.body.error).toMatch(/clientSeq/);
+  });
+});
+
+describe('bulk NDJSON import', () => {
+  const line = (clientSeq, mmr, extra = {}) =>
+    JSON.stringify({
+      timestamp: `2025-11-2${clientSeq}T18:00:00Z`,
+      playlist: 'Ranked Doubles',
+      mmr,
+      gamesPlayedDiff: 1,
+      source: 'bakkes',
+      installId: 'install-a',
+      clientSeq,
+      oldestPendingSeq: 1,
+      ...extra,
+    });
+
+  it('ingests a gzip-compressed backlog in one request and acknowledges it', async () => {
+    await request(app)
+      .post('/api/mmr-log')
+      .set('X-User-Id', 'player-1')
+      .send(JSON.parse(line(1, 1000)));
+
+    const documentText = [line(1, 1000), line(2, 1010), line(3, 1020, { playlist: 'Nope' }), line(4, 1030)].join('\n');
+    const response = await request(app)
+      .post('/api/history/import')
+      .set('X-User-Id', 'player-1')
+      .set('Content-Type', 'application/x-ndjson')
+      .set('Content-Encoding', 'gzip')
+      .send(zlib.gzipSync(documentText));
+
+    expect(response.statusCode).toBe(200);
+    expect(response.body).toMatchObject({ imported: 2, duplicates: 1, rejectedSeqs: [3], receivedSeqs: [1, 2, 4], ackedSeq: 2 });
+    expect(response.body.errors).toEqual(['Line 3: unsupported playlist']);
+    expect(response.headers['x-acked-seq']).toBe('2');
+
+    const logs = await request(app).get('/api/mmr');
+    expect(logs.body.map((row) => row.mmr)).toEqual([1000, 1010, 1030]);
+  });
+});
@@ -0,0 +1,141 @@
+const crypto = require('crypto');
+const http = require('http');
+const net = require('net');
+
+process.env.DATABASE_PATH = ':memory:';
+
+const request = require('supertest');
+const app = require('../app');
+const { createLiveStream, acceptKey, MAX_FRAME_BYTES } = require('../live-stream');
+
+function maskedFrame(opcode, text) {
+  const payload = Buffer.from(text);
+  const mask = crypto.randomBytes(4);
+  const header = payload.length < 126 ? Buffer.from([0x80 | opcode, 0x80 | payload.length]) : Buffer.alloc(4);
+  if (payload.length >= 126) {
+    header[0] = 0x80 | opcode;
+    header[1] = 0x80 | 126;
+    header.writeUInt16BE(payload.length, 2);
+  }
+  const body = Buffer.from(payload.map((byte, index) => byte ^ mask[index % 4]));
+  return Buffer.concat([header, mask, body]);
+}
+
+function connect(port, headers = {}) {
+  return new Promise((resolve, reject) => {
+    const socket = net.connect(port, '127.0.0.1');
+    const key = crypto.randomBytes(16).toString('base64');
+    let response = '';
+    socket.on('error', reject);
+    socket.on('connect', () => {
+      const extra = Object.entries(headers).map(([name, value]) => `${name}: ${value}\r\n`).join('');
+      socket.write(
+        'GET /api/live HTTP/1.1\r\nHost: localhost\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n' +
+          `Sec-WebSocket-Version: 13\r\nSec-WebSocket-Key: ${key}\r\n${extra}\r\n`,
+      );
+    });
+    socket.on('data', function onData(chunk) {
+      response += chunk.toString('latin1');
+      if (response.includes('\r\n\r\n')) {
+        socket.off('data', onData);
+        resolve({ socket, response, key });
+      }
+    });
+  });
+}
+
+function waitFor(predicate) {
+  return new Promise((resolve) => {
+    const check = () => (predicate() ? resolve() : setTimeout(check, 5));
+    check();
+  });
+}
+
+describe('live stream frames', () => {
+  it('applies keyframes, deltas, goals and the match end', () => {
+    const stream = createLiveStream();
+    expect(stream.applyFrame('p1', { type: 'state', clock: 5 })).toBeNull();
+
+    stream.applyFrame('p1', { type: 'key', match: 'm1', playlist: 11, team: 0, score: [0, 0], clock: 10, ot: false, boost: 33 });
+    stream.applyFrame('p1', { type: 'state', clock: 11, boost: 100 });
+    stream.applyFrame('p1', { type: 'state', score: [1, 0], boost: 'full' });
+    stream.applyFrame('p1', { type: 'goal', match: 'm1', team: 0, clock: 11 });
+    expect(stream.applyFrame('p1', { type: 'goal', match: 'other', team: 1, clock: 12 })).toBeNull();
+
+    const [live] = stream.snapshot();
+    expect(live).toMatchObject({ userId: 'p1', match: 'm1', playlist: 11, score: [1, 0], clock: 11, boost: 100, ended: false });
+    expect(live.goals).toEqual([{ team: 0, clock: 11 }]);
+
+    stream.applyFrame('p1', { type: 'end', match: 'm1' });
+    expect(stream.applyFrame('p1', { type: 'state', clock: 20 })).toBeNull();
+    expect(stream.snapshot()[0]).toMatchObject({ ended: true, clock: 11 });
+  });
+
+  it('keeps goals when the plugin reconnects during the same match', () => {
+    const stream = createLiveStream();
+    stream.applyFrame('p1', { type: 'key', match: 'm1', score: [0, 0] });
+    stream.applyFrame('p1', { type: 'goal', match: 'm1', team: 1, clock: 40 });
+    stream.applyFrame('p1', { type: 'key', match: 'm1', score: [0, 1] });
+    expect(stream.snapshot()[0].goals).toHaveLength(1);
+
+    stream.applyFrame('p1', { type: 'key', match: 'm2' });
+    expect(stream.snapshot()[0].goals).toEqual([]);
+  });
+});
+
+describe('live stream WebSocket', () => {
+  let server;
+  let port;
+  let updates;
+
+  beforeEach(async () => {
+    updates = [];
+    const stream = createLiveStream({ onState: (update) => updates.push(update) });
+    server = stream.attach(http.createServer());
+    await new Promise((resolve) => server.listen(0, '127.0.0.1', resolve));
+    port = server.address().port;
+  });
+
+  afterEach(async () => {
+    await new Promise((resolve) => server.close(resolve));
+  });
+
+  it('completes the handshake and reports each frame', async () => {
+    const { socket, response, key } = await connect(port, { 'X-User-Id': 'p1' });
+    expect(response.startsWith('HTTP/1.1 101')).toBe(true);
+    expect(response).toContain(`Sec-WebSocket-Accept: ${acceptKey(key)}`);
+
+    socket.write(maskedFrame(0x1, JSON.stringify({ type: 'key', match: 'm1', score: [2, 1], clock: 90 })));
+    socket.write(maskedFrame(0x1, JSON.stringify({ type: 'state', clock: 91 })));
+    await waitFor(() => updates.length === 2);
+
+    expect(updates[1]).toMatchObject({ userId: 'p1', type: 'state', state: { match: 'm1', score: [2, 1], clock: 91 } });
+    socket.destroy();
+  });
+
+  it('rejects an upgrade without a user id', async () => {
+    const { socket, response } = await connect(port);
+    expect(response.startsWith('HTTP/1.1 401')).toBe(true);
+    socket.destroy();
+  });
+
+  it('closes the connection on an oversized frame', async () => {
+    const { socket } = await connect(port, { 'X-User-Id': 'p1' });
+    const closed = new Promise((resolve) => socket.on('close', resolve));
+    socket.write(maskedFrame(0x1, 'x'.repeat(MAX_FRAME_BYTES + 1)));
+    await closed;
+    expect(updates).toHaveLength(0);
+  });
+});
+
+describe('GET /api/live', () => {
+  it('returns the latest state of each streamed match', async () => {
+    app.liveStream.clear();
+    app.liveStream.applyFrame('p1', { type: 'key', match: 'm1', score: [0, 3], clock: 200, ot: true });
+
+    const response = await request(app).get('/api/live');
+    expect(response.statusCode).toBe(200);
+    expect(response.body.matches).toHaveLength(1);
+    expect(response.body.matches[0]).toMatchObject({ userId: 'p1', match: 'm1', score: [0, 3], overtime: true });
+  });
+});
@@ -0,0 +1,66 @@
+process.env.DATABASE_PATH = ':memory:';
+
+const request = require('supertest');
+const app = require('../app');
+const db = require('../db');
+const { decodeTimelineEvents, validateTimeline } = require('../match-timeline');
+
+beforeEach(() => {
+  db.clearMmrLogs();
+  db.clearMatchTimelines();
+});
+
+describe('match timelines', () => {
+  const players = [
+    { name: 'Alice', team: 0 },
+    { name: 'Bob', team: 0 },
+    { name: 'Carol', team: 1 },
+  ];
+  const timeline = { guid: 'ABC123', players, events: '12,G,0,0,1;28,D,1,2,0;260,O;20,G,1,2' };
+
+  it('decodes delta-encoded events into absolute seconds and player names', () => {
+    expect(decodeTimelineEvents(timeline.events, players)).toEqual([
+      { seconds: 12, type: 'goal', team: 0, scorer: 'Alice', assister: 'Bob' },
+      { seconds: 40, type: 'demolish', team: 1, attacker: 'Carol', victim: 'Alice' },
+      { seconds: 300, type: 'overtime' },
+      { seconds: 320, type: 'goal', team: 1, scorer: 'Carol', assister: null },
+    ]);
+  });
+
+  it('rejects malformed timelines', () => {
+    expect(validateTimeline({ players, events: '12,G,0,"x"' })).toMatch(/events/);
+    expect(validateTimeline({ events: '' })).toMatch(/players/);
+    expect(validateTimeline(null)).toMatch(/object/);
+  });
+
+  it('stores the timeline sent with a match upload once per match', async () => {
+    const payload = {
+      timestamp: '2025-11-20T18:00:00Z',
+      playlist: 'Ranked Doubles',
+      mmr: 1010,
+      gamesPlayedDiff: 1,
+      source: 'bakkes',
+      timeline,
+    };
+
+    const first = await request(app).post('/api/mmr-log').set('X-User-Id', 'player-1').send(payload);
+    expect(first.statusCode).toBe(201);
+    const second = await request(app).post('/api/mmr-log').set('X-User-Id', 'player-1').send(payload);
+    expect(second.statusCode).toBe(201);
+
+    const response = await request(app).get('/api/match-timelines').set('X-User-Id', 'player-1');
+    expect(response.statusCode).toBe(200);
+    expect(response.body).toHaveLength(1);
+    expect(response.body[0]).toMatchObject({ matchGuid: 'ABC123', playlist: 'Ranked Doubles', players });
+    expect(response.body[0].events).toHaveLength(4);
+  });
+
+  it('returns 400 when the timeline is malformed', async () => {
+    const response = await request(app)
+      .post('/api/mmr-log')
+      .send({ timestamp: '2025-11-20T18:00:00Z', playlist: 'Ranked Doubles', mmr: 1000, gamesPlayedDiff: 1, timeline: { players: 'x', events: '' } });
+
+    expect(response.statusCode).toBe(400);
+    expect(response.body.error).toMatch(/timeline.players/);
+  });
+});
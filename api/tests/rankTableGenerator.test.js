@@ -0,0 +1,84 @@
+const fs = require('fs');
+
+const {
+  parseRange,
+  parseRankName,
+  parseRanksCsv,
+  renderHeader,
+  DEFAULT_CSV_PATH,
+  DEFAULT_HEADER_PATH,
+} = require('../../tools/generate-rank-table');
+
+describe('generate-rank-table', () => {
+  test('parseRange handles en dashes and single values', () => {
+    expect(parseRange('1341–1660')).toEqual({ min: 1341, max: 1660 });
+    expect(parseRange('1521')).toEqual({ min: 1521, max: 1521 });
+    expect(parseRange('')).toBeNull();
+  });
+
+  test('parseRankName splits tier and division', () => {
+    expect(parseRankName('GC3 Div 4')).toEqual({ tier: 'GC3', division: 4 });
+    expect(parseRankName('SSL')).toEqual({ tier: 'SSL', division: 0 });
+  });
+
+  test('clamps overlapping floors above the division below', () => {
+    const csv = [
+      'RANK,1v1,2v2,3v3,Hoops,Rumble,Dropshot,Snowday,4v4',
+      'S1 Div 2,,200–250,,,,,,',
+      'S1 Div 1,,100–199,,,,,,',
+      'B1 Div 2,,100–150,,,,,,',
+      'B1 Div 1,,0–99,,,,,,',
+    ].join('\n');
+
+    const { tiers, tables } = parseRanksCsv(csv);
+    expect(tiers).toEqual(['B1', 'S1']);
+
+    const doubles = tables.find((table) => table.identifier === 'Doubles');
+    expect(doubles.intervals.map((interval) => interval.floor)).toEqual([0, 100, 151, 200]);
+    expect(doubles.intervals.map((interval) => interval.ceiling)).toEqual([99, 150, 199, 250]);
+    expect(doubles.intervals[1]).toMatchObject({ tier: 0, division: 2 });
+  });
+
+  test('drops rows that lie entirely within the divisions below them', () => {
+    const csv = [
+      'RANK,1v1,2v2,3v3,Hoops,Rumble,Dropshot,Snowday,4v4',
+      'S1 Div 1,,90–120,,,,,,',
+      'B1 Div 2,,40–80,,,,,,',
+      'B1 Div 1,,0–99,,,,,,',
+    ].join('\n');
+
+    const { tables, warnings } = parseRanksCsv(csv);
+    const doubles = tables.find((table) => table.identifier === 'Doubles');
+    expect(doubles.intervals).toEqual([
+      { floor: 0, ceiling: 99, tier: 0, division: 1 },
+      { floor: 100, ceiling: 120, tier: 1, division: 1 },
+    ]);
+    expect(warnings).toEqual([expect.stringContaining('Doubles: B1 Div 2')]);
+  });
+
+  test('keeps every division of the real ranks.csv and leaves no gaps', () => {
+    const { tiers, tables } = parseRanksCsv(fs.readFileSync(DEFAULT_CSV_PATH, 'utf8'));
+    const divisionsOf = (identifier, tier) => tables
+      .find((table) => table.identifier === identifier).intervals
+      .filter((interval) => interval.tier === tiers.indexOf(tier))
+      .map((interval) => interval.division);
+
+    expect(divisionsOf('Duel', 'C2')).toEqual([1, 2, 3, 4]);
+    expect(divisionsOf('Duel', 'C3')).toEqual([1, 2, 3, 4]);
+    expect(divisionsOf('Standard', 'C3')).toEqual([1, 2, 3, 4]);
+
+    for (const { identifier, intervals } of tables) {
+      intervals.forEach((interval, i) => {
+        expect({ identifier, valid: interval.floor <= interval.ceiling }).toEqual({ identifier, valid: true });
+        if (i + 1 < intervals.length) {
+          expect({ identifier, ceiling: interval.ceiling }).toEqual({ identifier, ceiling: intervals[i + 1].floor - 1 });
+        }
+      });
+    }
+  });
+
+  test('checked-in plugin header matches ranks.csv', () => {
+    const expected = renderHeader(parseRanksCsv(fs.readFileSync(DEFAULT_CSV_PATH, 'utf8')));
+    expect(fs.readFileSync(DEFAULT_HEADER_PATH, 'utf8')).toBe(expected);
+  });
+});
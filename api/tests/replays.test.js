@@ -0,0 +1,80 @@
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+
+process.env.DATABASE_PATH = ':memory:';
+process.env.REPLAY_STORAGE_PATH = fs.mkdtempSync(path.join(os.tmpdir(), 'rtj-replays-'));
+
+const request = require('supertest');
+const app = require('../app');
+const db = require('../db');
+
+beforeEach(() => {
+  db.clearReplays();
+});
+
+afterAll(() => {
+  fs.rmSync(process.env.REPLAY_STORAGE_PATH, { recursive: true, force: true });
+});
+
+describe('replay uploads', () => {
+  const replay = Buffer.from(Array.from({ length: 1000 }, (_, index) => index % 251));
+
+  function putChunk(id, offset, chunk, size = replay.length) {
+    return request(app)
+      .put(`/api/replays/${id}/chunks?offset=${offset}&size=${size}`)
+      .set('Content-Type', 'application/octet-stream')
+      .set('X-User-Id', 'player-1')
+      .send(chunk);
+  }
+
+  it('assembles chunks in order and serves the finished file', async () => {
+    const first = await putChunk('ABC123', 0, replay.subarray(0, 400));
+    expect(first.statusCode).toBe(200);
+    expect(first.body).toMatchObject({ id: 'ABC123', userId: 'player-1', size: 1000, received: 400, complete: false });
+
+    const second = await putChunk('ABC123', 400, replay.subarray(400));
+    expect(second.body).toMatchObject({ received: 1000, complete: true });
+
+    const status = await request(app).get('/api/replays/ABC123');
+    expect(status.body.completedAt).toEqual(expect.any(String));
+
+    const file = await request(app)
+      .get('/api/replays/ABC123/file')
+      .buffer(true)
+      .parse((res, callback) => {
+        const parts = [];
+        res.on('data', (part) => parts.push(part));
+        res.on('end', () => callback(null, Buffer.concat(parts)));
+      });
+    expect(file.statusCode).toBe(200);
+    expect(Buffer.compare(file.body, replay)).toBe(0);
+  });
+
+  it('answers an out-of-order chunk with the acknowledged offset so the plugin can resume', async () => {
+    await putChunk('RESUME1', 0, replay.subarray(0, 300));
+
+    const skipped = await putChunk('RESUME1', 600, replay.subarray(600, 900));
+    expect(skipped.statusCode).toBe(409);
+    expect(skipped.body.received).toBe(300);
+
+    const retried = await putChunk('RESUME1', 0, replay.subarray(0, 300));
+    expect(retried.statusCode).toBe(409);
+    expect(retried.body.received).toBe(300);
+
+    const resumed = await putChunk('RESUME1', 300, replay.subarray(300));
+    expect(resumed.body).toMatchObject({ received: 1000, complete: true });
+
+    const incomplete = await putChunk('OTHER', 0, replay.subarray(0, 10));
+    expect(incomplete.statusCode).toBe(200);
+    const early = await request(app).get('/api/replays/OTHER/file');
+    expect(early.statusCode).toBe(409);
+  });
+
+  it('rejects invalid ids, sizes and chunks that overrun the declared size', async () => {
+    expect((await putChunk('bad.id', 0, replay)).statusCode).toBe(400);
+    expect((await putChunk('SIZE', 0, replay, 0)).statusCode).toBe(400);
+    expect((await putChunk('SIZE', 0, replay, 10)).statusCode).toBe(400);
+    expect((await request(app).get('/api/replays/missing')).statusCode).toBe(404);
+  });
+});
@@ -0,0 +1,67 @@
+process.env.DATABASE_PATH = ':memory:';
+
+const request = require('supertest');
+const app = require('../app');
+const db = require('../db');
+
+beforeEach(() => {
+  db.clearSessionSummaries();
+});
+
+describe('session summaries', () => {
+  const payload = {
+    startedTime: '2025-11-20T18:00:00Z',
+    finishedTime: '2025-11-20T19:10:00Z',
+    matches: 5,
+    wins: 3,
+    losses: 2,
+    playlists: [
+      {
+        playlist: 'Ranked Doubles',
+        matches: 5,
+        wins: 3,
+        losses: 2,
+        netMmr: 24,
+        goalsPerGame: 1.4,
+        currentStreak: 2,
+        longestWinStreak: 2,
+        longestLossStreak: 1,
+      },
+    ],
+  };
+
+  it('stores a plugin session summary and lists it for the same user', async () => {
+    const response = await request(app)
+      .post('/api/session-summaries')
+      .set('X-User-Id', 'player-1')
+      .send(payload)
+      .set('Content-Type', 'application/json');
+
+    expect(response.statusCode).toBe(201);
+    expect(response.body).toMatchObject({
+      userId: 'player-1',
+      matches: 5,
+      wins: 3,
+      losses: 2,
+    });
+    expect(response.body.playlists[0]).toMatchObject({ playlist: 'Ranked 2v2', netMmr: 24 });
+
+    const mine = await request(app).get('/api/session-summaries').set('X-User-Id', 'player-1');
+    expect(mine.statusCode).toBe(200);
+    expect(mine.body).toHaveLength(1);
+
+    const others = await request(app).get('/api/session-summaries').set('X-User-Id', 'player-2');
+    expect(others.body).toHaveLength(0);
+  });
+
+  it('rejects summaries with missing counts', async () => {
+    const response = await request(app)
+      .post('/api/session-summaries')
+      .set('X-User-Id', 'player-1')
+      .send({ ...payload, wins: -1 })
+      .set('Content-Type', 'application/json');
+
+    expect(response.statusCode).toBe(400);
+    expect(response.body).toHaveProperty('error');
+  });
+});
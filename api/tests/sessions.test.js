@@ -99,6 +99,37 @@ describe('POST /api/sessions', () => {
     const sessionsList = await request(app).get('/api/sessions');
     expect(sessionsList.body).toHaveLength(0);
   });
+
+  it('maps plugin-captured training packs onto the skills that use them', async () => {
+    const skill = db.upsertSkill({
+      name: 'Backboard reads',
+      category: 'Aerial',
+      trainingPacks: [{ name: 'Backboard 1', code: 'A1B2-C3D4-E5F6-0789' }],
+    });
+
+    const response = await request(app)
+      .post('/api/sessions')
+      .send({
+        startedTime: '2025-11-15T10:00:00Z',
+        finishedTime: '2025-11-15T10:20:00Z',
+        source: 'bakkes_training',
+        blocks: [
+          {
+            type: 'training_pack',
+            skillIds: [],
+            packCode: 'A1B2-C3D4-E5F6-0789',
+            plannedDuration: 900,
+            actualDuration: 900,
+            notes: 'Backboard 1: 14/40 goals',
+          },
+          { type: 'freeplay', skillIds: [], plannedDuration: 300, actualDuration: 300 },
+        ],
+      });
+
+    expect(response.statusCode).toBe(201);
+    expect(response.body.blocks[0].skillIds).toEqual([skill.id]);
+    expect(response.body.blocks[1].skillIds).toEqual([]);
+  });
 });
 
 describe('DELETE /api/sessions/:id', () => {
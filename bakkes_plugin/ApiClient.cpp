@@ -1,9 +1,16 @@
 #include "pch.h"
 #include "ApiClient.h"
+#include "EpollHttpTransport.h"
+#include "MemoryTracker.h"
+#include "TraceRecorder.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cctype>
-#include <sstream>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <unordered_set>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -13,7 +20,34 @@
 
 namespace
 {
+    // Synchronous responses land here. Each worker thread keeps its buffer between
+    // requests, but gives back anything beyond kRetainedResponseBytes.
+    constexpr std::size_t kRetainedResponseBytes = 64 * 1024;
+
+    TrackedString& ThreadResponseBuffer()
+    {
+        thread_local TrackedString buffer;
+        buffer.clear();
+        if (buffer.capacity() > kRetainedResponseBytes)
+        {
+            buffer.shrink_to_fit();
+        }
+        return buffer;
+    }
+
 #ifdef _WIN32
+    // Closes the span for the stage that just finished and starts timing the next one.
+    void TraceStage(const char* name, std::int64_t& stageStart)
+    {
+        if (!TraceRecorder::IsEnabled())
+        {
+            return;
+        }
+        const std::int64_t now = TraceRecorder::NowMicros();
+        TraceRecorder::Record(name, TraceRecorder::CurrentUploadId(), stageStart, now - stageStart);
+        stageStart = now;
+    }
+
     struct ParsedUrl
     {
         bool secure;
@@ -100,11 +134,200 @@ namespace
 
 } // namespace
 
+#ifdef _WIN32
+// One WINHTTP_FLAG_ASYNC session shared by every SendAsync call. Each call walks
+// send -> receive -> (query data -> read)* on WinHTTP's own threads and reports
+// from HANDLE_CLOSING, the last callback its request handle gets.
+struct ApiClient::AsyncTransport
+{
+    struct Call
+    {
+        AsyncTransport* transport = nullptr;
+        HINTERNET connection = nullptr;
+        HINTERNET request = nullptr;
+        std::atomic<bool> closing{false};
+        std::string body;
+        std::vector<char> chunk;
+        std::string response;
+        HttpResult result;
+        Completion done;
+    };
+
+    std::mutex mutex;
+    std::condition_variable drained;
+    HINTERNET session = nullptr;
+    std::unordered_set<Call*> active;
+    bool closed = false;
+
+    static void Close(Call* call)
+    {
+        if (!call->closing.exchange(true))
+        {
+            WinHttpCloseHandle(call->request);
+        }
+    }
+
+    static void Fail(Call* call, const std::string& error)
+    {
+        if (call->result.error.empty())
+        {
+            call->result.error = error;
+        }
+        Close(call);
+    }
+
+    static void Finish(Call* call)
+    {
+        HttpResult& result = call->result;
+        result.body = std::move(call->response);
+        result.success = result.status >= 200 && result.status < 300;
+        if (!result.success)
+        {
+            result.error = "HTTP " + std::to_string(result.status);
+            if (!result.body.empty())
+            {
+                result.error += ": " + result.body;
+            }
+        }
+        Close(call);
+    }
+
+    static void RequestMore(Call* call)
+    {
+        if (!WinHttpQueryDataAvailable(call->request, nullptr))
+        {
+            Fail(call, "WinHttpQueryDataAvailable failed: " + std::to_string(GetLastError()));
+        }
+    }
+
+    static void CALLBACK OnStatus(HINTERNET, DWORD_PTR context, DWORD status, LPVOID info, DWORD length)
+    {
+        Call* call = reinterpret_cast<Call*>(context);
+        if (!call)
+        {
+            return;
+        }
+
+        switch (status)
+        {
+        case WINHTTP_CALLBACK_STATUS_SENDREQUEST_COMPLETE:
+            if (!WinHttpReceiveResponse(call->request, nullptr))
+            {
+                Fail(call, "WinHttpReceiveResponse failed: " + std::to_string(GetLastError()));
+            }
+            break;
+        case WINHTTP_CALLBACK_STATUS_HEADERS_AVAILABLE:
+        {
+            DWORD statusCode = 0;
+            DWORD statusSize = sizeof(statusCode);
+            if (!WinHttpQueryHeaders(call->request,
+                                     WINHTTP_QUERY_STATUS_CODE | WINHTTP_QUERY_FLAG_NUMBER,
+                                     WINHTTP_HEADER_NAME_BY_INDEX,
+                                     &statusCode,
+                                     &statusSize,
+                                     WINHTTP_NO_HEADER_INDEX))
+            {
+                Fail(call, "Unable to query HTTP status code: " + std::to_string(GetLastError()));
+                break;
+            }
+            call->result.status = statusCode;
+            RequestMore(call);
+            break;
+        }
+        case WINHTTP_CALLBACK_STATUS_DATA_AVAILABLE:
+        {
+            const DWORD available = info ? *static_cast<const DWORD*>(info) : 0;
+            if (available == 0)
+            {
+                Finish(call);
+                break;
+            }
+            call->chunk.resize(available);
+            if (!WinHttpReadData(call->request, call->chunk.data(), available, nullptr))
+            {
+                Fail(call, "WinHttpReadData failed: " + std::to_string(GetLastError()));
+            }
+            break;
+        }
+        case WINHTTP_CALLBACK_STATUS_READ_COMPLETE:
+            if (length == 0)
+            {
+                Finish(call);
+                break;
+            }
+            if (call->response.size() + length > kMaxResponseBytes)
+            {
+                Fail(call, "response larger than " + std::to_string(kMaxResponseBytes) + " bytes");
+                break;
+            }
+            call->response.append(static_cast<const char*>(info), length);
+            RequestMore(call);
+            break;
+        case WINHTTP_CALLBACK_STATUS_REQUEST_ERROR:
+        {
+            const auto* asyncResult = static_cast<const WINHTTP_ASYNC_RESULT*>(info);
+            Fail(call, "WinHTTP request failed: " + std::to_string(asyncResult ? asyncResult->dwError : 0));
+            break;
+        }
+        case WINHTTP_CALLBACK_STATUS_HANDLE_CLOSING:
+        {
+            WinHttpCloseHandle(call->connection);
+            AsyncTransport* transport = call->transport;
+            Completion done = std::move(call->done);
+            HttpResult result = std::move(call->result);
+            if (!result.success && result.error.empty())
+            {
+                result.error = "Request cancelled";
+            }
+            if (done)
+            {
+                done(std::move(result));
+            }
+            {
+                // ~ApiClient may return as soon as this lock is released.
+                std::lock_guard<std::mutex> lock(transport->mutex);
+                transport->active.erase(call);
+                transport->drained.notify_all();
+            }
+            delete call;
+            break;
+        }
+        default:
+            break;
+        }
+    }
+};
+#elif defined(__linux__)
+struct ApiClient::AsyncTransport
+{
+    EpollHttpTransport transport;
+};
+#else
+struct ApiClient::AsyncTransport
+{
+};
+#endif
+
 ApiClient::ApiClient(std::string baseUrl)
+    : async_(std::make_unique<AsyncTransport>())
 {
     SetBaseUrl(std::move(baseUrl));
 }
 
+ApiClient::~ApiClient()
+{
+#ifdef _WIN32
+    ShutdownAsync();
+    std::unique_lock<std::mutex> lock(async_->mutex);
+    async_->drained.wait(lock, [this]() { return async_->active.empty(); });
+    if (async_->session)
+    {
+        WinHttpCloseHandle(async_->session);
+        async_->session = nullptr;
+    }
+#endif
+}
+
 void ApiClient::SetBaseUrl(std::string newBaseUrl)
 {
     baseUrl = NormalizeBaseUrl(std::move(newBaseUrl));
@@ -159,11 +382,124 @@ bool ApiClient::PostJson(const std::string& endpoint,
                          const std::vector<HttpHeader>& headers,
                          std::string& error) const
 {
+    RTJ_TRACE_SCOPE("PostJson");
+    return ToLegacy(Send("POST", endpoint, "application/json", body.data(), body.size(), headers), error);
+}
+
+bool ApiClient::PostBytes(const std::string& endpoint,
+                          const char* contentType,
+                          const void* data,
+                          std::size_t size,
+                          const std::vector<HttpHeader>& headers,
+                          std::string& error) const
+{
+    RTJ_TRACE_SCOPE("PostBytes");
+    return ToLegacy(Send("POST", endpoint, contentType, data, size, headers), error);
+}
+
+bool ApiClient::PutBytes(const std::string& endpoint,
+                         const void* data,
+                         std::size_t size,
+                         const std::vector<HttpHeader>& headers,
+                         std::string& error) const
+{
+    RTJ_TRACE_SCOPE("PutBytes");
+    return ToLegacy(Send("PUT", endpoint, "application/octet-stream", data, size, headers), error);
+}
+
+bool ApiClient::Get(const std::string& endpoint,
+                    const std::vector<HttpHeader>& headers,
+                    std::string& error) const
+{
+    return ToLegacy(Send("GET", endpoint, nullptr, nullptr, 0, headers), error);
+}
+
+bool ApiClient::ToLegacy(const HttpResponse& response, std::string& error)
+{
+    if (response.success)
+    {
+        error.assign(response.body.data(), response.body.size());
+    }
+    else
+    {
+        error = response.error;
+    }
+    return response.success;
+}
+
+HttpResponse ApiClient::Send(const char* method,
+                             const std::string& endpoint,
+                             const char* contentType,
+                             const void* data,
+                             std::size_t size,
+                             const std::vector<HttpHeader>& headers,
+                             ResponseBody bodyMode) const
+{
+    const auto started = std::chrono::steady_clock::now();
+    counters_.inFlight.fetch_add(1, std::memory_order_relaxed);
+    HttpResponse response = Transmit(method, endpoint, contentType, data, size, headers, bodyMode);
+    if (!response.success && response.error.empty())
+    {
+        response.error = "HTTP " + std::to_string(response.status);
+        if (!response.body.empty())
+        {
+            response.error.append(": ").append(response.body.data(), response.body.size());
+        }
+    }
+    const auto micros = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - started);
+    RecordRequest(size, response.body.size(), response.success, static_cast<std::uint64_t>(micros.count()));
+    return response;
+}
+
+void ApiClient::RecordRequest(std::size_t sent, std::size_t received, bool success, std::uint64_t micros) const
+{
+    counters_.inFlight.fetch_sub(1, std::memory_order_relaxed);
+    counters_.requests.fetch_add(1, std::memory_order_relaxed);
+    if (!success)
+    {
+        counters_.failures.fetch_add(1, std::memory_order_relaxed);
+    }
+    counters_.bytesSent.fetch_add(sent, std::memory_order_relaxed);
+    counters_.bytesReceived.fetch_add(received, std::memory_order_relaxed);
+    counters_.totalMicros.fetch_add(micros, std::memory_order_relaxed);
+    std::uint64_t previousMax = counters_.maxMicros.load(std::memory_order_relaxed);
+    while (micros > previousMax &&
+           !counters_.maxMicros.compare_exchange_weak(previousMax, micros, std::memory_order_relaxed))
+    {
+    }
+}
+
+TransportStats ApiClient::Stats() const
+{
+    TransportStats stats;
+    stats.requests = counters_.requests.load(std::memory_order_relaxed);
+    stats.failures = counters_.failures.load(std::memory_order_relaxed);
+    stats.inFlight = counters_.inFlight.load(std::memory_order_relaxed);
+    stats.bytesSent = counters_.bytesSent.load(std::memory_order_relaxed);
+    stats.bytesReceived = counters_.bytesReceived.load(std::memory_order_relaxed);
+    stats.totalMicros = counters_.totalMicros.load(std::memory_order_relaxed);
+    stats.maxMicros = counters_.maxMicros.load(std::memory_order_relaxed);
+    return stats;
+}
+
+HttpResponse ApiClient::Transmit(const char* method,
+                                 const std::string& endpoint,
+                                 const char* contentType,
+                                 const void* data,
+                                 std::size_t size,
+                                 const std::vector<HttpHeader>& headers,
+                                 ResponseBody bodyMode) const
+{
+    HttpResponse response;
+    std::string& error = response.error;
 #ifdef _WIN32
+    RTJ_MEMORY_SCOPE(Transport);
+    std::int64_t stageStart = TraceRecorder::IsEnabled() ? TraceRecorder::NowMicros() : 0;
+
     if (baseUrl.empty())
     {
         error = "API base URL is empty";
-        return false;
+        return response;
     }
 
     const std::string url = BuildUrl(endpoint);
@@ -171,7 +507,7 @@ bool ApiClient::PostJson(const std::string& endpoint,
     ParsedUrl parsed;
     if (!ParseUrl(url, parsed, error))
     {
-        return false;
+        return response;
     }
 
     HINTERNET session = WinHttpOpen(L"RLTrainingJournalPlugin/1.0",
@@ -182,7 +518,7 @@ bool ApiClient::PostJson(const std::string& endpoint,
     if (!session)
     {
         error = "WinHttpOpen failed: " + std::to_string(GetLastError());
-        return false;
+        return response;
     }
 
     HINTERNET connection = WinHttpConnect(session, parsed.host.c_str(), parsed.port, 0);
@@ -190,12 +526,13 @@ bool ApiClient::PostJson(const std::string& endpoint,
     {
         error = "WinHttpConnect failed: " + std::to_string(GetLastError());
         WinHttpCloseHandle(session);
-        return false;
+        return response;
     }
 
     DWORD flags = parsed.secure ? WINHTTP_FLAG_SECURE : 0;
+    const std::wstring wideMethod = ToWide(method);
     HINTERNET request = WinHttpOpenRequest(connection,
-                                           L"POST",
+                                           wideMethod.c_str(),
                                            parsed.path.c_str(),
                                            nullptr,
                                            WINHTTP_NO_REFERER,
@@ -206,10 +543,16 @@ bool ApiClient::PostJson(const std::string& endpoint,
         error = "WinHttpOpenRequest failed: " + std::to_string(GetLastError());
         WinHttpCloseHandle(connection);
         WinHttpCloseHandle(session);
-        return false;
+        return response;
     }
 
-    WinHttpAddRequestHeaders(request, L"Content-Type: application/json\r\n", -1L, WINHTTP_ADDREQ_FLAG_ADD);
+    TraceStage("WinHttpConnect", stageStart);
+
+    if (contentType)
+    {
+        const std::wstring contentHeader = ToWide(std::string("Content-Type: ") + contentType + "\r\n");
+        WinHttpAddRequestHeaders(request, contentHeader.c_str(), -1L, WINHTTP_ADDREQ_FLAG_ADD);
+    }
     for (const auto& header : headers)
     {
         if (header.name.empty())
@@ -228,9 +571,9 @@ bool ApiClient::PostJson(const std::string& endpoint,
     BOOL result = WinHttpSendRequest(request,
                                      WINHTTP_NO_ADDITIONAL_HEADERS,
                                      0,
-                                     body.empty() ? WINHTTP_NO_REQUEST_DATA : (LPVOID)body.data(),
-                                     static_cast<DWORD>(body.size()),
-                                     static_cast<DWORD>(body.size()),
+                                     size == 0 ? WINHTTP_NO_REQUEST_DATA : const_cast<LPVOID>(data),
+                                     static_cast<DWORD>(size),
+                                     static_cast<DWORD>(size),
                                      0);
     if (!result)
     {
@@ -238,9 +581,11 @@ bool ApiClient::PostJson(const std::string& endpoint,
         WinHttpCloseHandle(request);
         WinHttpCloseHandle(connection);
         WinHttpCloseHandle(session);
-        return false;
+        return response;
     }
 
+    TraceStage("WinHttpSendRequest", stageStart);
+
     result = WinHttpReceiveResponse(request, nullptr);
     if (!result)
     {
@@ -248,7 +593,7 @@ bool ApiClient::PostJson(const std::string& endpoint,
         WinHttpCloseHandle(request);
         WinHttpCloseHandle(connection);
         WinHttpCloseHandle(session);
-        return false;
+        return response;
     }
 
     DWORD statusCode = 0;
@@ -264,64 +609,274 @@ bool ApiClient::PostJson(const std::string& endpoint,
         WinHttpCloseHandle(request);
         WinHttpCloseHandle(connection);
         WinHttpCloseHandle(session);
-        return false;
+        return response;
     }
 
-    std::ostringstream responseStream;
-    DWORD availableBytes = 0;
-    do
+    TraceStage("WinHttpReceiveResponse", stageStart);
+
+    response.status = statusCode;
+    response.success = statusCode >= 200 && statusCode < 300;
+    DWORD retryAfter = 0;
+    DWORD retryAfterSize = sizeof(retryAfter);
+    if (WinHttpQueryHeaders(request,
+                            WINHTTP_QUERY_RETRY_AFTER | WINHTTP_QUERY_FLAG_NUMBER,
+                            WINHTTP_HEADER_NAME_BY_INDEX,
+                            &retryAfter,
+                            &retryAfterSize,
+                            WINHTTP_NO_HEADER_INDEX))
     {
-        if (!WinHttpQueryDataAvailable(request, &availableBytes))
-        {
-            error = "WinHttpQueryDataAvailable failed: " + std::to_string(GetLastError());
-            break;
-        }
+        response.retryAfterSeconds = static_cast<long>(retryAfter);
+    }
 
-        if (!availableBytes)
+    // The session is closed below, so an unread body costs nothing.
+    if (!response.success || bodyMode == ResponseBody::Read)
+    {
+        TrackedString& buffer = ThreadResponseBuffer();
+        DWORD availableBytes = 0;
+        do
         {
-            break;
-        }
+            if (!WinHttpQueryDataAvailable(request, &availableBytes))
+            {
+                error = "WinHttpQueryDataAvailable failed: " + std::to_string(GetLastError());
+                break;
+            }
+            if (!availableBytes)
+            {
+                break;
+            }
+            if (buffer.size() >= kMaxResponseBytes)
+            {
+                response.truncated = true;
+                break;
+            }
 
-        std::string buffer;
-        buffer.resize(availableBytes);
-        DWORD downloaded = 0;
-        if (!WinHttpReadData(request, buffer.data(), availableBytes, &downloaded))
-        {
-            error = "WinHttpReadData failed: " + std::to_string(GetLastError());
-            break;
-        }
+            const std::size_t offset = buffer.size();
+            const DWORD wanted = static_cast<DWORD>(std::min<std::size_t>(availableBytes, kMaxResponseBytes - offset));
+            buffer.resize(offset + wanted);
+            DWORD downloaded = 0;
+            if (!WinHttpReadData(request, buffer.data() + offset, wanted, &downloaded))
+            {
+                buffer.resize(offset);
+                error = "WinHttpReadData failed: " + std::to_string(GetLastError());
+                break;
+            }
+            buffer.resize(offset + downloaded);
+        } while (availableBytes > 0);
+        response.body = buffer;
+    }
 
-        responseStream.write(buffer.data(), downloaded);
-    } while (availableBytes > 0);
+    TraceStage("WinHttpReadBody", stageStart);
 
     WinHttpCloseHandle(request);
     WinHttpCloseHandle(connection);
     WinHttpCloseHandle(session);
 
-    const bool success = statusCode >= 200 && statusCode < 300;
-    std::string responseBody = responseStream.str();
-    if (success)
+    if (!error.empty())
     {
-        error = responseBody;
+        response.success = false;
     }
-    else
+    return response;
+#elif defined(__linux__)
+    RTJ_MEMORY_SCOPE(Transport);
+    if (baseUrl.empty())
     {
-        std::ostringstream oss;
-        oss << "HTTP " << statusCode;
-        if (!responseBody.empty())
-        {
-            oss << ": " << responseBody;
-        }
-        error = oss.str();
+        error = "API base URL is empty";
+        return response;
     }
 
-    return success;
+    // The transport has already read the body (within the same cap); a 2xx body the
+    // caller does not want is dropped without the copy.
+    HttpResult result = async_->transport.Execute(BuildUrl(endpoint), method, contentType, data, size, headers);
+    response.success = result.success;
+    response.status = result.status;
+    if (!result.success)
+    {
+        error = std::move(result.error);
+    }
+    if (!result.success || bodyMode == ResponseBody::Read)
+    {
+        TrackedString& buffer = ThreadResponseBuffer();
+        buffer.assign(result.body.data(), std::min(result.body.size(), kMaxResponseBytes));
+        response.truncated = result.body.size() > kMaxResponseBytes;
+        response.body = buffer;
+    }
+    return response;
 #else
+    (void)method;
     (void)endpoint;
-    (void)body;
+    (void)contentType;
+    (void)data;
+    (void)size;
     (void)headers;
-    error = "HTTP client is only available on Windows";
-    return false;
+    (void)bodyMode;
+    error = "HTTP client is only available on Windows and Linux";
+    return response;
 #endif
 }
 
+void ApiClient::SendAsync(HttpRequest request, Completion done) const
+{
+    const auto started = std::chrono::steady_clock::now();
+    const std::size_t sent = request.body.size();
+    counters_.inFlight.fetch_add(1, std::memory_order_relaxed);
+    done = [this, started, sent, inner = std::move(done)](HttpResult result) {
+        const auto micros = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - started);
+        RecordRequest(sent, result.body.size(), result.success, static_cast<std::uint64_t>(micros.count()));
+        inner(std::move(result));
+    };
+
+    HttpResult failure;
+#ifdef _WIN32
+    if (baseUrl.empty())
+    {
+        failure.error = "API base URL is empty";
+        done(std::move(failure));
+        return;
+    }
+
+    ParsedUrl parsed;
+    if (!ParseUrl(BuildUrl(request.endpoint), parsed, failure.error))
+    {
+        done(std::move(failure));
+        return;
+    }
+
+    HINTERNET session = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(async_->mutex);
+        if (async_->closed)
+        {
+            failure.error = "API client is shutting down";
+        }
+        else if (!async_->session)
+        {
+            async_->session = WinHttpOpen(L"RLTrainingJournalPlugin/1.0",
+                                          WINHTTP_ACCESS_TYPE_AUTOMATIC_PROXY,
+                                          WINHTTP_NO_PROXY_NAME,
+                                          WINHTTP_NO_PROXY_BYPASS,
+                                          WINHTTP_FLAG_ASYNC);
+        }
+        session = async_->session;
+    }
+    if (!session)
+    {
+        if (failure.error.empty())
+        {
+            failure.error = "WinHttpOpen failed: " + std::to_string(GetLastError());
+        }
+        done(std::move(failure));
+        return;
+    }
+
+    HINTERNET connection = WinHttpConnect(session, parsed.host.c_str(), parsed.port, 0);
+    if (!connection)
+    {
+        failure.error = "WinHttpConnect failed: " + std::to_string(GetLastError());
+        done(std::move(failure));
+        return;
+    }
+
+    const std::wstring wideMethod = ToWide(request.method);
+    HINTERNET handle = WinHttpOpenRequest(connection,
+                                          wideMethod.c_str(),
+                                          parsed.path.c_str(),
+                                          nullptr,
+                                          WINHTTP_NO_REFERER,
+                                          WINHTTP_DEFAULT_ACCEPT_TYPES,
+                                          parsed.secure ? WINHTTP_FLAG_SECURE : 0);
+    if (!handle)
+    {
+        failure.error = "WinHttpOpenRequest failed: " + std::to_string(GetLastError());
+        WinHttpCloseHandle(connection);
+        done(std::move(failure));
+        return;
+    }
+
+    std::string headerBlock;
+    if (!request.contentType.empty())
+    {
+        headerBlock += "Content-Type: " + request.contentType + "\r\n";
+    }
+    for (const auto& header : request.headers)
+    {
+        if (!header.name.empty())
+        {
+            headerBlock += header.name + ": " + header.value + "\r\n";
+        }
+    }
+    if (!headerBlock.empty())
+    {
+        const std::wstring wideHeaders = ToWide(headerBlock);
+        WinHttpAddRequestHeaders(handle, wideHeaders.c_str(), -1L, WINHTTP_ADDREQ_FLAG_ADD);
+    }
+
+    auto* call = new AsyncTransport::Call();
+    call->transport = async_.get();
+    call->connection = connection;
+    call->request = handle;
+    call->body = std::move(request.body);
+    call->done = std::move(done);
+
+    // From here on every path ends in HANDLE_CLOSING, which reports and frees the call.
+    DWORD_PTR context = reinterpret_cast<DWORD_PTR>(call);
+    WinHttpSetOption(handle, WINHTTP_OPTION_CONTEXT_VALUE, &context, sizeof(context));
+    WinHttpSetStatusCallback(handle,
+                             &AsyncTransport::OnStatus,
+                             WINHTTP_CALLBACK_FLAG_ALL_COMPLETIONS | WINHTTP_CALLBACK_FLAG_HANDLES,
+                             0);
+    {
+        std::lock_guard<std::mutex> lock(async_->mutex);
+        async_->active.insert(call);
+    }
+
+    const DWORD size = static_cast<DWORD>(call->body.size());
+    if (!WinHttpSendRequest(handle,
+                            WINHTTP_NO_ADDITIONAL_HEADERS,
+                            0,
+                            size == 0 ? WINHTTP_NO_REQUEST_DATA : call->body.data(),
+                            size,
+                            size,
+                            context))
+    {
+        AsyncTransport::Fail(call, "WinHttpSendRequest failed: " + std::to_string(GetLastError()));
+    }
+#elif defined(__linux__)
+    if (baseUrl.empty())
+    {
+        failure.error = "API base URL is empty";
+        done(std::move(failure));
+        return;
+    }
+    const std::string url = BuildUrl(request.endpoint);
+    async_->transport.Submit(url, std::move(request), std::move(done));
+#else
+    (void)request;
+    failure.error = "HTTP client is only available on Windows and Linux";
+    done(std::move(failure));
+#endif
+}
+
+void ApiClient::ShutdownAsync() const
+{
+#ifdef _WIN32
+    // Closing a request handle aborts its pending operation; HANDLE_CLOSING follows.
+    std::vector<HINTERNET> requests;
+    {
+        std::lock_guard<std::mutex> lock(async_->mutex);
+        async_->closed = true;
+        for (AsyncTransport::Call* call : async_->active)
+        {
+            if (!call->closing.exchange(true))
+            {
+                requests.push_back(call->request);
+            }
+        }
+    }
+    for (HINTERNET request : requests)
+    {
+        WinHttpCloseHandle(request);
+    }
+#elif defined(__linux__)
+    async_->transport.Shutdown();
+#endif
+}
@@ -1,6 +1,12 @@
 #pragma once
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 struct HttpHeader {
@@ -11,9 +17,63 @@ struct HttpHeader {
     HttpHeader(std::string n, std::string v) : name(std::move(n)), value(std::move(v)) {}
 };
 
+struct HttpRequest {
+    std::string method = "GET";
+    std::string endpoint;
+    std::string contentType; // empty sends no Content-Type
+    std::string body;
+    std::vector<HttpHeader> headers;
+};
+
+struct HttpResult {
+    bool success = false; // 2xx
+    unsigned long status = 0; // 0 when no response arrived
+    std::string body;
+    std::string error; // same text the blocking calls report on failure
+};
+
+// Whether ApiClient::Send reads the response body.
+enum class ResponseBody {
+    Read,
+    ErrorsOnly, // a 2xx body is never read
+};
+
+// What ApiClient::Send returns. body views a per-thread buffer that the same
+// thread's next request reuses; copy out anything that must outlive it.
+struct HttpResponse {
+    bool success = false; // 2xx
+    unsigned long status = 0; // 0 when no response arrived
+    std::string_view body;
+    bool truncated = false; // the body stopped at ApiClient::kMaxResponseBytes
+    long retryAfterSeconds = -1; // Retry-After in seconds, -1 when absent or a date
+    std::string error; // transport failure, or "HTTP <status>: <body>"; empty on success
+};
+
+// Totals since the client was created, for rtj_stats.
+struct TransportStats {
+    std::uint64_t requests = 0;
+    std::uint64_t failures = 0;
+    std::uint64_t inFlight = 0;
+    std::uint64_t bytesSent = 0;
+    std::uint64_t bytesReceived = 0;
+    std::uint64_t totalMicros = 0;
+    std::uint64_t maxMicros = 0;
+};
+
 class ApiClient {
 public:
+    using Completion = std::function<void(HttpResult)>;
+
+    // Larger responses are cut off here (synchronous calls) or fail (the Linux
+    // transport, and async calls), so a misbehaving server cannot make the plugin
+    // buffer without limit.
+    static constexpr std::size_t kMaxResponseBytes = 1024 * 1024;
+
     ApiClient(std::string baseUrl);
+    ~ApiClient();
+    ApiClient(const ApiClient&) = delete;
+    ApiClient& operator=(const ApiClient&) = delete;
+
     void SetBaseUrl(std::string newBaseUrl);
     std::string NormalizeBaseUrl(const std::string& url) const;
     std::string BuildUrl(const std::string& endpoint) const;
@@ -21,7 +81,68 @@ public:
                   const std::string& body,
                   const std::vector<HttpHeader>& headers,
                   std::string& error) const;
+    // Pre-encoded body, e.g. a gzip NDJSON backlog; extra headers carry Content-Encoding.
+    bool PostBytes(const std::string& endpoint,
+                   const char* contentType,
+                   const void* data,
+                   std::size_t size,
+                   const std::vector<HttpHeader>& headers,
+                   std::string& error) const;
+    // Raw request body; used for replay chunks, which must not be copied into a string.
+    bool PutBytes(const std::string& endpoint,
+                  const void* data,
+                  std::size_t size,
+                  const std::vector<HttpHeader>& headers,
+                  std::string& error) const;
+    bool Get(const std::string& endpoint,
+             const std::vector<HttpHeader>& headers,
+             std::string& error) const;
+
+    // The blocking call the methods above wrap. The response is read into one buffer
+    // per calling thread, and a 2xx body is skipped entirely with ErrorsOnly.
+    HttpResponse Send(const char* method,
+                      const std::string& endpoint,
+                      const char* contentType,
+                      const void* data,
+                      std::size_t size,
+                      const std::vector<HttpHeader>& headers,
+                      ResponseBody bodyMode = ResponseBody::Read) const;
+
+    // Starts a request on the non-blocking WinHTTP session and returns at once. done
+    // runs exactly once, on a WinHTTP worker thread, so it should only hand the result
+    // on (see AsyncApi.h for the awaitable form).
+    void SendAsync(HttpRequest request, Completion done) const;
+    // Aborts every async request still in flight and fails any started later; each
+    // completes with an error. Called once, on unload.
+    void ShutdownAsync() const;
+
+    TransportStats Stats() const;
 
 private:
+    // On success the response body is returned through error, as PostJson always has.
+    static bool ToLegacy(const HttpResponse& response, std::string& error);
+    HttpResponse Transmit(const char* method,
+                          const std::string& endpoint,
+                          const char* contentType,
+                          const void* data,
+                          std::size_t size,
+                          const std::vector<HttpHeader>& headers,
+                          ResponseBody bodyMode) const;
+    void RecordRequest(std::size_t sent, std::size_t received, bool success, std::uint64_t micros) const;
+
+    struct Counters {
+        std::atomic<std::uint64_t> requests{0};
+        std::atomic<std::uint64_t> failures{0};
+        std::atomic<std::uint64_t> inFlight{0};
+        std::atomic<std::uint64_t> bytesSent{0};
+        std::atomic<std::uint64_t> bytesReceived{0};
+        std::atomic<std::uint64_t> totalMicros{0};
+        std::atomic<std::uint64_t> maxMicros{0};
+    };
+    struct AsyncTransport;
+
     std::string baseUrl;
+    // Before async_, so completions that fire while it is torn down can still count.
+    mutable Counters counters_;
+    std::unique_ptr<AsyncTransport> async_;
 };
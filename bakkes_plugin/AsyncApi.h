@@ -0,0 +1,246 @@
+#pragma once
+
+// Awaitable front end for ApiClient::SendAsync. Coroutines written against it run on
+// an UploadExecutor and are suspended, not blocking a thread, while a request is on
+// the wire, so a probe -> GET -> POST chain or a retry after a delay reads as
+// straight-line code. Needs C++20 coroutines; C++17 builds keep the std::async path.
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#define RTJ_HAVE_COROUTINES 1
+#else
+#define RTJ_HAVE_COROUTINES 0
+#endif
+
+#if RTJ_HAVE_COROUTINES
+
+#include <chrono>
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ApiClient.h"
+#include "UploadExecutor.h"
+
+template <typename T>
+class Task;
+
+namespace async_detail
+{
+    // Resumes whoever awaited the task, by symmetric transfer so long chains do not
+    // grow the stack.
+    struct FinalAwaiter {
+        bool await_ready() const noexcept { return false; }
+
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> finished) const noexcept
+        {
+            std::coroutine_handle<> continuation = finished.promise().continuation;
+            return continuation ? continuation : std::noop_coroutine();
+        }
+
+        void await_resume() const noexcept {}
+    };
+
+    struct PromiseBase {
+        std::coroutine_handle<> continuation;
+        std::exception_ptr exception;
+
+        std::suspend_always initial_suspend() const noexcept { return {}; }
+        FinalAwaiter final_suspend() const noexcept { return {}; }
+        void unhandled_exception() { exception = std::current_exception(); }
+    };
+
+    struct DetachedTask {
+        struct promise_type {
+            DetachedTask get_return_object() const noexcept { return {}; }
+            std::suspend_never initial_suspend() const noexcept { return {}; }
+            std::suspend_never final_suspend() const noexcept { return {}; }
+            void return_void() const noexcept {}
+            void unhandled_exception() const noexcept {}
+        };
+    };
+
+    template <typename Promise>
+    class TaskBase {
+    public:
+        TaskBase(TaskBase&& other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+        TaskBase& operator=(TaskBase&& other) noexcept
+        {
+            if (this != &other)
+            {
+                Reset();
+                handle_ = std::exchange(other.handle_, {});
+            }
+            return *this;
+        }
+        TaskBase(const TaskBase&) = delete;
+        TaskBase& operator=(const TaskBase&) = delete;
+        ~TaskBase() { Reset(); }
+
+        bool await_ready() const noexcept { return !handle_ || handle_.done(); }
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+        {
+            handle_.promise().continuation = awaiting;
+            return handle_;
+        }
+
+    protected:
+        explicit TaskBase(std::coroutine_handle<Promise> handle) : handle_(handle) {}
+
+        Promise& promise() const { return handle_.promise(); }
+        void RethrowIfFailed() const
+        {
+            if (handle_.promise().exception)
+            {
+                std::rethrow_exception(handle_.promise().exception);
+            }
+        }
+
+    private:
+        void Reset()
+        {
+            if (handle_)
+            {
+                handle_.destroy();
+                handle_ = {};
+            }
+        }
+
+        std::coroutine_handle<Promise> handle_;
+    };
+
+    template <typename T>
+    struct ValuePromise : PromiseBase {
+        std::optional<T> value;
+        Task<T> get_return_object();
+        void return_value(T result) { value = std::move(result); }
+    };
+
+    struct VoidPromise : PromiseBase {
+        Task<void> get_return_object();
+        void return_void() const noexcept {}
+    };
+}
+
+// Lazily started coroutine; it runs when first awaited and hands its result back to
+// the awaiting coroutine.
+template <typename T>
+class [[nodiscard]] Task : public async_detail::TaskBase<async_detail::ValuePromise<T>> {
+public:
+    using promise_type = async_detail::ValuePromise<T>;
+
+    T await_resume()
+    {
+        this->RethrowIfFailed();
+        return std::move(*this->promise().value);
+    }
+
+private:
+    friend struct async_detail::ValuePromise<T>;
+    using async_detail::TaskBase<promise_type>::TaskBase;
+};
+
+template <>
+class [[nodiscard]] Task<void> : public async_detail::TaskBase<async_detail::VoidPromise> {
+public:
+    using promise_type = async_detail::VoidPromise;
+
+    void await_resume() { RethrowIfFailed(); }
+
+private:
+    friend struct async_detail::VoidPromise;
+    using async_detail::TaskBase<promise_type>::TaskBase;
+};
+
+template <typename T>
+Task<T> async_detail::ValuePromise<T>::get_return_object()
+{
+    return Task<T>(std::coroutine_handle<ValuePromise<T>>::from_promise(*this));
+}
+
+inline Task<void> async_detail::VoidPromise::get_return_object()
+{
+    return Task<void>(std::coroutine_handle<VoidPromise>::from_promise(*this));
+}
+
+// Continues the awaiting coroutine on one of the executor's threads.
+class ResumeOn {
+public:
+    explicit ResumeOn(UploadExecutor& executor) : executor_(executor) {}
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> awaiting) const
+    {
+        executor_.Post([awaiting]() { awaiting.resume(); });
+    }
+    void await_resume() const noexcept {}
+
+private:
+    UploadExecutor& executor_;
+};
+
+// Suspends for delay without holding a thread. Cut short once the executor shuts down.
+class Delay {
+public:
+    Delay(UploadExecutor& executor, std::chrono::milliseconds delay) : executor_(executor), delay_(delay) {}
+
+    bool await_ready() const noexcept { return delay_.count() <= 0; }
+    void await_suspend(std::coroutine_handle<> awaiting) const
+    {
+        executor_.PostAfter(delay_, [awaiting]() { awaiting.resume(); });
+    }
+    void await_resume() const noexcept {}
+
+private:
+    UploadExecutor& executor_;
+    std::chrono::milliseconds delay_;
+};
+
+// co_await Request(...) yields the HttpResult once WinHTTP has the whole response.
+class Request {
+public:
+    Request(const ApiClient& client, UploadExecutor& executor, HttpRequest request)
+        : client_(client), executor_(executor), request_(std::move(request))
+    {
+    }
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> awaiting)
+    {
+        // The awaitable lives in the suspended frame, so it is still there when the
+        // completion fires.
+        client_.SendAsync(std::move(request_), [this, awaiting](HttpResult result) {
+            result_ = std::move(result);
+            executor_.Post([awaiting]() { awaiting.resume(); });
+        });
+    }
+    HttpResult await_resume() { return std::move(result_); }
+
+private:
+    const ApiClient& client_;
+    UploadExecutor& executor_;
+    HttpRequest request_;
+    HttpResult result_;
+};
+
+// Starts task on the executor and lets it run to completion on its own. The
+// executor counts it, so Shutdown waits for it.
+inline void Spawn(UploadExecutor& executor, Task<void> task)
+{
+    executor.BeginOperation();
+    [](UploadExecutor& owner, Task<void> work) -> async_detail::DetachedTask {
+        co_await ResumeOn(owner);
+        try
+        {
+            co_await std::move(work);
+        }
+        catch (...)
+        {
+        }
+        owner.EndOperation();
+    }(executor, std::move(task));
+}
+
+#endif
@@ -0,0 +1,92 @@
+#include "pch.h"
+#include "BacklogDocument.h"
+#include "MemoryTracker.h"
+
+#include <algorithm>
+
+#if RTJ_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace
+{
+#if RTJ_HAVE_ZLIB
+    constexpr std::size_t kDeflateChunk = 16 * 1024;
+
+    // Feeds one input span to the gzip stream, appending whatever it produces.
+    bool DeflateInto(z_stream& stream, const char* data, std::size_t size, int flush, std::string& out)
+    {
+        stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+        stream.avail_in = static_cast<uInt>(size);
+
+        unsigned char buffer[kDeflateChunk];
+        do
+        {
+            stream.next_out = buffer;
+            stream.avail_out = static_cast<uInt>(sizeof(buffer));
+            const int status = deflate(&stream, flush);
+            if (status == Z_STREAM_ERROR)
+            {
+                return false;
+            }
+            out.append(reinterpret_cast<const char*>(buffer), sizeof(buffer) - stream.avail_out);
+        } while (stream.avail_out == 0);
+        return true;
+    }
+#endif
+
+    BacklogDocument BuildPlain(const std::vector<OutboxEntry>& entries, std::size_t begin, std::size_t end)
+    {
+        BacklogDocument document;
+        std::size_t total = 0;
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            total += entries[i].body.size() + 1;
+        }
+
+        document.bytes.reserve(total);
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            document.bytes += entries[i].body;
+            document.bytes += '\n';
+        }
+        document.entries = end - begin;
+        document.rawBytes = document.bytes.size();
+        return document;
+    }
+}
+
+BacklogDocument BuildBacklogDocument(const std::vector<OutboxEntry>& entries, std::size_t begin, std::size_t count)
+{
+    RTJ_MEMORY_SCOPE(Serializer);
+    begin = std::min(begin, entries.size());
+    const std::size_t end = std::min(entries.size(), begin + count);
+
+#if RTJ_HAVE_ZLIB
+    z_stream stream{};
+    // windowBits 15 + 16 selects the gzip wrapper the API's body parser understands.
+    if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) == Z_OK)
+    {
+        BacklogDocument document;
+        document.gzip = true;
+        bool ok = true;
+        for (std::size_t i = begin; ok && i < end; ++i)
+        {
+            const std::string& body = entries[i].body;
+            ok = DeflateInto(stream, body.data(), body.size(), Z_NO_FLUSH, document.bytes) &&
+                 DeflateInto(stream, "\n", 1, Z_NO_FLUSH, document.bytes);
+            document.rawBytes += body.size() + 1;
+        }
+        ok = ok && DeflateInto(stream, nullptr, 0, Z_FINISH, document.bytes);
+        deflateEnd(&stream);
+
+        if (ok)
+        {
+            document.entries = end - begin;
+            return document;
+        }
+    }
+#endif
+
+    return BuildPlain(entries, begin, end);
+}
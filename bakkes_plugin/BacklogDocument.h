@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "UploadOutbox.h"
+
+// Builds with zlib on the include path compress bulk uploads; others send plain NDJSON.
+#if __has_include(<zlib.h>)
+#define RTJ_HAVE_ZLIB 1
+#else
+#define RTJ_HAVE_ZLIB 0
+#endif
+
+// One /api/history/import request body: the outbox entries as NDJSON, one stamped
+// mmr-log payload per line.
+struct BacklogDocument {
+    std::string bytes;
+    bool gzip = false;
+    std::size_t entries = 0;
+    std::size_t rawBytes = 0; // NDJSON size before compression
+};
+
+// Encodes entries[begin, begin + count). With zlib the lines are deflated one at a
+// time, so the uncompressed document is never held in memory.
+BacklogDocument BuildBacklogDocument(const std::vector<OutboxEntry>& entries, std::size_t begin, std::size_t count);
@@ -1,52 +1,28 @@
 #include "pch.h"
 #include "DiagnosticLogger.h"
+#include "MemoryTracker.h"
 
 #include <chrono>
 #include <ctime>
-#include <filesystem>
 #include <fstream>
 #include <iomanip>
 #include <mutex>
 #include <sstream>
-#include <cstdlib>
+#include <vector>
 
 static std::mutex g_logMutex;
-static std::string g_logPath;
+static std::ofstream g_logStream;
+static bool g_logInitialized = false;
+static std::vector<std::string> g_earlyLines; // logged before Init; written by it
+static DiagnosticLoggerStats g_logStats;      // all guarded by g_logMutex
 
-void DiagnosticLogger::Init()
+namespace
 {
-    try {
-#ifdef _WIN32
-        char* appdata_env = nullptr;
-        size_t env_len = 0;
-        std::string appdata_str;
-        if (_dupenv_s(&appdata_env, &env_len, "APPDATA") == 0 && appdata_env && appdata_env[0] != '\0') {
-            appdata_str = appdata_env;
-        }
-        if (appdata_env) {
-            free(appdata_env);
-        }
-        std::filesystem::path base;
-        if (!appdata_str.empty()) {
-            base = appdata_str;
-        } else {
-            base = std::filesystem::temp_directory_path();
-        }
-#else
-        const char* appdata = std::getenv("APPDATA");
-        std::filesystem::path base;
-        if (appdata && appdata[0] != '\0') {
-            base = appdata;
-        } else {
-            base = std::filesystem::temp_directory_path();
-        }
-#endif
-
-        std::filesystem::path dir = base / "bakkesmod" / "rltrainingjournal_logs";
-        std::error_code ec;
-        std::filesystem::create_directories(dir, ec);
+    // Enough for everything onLoad logs before the deferred phase opens the file.
+    constexpr std::size_t kMaxEarlyLines = 256;
 
-        auto now = std::chrono::system_clock::now();
+    std::tm LocalTime(std::chrono::system_clock::time_point now)
+    {
         std::time_t t = std::chrono::system_clock::to_time_t(now);
         std::tm tm;
 #ifdef _WIN32
@@ -54,49 +30,96 @@ void DiagnosticLogger::Init()
 #else
         localtime_r(&t, &tm);
 #endif
+        return tm;
+    }
 
-        std::ostringstream oss;
-        oss << std::put_time(&tm, "%Y%m%d-%H%M%S");
-        std::string filename = std::string("rltrainingjournal_") + oss.str() + ".log";
+    bool WriteLocked(const std::string& line)
+    {
+        g_logStream << line;
+        // Flushed per line so the log survives a game crash.
+        g_logStream.flush();
+        if (!g_logStream)
+        {
+            g_logStream.clear();
+            ++g_logStats.failures;
+            return false;
+        }
+        ++g_logStats.lines;
+        g_logStats.bytes += line.size();
+        return true;
+    }
+}
 
-        g_logPath = (dir / filename).string();
+void DiagnosticLogger::Init(const std::filesystem::path& directory)
+{
+    std::lock_guard<std::mutex> lock(g_logMutex);
+    if (g_logInitialized)
+    {
+        return;
+    }
+    g_logInitialized = true;
+
+    try {
+        std::error_code ec;
+        std::filesystem::create_directories(directory, ec);
 
-        // Write header
-        std::ofstream ofs(g_logPath, std::ios::out | std::ios::app);
-        if (ofs) {
-            ofs << "--- RLTrainingJournal Diagnostic Log " << oss.str() << " ---\n";
-            ofs.close();
+        const std::tm tm = LocalTime(std::chrono::system_clock::now());
+        std::ostringstream stamp;
+        stamp << std::put_time(&tm, "%Y%m%d-%H%M%S");
+        g_logStream.open(directory / ("rltrainingjournal_" + stamp.str() + ".log"), std::ios::out | std::ios::app);
+        if (g_logStream.is_open()) {
+            g_logStream << "--- RLTrainingJournal Diagnostic Log " << stamp.str() << " ---\n";
+            for (const std::string& line : g_earlyLines) {
+                WriteLocked(line);
+            }
+        } else {
+            g_logStats.failures += g_earlyLines.size();
         }
     } catch (...) {
         // Best-effort; do not throw
     }
+    g_earlyLines.clear();
+    g_earlyLines.shrink_to_fit();
 }
 
 void DiagnosticLogger::Log(const std::string& msg)
 {
-    std::lock_guard<std::mutex> lock(g_logMutex);
+    RTJ_MEMORY_SCOPE(Logger);
+    const auto started = std::chrono::steady_clock::now();
+    std::string line;
     try {
-        if (g_logPath.empty()) {
-            Init();
-        }
-        auto now = std::chrono::system_clock::now();
-        std::time_t t = std::chrono::system_clock::to_time_t(now);
-        std::tm tm;
-#ifdef _WIN32
-        localtime_s(&tm, &t);
-#else
-        localtime_r(&t, &tm);
-#endif
-
-        std::ostringstream oss;
+        const std::tm tm = LocalTime(std::chrono::system_clock::now());
+        TrackedOStringStream oss;
         oss << std::put_time(&tm, "%Y-%m-%d %H:%M:%S") << " - " << msg << "\n";
+        line = ToStdString(oss);
+    } catch (...) {
+        // swallow errors; logging must not crash plugin
+    }
 
-        std::ofstream ofs(g_logPath, std::ios::out | std::ios::app);
-        if (ofs) {
-            ofs << oss.str();
+    std::lock_guard<std::mutex> lock(g_logMutex);
+    try {
+        if (line.empty()) {
+            ++g_logStats.failures;
+        } else if (!g_logInitialized) {
+            if (g_earlyLines.size() < kMaxEarlyLines) {
+                g_earlyLines.push_back(std::move(line));
+            } else {
+                ++g_logStats.failures;
+            }
+        } else if (g_logStream.is_open()) {
+            WriteLocked(line);
+        } else {
+            ++g_logStats.failures;
         }
     } catch (...) {
-        // swallow errors; logging must not crash plugin
+        ++g_logStats.failures;
     }
+    g_logStats.totalMicros += static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - started).count());
 }
 
+DiagnosticLoggerStats DiagnosticLogger::Stats()
+{
+    std::lock_guard<std::mutex> lock(g_logMutex);
+    return g_logStats;
+}
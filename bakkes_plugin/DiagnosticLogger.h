@@ -1,12 +1,24 @@
 #pragma once
 
+#include <cstdint>
+#include <filesystem>
 #include <string>
 
+struct DiagnosticLoggerStats {
+    std::uint64_t lines = 0;
+    std::uint64_t bytes = 0;
+    std::uint64_t failures = 0;
+    std::uint64_t totalMicros = 0; // time spent inside Log, including the lock wait
+};
+
 class DiagnosticLogger {
 public:
-    // Initialize logger; called once from plugin startup.
-    static void Init();
+    // Opens a new log file in directory; called once, off the game thread, during
+    // plugin load. Lines logged before then are held in memory and written here.
+    static void Init(const std::filesystem::path& directory);
 
     // Thread-safe append message with timestamp.
     static void Log(const std::string& msg);
+
+    static DiagnosticLoggerStats Stats();
 };
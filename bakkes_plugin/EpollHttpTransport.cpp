@@ -0,0 +1,1099 @@
+#include "pch.h"
+#include "EpollHttpTransport.h"
+
+#ifdef __linux__
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    constexpr std::size_t kMaxLineBytes = 16 * 1024;
+    constexpr std::size_t kMaxBodyBytes = ApiClient::kMaxResponseBytes;
+    constexpr std::size_t kReadChunkBytes = 64 * 1024;
+    constexpr int kMaxEvents = 64;
+    constexpr char kShutdownError[] = "API client is shutting down";
+
+    struct Target {
+        std::string host;
+        std::string port = "80";
+        std::string path;
+    };
+
+    bool ParseTarget(const std::string& url, Target& target, std::string& error)
+    {
+        const std::string http = "http://";
+        if (url.rfind("https://", 0) == 0)
+        {
+            error = "https is not supported by the Linux transport";
+            return false;
+        }
+        if (url.rfind(http, 0) != 0)
+        {
+            error = "URL must start with http:// or https://";
+            return false;
+        }
+
+        const std::string rest = url.substr(http.size());
+        const std::string::size_type slashPos = rest.find('/');
+        std::string hostPort = slashPos == std::string::npos ? rest : rest.substr(0, slashPos);
+        target.path = slashPos == std::string::npos ? "/" : rest.substr(slashPos);
+        if (hostPort.empty())
+        {
+            error = "URL missing host";
+            return false;
+        }
+
+        std::string::size_type colonPos = std::string::npos;
+        if (hostPort.front() == '[')
+        {
+            const std::string::size_type closePos = hostPort.find(']');
+            if (closePos == std::string::npos)
+            {
+                error = "URL missing host";
+                return false;
+            }
+            target.host = hostPort.substr(1, closePos - 1);
+            colonPos = hostPort.find(':', closePos);
+        }
+        else
+        {
+            colonPos = hostPort.find(':');
+            target.host = hostPort.substr(0, colonPos);
+        }
+
+        if (colonPos != std::string::npos)
+        {
+            target.port = hostPort.substr(colonPos + 1);
+            char* end = nullptr;
+            const unsigned long port = std::strtoul(target.port.c_str(), &end, 10);
+            if (target.port.empty() || *end != '\0' || port == 0 || port > 65535)
+            {
+                error = "Invalid port in URL";
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool EqualsIgnoreCase(std::string_view a, std::string_view b)
+    {
+        return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+                   return std::tolower(static_cast<unsigned char>(x)) == std::tolower(static_cast<unsigned char>(y));
+               });
+    }
+
+    bool ContainsIgnoreCase(std::string_view haystack, std::string_view needle)
+    {
+        if (needle.size() > haystack.size())
+        {
+            return false;
+        }
+        for (std::size_t i = 0; i + needle.size() <= haystack.size(); ++i)
+        {
+            if (EqualsIgnoreCase(haystack.substr(i, needle.size()), needle))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::string_view Trim(std::string_view value)
+    {
+        while (!value.empty() && (value.front() == ' ' || value.front() == '\t'))
+        {
+            value.remove_prefix(1);
+        }
+        while (!value.empty() && (value.back() == ' ' || value.back() == '\t'))
+        {
+            value.remove_suffix(1);
+        }
+        return value;
+    }
+
+    // Incremental HTTP/1.1 response reader; bytes are fed in as recv returns them.
+    class ResponseParser {
+    public:
+        void Reset(bool headRequest)
+        {
+            *this = ResponseParser();
+            headRequest_ = headRequest;
+        }
+
+        // False on a malformed or oversized response.
+        bool Feed(const char* data, std::size_t size)
+        {
+            std::size_t offset = 0;
+            while (offset < size && state_ != State::Done)
+            {
+                if (state_ == State::Body || state_ == State::ChunkData)
+                {
+                    const std::size_t take = static_cast<std::size_t>(std::min<std::uint64_t>(remaining_, size - offset));
+                    if (body_.size() + take > kMaxBodyBytes)
+                    {
+                        return false;
+                    }
+                    body_.append(data + offset, take);
+                    offset += take;
+                    remaining_ -= take;
+                    if (remaining_ == 0)
+                    {
+                        state_ = state_ == State::Body ? State::Done : State::ChunkDataEnd;
+                    }
+                    continue;
+                }
+
+                if (state_ == State::UntilClose)
+                {
+                    if (body_.size() + (size - offset) > kMaxBodyBytes)
+                    {
+                        return false;
+                    }
+                    body_.append(data + offset, size - offset);
+                    return true;
+                }
+
+                const void* newline = std::memchr(data + offset, '\n', size - offset);
+                const std::size_t end = newline ? static_cast<const char*>(newline) - data : size;
+                line_.append(data + offset, end - offset);
+                if (line_.size() > kMaxLineBytes)
+                {
+                    return false;
+                }
+                if (!newline)
+                {
+                    return true;
+                }
+                offset = end + 1;
+                if (!line_.empty() && line_.back() == '\r')
+                {
+                    line_.pop_back();
+                }
+                if (!OnLine(line_))
+                {
+                    return false;
+                }
+                line_.clear();
+            }
+            return true;
+        }
+
+        // The server closed the connection; that ends a body with no length.
+        bool FinishAtEof()
+        {
+            if (state_ == State::UntilClose)
+            {
+                state_ = State::Done;
+            }
+            return state_ == State::Done;
+        }
+
+        bool Complete() const { return state_ == State::Done; }
+        unsigned long Status() const { return status_; }
+        bool KeepAlive() const { return keepAlive_; }
+        std::string TakeBody() { return std::move(body_); }
+
+    private:
+        enum class State {
+            StatusLine,
+            Headers,
+            Body,
+            UntilClose,
+            ChunkSize,
+            ChunkData,
+            ChunkDataEnd,
+            Trailers,
+            Done
+        };
+
+        bool OnLine(std::string_view line)
+        {
+            switch (state_)
+            {
+            case State::StatusLine:
+            {
+                // HTTP/1.1 200 OK
+                if (line.size() < 12 || line.substr(0, 5) != "HTTP/")
+                {
+                    return false;
+                }
+                const std::string_view version = line.substr(5, 3);
+                const unsigned long status = std::strtoul(std::string(line.substr(9, 3)).c_str(), nullptr, 10);
+                if (status < 100 || status > 599)
+                {
+                    return false;
+                }
+                status_ = status;
+                keepAlive_ = version != "1.0";
+                chunked_ = false;
+                hasLength_ = false;
+                state_ = State::Headers;
+                return true;
+            }
+            case State::Headers:
+                if (line.empty())
+                {
+                    return EndHeaders();
+                }
+                return OnHeader(line);
+            case State::ChunkSize:
+            {
+                const std::string size(line.substr(0, line.find(';')));
+                char* end = nullptr;
+                remaining_ = std::strtoull(size.c_str(), &end, 16);
+                if (size.empty() || (*end != '\0' && *end != ' ' && *end != '\t'))
+                {
+                    return false;
+                }
+                state_ = remaining_ == 0 ? State::Trailers : State::ChunkData;
+                return true;
+            }
+            case State::ChunkDataEnd:
+                state_ = State::ChunkSize;
+                return line.empty();
+            case State::Trailers:
+                if (line.empty())
+                {
+                    state_ = State::Done;
+                }
+                return true;
+            default:
+                return false;
+            }
+        }
+
+        bool OnHeader(std::string_view line)
+        {
+            const std::string_view::size_type colon = line.find(':');
+            if (colon == std::string_view::npos)
+            {
+                return false;
+            }
+            const std::string_view name = Trim(line.substr(0, colon));
+            const std::string_view value = Trim(line.substr(colon + 1));
+            if (EqualsIgnoreCase(name, "Content-Length"))
+            {
+                char* end = nullptr;
+                const std::string digits(value);
+                remaining_ = std::strtoull(digits.c_str(), &end, 10);
+                hasLength_ = !digits.empty() && *end == '\0';
+                return hasLength_ && remaining_ <= kMaxBodyBytes;
+            }
+            if (EqualsIgnoreCase(name, "Transfer-Encoding"))
+            {
+                chunked_ = ContainsIgnoreCase(value, "chunked");
+            }
+            else if (EqualsIgnoreCase(name, "Connection"))
+            {
+                if (ContainsIgnoreCase(value, "close"))
+                {
+                    keepAlive_ = false;
+                }
+                else if (ContainsIgnoreCase(value, "keep-alive"))
+                {
+                    keepAlive_ = true;
+                }
+            }
+            return true;
+        }
+
+        bool EndHeaders()
+        {
+            if (status_ < 200)
+            {
+                // Interim response (100 Continue); the real one follows.
+                state_ = State::StatusLine;
+                return true;
+            }
+            if (headRequest_ || status_ == 204 || status_ == 304)
+            {
+                state_ = State::Done;
+            }
+            else if (chunked_)
+            {
+                state_ = State::ChunkSize;
+            }
+            else if (hasLength_)
+            {
+                state_ = remaining_ == 0 ? State::Done : State::Body;
+            }
+            else
+            {
+                state_ = State::UntilClose;
+                keepAlive_ = false;
+            }
+            return true;
+        }
+
+        State state_ = State::StatusLine;
+        bool headRequest_ = false;
+        unsigned long status_ = 0;
+        bool keepAlive_ = true;
+        bool chunked_ = false;
+        bool hasLength_ = false;
+        std::uint64_t remaining_ = 0;
+        std::string line_;
+        std::string body_;
+    };
+
+    HttpResult Failure(std::string error)
+    {
+        HttpResult result;
+        result.error = std::move(error);
+        return result;
+    }
+}
+
+struct EpollHttpTransport::Impl
+{
+    struct Operation
+    {
+        std::string key; // host:port, the keep-alive pool it may reuse
+        sockaddr_storage address{};
+        socklen_t addressLength = 0;
+        std::string head;
+        std::string ownedBody;
+        const char* body = nullptr;
+        std::size_t bodySize = 0;
+        bool headRequest = false;
+        bool retried = false;
+        Clock::time_point deadline;
+        Completion done;
+    };
+
+    struct Connection
+    {
+        int fd = -1;
+        std::string key;
+        bool connecting = false;
+        bool reused = false;
+        bool receivedAny = false;
+        std::size_t written = 0;
+        Clock::time_point connectDeadline;
+        Clock::time_point idleSince;
+        std::unique_ptr<Operation> op; // null while idle in the pool
+        ResponseParser parser;
+    };
+
+    EpollTransportOptions options;
+
+    std::mutex mutex;
+    std::deque<std::unique_ptr<Operation>> queued;
+    bool started = false;
+    bool stopping = false;
+    std::thread loop;
+    int epollFd = -1;
+    int wakeFd = -1;
+
+    std::mutex resolveMutex;
+    std::unordered_map<std::string, std::pair<sockaddr_storage, socklen_t>> resolved;
+
+    // Epoll thread only.
+    std::unordered_map<int, std::unique_ptr<Connection>> connections;
+    std::unordered_map<std::string, std::vector<int>> idle;
+    std::unordered_map<std::string, std::size_t> openPerHost;
+    std::unordered_map<std::string, std::deque<std::unique_ptr<Operation>>> waiting;
+
+    bool Resolve(const Target& target, Operation& op, std::string& error)
+    {
+        std::lock_guard<std::mutex> lock(resolveMutex);
+        auto found = resolved.find(op.key);
+        if (found == resolved.end())
+        {
+            addrinfo hints{};
+            hints.ai_family = AF_UNSPEC;
+            hints.ai_socktype = SOCK_STREAM;
+            addrinfo* results = nullptr;
+            const int status = getaddrinfo(target.host.c_str(), target.port.c_str(), &hints, &results);
+            if (status != 0 || !results)
+            {
+                error = "Unable to resolve " + target.host + ": " + gai_strerror(status);
+                return false;
+            }
+            std::pair<sockaddr_storage, socklen_t> address{};
+            std::memcpy(&address.first, results->ai_addr, results->ai_addrlen);
+            address.second = static_cast<socklen_t>(results->ai_addrlen);
+            freeaddrinfo(results);
+            found = resolved.emplace(op.key, address).first;
+        }
+        op.address = found->second.first;
+        op.addressLength = found->second.second;
+        return true;
+    }
+
+    // Parses and resolves the URL and frames the request head; the body is attached
+    // by the caller.
+    std::unique_ptr<Operation> Prepare(const std::string& url,
+                                       const std::string& method,
+                                       const std::string& contentType,
+                                       const std::vector<HttpHeader>& headers,
+                                       std::size_t bodySize,
+                                       std::string& error)
+    {
+        Target target;
+        if (!ParseTarget(url, target, error))
+        {
+            return nullptr;
+        }
+
+        auto op = std::make_unique<Operation>();
+        op->key = target.host + ":" + target.port;
+        if (!Resolve(target, *op, error))
+        {
+            return nullptr;
+        }
+
+        std::string& head = op->head;
+        head.reserve(256);
+        head += method + " " + target.path + " HTTP/1.1\r\nHost: ";
+        head += target.host.find(':') != std::string::npos ? "[" + target.host + "]" : target.host;
+        if (target.port != "80")
+        {
+            head += ":" + target.port;
+        }
+        head += "\r\nConnection: keep-alive\r\n";
+        if (!contentType.empty())
+        {
+            head += "Content-Type: " + contentType + "\r\n";
+        }
+        if (bodySize > 0 || method == "POST" || method == "PUT")
+        {
+            head += "Content-Length: " + std::to_string(bodySize) + "\r\n";
+        }
+        for (const auto& header : headers)
+        {
+            if (!header.name.empty())
+            {
+                head += header.name + ": " + header.value + "\r\n";
+            }
+        }
+        head += "\r\n";
+
+        op->headRequest = method == "HEAD";
+        op->deadline = Clock::now() + options.requestTimeout;
+        return op;
+    }
+
+    void Enqueue(std::unique_ptr<Operation> op)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (stopping)
+            {
+                lock.unlock();
+                op->done(Failure(kShutdownError));
+                return;
+            }
+            if (!started && !Start(op))
+            {
+                return;
+            }
+            queued.push_back(std::move(op));
+        }
+        Wake();
+    }
+
+    // Called with mutex held.
+    bool Start(std::unique_ptr<Operation>& op)
+    {
+        epollFd = epoll_create1(EPOLL_CLOEXEC);
+        wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (epollFd < 0 || wakeFd < 0)
+        {
+            const std::string error = std::string("epoll setup failed: ") + std::strerror(errno);
+            CloseDescriptors();
+            op->done(Failure(error));
+            return false;
+        }
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = wakeFd;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &event);
+        started = true;
+        loop = std::thread([this]() { Run(); });
+        return true;
+    }
+
+    void Wake() const
+    {
+        const std::uint64_t one = 1;
+        [[maybe_unused]] const ssize_t written = write(wakeFd, &one, sizeof(one));
+    }
+
+    void CloseDescriptors()
+    {
+        if (epollFd >= 0)
+        {
+            close(epollFd);
+            epollFd = -1;
+        }
+        if (wakeFd >= 0)
+        {
+            close(wakeFd);
+            wakeFd = -1;
+        }
+    }
+
+    void Run()
+    {
+        epoll_event events[kMaxEvents];
+        for (;;)
+        {
+            const int count = epoll_wait(epollFd, events, kMaxEvents, NextTimeoutMillis());
+            for (int i = 0; i < count; ++i)
+            {
+                if (events[i].data.fd == wakeFd)
+                {
+                    std::uint64_t value = 0;
+                    [[maybe_unused]] const ssize_t drained = read(wakeFd, &value, sizeof(value));
+                    continue;
+                }
+                HandleEvent(events[i].data.fd, events[i].events);
+            }
+
+            std::deque<std::unique_ptr<Operation>> ready;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (stopping)
+                {
+                    break;
+                }
+                ready.swap(queued);
+            }
+            for (auto& op : ready)
+            {
+                Dispatch(std::move(op));
+            }
+            ExpireTimeouts();
+            StartWaiting();
+        }
+
+        std::deque<std::unique_ptr<Operation>> abandoned;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            abandoned.swap(queued);
+        }
+        for (auto& entry : waiting)
+        {
+            for (auto& op : entry.second)
+            {
+                abandoned.push_back(std::move(op));
+            }
+        }
+        waiting.clear();
+        for (auto& op : abandoned)
+        {
+            op->done(Failure(kShutdownError));
+        }
+        std::vector<int> open;
+        for (const auto& entry : connections)
+        {
+            open.push_back(entry.first);
+        }
+        for (int fd : open)
+        {
+            Fail(fd, kShutdownError);
+        }
+    }
+
+    int NextTimeoutMillis() const
+    {
+        if (connections.empty())
+        {
+            return -1;
+        }
+        Clock::time_point next = Clock::time_point::max();
+        for (const auto& entry : waiting)
+        {
+            if (!entry.second.empty())
+            {
+                next = std::min(next, entry.second.front()->deadline);
+            }
+        }
+        for (const auto& entry : connections)
+        {
+            const Connection& connection = *entry.second;
+            if (!connection.op)
+            {
+                next = std::min(next, connection.idleSince + options.idleTimeout);
+                continue;
+            }
+            next = std::min(next, connection.op->deadline);
+            if (connection.connecting)
+            {
+                next = std::min(next, connection.connectDeadline);
+            }
+        }
+        const auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(next - Clock::now()).count();
+        return static_cast<int>(std::clamp<long long>(wait + 1, 0, 60000));
+    }
+
+    void ExpireTimeouts()
+    {
+        const Clock::time_point now = Clock::now();
+        std::vector<std::pair<int, const char*>> expired;
+        for (const auto& entry : connections)
+        {
+            const Connection& connection = *entry.second;
+            if (!connection.op)
+            {
+                if (now - connection.idleSince >= options.idleTimeout)
+                {
+                    expired.emplace_back(entry.first, nullptr);
+                }
+            }
+            else if (connection.connecting && now >= connection.connectDeadline)
+            {
+                expired.emplace_back(entry.first, "Connect timed out");
+            }
+            else if (now >= connection.op->deadline)
+            {
+                expired.emplace_back(entry.first, "Request timed out");
+            }
+        }
+        for (const auto& [fd, error] : expired)
+        {
+            if (error)
+            {
+                Fail(fd, error);
+            }
+            else
+            {
+                CloseConnection(fd);
+            }
+        }
+
+        // Waiting requests are queued in submission order, so expired ones are at the front.
+        for (auto& entry : waiting)
+        {
+            auto& queue = entry.second;
+            while (!queue.empty() && now >= queue.front()->deadline)
+            {
+                std::unique_ptr<Operation> op = std::move(queue.front());
+                queue.pop_front();
+                op->done(Failure("Request timed out"));
+            }
+        }
+    }
+
+    // Opens connections for waiting requests wherever a host is below its limit.
+    void StartWaiting()
+    {
+        for (auto& entry : waiting)
+        {
+            auto& queue = entry.second;
+            while (!queue.empty() && openPerHost[entry.first] < options.maxConnectionsPerHost)
+            {
+                std::unique_ptr<Operation> op = std::move(queue.front());
+                queue.pop_front();
+                Open(std::move(op));
+            }
+        }
+    }
+
+    void Dispatch(std::unique_ptr<Operation> op)
+    {
+        auto pool = idle.find(op->key);
+        while (pool != idle.end() && !pool->second.empty())
+        {
+            const int fd = pool->second.back();
+            pool->second.pop_back();
+            auto found = connections.find(fd);
+            if (found == connections.end())
+            {
+                continue;
+            }
+            Connection& connection = *found->second;
+            connection.reused = true;
+            Assign(connection, std::move(op));
+            return;
+        }
+        if (openPerHost[op->key] >= options.maxConnectionsPerHost)
+        {
+            waiting[op->key].push_back(std::move(op));
+            return;
+        }
+        Open(std::move(op));
+    }
+
+    void Open(std::unique_ptr<Operation> op)
+    {
+        const int fd = socket(op->address.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd < 0)
+        {
+            op->done(Failure(std::string("socket failed: ") + std::strerror(errno)));
+            return;
+        }
+        const int noDelay = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+        auto connection = std::make_unique<Connection>();
+        connection->fd = fd;
+        connection->key = op->key;
+        connection->connectDeadline = Clock::now() + options.connectTimeout;
+
+        if (connect(fd, reinterpret_cast<const sockaddr*>(&op->address), op->addressLength) != 0)
+        {
+            if (errno != EINPROGRESS)
+            {
+                const std::string error = std::string("connect failed: ") + std::strerror(errno);
+                close(fd);
+                op->done(Failure(error));
+                return;
+            }
+            connection->connecting = true;
+        }
+
+        epoll_event event{};
+        event.events = EPOLLOUT;
+        event.data.fd = fd;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event);
+
+        ++openPerHost[op->key];
+        Connection& added = *connections.emplace(fd, std::move(connection)).first->second;
+        Assign(added, std::move(op));
+    }
+
+    void Assign(Connection& connection, std::unique_ptr<Operation> op)
+    {
+        connection.parser.Reset(op->headRequest);
+        connection.receivedAny = false;
+        connection.written = 0;
+        connection.op = std::move(op);
+        if (!connection.connecting)
+        {
+            Write(connection);
+        }
+    }
+
+    void Watch(const Connection& connection, std::uint32_t events)
+    {
+        epoll_event event{};
+        event.events = events;
+        event.data.fd = connection.fd;
+        epoll_ctl(epollFd, EPOLL_CTL_MOD, connection.fd, &event);
+    }
+
+    void HandleEvent(int fd, std::uint32_t events)
+    {
+        auto found = connections.find(fd);
+        if (found == connections.end())
+        {
+            return;
+        }
+        Connection& connection = *found->second;
+
+        if (!connection.op)
+        {
+            // Idle connections only become readable when the server closes them.
+            CloseConnection(fd);
+            return;
+        }
+
+        if (connection.connecting)
+        {
+            int socketError = 0;
+            socklen_t length = sizeof(socketError);
+            getsockopt(fd, SOL_SOCKET, SO_ERROR, &socketError, &length);
+            if (socketError != 0)
+            {
+                Fail(fd, std::string("connect failed: ") + std::strerror(socketError));
+                return;
+            }
+            connection.connecting = false;
+            Write(connection);
+            return;
+        }
+
+        if (events & EPOLLOUT)
+        {
+            Write(connection);
+            return;
+        }
+        if (events & (EPOLLIN | EPOLLHUP | EPOLLERR))
+        {
+            Read(connection);
+        }
+    }
+
+    // Head and body go out in one sendmsg where the socket allows it.
+    void Write(Connection& connection)
+    {
+        Operation& op = *connection.op;
+        const std::size_t total = op.head.size() + op.bodySize;
+        while (connection.written < total)
+        {
+            iovec parts[2];
+            int partCount = 0;
+            if (connection.written < op.head.size())
+            {
+                parts[partCount].iov_base = op.head.data() + connection.written;
+                parts[partCount].iov_len = op.head.size() - connection.written;
+                ++partCount;
+            }
+            if (op.bodySize > 0)
+            {
+                const std::size_t bodyOffset = connection.written > op.head.size() ? connection.written - op.head.size() : 0;
+                parts[partCount].iov_base = const_cast<char*>(op.body) + bodyOffset;
+                parts[partCount].iov_len = op.bodySize - bodyOffset;
+                ++partCount;
+            }
+
+            msghdr message{};
+            message.msg_iov = parts;
+            message.msg_iovlen = partCount;
+            const ssize_t sent = sendmsg(connection.fd, &message, MSG_NOSIGNAL);
+            if (sent < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                if (errno == EAGAIN || errno == EWOULDBLOCK)
+                {
+                    Watch(connection, EPOLLOUT);
+                    return;
+                }
+                FailOrRetry(connection, std::string("send failed: ") + std::strerror(errno));
+                return;
+            }
+            connection.written += static_cast<std::size_t>(sent);
+        }
+        Watch(connection, EPOLLIN);
+    }
+
+    void Read(Connection& connection)
+    {
+        char buffer[kReadChunkBytes];
+        for (;;)
+        {
+            const ssize_t received = recv(connection.fd, buffer, sizeof(buffer), 0);
+            if (received > 0)
+            {
+                connection.receivedAny = true;
+                if (!connection.parser.Feed(buffer, static_cast<std::size_t>(received)))
+                {
+                    Fail(connection.fd, "Malformed HTTP response");
+                    return;
+                }
+                if (connection.parser.Complete())
+                {
+                    Complete(connection);
+                    return;
+                }
+                continue;
+            }
+            if (received == 0)
+            {
+                if (connection.parser.FinishAtEof())
+                {
+                    Complete(connection);
+                }
+                else
+                {
+                    FailOrRetry(connection, "Connection closed by server");
+                }
+                return;
+            }
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+            {
+                FailOrRetry(connection, std::string("recv failed: ") + std::strerror(errno));
+            }
+            return;
+        }
+    }
+
+    void Complete(Connection& connection)
+    {
+        HttpResult result;
+        result.status = connection.parser.Status();
+        result.body = connection.parser.TakeBody();
+        result.success = result.status >= 200 && result.status < 300;
+        if (!result.success)
+        {
+            result.error = "HTTP " + std::to_string(result.status);
+            if (!result.body.empty())
+            {
+                result.error += ": " + result.body;
+            }
+        }
+
+        std::unique_ptr<Operation> op = std::move(connection.op);
+        if (!connection.parser.KeepAlive())
+        {
+            CloseConnection(connection.fd);
+        }
+        else
+        {
+            // Hand the connection straight to the next request for this host, if any.
+            auto queue = waiting.find(connection.key);
+            if (queue != waiting.end() && !queue->second.empty())
+            {
+                std::unique_ptr<Operation> next = std::move(queue->second.front());
+                queue->second.pop_front();
+                connection.reused = true;
+                Assign(connection, std::move(next));
+            }
+            else
+            {
+                connection.idleSince = Clock::now();
+                idle[connection.key].push_back(connection.fd);
+                Watch(connection, EPOLLIN | EPOLLRDHUP);
+            }
+        }
+        op->done(std::move(result));
+    }
+
+    // A kept-alive connection the server closed just before our request landed has
+    // produced no response at all; that request gets one more try on a fresh socket.
+    // Uploads carry clientSeq, so a replay that did reach the API is not stored twice.
+    void FailOrRetry(Connection& connection, const std::string& error)
+    {
+        if (connection.reused && !connection.receivedAny && !connection.op->retried && Clock::now() < connection.op->deadline)
+        {
+            std::unique_ptr<Operation> op = std::move(connection.op);
+            op->retried = true;
+            CloseConnection(connection.fd);
+            Open(std::move(op));
+            return;
+        }
+        Fail(connection.fd, error);
+    }
+
+    void Fail(int fd, const std::string& error)
+    {
+        auto found = connections.find(fd);
+        if (found == connections.end())
+        {
+            return;
+        }
+        std::unique_ptr<Operation> op = std::move(found->second->op);
+        CloseConnection(fd);
+        if (op)
+        {
+            op->done(Failure(error));
+        }
+    }
+
+    void CloseConnection(int fd)
+    {
+        auto found = connections.find(fd);
+        if (found == connections.end())
+        {
+            return;
+        }
+        auto pool = idle.find(found->second->key);
+        if (pool != idle.end())
+        {
+            pool->second.erase(std::remove(pool->second.begin(), pool->second.end(), fd), pool->second.end());
+        }
+        auto open = openPerHost.find(found->second->key);
+        if (open != openPerHost.end() && open->second > 0)
+        {
+            --open->second;
+        }
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+        close(fd);
+        connections.erase(found);
+    }
+};
+
+EpollHttpTransport::EpollHttpTransport(EpollTransportOptions options)
+    : impl_(std::make_unique<Impl>())
+{
+    impl_->options = options;
+}
+
+EpollHttpTransport::~EpollHttpTransport()
+{
+    Shutdown();
+    impl_->CloseDescriptors();
+}
+
+void EpollHttpTransport::Submit(const std::string& url, HttpRequest request, Completion done)
+{
+    std::string error;
+    auto op = impl_->Prepare(url, request.method, request.contentType, request.headers, request.body.size(), error);
+    if (!op)
+    {
+        done(Failure(error));
+        return;
+    }
+    op->ownedBody = std::move(request.body);
+    op->body = op->ownedBody.data();
+    op->bodySize = op->ownedBody.size();
+    op->done = std::move(done);
+    impl_->Enqueue(std::move(op));
+}
+
+HttpResult EpollHttpTransport::Execute(const std::string& url,
+                                       const char* method,
+                                       const char* contentType,
+                                       const void* data,
+                                       std::size_t size,
+                                       const std::vector<HttpHeader>& headers)
+{
+    std::string error;
+    auto op = impl_->Prepare(url, method, contentType ? contentType : "", headers, size, error);
+    if (!op)
+    {
+        return Failure(error);
+    }
+
+    std::promise<HttpResult> promise;
+    std::future<HttpResult> result = promise.get_future();
+    op->body = static_cast<const char*>(data);
+    op->bodySize = size;
+    op->done = [&promise](HttpResult response) { promise.set_value(std::move(response)); };
+    impl_->Enqueue(std::move(op));
+    return result.get();
+}
+
+void EpollHttpTransport::Shutdown()
+{
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex);
+        if (impl_->stopping)
+        {
+            return;
+        }
+        impl_->stopping = true;
+        if (!impl_->started)
+        {
+            return;
+        }
+    }
+    impl_->Wake();
+    if (impl_->loop.joinable() && impl_->loop.get_id() != std::this_thread::get_id())
+    {
+        impl_->loop.join();
+    }
+}
+
+#endif
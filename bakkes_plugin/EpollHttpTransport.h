@@ -0,0 +1,59 @@
+#pragma once
+
+#ifdef __linux__
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ApiClient.h"
+
+struct EpollTransportOptions {
+    std::chrono::milliseconds connectTimeout{5000};
+    std::chrono::milliseconds requestTimeout{30000};
+    // Shorter than Node's default keepAliveTimeout (5s), so the API rarely closes a
+    // connection just as it is reused.
+    std::chrono::milliseconds idleTimeout{4000};
+    // Requests beyond this wait for a connection to free up rather than opening more.
+    std::size_t maxConnectionsPerHost = 8;
+};
+
+// The Linux transport behind ApiClient: plain HTTP/1.1 over non-blocking sockets,
+// with every request in flight driven by one epoll thread. Connections are kept
+// alive and reused per host:port, and both Content-Length and chunked responses
+// are read. There is no TLS; the Linux build talks to a local or LAN API.
+class EpollHttpTransport {
+public:
+    using Completion = std::function<void(HttpResult)>;
+
+    explicit EpollHttpTransport(EpollTransportOptions options = {});
+    ~EpollHttpTransport();
+
+    EpollHttpTransport(const EpollHttpTransport&) = delete;
+    EpollHttpTransport& operator=(const EpollHttpTransport&) = delete;
+
+    // done runs exactly once: on the epoll thread, or inline if the request cannot
+    // be started (bad URL, unresolvable host, shut down).
+    void Submit(const std::string& url, HttpRequest request, Completion done);
+
+    // Blocking form for ApiClient's synchronous calls. The body is not copied, so
+    // data only has to stay valid until this returns.
+    HttpResult Execute(const std::string& url,
+                       const char* method,
+                       const char* contentType,
+                       const void* data,
+                       std::size_t size,
+                       const std::vector<HttpHeader>& headers);
+
+    // Fails everything in flight and every later request, then stops the thread.
+    void Shutdown();
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+#endif
@@ -0,0 +1,166 @@
+#include "pch.h"
+#include "HistoryTable.h"
+#include "MatchHistory.h"
+#include "PlaylistRegistry.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace
+{
+    std::string PlaylistLabel(int playlistId)
+    {
+        const PlaylistInfo* info = PlaylistRegistry::FindById(playlistId);
+        return info ? info->name : "Playlist " + std::to_string(playlistId);
+    }
+
+    // Wins above no result above losses.
+    int MatchResultRank(std::uint8_t flags)
+    {
+        return (flags & kMatchWon) ? 2 : (flags & kMatchLost) ? 0 : 1;
+    }
+}
+
+void HistoryTable::AddMatches(const std::vector<MatchRecord>& records)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const MatchRecord& record : records)
+    {
+        AppendMatchLocked(record);
+    }
+    for (std::size_t column = 0; column < kHistoryColumnCount; ++column)
+    {
+        std::vector<std::uint32_t>& order = order_[column];
+        order.resize(timestamp_.size());
+        std::iota(order.begin(), order.end(), 0u);
+        std::stable_sort(order.begin(), order.end(), [this, column](std::uint32_t a, std::uint32_t b) {
+            return LessLocked(static_cast<HistoryColumn>(column), a, b);
+        });
+    }
+}
+
+void HistoryTable::AddMatch(const MatchRecord& record)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    AppendMatchLocked(record);
+    InsertLastLocked();
+}
+
+void HistoryTable::AddUpload(std::int64_t timestamp, const std::string& endpoint, bool success, unsigned long status,
+                             std::int64_t latencyMillis, std::size_t bytes)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (uploads_ >= kMaxUploadRows)
+    {
+        ++droppedUploads_;
+        return;
+    }
+    ++uploads_;
+    AppendLocked(timestamp, true, endpoint, success ? 1 : 0,
+                 static_cast<std::uint16_t>(std::min<unsigned long>(status, 65535)), 0, 0, 0,
+                 static_cast<std::int32_t>(std::clamp<std::int64_t>(latencyMillis, 0, INT32_MAX)),
+                 static_cast<std::int32_t>(std::min<std::size_t>(bytes, INT32_MAX)));
+    InsertLastLocked();
+}
+
+std::size_t HistoryTable::Size() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return timestamp_.size();
+}
+
+std::size_t HistoryTable::DroppedUploads() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return droppedUploads_;
+}
+
+bool HistoryTable::RowAt(std::size_t position, HistoryColumn column, bool descending, HistoryRow& row) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    const std::vector<std::uint32_t>& order = order_[static_cast<std::size_t>(column)];
+    if (position >= order.size())
+    {
+        return false;
+    }
+    const std::uint32_t index = order[descending ? order.size() - 1 - position : position];
+    row.timestamp = timestamp_[index];
+    row.upload = upload_[index] != 0;
+    row.label = labels_[label_[index]];
+    row.flags = flags_[index];
+    row.status = status_[index];
+    row.mmr = mmr_[index];
+    row.teamGoals = teamGoals_[index];
+    row.opponentGoals = opponentGoals_[index];
+    row.latencyMillis = latencyMillis_[index];
+    row.bytes = bytes_[index];
+    return true;
+}
+
+void HistoryTable::AppendLocked(std::int64_t timestamp, bool upload, const std::string& label, std::uint8_t flags,
+                                std::uint16_t status, std::int16_t mmr, std::uint8_t teamGoals, std::uint8_t opponentGoals,
+                                std::int32_t latencyMillis, std::int32_t bytes)
+{
+    auto it = std::find(labels_.begin(), labels_.end(), label);
+    if (it == labels_.end())
+    {
+        it = labels_.insert(labels_.end(), label);
+    }
+    timestamp_.push_back(timestamp);
+    upload_.push_back(upload ? 1 : 0);
+    label_.push_back(static_cast<std::uint16_t>(it - labels_.begin()));
+    flags_.push_back(flags);
+    status_.push_back(status);
+    mmr_.push_back(mmr);
+    teamGoals_.push_back(teamGoals);
+    opponentGoals_.push_back(opponentGoals);
+    latencyMillis_.push_back(latencyMillis);
+    bytes_.push_back(bytes);
+}
+
+void HistoryTable::AppendMatchLocked(const MatchRecord& record)
+{
+    AppendLocked(record.timestamp, false, PlaylistLabel(record.playlistId), record.flags, 0, record.mmr,
+                 record.teamGoals, record.opponentGoals, -1, -1);
+}
+
+// The new row is the newest, so inserting after its equals keeps ties in arrival
+// order. Moving the tail of each order is a memmove of 4-byte indices.
+void HistoryTable::InsertLastLocked()
+{
+    const std::uint32_t last = static_cast<std::uint32_t>(timestamp_.size() - 1);
+    for (std::size_t column = 0; column < kHistoryColumnCount; ++column)
+    {
+        std::vector<std::uint32_t>& order = order_[column];
+        const auto at = std::upper_bound(order.begin(), order.end(), last, [this, column](std::uint32_t a, std::uint32_t b) {
+            return LessLocked(static_cast<HistoryColumn>(column), a, b);
+        });
+        order.insert(at, last);
+    }
+}
+
+bool HistoryTable::LessLocked(HistoryColumn column, std::uint32_t a, std::uint32_t b) const
+{
+    switch (column)
+    {
+    case HistoryColumn::Time:
+        return timestamp_[a] < timestamp_[b];
+    case HistoryColumn::Type:
+        return upload_[a] < upload_[b];
+    case HistoryColumn::Detail:
+        return labels_[label_[a]] < labels_[label_[b]];
+    case HistoryColumn::Result:
+        if (upload_[a] != upload_[b])
+        {
+            return upload_[a] < upload_[b];
+        }
+        return upload_[a] ? status_[a] < status_[b] : MatchResultRank(flags_[a]) < MatchResultRank(flags_[b]);
+    case HistoryColumn::Mmr:
+        return mmr_[a] < mmr_[b];
+    case HistoryColumn::Latency:
+        return latencyMillis_[a] < latencyMillis_[b];
+    case HistoryColumn::Size:
+        return bytes_[a] < bytes_[b];
+    }
+    return false;
+}
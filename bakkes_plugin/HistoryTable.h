@@ -0,0 +1,82 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+struct MatchRecord;
+
+enum class HistoryColumn : std::uint8_t {
+    Time,
+    Type,
+    Detail,
+    Result,
+    Mmr,
+    Latency,
+    Size,
+};
+constexpr std::size_t kHistoryColumnCount = 7;
+
+// One row as the overlay draws it.
+struct HistoryRow {
+    std::int64_t timestamp = 0; // unix seconds
+    bool upload = false;
+    std::string label; // playlist name or endpoint
+    // Matches: MatchRecordFlags. Uploads: 1 on a 2xx, 0 otherwise.
+    std::uint8_t flags = 0;
+    std::uint16_t status = 0; // uploads: HTTP status, 0 when none is known
+    std::int16_t mmr = 0;
+    std::uint8_t teamGoals = 0;
+    std::uint8_t opponentGoals = 0;
+    std::int32_t latencyMillis = -1; // -1 for matches
+    std::int32_t bytes = -1;         // -1 for matches
+};
+
+// Matches and upload attempts as struct-of-arrays columns, plus one row-index
+// permutation per column kept sorted as rows arrive. Drawing row N in any order is
+// then an index lookup, so the overlay formats only the rows on screen, whatever
+// the table's length. Thread-safe.
+class HistoryTable {
+public:
+    static constexpr std::size_t kMaxUploadRows = 20000;
+
+    // For seeding from the history file, oldest first: sorts each order once
+    // instead of inserting row by row.
+    void AddMatches(const std::vector<MatchRecord>& records);
+    void AddMatch(const MatchRecord& record);
+    void AddUpload(std::int64_t timestamp, const std::string& endpoint, bool success, unsigned long status,
+                   std::int64_t latencyMillis, std::size_t bytes);
+
+    std::size_t Size() const;
+    std::size_t DroppedUploads() const;
+    // position counts from the start of the order on column, or from its end when
+    // descending. Ties keep arrival order.
+    bool RowAt(std::size_t position, HistoryColumn column, bool descending, HistoryRow& row) const;
+
+private:
+    void AppendLocked(std::int64_t timestamp, bool upload, const std::string& label, std::uint8_t flags,
+                      std::uint16_t status, std::int16_t mmr, std::uint8_t teamGoals, std::uint8_t opponentGoals,
+                      std::int32_t latencyMillis, std::int32_t bytes);
+    void AppendMatchLocked(const MatchRecord& record);
+    void InsertLastLocked();
+    bool LessLocked(HistoryColumn column, std::uint32_t a, std::uint32_t b) const;
+
+    mutable std::mutex mutex_;
+    std::vector<std::string> labels_; // few distinct playlists and endpoints
+    std::vector<std::int64_t> timestamp_;
+    std::vector<std::uint8_t> upload_;
+    std::vector<std::uint16_t> label_;
+    std::vector<std::uint8_t> flags_;
+    std::vector<std::uint16_t> status_;
+    std::vector<std::int16_t> mmr_;
+    std::vector<std::uint8_t> teamGoals_;
+    std::vector<std::uint8_t> opponentGoals_;
+    std::vector<std::int32_t> latencyMillis_;
+    std::vector<std::int32_t> bytes_;
+    std::array<std::vector<std::uint32_t>, kHistoryColumnCount> order_;
+    std::size_t uploads_ = 0;
+    std::size_t droppedUploads_ = 0;
+};
@@ -0,0 +1,293 @@
+#include "pch.h"
+#include "LiveStream.h"
+#include "DiagnosticLogger.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <utility>
+
+namespace
+{
+    constexpr std::chrono::milliseconds kFirstRetry{1000};
+    constexpr std::chrono::milliseconds kMaxRetry{30000};
+
+    // Match GUIDs are hex, but nothing here depends on that.
+    void AppendJsonString(std::string& out, const std::string& value)
+    {
+        out += '"';
+        for (const char ch : value)
+        {
+            if (ch == '"' || ch == '\\')
+            {
+                out += '\\';
+                out += ch;
+            }
+            else if (static_cast<unsigned char>(ch) < 0x20)
+            {
+                char escaped[8];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(ch));
+                out += escaped;
+            }
+            else
+            {
+                out += ch;
+            }
+        }
+        out += '"';
+    }
+
+    void AppendScore(std::string& out, const LiveState& state)
+    {
+        out += ",\"score\":[" + std::to_string(state.score[0]) + ',' + std::to_string(state.score[1]) + ']';
+    }
+
+    bool SameState(const LiveState& a, const LiveState& b)
+    {
+        return a.matchGuid == b.matchGuid && a.playlistId == b.playlistId && a.team == b.team &&
+               a.score[0] == b.score[0] && a.score[1] == b.score[1] && a.clock == b.clock &&
+               a.overtime == b.overtime && a.boost == b.boost;
+    }
+
+    std::chrono::steady_clock::duration IntervalFor(int framesPerSecond)
+    {
+        const int rate = std::clamp(framesPerSecond, LiveStream::kMinRate, LiveStream::kMaxRate);
+        return std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::seconds(1)) / rate;
+    }
+}
+
+LiveStream::LiveStream(std::string url, std::vector<HttpHeader> headers, int framesPerSecond)
+    : url_(std::move(url)),
+      headers_(std::move(headers)),
+      interval_(IntervalFor(framesPerSecond))
+{
+    worker_ = std::thread([this]() { Run(); });
+}
+
+LiveStream::~LiveStream()
+{
+    Stop();
+}
+
+void LiveStream::SetRate(int framesPerSecond)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    interval_ = IntervalFor(framesPerSecond);
+}
+
+void LiveStream::Publish(const LiveState& state)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (SameState(state, latest_))
+        {
+            return;
+        }
+        if (dirty_)
+        {
+            ++stats_.coalesced;
+        }
+        latest_ = state;
+        dirty_ = true;
+    }
+    wake_.notify_one();
+}
+
+void LiveStream::PublishGoal(int team, std::uint16_t clock)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::string event = "{\"type\":\"goal\",\"match\":";
+        AppendJsonString(event, latest_.matchGuid);
+        event += ",\"team\":" + std::to_string(team) + ",\"clock\":" + std::to_string(clock) + '}';
+        QueueEventLocked(std::move(event));
+    }
+    wake_.notify_one();
+}
+
+// EventMatchEnded and Destroyed both end a match; only the first sends anything.
+void LiveStream::EndMatch()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (latest_.matchGuid.empty())
+        {
+            return;
+        }
+        std::string event = "{\"type\":\"end\",\"match\":";
+        AppendJsonString(event, latest_.matchGuid);
+        event += '}';
+        QueueEventLocked(std::move(event));
+        latest_ = LiveState{};
+        dirty_ = false;
+    }
+    wake_.notify_one();
+}
+
+LiveStreamStats LiveStream::Stats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void LiveStream::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    if (worker_.joinable())
+    {
+        worker_.join();
+    }
+}
+
+void LiveStream::QueueEventLocked(std::string event)
+{
+    if (events_.size() >= kMaxEvents)
+    {
+        events_.pop_front();
+        ++stats_.droppedEvents;
+    }
+    events_.push_back(std::move(event));
+}
+
+std::string LiveStream::BuildStateFrameLocked()
+{
+    dirty_ = false;
+    if (latest_.matchGuid.empty())
+    {
+        return std::string();
+    }
+
+    std::string frame;
+    if (needKey_ || latest_.matchGuid != sent_.matchGuid)
+    {
+        frame = "{\"type\":\"key\",\"match\":";
+        AppendJsonString(frame, latest_.matchGuid);
+        frame += ",\"playlist\":" + std::to_string(latest_.playlistId) + ",\"team\":" + std::to_string(latest_.team);
+        AppendScore(frame, latest_);
+        frame += ",\"clock\":" + std::to_string(latest_.clock) + ",\"ot\":" + (latest_.overtime ? "true" : "false") +
+                 ",\"boost\":" + std::to_string(latest_.boost) + '}';
+        needKey_ = false;
+    }
+    else
+    {
+        std::string fields;
+        if (latest_.score[0] != sent_.score[0] || latest_.score[1] != sent_.score[1])
+        {
+            AppendScore(fields, latest_);
+        }
+        if (latest_.clock != sent_.clock)
+        {
+            fields += ",\"clock\":" + std::to_string(latest_.clock);
+        }
+        if (latest_.overtime != sent_.overtime)
+        {
+            fields += std::string(",\"ot\":") + (latest_.overtime ? "true" : "false");
+        }
+        if (latest_.boost != sent_.boost)
+        {
+            fields += ",\"boost\":" + std::to_string(latest_.boost);
+        }
+        // The team and playlist only change with the match, which sends a keyframe.
+        if (fields.empty())
+        {
+            return std::string();
+        }
+        frame = "{\"type\":\"state\"" + fields + '}';
+    }
+    sent_ = latest_;
+    return frame;
+}
+
+void LiveStream::Run()
+{
+    auto backoff = std::chrono::milliseconds(kFirstRetry);
+    bool everConnected = false;
+    Clock::time_point nextFrame{};
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_)
+    {
+        if (!stats_.connected)
+        {
+            lock.unlock();
+            std::string error;
+            const bool connected = socket_.Connect(url_, headers_, error);
+            lock.lock();
+            if (!connected)
+            {
+                stats_.lastError = error;
+                DiagnosticLogger::Log("LiveStream: connect failed, retrying in " + std::to_string(backoff.count()) + " ms: " + error);
+                wake_.wait_for(lock, backoff, [this]() { return stopping_; });
+                backoff = std::min(kMaxRetry, backoff * 2);
+                continue;
+            }
+            if (everConnected)
+            {
+                ++stats_.reconnects;
+            }
+            everConnected = true;
+            stats_.connected = true;
+            backoff = kFirstRetry;
+            // The server may have restarted; it gets the whole state again.
+            needKey_ = true;
+            dirty_ = !latest_.matchGuid.empty();
+            DiagnosticLogger::Log("LiveStream: connected to " + url_);
+        }
+
+        wake_.wait(lock, [this]() { return stopping_ || dirty_ || !events_.empty(); });
+        if (stopping_)
+        {
+            break;
+        }
+        // States published while waiting out the interval are coalesced into one frame.
+        if (Clock::now() < nextFrame)
+        {
+            wake_.wait_until(lock, nextFrame, [this]() { return stopping_; });
+            continue;
+        }
+
+        // A keyframe goes ahead of events, so they always refer to a known match; a new
+        // match guid makes the next state frame a keyframe too.
+        const bool keyPending = (needKey_ || latest_.matchGuid != sent_.matchGuid) && dirty_;
+        const bool isEvent = !events_.empty() && !keyPending;
+        std::string frame;
+        if (isEvent)
+        {
+            frame = std::move(events_.front());
+            events_.pop_front();
+        }
+        else
+        {
+            frame = BuildStateFrameLocked();
+        }
+        if (frame.empty())
+        {
+            continue;
+        }
+
+        lock.unlock();
+        std::string error;
+        const bool sent = socket_.SendText(frame, error);
+        lock.lock();
+        nextFrame = Clock::now() + interval_;
+        if (sent)
+        {
+            ++stats_.frames;
+            stats_.bytes += frame.size();
+            continue;
+        }
+
+        stats_.connected = false;
+        stats_.lastError = error;
+        DiagnosticLogger::Log("LiveStream: " + error);
+        // State is resent as a keyframe on reconnect; an event is not superseded by anything.
+        if (isEvent && events_.size() < kMaxEvents)
+        {
+            events_.push_front(std::move(frame));
+        }
+    }
+    lock.unlock();
+    socket_.Close();
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ApiClient.h"
+#include "WebSocketClient.h"
+
+// What the live dashboard shows of the match in progress; sampled on the game thread.
+struct LiveState {
+    std::string matchGuid; // empty outside a match
+    int playlistId = 0;
+    int team = -1; // local player's team, -1 if unknown
+    int score[2] = {0, 0};
+    std::uint16_t clock = 0; // elapsed seconds, as in the timeline
+    bool overtime = false;
+    int boost = -1; // local car, 0-100; -1 when there is no car
+};
+
+struct LiveStreamStats {
+    std::uint64_t frames = 0;
+    std::uint64_t bytes = 0;
+    std::uint64_t coalesced = 0; // states replaced before they were sent
+    std::uint64_t droppedEvents = 0;
+    std::uint64_t reconnects = 0;
+    bool connected = false;
+    std::string lastError;
+};
+
+// Streams live match state to the journal over one WebSocket. Publish only overwrites
+// the latest state; a worker sends at most one frame per interval, carrying the fields
+// that changed since the last frame, so a slow link skips intermediate states instead
+// of queueing them. Goals and the match end are events and are sent in order ahead of
+// state, from a small bounded queue. Each connection, and each new match, starts with
+// a keyframe holding every field. Thread-safe.
+class LiveStream {
+public:
+    static constexpr std::size_t kMaxEvents = 16;
+    static constexpr int kMinRate = 1;
+    static constexpr int kMaxRate = 20;
+
+    // url is the full WebSocket endpoint, e.g. http://localhost:4000/api/live.
+    LiveStream(std::string url, std::vector<HttpHeader> headers, int framesPerSecond);
+    ~LiveStream();
+
+    LiveStream(const LiveStream&) = delete;
+    LiveStream& operator=(const LiveStream&) = delete;
+
+    const std::string& Url() const { return url_; }
+    void SetRate(int framesPerSecond);
+    void Publish(const LiveState& state);
+    void PublishGoal(int team, std::uint16_t clock);
+    void EndMatch();
+    LiveStreamStats Stats() const;
+
+    // Closes the connection; nothing queued is sent.
+    void Stop();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    void Run();
+    void QueueEventLocked(std::string event);
+    // Empty when nothing changed since the last frame.
+    std::string BuildStateFrameLocked();
+
+    const std::string url_;
+    const std::vector<HttpHeader> headers_;
+    WebSocketClient socket_; // worker only
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    Clock::duration interval_;
+    LiveState latest_;
+    LiveState sent_;     // what the server has, as of the last frame
+    bool dirty_ = false; // latest_ differs from what was last published to the worker
+    bool needKey_ = true;
+    std::deque<std::string> events_;
+    LiveStreamStats stats_;
+    bool stopping_ = false;
+    std::thread worker_;
+};
@@ -0,0 +1,246 @@
+#include "pch.h"
+#include "MappedFile.h"
+
+#include <algorithm>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+#ifdef _WIN32
+bool MappedFile::Open(const std::filesystem::path& path, std::string& error)
+{
+    Close();
+
+    HANDLE file = CreateFileW(path.wstring().c_str(),
+                              GENERIC_READ,
+                              FILE_SHARE_READ | FILE_SHARE_WRITE,
+                              nullptr,
+                              OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+                              nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        error = "CreateFileW failed: " + std::to_string(GetLastError());
+        return false;
+    }
+    file_ = file;
+
+    LARGE_INTEGER size{};
+    if (!GetFileSizeEx(file, &size) || size.QuadPart <= 0)
+    {
+        error = "replay file is empty or unreadable";
+        Close();
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping)
+    {
+        error = "CreateFileMappingW failed: " + std::to_string(GetLastError());
+        Close();
+        return false;
+    }
+    mapping_ = mapping;
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view)
+    {
+        error = "MapViewOfFile failed: " + std::to_string(GetLastError());
+        Close();
+        return false;
+    }
+
+    data_ = static_cast<const unsigned char*>(view);
+    size_ = static_cast<std::size_t>(size.QuadPart);
+    return true;
+}
+
+bool MappedFile::OpenWritable(const std::filesystem::path& path, std::size_t size, std::string& error)
+{
+    Close();
+
+    HANDLE file = CreateFileW(path.wstring().c_str(),
+                              GENERIC_READ | GENERIC_WRITE,
+                              FILE_SHARE_READ,
+                              nullptr,
+                              OPEN_ALWAYS,
+                              FILE_ATTRIBUTE_NORMAL,
+                              nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        error = "CreateFileW failed: " + std::to_string(GetLastError());
+        return false;
+    }
+    file_ = file;
+
+    LARGE_INTEGER existing{};
+    if (!GetFileSizeEx(file, &existing))
+    {
+        error = "GetFileSizeEx failed: " + std::to_string(GetLastError());
+        Close();
+        return false;
+    }
+    // A mapping larger than the file extends it with zeros.
+    const unsigned long long mapped = std::max<unsigned long long>(static_cast<unsigned long long>(existing.QuadPart), size);
+    if (mapped == 0)
+    {
+        error = "cannot map an empty file";
+        Close();
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READWRITE,
+                                        static_cast<DWORD>(mapped >> 32), static_cast<DWORD>(mapped & 0xFFFFFFFFull), nullptr);
+    if (!mapping)
+    {
+        error = "CreateFileMappingW failed: " + std::to_string(GetLastError());
+        Close();
+        return false;
+    }
+    mapping_ = mapping;
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ | FILE_MAP_WRITE, 0, 0, 0);
+    if (!view)
+    {
+        error = "MapViewOfFile failed: " + std::to_string(GetLastError());
+        Close();
+        return false;
+    }
+
+    data_ = static_cast<const unsigned char*>(view);
+    size_ = static_cast<std::size_t>(mapped);
+    writable_ = true;
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (data_)
+    {
+        UnmapViewOfFile(data_);
+    }
+    if (mapping_)
+    {
+        CloseHandle(static_cast<HANDLE>(mapping_));
+    }
+    if (file_)
+    {
+        CloseHandle(static_cast<HANDLE>(file_));
+    }
+    data_ = nullptr;
+    size_ = 0;
+    writable_ = false;
+    mapping_ = nullptr;
+    file_ = nullptr;
+}
+#else
+bool MappedFile::Open(const std::filesystem::path& path, std::string& error)
+{
+    Close();
+
+    fd_ = ::open(path.c_str(), O_RDONLY);
+    if (fd_ < 0)
+    {
+        error = "open failed: " + path.string();
+        return false;
+    }
+
+    struct stat info{};
+    if (::fstat(fd_, &info) != 0 || info.st_size <= 0)
+    {
+        error = "replay file is empty or unreadable";
+        Close();
+        return false;
+    }
+
+    void* view = ::mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd_, 0);
+    if (view == MAP_FAILED)
+    {
+        error = "mmap failed: " + path.string();
+        Close();
+        return false;
+    }
+    ::madvise(view, static_cast<std::size_t>(info.st_size), MADV_SEQUENTIAL);
+
+    data_ = static_cast<const unsigned char*>(view);
+    size_ = static_cast<std::size_t>(info.st_size);
+    return true;
+}
+
+bool MappedFile::OpenWritable(const std::filesystem::path& path, std::size_t size, std::string& error)
+{
+    Close();
+
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd_ < 0)
+    {
+        error = "open failed: " + path.string();
+        return false;
+    }
+
+    struct stat info{};
+    if (::fstat(fd_, &info) != 0)
+    {
+        error = "fstat failed: " + path.string();
+        Close();
+        return false;
+    }
+    std::size_t mapped = static_cast<std::size_t>(info.st_size);
+    if (mapped < size)
+    {
+        if (::ftruncate(fd_, static_cast<off_t>(size)) != 0)
+        {
+            error = "ftruncate failed: " + path.string();
+            Close();
+            return false;
+        }
+        mapped = size;
+    }
+    if (mapped == 0)
+    {
+        error = "cannot map an empty file";
+        Close();
+        return false;
+    }
+
+    void* view = ::mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (view == MAP_FAILED)
+    {
+        error = "mmap failed: " + path.string();
+        Close();
+        return false;
+    }
+
+    data_ = static_cast<const unsigned char*>(view);
+    size_ = mapped;
+    writable_ = true;
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (data_)
+    {
+        ::munmap(const_cast<unsigned char*>(data_), size_);
+    }
+    if (fd_ >= 0)
+    {
+        ::close(fd_);
+    }
+    data_ = nullptr;
+    size_ = 0;
+    writable_ = false;
+    fd_ = -1;
+}
+#endif
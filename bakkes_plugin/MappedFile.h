@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <string>
+
+// Memory-mapped view of a whole file. Pages are faulted in as they are touched, so
+// streaming a large file through it never holds a full copy in memory.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool Open(const std::filesystem::path& path, std::string& error);
+    // Maps path read/write, creating it or growing it to at least size bytes first
+    // (new bytes read as zero). Stores land in the page cache and the OS writes them
+    // back, so they survive the game crashing.
+    bool OpenWritable(const std::filesystem::path& path, std::size_t size, std::string& error);
+    void Close();
+
+    const unsigned char* Data() const { return data_; }
+    unsigned char* MutableData() const { return writable_ ? const_cast<unsigned char*>(data_) : nullptr; }
+    std::size_t Size() const { return size_; }
+
+private:
+    const unsigned char* data_ = nullptr;
+    std::size_t size_ = 0;
+    bool writable_ = false;
+#ifdef _WIN32
+    void* file_ = nullptr;
+    void* mapping_ = nullptr;
+#else
+    int fd_ = -1;
+#endif
+};
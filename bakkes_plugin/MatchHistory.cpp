@@ -0,0 +1,234 @@
+#include "pch.h"
+#include "MatchHistory.h"
+
+#include <algorithm>
+#include <cstring>
+#include <system_error>
+
+namespace
+{
+    constexpr char kMagic[4] = {'R', 'T', 'J', 'H'};
+    constexpr std::uint32_t kVersion = 1;
+    constexpr std::size_t kHeaderBytes = 512;
+    constexpr std::size_t kInitialCapacity = 1024;
+
+    struct HistoryHeader {
+        char magic[4];
+        std::uint32_t version;
+        std::uint32_t recordSize;
+        std::uint32_t count;
+        // Slot i holds playlist playlistIds[i]; slots fill in first-seen order.
+        std::int32_t playlistIds[MatchHistory::kMaxPlaylists];
+        std::uint32_t newest[MatchHistory::kMaxPlaylists]; // index + 1 of the slot's newest record
+        std::uint32_t counts[MatchHistory::kMaxPlaylists];
+        std::uint32_t slotsUsed;
+    };
+    static_assert(sizeof(HistoryHeader) <= kHeaderBytes, "header must fit before the first record");
+
+    HistoryHeader* HeaderOf(const MappedFile& file)
+    {
+        return reinterpret_cast<HistoryHeader*>(file.MutableData());
+    }
+
+    const MatchRecord* RecordsOf(const MappedFile& file)
+    {
+        return reinterpret_cast<const MatchRecord*>(file.Data() + kHeaderBytes);
+    }
+
+    std::size_t CapacityOf(const MappedFile& file)
+    {
+        return file.Size() < kHeaderBytes ? 0 : (file.Size() - kHeaderBytes) / sizeof(MatchRecord);
+    }
+
+    int FindSlot(const HistoryHeader& header, int playlistId)
+    {
+        for (std::uint32_t slot = 0; slot < header.slotsUsed && slot < MatchHistory::kMaxPlaylists; ++slot)
+        {
+            if (header.playlistIds[slot] == playlistId)
+            {
+                return static_cast<int>(slot);
+            }
+        }
+        return -1;
+    }
+
+    void InitHeader(HistoryHeader& header)
+    {
+        std::memcpy(header.magic, kMagic, sizeof(kMagic));
+        header.version = kVersion;
+        header.recordSize = sizeof(MatchRecord);
+    }
+}
+
+bool MatchHistory::Open(const std::filesystem::path& path, std::string& error)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    file_.Close();
+    path_ = path;
+    std::error_code ec;
+    std::filesystem::create_directories(path.parent_path(), ec);
+
+    if (!MapLocked(kInitialCapacity, error))
+    {
+        return false;
+    }
+
+    HistoryHeader* header = HeaderOf(file_);
+    static const char kZeros[sizeof(kMagic)] = {};
+    if (std::memcmp(header->magic, kZeros, sizeof(kMagic)) == 0)
+    {
+        InitHeader(*header);
+        return true;
+    }
+
+    const bool valid = std::memcmp(header->magic, kMagic, sizeof(kMagic)) == 0 &&
+                       header->version == kVersion &&
+                       header->recordSize == sizeof(MatchRecord) &&
+                       header->count <= CapacityOf(file_) &&
+                       header->slotsUsed <= kMaxPlaylists;
+    if (valid)
+    {
+        return true;
+    }
+
+    file_.Close();
+    std::filesystem::path aside = path;
+    aside += ".bad";
+    std::filesystem::rename(path, aside, ec);
+    if (ec)
+    {
+        error = "unrecognized history file could not be moved aside: " + ec.message();
+        return false;
+    }
+    if (!MapLocked(kInitialCapacity, error))
+    {
+        return false;
+    }
+    InitHeader(*HeaderOf(file_));
+    return true;
+}
+
+void MatchHistory::Close()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    file_.Close();
+}
+
+bool MatchHistory::IsOpen() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return file_.MutableData() != nullptr;
+}
+
+bool MatchHistory::Append(MatchRecord record, std::string& error)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!file_.MutableData())
+    {
+        error = "history is not open";
+        return false;
+    }
+
+    HistoryHeader* header = HeaderOf(file_);
+    if (header->count == CapacityOf(file_))
+    {
+        if (!MapLocked(CapacityOf(file_) * 2, error))
+        {
+            return false;
+        }
+        header = HeaderOf(file_);
+    }
+
+    int slot = FindSlot(*header, record.playlistId);
+    if (slot < 0 && header->slotsUsed < kMaxPlaylists)
+    {
+        slot = static_cast<int>(header->slotsUsed);
+        header->playlistIds[slot] = record.playlistId;
+        header->newest[slot] = 0;
+        header->counts[slot] = 0;
+        ++header->slotsUsed;
+    }
+    // Past kMaxPlaylists a record is still stored, just not indexed.
+    record.previousInPlaylist = slot >= 0 ? header->newest[slot] : 0;
+
+    const std::uint32_t index = header->count;
+    std::memcpy(file_.MutableData() + kHeaderBytes + index * sizeof(MatchRecord), &record, sizeof(MatchRecord));
+    // The record is in place before the header points at it.
+    if (slot >= 0)
+    {
+        header->newest[slot] = index + 1;
+        ++header->counts[slot];
+    }
+    header->count = index + 1;
+    return true;
+}
+
+std::vector<MatchRecord> MatchHistory::Recent(int playlistId, std::size_t count) const
+{
+    std::vector<MatchRecord> records;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!file_.Data())
+    {
+        return records;
+    }
+    const HistoryHeader* header = HeaderOf(file_);
+    const int slot = FindSlot(*header, playlistId);
+    if (slot < 0)
+    {
+        return records;
+    }
+
+    const MatchRecord* all = RecordsOf(file_);
+    records.reserve(std::min<std::size_t>(count, header->counts[slot]));
+    std::uint32_t next = header->newest[slot];
+    // Links only ever point backwards; anything else means a damaged file.
+    std::uint32_t limit = header->count + 1;
+    while (next != 0 && next < limit && records.size() < count)
+    {
+        records.push_back(all[next - 1]);
+        limit = next;
+        next = all[next - 1].previousInPlaylist;
+    }
+    return records;
+}
+
+std::vector<MatchRecord> MatchHistory::RecentAny(std::size_t count) const
+{
+    std::vector<MatchRecord> records;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!file_.Data())
+    {
+        return records;
+    }
+    const std::size_t total = HeaderOf(file_)->count;
+    const MatchRecord* all = RecordsOf(file_);
+    for (std::size_t i = total; i > 0 && records.size() < count; --i)
+    {
+        records.push_back(all[i - 1]);
+    }
+    return records;
+}
+
+std::size_t MatchHistory::Size() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return file_.Data() ? HeaderOf(file_)->count : 0;
+}
+
+std::size_t MatchHistory::PlaylistSize(int playlistId) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!file_.Data())
+    {
+        return 0;
+    }
+    const HistoryHeader* header = HeaderOf(file_);
+    const int slot = FindSlot(*header, playlistId);
+    return slot >= 0 ? header->counts[slot] : 0;
+}
+
+bool MatchHistory::MapLocked(std::size_t capacity, std::string& error)
+{
+    // Remapping invalidates every pointer into the file; callers re-fetch the header.
+    return file_.OpenWritable(path_, kHeaderBytes + capacity * sizeof(MatchRecord), error);
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "MappedFile.h"
+
+enum MatchRecordFlags : std::uint8_t {
+    kMatchWon = 1 << 0,
+    kMatchLost = 1 << 1, // neither flag: no winner (left early, forfeit)
+    kMatchOvertime = 1 << 2,
+    kMatchMvp = 1 << 3,
+};
+
+// One finished match as stored on disk: 32 bytes, so 100,000 matches take about 3 MB.
+struct MatchRecord {
+    std::int64_t timestamp = 0;            // unix seconds
+    std::uint32_t previousInPlaylist = 0;  // index + 1 of the playlist's previous record; 0 = none
+    std::int32_t playlistId = 0;
+    std::int16_t mmr = 0;
+    std::uint16_t score = 0;
+    std::uint8_t flags = 0;
+    std::uint8_t team = 0;
+    std::uint8_t teamGoals = 0;
+    std::uint8_t opponentGoals = 0;
+    std::uint8_t goals = 0;
+    std::uint8_t assists = 0;
+    std::uint8_t saves = 0;
+    std::uint8_t shots = 0;
+    std::uint8_t demos = 0;
+    std::uint8_t reserved[3] = {};
+};
+static_assert(sizeof(MatchRecord) == 32, "MatchRecord is an on-disk format");
+
+// Append-only match log in a memory-mapped file: a fixed header, then records in
+// arrival order. The header keeps each playlist's newest record and every record
+// links to the previous one in its playlist, so "last N in Ranked Doubles" follows
+// N links instead of scanning. Append is a store into the mapping plus a header
+// update; the file doubles when full.
+class MatchHistory {
+public:
+    static constexpr std::size_t kMaxPlaylists = 32;
+
+    MatchHistory() = default;
+    MatchHistory(const MatchHistory&) = delete;
+    MatchHistory& operator=(const MatchHistory&) = delete;
+
+    // Creates the file if needed. A file with a foreign header is moved aside to
+    // <path>.bad and a new one started.
+    bool Open(const std::filesystem::path& path, std::string& error);
+    void Close();
+    bool IsOpen() const;
+
+    // Sets record.previousInPlaylist itself.
+    bool Append(MatchRecord record, std::string& error);
+
+    // Newest first.
+    std::vector<MatchRecord> Recent(int playlistId, std::size_t count) const;
+    std::vector<MatchRecord> RecentAny(std::size_t count) const;
+    std::size_t Size() const;
+    std::size_t PlaylistSize(int playlistId) const;
+
+private:
+    bool MapLocked(std::size_t capacity, std::string& error);
+
+    mutable std::mutex mutex_;
+    std::filesystem::path path_;
+    MappedFile file_;
+};
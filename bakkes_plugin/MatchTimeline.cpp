@@ -0,0 +1,155 @@
+#include "pch.h"
+#include "MatchTimeline.h"
+
+namespace
+{
+    constexpr std::uint16_t kAssistWindowSeconds = 5;
+
+    char EventCode(TimelineEventType type)
+    {
+        switch (type)
+        {
+        case TimelineEventType::Goal:
+            return 'G';
+        case TimelineEventType::Demolish:
+            return 'D';
+        case TimelineEventType::Overtime:
+        default:
+            return 'O';
+        }
+    }
+}
+
+void MatchTimeline::BeginMatch(std::string_view matchKey)
+{
+    if (IsMatch(matchKey))
+    {
+        return;
+    }
+
+    Clear();
+    matchKeyLength_ = matchKey.copy(matchKey_.data(), kKeyCapacity);
+    matchKey_[matchKeyLength_] = '\0';
+}
+
+bool MatchTimeline::IsMatch(std::string_view matchKey) const
+{
+    return matchKeyLength_ > 0 && matchKey.substr(0, kKeyCapacity) == std::string_view(matchKey_.data(), matchKeyLength_);
+}
+
+void MatchTimeline::EndMatch()
+{
+    Clear();
+}
+
+void MatchTimeline::Clear()
+{
+    matchKeyLength_ = 0;
+    matchKey_[0] = '\0';
+    eventCount_ = 0;
+    dropped_ = 0;
+    playerCount_ = 0;
+}
+
+std::uint8_t MatchTimeline::FindPlayer(std::uintptr_t key) const
+{
+    for (std::size_t i = 0; i < playerCount_; ++i)
+    {
+        if (players_[i].key == key)
+        {
+            return static_cast<std::uint8_t>(i);
+        }
+    }
+    return kTimelineNoPlayer;
+}
+
+std::uint8_t MatchTimeline::AddPlayer(std::uintptr_t key, std::uint8_t team, const std::string& name)
+{
+    if (playerCount_ == kPlayerCapacity)
+    {
+        return kTimelineNoPlayer;
+    }
+
+    TimelinePlayer& player = players_[playerCount_];
+    player.key = key;
+    player.team = team;
+    const std::size_t copied = name.copy(player.name, sizeof(player.name) - 1);
+    player.name[copied] = '\0';
+    return static_cast<std::uint8_t>(playerCount_++);
+}
+
+bool MatchTimeline::Append(const TimelineEvent& event)
+{
+    if (eventCount_ == kEventCapacity)
+    {
+        ++dropped_;
+        return false;
+    }
+
+    events_[eventCount_++] = event;
+    return true;
+}
+
+bool MatchTimeline::AttachAssist(std::uint8_t team, std::uint8_t assister, std::uint16_t seconds)
+{
+    for (std::size_t i = eventCount_; i > 0; --i)
+    {
+        TimelineEvent& event = events_[i - 1];
+        if (event.seconds + kAssistWindowSeconds < seconds)
+        {
+            break;
+        }
+        if (event.type == TimelineEventType::Goal && event.team == team)
+        {
+            if (event.other != kTimelineNoPlayer || event.actor == assister)
+            {
+                return false;
+            }
+            event.other = assister;
+            return true;
+        }
+    }
+    return false;
+}
+
+void MatchTimeline::AppendEncodedEvents(std::string& out) const
+{
+    out.reserve(out.size() + eventCount_ * 12);
+
+    std::uint16_t previous = 0;
+    for (std::size_t i = 0; i < eventCount_; ++i)
+    {
+        const TimelineEvent& event = events_[i];
+        if (i > 0)
+        {
+            out += ';';
+        }
+
+        // Events are appended in game order, but the clock can step back after a
+        // goal replay; clamp so deltas stay non-negative.
+        const std::uint16_t delta = event.seconds >= previous ? static_cast<std::uint16_t>(event.seconds - previous) : 0;
+        previous = event.seconds >= previous ? event.seconds : previous;
+
+        out += std::to_string(delta);
+        out += ',';
+        out += EventCode(event.type);
+        if (event.type == TimelineEventType::Overtime)
+        {
+            continue;
+        }
+
+        out += ',';
+        out += std::to_string(event.team);
+        if (event.actor == kTimelineNoPlayer)
+        {
+            continue;
+        }
+        out += ',';
+        out += std::to_string(event.actor);
+        if (event.other != kTimelineNoPlayer)
+        {
+            out += ',';
+            out += std::to_string(event.other);
+        }
+    }
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+enum class TimelineEventType : std::uint8_t {
+    Goal,
+    Demolish,
+    Overtime
+};
+
+constexpr std::uint8_t kTimelineNoPlayer = 0xFF;
+
+// One fixed-size record. actor/other index the timeline's player slots:
+// scorer/assister for goals, attacker/victim for demolitions.
+struct TimelineEvent {
+    std::uint16_t seconds;
+    TimelineEventType type;
+    std::uint8_t team;
+    std::uint8_t actor;
+    std::uint8_t other;
+};
+
+struct TimelinePlayer {
+    std::uintptr_t key; // PRI address; stable for the lifetime of the match
+    std::uint8_t team;
+    char name[32];
+};
+
+// Per-match event log backed by fixed arrays, so recording an event never touches
+// the heap. Owned by the game thread: hooks append, the match upload reads.
+class MatchTimeline {
+public:
+    static constexpr std::size_t kEventCapacity = 512;
+    static constexpr std::size_t kPlayerCapacity = 16;
+
+    // Starts a new match when matchKey (the match GUID, or a local key offline)
+    // differs from the current one. Keys longer than kKeyCapacity are truncated.
+    void BeginMatch(std::string_view matchKey);
+    bool IsMatch(std::string_view matchKey) const;
+    // Forgets the current match once its timeline has been uploaded.
+    void EndMatch();
+
+    // Returns the slot for key, or kTimelineNoPlayer when unknown.
+    std::uint8_t FindPlayer(std::uintptr_t key) const;
+    // Adds a slot; returns kTimelineNoPlayer when the player table is full.
+    std::uint8_t AddPlayer(std::uintptr_t key, std::uint8_t team, const std::string& name);
+
+    bool Append(const TimelineEvent& event);
+    // Assist ticker messages arrive right after the goal; fills the assister of the
+    // newest goal for that team if it has none yet.
+    bool AttachAssist(std::uint8_t team, std::uint8_t assister, std::uint16_t seconds);
+
+    std::size_t EventCount() const { return eventCount_; }
+    std::size_t DroppedEvents() const { return dropped_; }
+    std::size_t PlayerCount() const { return playerCount_; }
+    const TimelinePlayer& Player(std::size_t index) const { return players_[index]; }
+
+    // Compact form: events separated by ';', fields by ','. Each event is
+    // "<seconds since previous event>,<G|D|O>[,<team>,<actor>[,<other>]]"; trailing
+    // unknown fields are omitted. A 30-event overtime match is a few hundred bytes.
+    void AppendEncodedEvents(std::string& out) const;
+
+    static constexpr std::size_t kKeyCapacity = 47;
+
+private:
+    void Clear();
+
+    std::array<char, kKeyCapacity + 1> matchKey_{};
+    std::size_t matchKeyLength_ = 0;
+    std::array<TimelineEvent, kEventCapacity> events_{};
+    std::size_t eventCount_ = 0;
+    std::size_t dropped_ = 0;
+    std::array<TimelinePlayer, kPlayerCapacity> players_{};
+    std::size_t playerCount_ = 0;
+};
@@ -0,0 +1,163 @@
+#include "pch.h"
+#include "MemoryTracker.h"
+
+#include <cstdlib>
+#include <limits>
+#include <new>
+
+std::atomic<bool> MemoryTracker::enabled_{false};
+
+namespace
+{
+    constexpr std::size_t kSubsystemCount = static_cast<std::size_t>(MemorySubsystem::Count);
+
+    // All counters are constant-initialized so tracked containers with static storage
+    // can use them before (and after) the plugin's dynamic initializers run.
+    struct SubsystemCounters
+    {
+        std::atomic<std::int64_t> liveBytes{0};
+        std::atomic<std::int64_t> peakBytes{0};
+        std::atomic<std::uint64_t> allocations{0};
+        std::atomic<std::uint64_t> frees{0};
+    };
+
+    SubsystemCounters g_counters[kSubsystemCount];
+    thread_local MemorySubsystem t_subsystem = MemorySubsystem::Other;
+    thread_local std::uint64_t t_allocations = 0;
+
+    constexpr const char* kSubsystemNames[kSubsystemCount] = {"other", "logger", "serializer", "transport", "ui"};
+}
+
+void MemoryTracker::SetEnabled(bool enabled)
+{
+    enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+const char* MemoryTracker::SubsystemName(MemorySubsystem subsystem)
+{
+    const auto index = static_cast<std::size_t>(subsystem);
+    return index < kSubsystemCount ? kSubsystemNames[index] : "unknown";
+}
+
+MemorySubsystem MemoryTracker::CurrentSubsystem()
+{
+    return t_subsystem;
+}
+
+void MemoryTracker::SetCurrentSubsystem(MemorySubsystem subsystem)
+{
+    t_subsystem = subsystem;
+}
+
+void MemoryTracker::RecordAlloc(MemorySubsystem subsystem, std::size_t bytes)
+{
+    ++t_allocations;
+    SubsystemCounters& counters = g_counters[static_cast<std::size_t>(subsystem)];
+    counters.allocations.fetch_add(1, std::memory_order_relaxed);
+    const std::int64_t live = counters.liveBytes.fetch_add(static_cast<std::int64_t>(bytes), std::memory_order_relaxed) +
+                              static_cast<std::int64_t>(bytes);
+
+    std::int64_t peak = counters.peakBytes.load(std::memory_order_relaxed);
+    while (live > peak && !counters.peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+    {
+    }
+}
+
+void MemoryTracker::RecordFree(MemorySubsystem subsystem, std::size_t bytes)
+{
+    SubsystemCounters& counters = g_counters[static_cast<std::size_t>(subsystem)];
+    counters.frees.fetch_add(1, std::memory_order_relaxed);
+    counters.liveBytes.fetch_sub(static_cast<std::int64_t>(bytes), std::memory_order_relaxed);
+}
+
+MemorySnapshot MemoryTracker::Snapshot()
+{
+    MemorySnapshot snapshot{};
+    for (std::size_t i = 0; i < kSubsystemCount; ++i)
+    {
+        snapshot[i].liveBytes = g_counters[i].liveBytes.load(std::memory_order_relaxed);
+        snapshot[i].peakBytes = g_counters[i].peakBytes.load(std::memory_order_relaxed);
+        snapshot[i].allocations = g_counters[i].allocations.load(std::memory_order_relaxed);
+        snapshot[i].frees = g_counters[i].frees.load(std::memory_order_relaxed);
+    }
+    return snapshot;
+}
+
+std::uint64_t MemoryTracker::TotalAllocations()
+{
+    std::uint64_t total = 0;
+    for (const auto& counters : g_counters)
+    {
+        total += counters.allocations.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+std::uint64_t MemoryTracker::ThreadAllocations()
+{
+    return t_allocations;
+}
+
+void MemoryTracker::ResetPeaks()
+{
+    for (auto& counters : g_counters)
+    {
+        counters.peakBytes.store(counters.liveBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+}
+
+namespace
+{
+    // Blocks allocated while tracking was off are marked uncounted so toggling the
+    // cvar never drives live bytes negative.
+    constexpr std::uint8_t kUncounted = 0xFF;
+
+    struct AllocationHeader
+    {
+        std::size_t size;
+        std::uint8_t subsystem;
+    };
+
+    constexpr std::size_t kHeaderSize = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+    static_assert(sizeof(AllocationHeader) <= kHeaderSize, "allocation header must fit in the alignment padding");
+}
+
+void* MemoryTracker::Allocate(std::size_t bytes)
+{
+    if (bytes > std::numeric_limits<std::size_t>::max() - kHeaderSize)
+    {
+        throw std::bad_alloc();
+    }
+    void* raw = std::malloc(bytes + kHeaderSize);
+    if (!raw)
+    {
+        throw std::bad_alloc();
+    }
+
+    auto* header = static_cast<AllocationHeader*>(raw);
+    header->size = bytes;
+    header->subsystem = kUncounted;
+    if (IsEnabled())
+    {
+        const MemorySubsystem subsystem = CurrentSubsystem();
+        header->subsystem = static_cast<std::uint8_t>(subsystem);
+        RecordAlloc(subsystem, bytes);
+    }
+    return static_cast<unsigned char*>(raw) + kHeaderSize;
+}
+
+void MemoryTracker::Deallocate(void* ptr) noexcept
+{
+    if (!ptr)
+    {
+        return;
+    }
+
+    void* raw = static_cast<unsigned char*>(ptr) - kHeaderSize;
+    const auto* header = static_cast<const AllocationHeader*>(raw);
+    if (header->subsystem != kUncounted)
+    {
+        RecordFree(static_cast<MemorySubsystem>(header->subsystem), header->size);
+    }
+    std::free(raw);
+}
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <string>
+#include <utility>
+
+// Opt-in allocation accounting. Build with RTJ_MEMORY_TRACKING defined to count the
+// buffers the plugin builds through TrackedAllocator (payload streams, log lines,
+// response buffers, overlay text); rtj_memory_tracking then switches the counting on at runtime.
+// Global operator new/delete are left alone, so blocks from the SDK or the host are
+// never touched. Without the define the scopes and the allocator compile away.
+enum class MemorySubsystem : std::uint8_t {
+    Other,
+    Logger,
+    Serializer,
+    Transport,
+    UI,
+    Count
+};
+
+struct MemorySubsystemStats {
+    std::int64_t liveBytes = 0;
+    std::int64_t peakBytes = 0;
+    std::uint64_t allocations = 0;
+    std::uint64_t frees = 0;
+};
+
+using MemorySnapshot = std::array<MemorySubsystemStats, static_cast<std::size_t>(MemorySubsystem::Count)>;
+
+class MemoryTracker {
+public:
+    static constexpr bool IsCompiledIn()
+    {
+#ifdef RTJ_MEMORY_TRACKING
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    static void SetEnabled(bool enabled);
+    static bool IsEnabled() { return enabled_.load(std::memory_order_relaxed); }
+
+    static const char* SubsystemName(MemorySubsystem subsystem);
+
+    // Attribution for allocations made on the calling thread; see MemoryScope.
+    static MemorySubsystem CurrentSubsystem();
+    static void SetCurrentSubsystem(MemorySubsystem subsystem);
+
+    // Called by Allocate/Deallocate. Safe to call before static init.
+    static void RecordAlloc(MemorySubsystem subsystem, std::size_t bytes);
+    static void RecordFree(MemorySubsystem subsystem, std::size_t bytes);
+
+    static MemorySnapshot Snapshot();
+    static std::uint64_t TotalAllocations();
+    // Counted allocations made by the calling thread; deltas give a per-call cost.
+    static std::uint64_t ThreadAllocations();
+    static void ResetPeaks();
+
+    // Backing store for TrackedAllocator. Each block carries its size and subsystem so
+    // the free is attributed correctly on any thread; only Deallocate may free it.
+    static void* Allocate(std::size_t bytes);
+    static void Deallocate(void* ptr) noexcept;
+
+private:
+    static std::atomic<bool> enabled_;
+};
+
+class MemoryScope {
+public:
+    explicit MemoryScope(MemorySubsystem subsystem)
+        : previous_(MemoryTracker::CurrentSubsystem())
+    {
+        MemoryTracker::SetCurrentSubsystem(subsystem);
+    }
+
+    ~MemoryScope() { MemoryTracker::SetCurrentSubsystem(previous_); }
+
+    MemoryScope(const MemoryScope&) = delete;
+    MemoryScope& operator=(const MemoryScope&) = delete;
+
+private:
+    MemorySubsystem previous_;
+};
+
+#ifdef RTJ_MEMORY_TRACKING
+#define RTJ_MEMORY_CONCAT_INNER(a, b) a##b
+#define RTJ_MEMORY_CONCAT(a, b) RTJ_MEMORY_CONCAT_INNER(a, b)
+#define RTJ_MEMORY_SCOPE(subsystem) MemoryScope RTJ_MEMORY_CONCAT(rtjMemoryScope_, __LINE__)(MemorySubsystem::subsystem)
+#else
+#define RTJ_MEMORY_SCOPE(subsystem) ((void)0)
+#endif
+
+#ifdef RTJ_MEMORY_TRACKING
+// Counts into the calling thread's current MemoryScope. Stateless, so any two
+// instances can free each other's blocks.
+template <typename T>
+class TrackedAllocator {
+public:
+    using value_type = T;
+
+    TrackedAllocator() noexcept = default;
+    template <typename U>
+    TrackedAllocator(const TrackedAllocator<U>&) noexcept
+    {
+    }
+
+    T* allocate(std::size_t count)
+    {
+        static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__, "over-aligned types are not tracked");
+        if (count > std::numeric_limits<std::size_t>::max() / sizeof(T))
+        {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T*>(MemoryTracker::Allocate(count * sizeof(T)));
+    }
+
+    void deallocate(T* ptr, std::size_t) noexcept { MemoryTracker::Deallocate(ptr); }
+
+    template <typename U>
+    bool operator==(const TrackedAllocator<U>&) const noexcept
+    {
+        return true;
+    }
+    template <typename U>
+    bool operator!=(const TrackedAllocator<U>&) const noexcept
+    {
+        return false;
+    }
+};
+#else
+template <typename T>
+using TrackedAllocator = std::allocator<T>;
+#endif
+
+using TrackedString = std::basic_string<char, std::char_traits<char>, TrackedAllocator<char>>;
+using TrackedOStringStream = std::basic_ostringstream<char, std::char_traits<char>, TrackedAllocator<char>>;
+
+// Hands a tracked buffer to code that takes std::string; a plain move when tracking
+// is compiled out.
+inline std::string ToStdString(TrackedString&& value)
+{
+#ifdef RTJ_MEMORY_TRACKING
+    return std::string(value.data(), value.size());
+#else
+    return std::move(value);
+#endif
+}
+
+inline std::string ToStdString(const TrackedOStringStream& stream)
+{
+    return ToStdString(stream.str());
+}
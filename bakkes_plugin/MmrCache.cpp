@@ -0,0 +1,98 @@
+#include "pch.h"
+#include "MmrCache.h"
+#include "TraceRecorder.h"
+
+#include "bakkesmod/wrappers/GameWrapper.h"
+#include "bakkesmod/wrappers/MMRWrapper.h"
+#include "bakkesmod/wrappers/UniqueIDWrapper.h"
+
+#include <utility>
+
+float MmrSnapshot::Rating(int playlistId) const
+{
+    const PlaylistInfo* info = PlaylistRegistry::FindById(playlistId);
+    return info ? ratings[static_cast<std::size_t>(info - PlaylistRegistry::kPlaylists)] : 0.0f;
+}
+
+MmrCache::MmrCache(UniqueIdCheck hasValidUniqueId, std::chrono::milliseconds ttl)
+    : hasValidUniqueId_(std::move(hasValidUniqueId))
+    , ttl_(ttl)
+{
+}
+
+MmrSnapshot MmrCache::ReadAllPlaylists(GameWrapper& gameWrapper) const
+{
+    RTJ_TRACE_SCOPE("ReadMmrSnapshot");
+    MmrSnapshot snapshot;
+    const auto started = std::chrono::steady_clock::now();
+    snapshot.readAt = started;
+
+    MMRWrapper mmrWrapper = gameWrapper.GetMMRWrapper();
+    UniqueIDWrapper uniqueId = gameWrapper.GetUniqueID();
+    // GetMMRWrapper, GetUniqueID and the ID check's GetUID. On Epic accounts the check
+    // also reads the Epic account ID, which is not counted.
+    snapshot.wrapperCalls = 3;
+    if (mmrWrapper.memory_address != 0 && hasValidUniqueId_(uniqueId))
+    {
+        snapshot.valid = true;
+        for (std::size_t i = 0; i < PlaylistRegistry::kPlaylistCount; ++i)
+        {
+            // One try around the loop would lose every later playlist to one bad read.
+            try
+            {
+                ++snapshot.wrapperCalls;
+                snapshot.ratings[i] = mmrWrapper.GetPlayerMMR(uniqueId, PlaylistRegistry::kPlaylists[i].playlistId);
+            }
+            catch (...)
+            {
+                snapshot.ratings[i] = 0.0f;
+            }
+        }
+    }
+
+    snapshot.micros = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - started).count();
+    return snapshot;
+}
+
+MmrSnapshot MmrCache::Get(GameWrapper& gameWrapper)
+{
+    const auto now = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (hasSnapshot_ && now - snapshot_.readAt < ttl_)
+        {
+            ++stats_.hits;
+            return snapshot_;
+        }
+    }
+
+    // Read outside the lock so the overlay never waits on the game.
+    MmrSnapshot snapshot = ReadAllPlaylists(gameWrapper);
+    std::lock_guard<std::mutex> lock(mutex_);
+    snapshot_ = snapshot;
+    hasSnapshot_ = true;
+    ++stats_.reads;
+    stats_.totalMicros += snapshot.micros;
+    return snapshot;
+}
+
+MmrSnapshot MmrCache::Latest() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return snapshot_;
+}
+
+void MmrCache::Restore(const MmrSnapshot& snapshot)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!hasSnapshot_)
+    {
+        snapshot_ = snapshot;
+    }
+}
+
+MmrCacheStats MmrCache::Stats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+
+#include "PlaylistRegistry.h"
+
+class GameWrapper;
+class UniqueIDWrapper;
+
+// Every PlaylistRegistry playlist's rating from one read: the MMR wrapper and the
+// unique ID are resolved once, then GetPlayerMMR is called per playlist.
+struct MmrSnapshot {
+    bool valid = false; // false when the MMR wrapper or the unique ID was unavailable
+    std::array<float, PlaylistRegistry::kPlaylistCount> ratings{}; // indexed like kPlaylists; 0 = no rating
+    std::chrono::steady_clock::time_point readAt;
+    std::size_t wrapperCalls = 0;
+    std::int64_t micros = 0; // game-thread time for the whole read
+
+    // 0 for playlists outside the registry.
+    float Rating(int playlistId) const;
+};
+
+struct MmrCacheStats {
+    std::uint64_t reads = 0;
+    std::uint64_t hits = 0;
+    std::int64_t totalMicros = 0;
+};
+
+// Serves the match payload, the snapshot upload and the overlay from one read, so
+// consumers within the TTL of each other cost a single pass. Get runs on the game
+// thread; Latest and Stats may be called from any thread.
+class MmrCache {
+public:
+    // Decides whether the player's unique ID can be used for GetPlayerMMR; the plugin
+    // passes its own HasValidUniqueId so both paths apply the same rule.
+    using UniqueIdCheck = std::function<bool(UniqueIDWrapper&)>;
+
+    explicit MmrCache(UniqueIdCheck hasValidUniqueId, std::chrono::milliseconds ttl = std::chrono::milliseconds(1000));
+
+    // The cached snapshot, read again once it is older than the TTL.
+    MmrSnapshot Get(GameWrapper& gameWrapper);
+    // The last snapshot read; never touches the game.
+    MmrSnapshot Latest() const;
+    // Seeds Latest() with a snapshot saved by a previous run. Get still reads the
+    // game before serving anything.
+    void Restore(const MmrSnapshot& snapshot);
+    MmrCacheStats Stats() const;
+
+private:
+    MmrSnapshot ReadAllPlaylists(GameWrapper& gameWrapper) const;
+
+    UniqueIdCheck hasValidUniqueId_;
+    std::chrono::milliseconds ttl_;
+    mutable std::mutex mutex_;
+    MmrSnapshot snapshot_;
+    bool hasSnapshot_ = false;
+    MmrCacheStats stats_;
+};
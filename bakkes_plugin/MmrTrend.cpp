@@ -0,0 +1,125 @@
+#include "pch.h"
+#include "MmrTrend.h"
+
+#include <algorithm>
+#include <cmath>
+
+void MmrTrend::Append(float mmr)
+{
+    if (levels_.empty())
+    {
+        levels_.emplace_back();
+    }
+    const TrendPoint point{static_cast<std::uint32_t>(levels_[0].points.size()), mmr};
+    levels_[0].points.push_back(point);
+    Push(1, point);
+}
+
+std::size_t MmrTrend::Size() const
+{
+    return levels_.empty() ? 0 : levels_[0].points.size();
+}
+
+void MmrTrend::Push(std::size_t level, const TrendPoint& point)
+{
+    if (level >= kMaxLevels)
+    {
+        return;
+    }
+    if (levels_.size() <= level)
+    {
+        levels_.emplace_back();
+    }
+    Level& current = levels_[level];
+
+    // Every level starts from the first match, as LTTB keeps the first point.
+    if (current.points.empty())
+    {
+        current.points.push_back(point);
+        Push(level + 1, point);
+        return;
+    }
+
+    current.pending[current.pendingCount++] = point;
+    if (current.pendingCount < current.pending.size())
+    {
+        return;
+    }
+
+    // Keep the point of the first bucket that forms the largest triangle with the
+    // last kept point and the average of the next bucket.
+    const TrendPoint& previous = current.points.back();
+    double nextX = 0.0;
+    double nextY = 0.0;
+    for (std::size_t i = kBucket; i < 2 * kBucket; ++i)
+    {
+        nextX += current.pending[i].index;
+        nextY += current.pending[i].mmr;
+    }
+    nextX /= kBucket;
+    nextY /= kBucket;
+
+    std::size_t chosen = 0;
+    double largest = -1.0;
+    for (std::size_t i = 0; i < kBucket; ++i)
+    {
+        const TrendPoint& candidate = current.pending[i];
+        const double area = std::abs((static_cast<double>(previous.index) - nextX) * (candidate.mmr - previous.mmr) -
+                                     (static_cast<double>(previous.index) - candidate.index) * (nextY - previous.mmr));
+        if (area > largest)
+        {
+            largest = area;
+            chosen = i;
+        }
+    }
+
+    const TrendPoint kept = current.pending[chosen];
+    std::copy(current.pending.begin() + kBucket, current.pending.end(), current.pending.begin());
+    current.pendingCount = kBucket;
+    current.points.push_back(kept);
+    // current may move when the next level is added.
+    Push(level + 1, kept);
+}
+
+void MmrTrend::Sample(std::size_t window, std::size_t budget, std::vector<float>& out) const
+{
+    out.clear();
+    const std::size_t size = Size();
+    if (size == 0 || budget < 2)
+    {
+        return;
+    }
+    if (window == 0 || window > size)
+    {
+        window = size;
+    }
+    const std::uint32_t first = static_cast<std::uint32_t>(size - window);
+
+    std::size_t level = 0;
+    std::size_t span = 1;
+    // +2: the window's first kept point, and the newest match, which a coarse level
+    // has not reached yet.
+    while (level + 1 < levels_.size() && window / span + 2 > budget)
+    {
+        ++level;
+        span *= kBucket;
+    }
+
+    const std::vector<TrendPoint>& points = levels_[level].points;
+    auto begin = std::lower_bound(points.begin(), points.end(), first, [](const TrendPoint& point, std::uint32_t index) {
+        return point.index < index;
+    });
+    // Only the top level can hold more than the budget; its oldest points are dropped.
+    if (static_cast<std::size_t>(points.end() - begin) > budget - 1)
+    {
+        begin = points.end() - static_cast<std::ptrdiff_t>(budget - 1);
+    }
+    for (auto it = begin; it != points.end(); ++it)
+    {
+        out.push_back(it->mmr);
+    }
+    if (points.empty() || points.back().index != size - 1)
+    {
+        out.push_back(levels_[0].points.back().mmr);
+    }
+}
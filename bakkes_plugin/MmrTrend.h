@@ -0,0 +1,42 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct TrendPoint {
+    std::uint32_t index = 0; // match number within the playlist, oldest = 0
+    float mmr = 0.0f;
+};
+
+// One playlist's MMR per match, kept as a pyramid of largest-triangle-three-buckets
+// series: each level keeps one point of every kBucket points of the level below. A
+// bucket is reduced as soon as the bucket after it is complete, so Append touches
+// each level once per kBucket points of the level below: O(1) amortized, with no
+// rebuild. Not thread-safe.
+class MmrTrend {
+public:
+    static constexpr std::size_t kBucket = 4;
+    static constexpr std::size_t kMaxLevels = 8; // the top level keeps 1 point per 4^7 matches
+
+    void Append(float mmr);
+    std::size_t Size() const;
+
+    // Ratings covering the last `window` matches (0 = all) from the finest level that
+    // needs at most `budget` points, oldest first and ending at the newest match.
+    void Sample(std::size_t window, std::size_t budget, std::vector<float>& out) const;
+
+private:
+    struct Level {
+        std::vector<TrendPoint> points; // kept points, oldest first
+        // Points from the level below not reduced yet: the bucket being reduced and
+        // the one whose average it is compared against.
+        std::array<TrendPoint, 2 * kBucket> pending{};
+        std::size_t pendingCount = 0;
+    };
+
+    void Push(std::size_t level, const TrendPoint& point);
+
+    std::vector<Level> levels_; // levels_[0].points holds every match
+};
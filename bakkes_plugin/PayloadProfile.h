@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+// Named field sets for upload payloads, selected with rtj_payload_profile. Each
+// profile maps to a policy struct; the payload builders are templates over the
+// policy and use if constexpr, so fields a profile leaves out are never read from
+// the game nor serialized.
+enum class PayloadProfile : std::uint8_t {
+    Minimal,  // timestamp, playlist, MMR: the fields /api/mmr-log stores
+    Standard, // + rank, userId, teams, scoreboard and goal/demo timeline
+    Full      // + match metadata and extended player stats (demos, touches, boost, MVP, platform ID)
+};
+
+struct MinimalPayloadPolicy {
+    static constexpr PayloadProfile kProfile = PayloadProfile::Minimal;
+    static constexpr bool kRank = false;
+    static constexpr bool kUserId = false;
+    static constexpr bool kTeams = false;
+    static constexpr bool kScoreboard = false;
+    static constexpr bool kTimeline = false;
+    static constexpr bool kMatchMetadata = false;
+    static constexpr bool kExtendedPlayerStats = false;
+};
+
+struct StandardPayloadPolicy {
+    static constexpr PayloadProfile kProfile = PayloadProfile::Standard;
+    static constexpr bool kRank = true;
+    static constexpr bool kUserId = true;
+    static constexpr bool kTeams = true;
+    static constexpr bool kScoreboard = true;
+    static constexpr bool kTimeline = true;
+    static constexpr bool kMatchMetadata = false;
+    static constexpr bool kExtendedPlayerStats = false;
+};
+
+struct FullPayloadPolicy {
+    static constexpr PayloadProfile kProfile = PayloadProfile::Full;
+    static constexpr bool kRank = true;
+    static constexpr bool kUserId = true;
+    static constexpr bool kTeams = true;
+    static constexpr bool kScoreboard = true;
+    static constexpr bool kTimeline = true;
+    static constexpr bool kMatchMetadata = true;
+    static constexpr bool kExtendedPlayerStats = true;
+};
+
+constexpr const char* PayloadProfileName(PayloadProfile profile)
+{
+    switch (profile)
+    {
+    case PayloadProfile::Minimal:
+        return "minimal";
+    case PayloadProfile::Full:
+        return "full";
+    case PayloadProfile::Standard:
+    default:
+        return "standard";
+    }
+}
+
+// Returns false (and leaves profile untouched) for unknown names.
+inline bool ParsePayloadProfile(const char* name, PayloadProfile& profile)
+{
+    for (PayloadProfile candidate : {PayloadProfile::Minimal, PayloadProfile::Standard, PayloadProfile::Full})
+    {
+        if (name && std::strcmp(name, PayloadProfileName(candidate)) == 0)
+        {
+            profile = candidate;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,207 @@
+#include "pch.h"
+#include "PayloadSink.h"
+#include "DiagnosticLogger.h"
+
+#include <algorithm>
+#include <system_error>
+
+namespace
+{
+    constexpr std::chrono::milliseconds kFirstRetry{1000};
+    constexpr std::chrono::milliseconds kMaxRetry{60000};
+}
+
+PayloadSink::PayloadSink(std::string name)
+    : name_(std::move(name))
+{
+}
+
+PayloadSink::~PayloadSink()
+{
+    Stop();
+}
+
+void PayloadSink::Start()
+{
+    worker_ = std::thread([this]() { Run(); });
+}
+
+void PayloadSink::Submit(SharedPayload payload)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_)
+        {
+            return;
+        }
+        if (queue_.size() >= kMaxQueued)
+        {
+            queue_.pop_front();
+            ++stats_.dropped;
+        }
+        queue_.push_back(std::move(payload));
+    }
+    wake_.notify_one();
+}
+
+SinkStats PayloadSink::Stats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    SinkStats stats = stats_;
+    stats.queued = queue_.size();
+    return stats;
+}
+
+void PayloadSink::BeginStop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_)
+        {
+            return;
+        }
+        stopping_ = true;
+        drainDeadline_ = std::chrono::steady_clock::now() + kDrainTime;
+    }
+    wake_.notify_all();
+}
+
+void PayloadSink::Stop()
+{
+    BeginStop();
+    if (worker_.joinable())
+    {
+        worker_.join();
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!queue_.empty())
+    {
+        DiagnosticLogger::Log("PayloadSink " + name_ + ": dropped " + std::to_string(queue_.size()) + " undelivered at stop");
+    }
+    stats_.dropped += queue_.size();
+    queue_.clear();
+}
+
+void PayloadSink::Run()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true)
+    {
+        wake_.wait(lock, [this]() { return stopping_ || !queue_.empty(); });
+        if (stopping_ && (queue_.empty() || std::chrono::steady_clock::now() >= drainDeadline_))
+        {
+            return;
+        }
+
+        // The payload stays queued while it is delivered; only this thread pops.
+        const SharedPayload payload = queue_.front();
+        lock.unlock();
+        const auto started = std::chrono::steady_clock::now();
+        std::string error;
+        const SinkResult result = Deliver(*payload, error);
+        const std::uint64_t micros = static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - started).count());
+        lock.lock();
+
+        stats_.totalMicros += micros;
+        stats_.maxMicros = std::max(stats_.maxMicros, micros);
+        if (result == SinkResult::Retry)
+        {
+            ++stats_.failures;
+            stats_.backoff = std::min(kMaxRetry, stats_.backoff.count() == 0 ? kFirstRetry : stats_.backoff * 2);
+            DiagnosticLogger::Log("PayloadSink " + name_ + ": retrying in " + std::to_string(stats_.backoff.count()) + " ms: " + error);
+            // BeginStop can pull the wake-up forward to the drain deadline, so it is
+            // recomputed after every wake.
+            const auto retryAt = std::chrono::steady_clock::now() + stats_.backoff;
+            for (auto until = std::min(retryAt, drainDeadline_); std::chrono::steady_clock::now() < until;
+                 until = std::min(retryAt, drainDeadline_))
+            {
+                wake_.wait_until(lock, until);
+            }
+            continue;
+        }
+
+        if (result == SinkResult::Delivered)
+        {
+            ++stats_.delivered;
+            stats_.bytes += payload->size();
+        }
+        else
+        {
+            ++stats_.rejected;
+            DiagnosticLogger::Log("PayloadSink " + name_ + ": rejected: " + error);
+        }
+        stats_.backoff = std::chrono::milliseconds(0);
+        // A full queue may have pushed this payload out while it was being delivered.
+        if (!queue_.empty() && queue_.front() == payload)
+        {
+            queue_.pop_front();
+        }
+    }
+}
+
+HttpSink::HttpSink(std::string name, const std::string& baseUrl, std::string endpoint, std::vector<HttpHeader> headers)
+    : PayloadSink(std::move(name)),
+      client_(baseUrl),
+      endpoint_(std::move(endpoint)),
+      headers_(std::move(headers))
+{
+    Start();
+}
+
+HttpSink::~HttpSink()
+{
+    Stop();
+}
+
+SinkResult HttpSink::Deliver(const std::string& payload, std::string& error)
+{
+    // Nothing in a mirror's 2xx response is used, so its body is never read.
+    const HttpResponse response = client_.Send("POST", endpoint_, "application/json", payload.data(), payload.size(),
+                                               headers_, ResponseBody::ErrorsOnly);
+    if (response.success)
+    {
+        return SinkResult::Delivered;
+    }
+    error = response.error;
+    // Same rule as the primary outbox: a 4xx other than 408/429 will not succeed later.
+    const bool rejected = response.status >= 400 && response.status < 500 && response.status != 408 && response.status != 429;
+    return rejected ? SinkResult::Rejected : SinkResult::Retry;
+}
+
+ArchiveSink::ArchiveSink(std::string name, std::filesystem::path path)
+    : PayloadSink(std::move(name)),
+      path_(std::move(path))
+{
+    Start();
+}
+
+ArchiveSink::~ArchiveSink()
+{
+    Stop();
+}
+
+SinkResult ArchiveSink::Deliver(const std::string& payload, std::string& error)
+{
+    if (!output_.is_open())
+    {
+        std::error_code ec;
+        std::filesystem::create_directories(path_.parent_path(), ec);
+        output_.clear();
+        output_.open(path_, std::ios::out | std::ios::app | std::ios::binary);
+        if (!output_.is_open())
+        {
+            error = "cannot open " + path_.string();
+            return SinkResult::Retry;
+        }
+    }
+    output_ << payload << '\n';
+    if (!output_.flush())
+    {
+        // Reopened on the retry; a partial line is followed by the full one.
+        output_.close();
+        error = "write failed: " + path_.string();
+        return SinkResult::Retry;
+    }
+    return SinkResult::Delivered;
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ApiClient.h"
+
+// A serialized upload, built once and shared read-only by every sink it goes to.
+using SharedPayload = std::shared_ptr<const std::string>;
+
+enum class SinkResult {
+    Delivered,
+    Retry,    // kept at the head of the queue and tried again after a backoff
+    Rejected, // the destination refused this payload; resending cannot help
+};
+
+struct SinkStats {
+    std::uint64_t delivered = 0;
+    std::uint64_t failures = 0; // failed attempts; each is retried
+    std::uint64_t rejected = 0;
+    std::uint64_t dropped = 0;  // pushed out of a full queue, or still queued when Stop's drain ran out
+    std::uint64_t bytes = 0;
+    std::uint64_t totalMicros = 0;
+    std::uint64_t maxMicros = 0;
+    std::size_t queued = 0;
+    std::chrono::milliseconds backoff{0}; // current wait before the next retry
+};
+
+// A destination for captured matches besides the primary API. Each sink has its own
+// queue, retry state and worker thread, so a slow or unreachable one only delays
+// itself. Submit never blocks on delivery.
+class PayloadSink {
+public:
+    static constexpr std::size_t kMaxQueued = 1000;
+    // How long a stopping sink keeps delivering what is already queued.
+    static constexpr std::chrono::milliseconds kDrainTime{2000};
+
+    explicit PayloadSink(std::string name);
+    virtual ~PayloadSink();
+
+    PayloadSink(const PayloadSink&) = delete;
+    PayloadSink& operator=(const PayloadSink&) = delete;
+
+    const std::string& Name() const { return name_; }
+    void Submit(SharedPayload payload);
+    SinkStats Stats() const;
+
+    // Refuses further payloads and gives the worker kDrainTime to deliver the queue;
+    // returns at once, so the drain can overlap other shutdown work.
+    void BeginStop();
+    // BeginStop, then waits for the worker; whatever it did not deliver is dropped.
+    // Derived destructors call this before their members go away.
+    void Stop();
+
+protected:
+    // Starts the worker; the last line of a derived constructor.
+    void Start();
+    // Runs on the worker.
+    virtual SinkResult Deliver(const std::string& payload, std::string& error) = 0;
+
+private:
+    void Run();
+
+    std::string name_;
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    std::deque<SharedPayload> queue_;
+    SinkStats stats_;
+    bool stopping_ = false;
+    std::chrono::steady_clock::time_point drainDeadline_ = std::chrono::steady_clock::time_point::max();
+    std::thread worker_;
+};
+
+// POSTs each payload to another API, e.g. a mirror of the primary.
+class HttpSink : public PayloadSink {
+public:
+    HttpSink(std::string name, const std::string& baseUrl, std::string endpoint, std::vector<HttpHeader> headers);
+    ~HttpSink() override;
+
+protected:
+    SinkResult Deliver(const std::string& payload, std::string& error) override;
+
+private:
+    ApiClient client_;
+    std::string endpoint_;
+    std::vector<HttpHeader> headers_;
+};
+
+// Appends each payload as one line of an NDJSON file; the file is the same format
+// /api/history/import accepts.
+class ArchiveSink : public PayloadSink {
+public:
+    ArchiveSink(std::string name, std::filesystem::path path);
+    ~ArchiveSink() override;
+
+protected:
+    SinkResult Deliver(const std::string& payload, std::string& error) override;
+
+private:
+    std::filesystem::path path_;
+    std::ofstream output_; // worker thread only
+};
@@ -0,0 +1,93 @@
+#include "pch.h"
+#include "PlayerTable.h"
+#include "TraceRecorder.h"
+
+#include "bakkesmod/wrappers/arraywrapper.h"
+#include "bakkesmod/wrappers/GameEvent/ServerWrapper.h"
+#include "bakkesmod/wrappers/GameObject/PriWrapper.h"
+#include "bakkesmod/wrappers/UniqueIDWrapper.h"
+#include "bakkesmod/wrappers/Engine/UnrealStringWrapper.h"
+
+#include <chrono>
+
+void PlayerTable::Clear()
+{
+    // Strings are cleared, not released, so their buffers are reused next match.
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        names[i].clear();
+        platformIds[i].clear();
+    }
+    count = 0;
+    skipped = 0;
+    hasExtended = false;
+}
+
+PlayerTableCaptureStats CapturePlayerTable(ServerWrapper server, bool extended, PlayerTable& table)
+{
+    RTJ_TRACE_SCOPE("CapturePlayerTable");
+    const auto started = std::chrono::steady_clock::now();
+
+    PlayerTableCaptureStats stats;
+    table.Clear();
+    table.hasExtended = extended;
+    if (!server)
+    {
+        return stats;
+    }
+
+    ArrayWrapper<PriWrapper> pris = server.GetPRIs();
+    const int priCount = pris.Count();
+    stats.wrapperCalls += 2;
+
+    for (int i = 0; i < priCount; ++i)
+    {
+        PriWrapper pri = pris.Get(i);
+        ++stats.wrapperCalls;
+        if (!pri)
+        {
+            continue;
+        }
+
+        const unsigned char team = pri.GetTeamNum();
+        const bool spectator = pri.GetbIsSpectator() != 0;
+        stats.wrapperCalls += 2;
+        if (spectator || team > 1 || table.count == PlayerTable::kCapacity)
+        {
+            ++table.skipped;
+            continue;
+        }
+
+        const std::size_t row = table.count++;
+        table.teamIndex[row] = team;
+
+        UnrealStringWrapper name = pri.GetPlayerName();
+        table.names[row] = name.IsNull() ? std::string("Unknown") : name.ToString();
+        table.score[row] = pri.GetMatchScore();
+        table.goals[row] = pri.GetMatchGoals();
+        table.assists[row] = pri.GetMatchAssists();
+        table.saves[row] = pri.GetMatchSaves();
+        table.shots[row] = pri.GetMatchShots();
+        stats.wrapperCalls += 7;
+
+        if (extended)
+        {
+            table.demos[row] = pri.GetMatchDemolishes();
+            table.touches[row] = pri.GetBallTouches();
+            table.boostPickups[row] = pri.GetBoostPickups();
+            table.mvp[row] = pri.GetbMatchMVP();
+            table.bot[row] = pri.GetbBot() != 0;
+            stats.wrapperCalls += 5;
+            try {
+                table.platformIds[row] = pri.GetUniqueIdWrapper().GetIdString();
+            } catch(...) {
+                table.platformIds[row].clear();
+            }
+            stats.wrapperCalls += 2;
+        }
+    }
+
+    stats.players = table.count;
+    stats.micros = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - started).count();
+    return stats;
+}
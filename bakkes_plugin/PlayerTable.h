@@ -0,0 +1,49 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+class ServerWrapper;
+
+// Struct-of-arrays scoreboard filled by one walk over the server's PRI list. Every
+// column is sized for kCapacity players up front, and the table is reused across
+// matches so the name/ID strings keep their capacity.
+struct PlayerTable {
+    static constexpr std::size_t kCapacity = 16;
+
+    std::size_t count = 0;
+    std::size_t skipped = 0; // PRIs beyond kCapacity, or spectators without a team
+
+    std::array<std::string, kCapacity> names;
+    std::array<std::string, kCapacity> platformIds;
+    std::array<std::uint8_t, kCapacity> teamIndex{};
+    std::array<int, kCapacity> score{};
+    std::array<int, kCapacity> goals{};
+    std::array<int, kCapacity> assists{};
+    std::array<int, kCapacity> saves{};
+    std::array<int, kCapacity> shots{};
+
+    // Extended columns; only read when the capture asks for them.
+    std::array<int, kCapacity> demos{};
+    std::array<int, kCapacity> touches{};
+    std::array<int, kCapacity> boostPickups{};
+    std::array<bool, kCapacity> mvp{};
+    std::array<bool, kCapacity> bot{};
+    bool hasExtended = false;
+
+    void Clear();
+};
+
+// Wrapper getter calls made by the last capture, for comparing capture strategies.
+struct PlayerTableCaptureStats {
+    std::size_t players = 0;
+    std::size_t wrapperCalls = 0;
+    std::int64_t micros = 0;
+};
+
+// Walks server.GetPRIs() once. Players whose car is gone (demolished, or waiting
+// to respawn when the match ends) are still captured; PRIs that are spectating
+// without a team are skipped.
+PlayerTableCaptureStats CapturePlayerTable(ServerWrapper server, bool extended, PlayerTable& table);
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "RankTable.generated.h"
+
+#include <cstddef>
+
+// Single source of truth for the playlists the plugin knows about: display names sent
+// to the API, whether a snapshot should read the playlist, and which ranks.csv column
+// ranks it.
+struct PlaylistInfo
+{
+    int playlistId;
+    const char* name;
+    RankTableData::RankColumn rankColumn;
+};
+
+namespace PlaylistRegistry
+{
+    using RankTableData::RankColumn;
+
+    constexpr PlaylistInfo kPlaylists[] = {
+        {1, "Ranked Duel", RankColumn::Duel},
+        {2, "Ranked Doubles", RankColumn::Doubles},
+        {3, "Ranked Standard", RankColumn::Standard},
+        {4, "Ranked 4v4", RankColumn::Quads},
+        {7, "Duel (Legacy)", RankColumn::None},
+        {8, "Hoops", RankColumn::Hoops},
+        {10, "Rumble", RankColumn::Rumble},
+        {11, "Dropshot", RankColumn::Dropshot},
+        {12, "Faceoff", RankColumn::None},
+        {13, "Snow Day", RankColumn::SnowDay},
+        {27, "Tournament (2v2)", RankColumn::None},
+        {28, "Tournament (3v3)", RankColumn::None},
+        {34, "Tournament", RankColumn::None},
+    };
+
+    constexpr std::size_t kPlaylistCount = sizeof(kPlaylists) / sizeof(kPlaylists[0]);
+
+    constexpr bool IsSortedById()
+    {
+        for (std::size_t i = 1; i < kPlaylistCount; ++i)
+        {
+            if (kPlaylists[i - 1].playlistId >= kPlaylists[i].playlistId)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+    static_assert(IsSortedById(), "kPlaylists must stay sorted by playlistId");
+
+    // Binary search over kPlaylists; returns nullptr for playlists we do not track.
+    constexpr const PlaylistInfo* FindById(int playlistId)
+    {
+        std::size_t low = 0;
+        std::size_t high = kPlaylistCount;
+        while (low < high)
+        {
+            const std::size_t mid = low + (high - low) / 2;
+            if (kPlaylists[mid].playlistId < playlistId)
+            {
+                low = mid + 1;
+            }
+            else
+            {
+                high = mid;
+            }
+        }
+        return (low < kPlaylistCount && kPlaylists[low].playlistId == playlistId) ? &kPlaylists[low] : nullptr;
+    }
+}
@@ -1,16 +1,38 @@
 #include "pch.h"
 #include "RLTrainingJournal.h"
 #include "ApiClient.h"
+#include "BacklogDocument.h"
 #include "DiagnosticLogger.h"
+#include "HistoryTable.h"
+#include "LiveStream.h"
+#include "MatchHistory.h"
+#include "MatchTimeline.h"
+#include "MemoryTracker.h"
+#include "MmrCache.h"
+#include "MmrTrend.h"
+#include "PayloadProfile.h"
+#include "PayloadSink.h"
+#include "PlayerTable.h"
+#include "PlaylistRegistry.h"
+#include "RankTable.h"
+#include "ReplayUploader.h"
+#include "SessionStats.h"
+#include "SettingsStore.h"
+#include "TraceRecorder.h"
+#include "TrainingSession.h"
+#include "UploadOutbox.h"
 
 #include "bakkesmod/wrappers/GameWrapper.h"
 #include "bakkesmod/wrappers/arraywrapper.h"
 #include "bakkesmod/wrappers/GameEvent/ServerWrapper.h"
 #include "bakkesmod/wrappers/GameEvent/GameSettingPlaylistWrapper.h"
+#include "bakkesmod/wrappers/GameEvent/TrainingEditorWrapper.h"
 #include "bakkesmod/wrappers/GameObject/CarWrapper.h"
 #include "bakkesmod/wrappers/GameObject/PriWrapper.h"
+#include "bakkesmod/wrappers/GameObject/PlayerControllerWrapper.h"
 #include "bakkesmod/wrappers/GameObject/TeamWrapper.h"
 #include "bakkesmod/wrappers/MMRWrapper.h"
+#include "bakkesmod/wrappers/StatEventWrapper.h"
 #include "bakkesmod/wrappers/UniqueIDWrapper.h"
 #include "bakkesmod/wrappers/Engine/UnrealStringWrapper.h"
 
@@ -23,6 +45,7 @@
 #endif
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <ctime>
 #include <cctype>
@@ -62,6 +85,82 @@ namespace
     constexpr char kUserIdCvarName[] = "rtj_user_id";
     constexpr char kGamesPlayedCvarName[] = "rtj_games_played_increment";
     constexpr char kUiEnabledCvarName[] = "rtj_ui_enabled";
+    constexpr char kSessionIdleCvarName[] = "rtj_session_idle_minutes";
+    constexpr char kTraceEnabledCvarName[] = "rtj_trace_enabled";
+    constexpr char kTraceDumpCommand[] = "rtj_trace_dump";
+    constexpr char kMemoryTrackingCvarName[] = "rtj_memory_tracking";
+    constexpr char kPayloadProfileCvarName[] = "rtj_payload_profile";
+    constexpr char kMemoryReportCommand[] = "rtj_memory_report";
+    constexpr char kFlushCommand[] = "rtj_flush";
+    constexpr char kStatsCommand[] = "rtj_stats";
+    constexpr char kBenchCommand[] = "rtj_bench";
+    constexpr double kDefaultFlushSeconds = 5.0;
+    constexpr double kMaxFlushSeconds = 30.0;
+    constexpr int kDefaultBenchIterations = 100;
+    constexpr int kMaxBenchIterations = 10000;
+    constexpr std::size_t kBenchBacklogEntries = 500;
+    constexpr int kBenchRoundTrips = 20;
+    constexpr char kReplayUploadCvarName[] = "rtj_replay_upload";
+    constexpr char kReplayUploadKbpsCvarName[] = "rtj_replay_upload_kbps";
+    constexpr char kReplayDirCvarName[] = "rtj_replay_dir";
+    constexpr char kBulkSyncThresholdCvarName[] = "rtj_bulk_sync_threshold";
+    constexpr char kMirrorBaseUrlCvarName[] = "rtj_mirror_base_url";
+    constexpr char kArchiveCvarName[] = "rtj_archive";
+    constexpr char kLiveUploadsCvarName[] = "rtj_live_uploads";
+    constexpr char kLiveStreamCvarName[] = "rtj_live_stream";
+    constexpr char kLiveStreamRateCvarName[] = "rtj_live_stream_hz";
+    constexpr int kDefaultLiveStreamRate = 4;
+    // Entries per /api/history/import request; keeps each document well under the API's body limit.
+    constexpr std::size_t kBulkSyncBatchSize = 500;
+    // Health probes before an outbox sync; the wait doubles after each failure.
+    constexpr int kOutboxProbeAttempts = 3;
+    constexpr std::chrono::milliseconds kOutboxProbeBackoff{2000};
+    // Rocket League writes the autosaved replay shortly after the match ends.
+    constexpr float kReplayScanDelaySeconds = 10.0f;
+    constexpr auto kReplayMaxAge = std::chrono::minutes(5);
+    constexpr float kSessionIdleCheckSeconds = 60.0f;
+    constexpr std::size_t kHistoryOverlayMatches = 10;
+    // Vertices per trend chart, whatever the window; about one per pixel column.
+    constexpr std::size_t kTrendPlotPoints = 240;
+    constexpr float kHistoryTableHeight = 260.0f;
+    constexpr std::array<float, kHistoryColumnCount> kHistoryColumnWidths = {110.0f, 60.0f, 150.0f, 110.0f, 50.0f, 70.0f, 70.0f};
+    constexpr std::array<const char*, kHistoryColumnCount> kHistoryColumnNames = {"Time", "Type", "Detail", "Result", "MMR", "Latency", "Size"};
+    // Loading screens pass through freeplay; shorter stints with no shots are not sessions.
+    constexpr double kMinTrainingStintSeconds = 60.0;
+
+    // Captures without a context are MMR snapshots; a capture after the replay is
+    // saved re-sends a match already uploaded at match end.
+    UploadLane LaneForContext(const char* contextTag)
+    {
+        if (!contextTag)
+        {
+            return UploadLane::Snapshot;
+        }
+        return std::strcmp(contextTag, "replay_recorded") == 0 ? UploadLane::Correction : UploadLane::Match;
+    }
+
+    // Identifies a match for the timeline and the live stream. Offline matches have no
+    // GUID; the server object identifies the match instead.
+    std::string MatchKeyFor(ServerWrapper server)
+    {
+        std::string key;
+        try {
+            key = server.GetMatchGUID();
+        } catch(...) { key.clear(); }
+        if (key.empty())
+        {
+            key = "local-" + std::to_string(server.memory_address);
+        }
+        return key;
+    }
+
+    // Parameters of GFxHUD_TA.HandleStatTickerMessage.
+    struct StatTickerParams
+    {
+        std::uintptr_t Receiver;
+        std::uintptr_t Victim;
+        std::uintptr_t StatEvent;
+    };
     constexpr char kDefaultBaseUrl[] = "http://localhost:4000";
     constexpr const char* kLocalhostBaseUrl = kDefaultBaseUrl;
     constexpr char kLanBaseUrl[] = "http://192.168.1.236:4000";
@@ -99,46 +198,132 @@ namespace
 
         return std::string("http://") + trimmed;
     }
-}
 
-void RLTrainingJournalPlugin::onLoad()
-{
-    DiagnosticLogger::Log("onLoad: start");
-    if (cvarManager)
+    // Local-time stamp safe for file names (no ':' characters).
+    std::string FileTimestamp()
     {
-        cvarManager->log("RTJ: onLoad() starting");
-        DiagnosticLogger::Log("onLoad: cvarManager present");
-    } else {
-        DiagnosticLogger::Log("onLoad: cvarManager null");
+        std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+        std::tm tmLocal;
+#ifdef _WIN32
+        localtime_s(&tmLocal, &now);
+#else
+        localtime_r(&now, &tmLocal);
+#endif
+        std::ostringstream oss;
+        oss << std::put_time(&tmLocal, "%Y%m%d-%H%M%S");
+        return oss.str();
     }
 
-    RegisterCVars();
-    LoadPersistedSettings();
+    // "HTTP 503 ..." as the blocking client reports failures; 0 for anything else.
+    unsigned long StatusFromResponse(const std::string& response)
+    {
+        return response.rfind("HTTP ", 0) == 0 ? std::strtoul(response.c_str() + 5, nullptr, 10) : 0;
+    }
 
-    DiagnosticLogger::Log("onLoad: RegisterCVars completed");
-    if (cvarManager)
+    // Requests of an outbox sync, built once for both the coroutine and blocking paths.
+    HttpRequest SyncRequest(const char* method, std::string endpoint, const std::vector<HttpHeader>& headers)
     {
-        cvarManager->log("RTJ: registered CVars");
+        HttpRequest request;
+        request.method = method;
+        request.endpoint = std::move(endpoint);
+        request.headers = headers;
+        return request;
     }
 
-    HookMatchEvents();
+    HttpRequest SyncPost(std::string endpoint, const char* contentType, std::string body, const std::vector<HttpHeader>& headers)
+    {
+        HttpRequest request = SyncRequest("POST", std::move(endpoint), headers);
+        request.contentType = contentType;
+        request.body = std::move(body);
+        return request;
+    }
 
-    DiagnosticLogger::Log("onLoad: HookMatchEvents completed");
-    if (cvarManager)
+#if !RTJ_HAVE_COROUTINES
+    // co_await Request without coroutines; the body is copied out of the per-thread buffer.
+    HttpResult SendBlocking(const ApiClient& client, const HttpRequest& request)
+    {
+        const HttpResponse response = client.Send(request.method.c_str(),
+                                                  request.endpoint,
+                                                  request.contentType.empty() ? nullptr : request.contentType.c_str(),
+                                                  request.body.data(),
+                                                  request.body.size(),
+                                                  request.headers);
+        HttpResult result;
+        result.success = response.success;
+        result.status = response.status;
+        result.body.assign(response.body.data(), response.body.size());
+        result.error = response.error;
+        return result;
+    }
+#endif
+
+    TrackedString ShortLocalTime(std::int64_t unixSeconds)
     {
-        cvarManager->log("RTJ: hooked match events");
+        const std::time_t time = static_cast<std::time_t>(unixSeconds);
+        std::tm tmLocal{};
+#ifdef _WIN32
+        localtime_s(&tmLocal, &time);
+#else
+        localtime_r(&time, &tmLocal);
+#endif
+        char buffer[32];
+        std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M", &tmLocal);
+        return buffer;
+    }
+
+    std::uint8_t ClampByte(int value)
+    {
+        return static_cast<std::uint8_t>(std::clamp(value, 0, 255));
+    }
+
+    // %APPDATA%/bakkesmod, or the temp directory when APPDATA is unset.
+    std::filesystem::path ResolveDataRoot()
+    {
+        std::filesystem::path base;
+#ifdef _WIN32
+        char* appdata_env = nullptr;
+        size_t env_len = 0;
+        if (_dupenv_s(&appdata_env, &env_len, "APPDATA") == 0 && appdata_env && appdata_env[0] != '\0')
+        {
+            base = appdata_env;
+        }
+        if (appdata_env)
+        {
+            free(appdata_env);
+        }
+#else
+        const char* appdata_env = std::getenv("APPDATA");
+        if (appdata_env && appdata_env[0] != '\0')
+        {
+            base = appdata_env;
+        }
+#endif
+        if (base.empty())
+        {
+            std::error_code ec;
+            base = std::filesystem::temp_directory_path(ec);
+        }
+        return base / "bakkesmod";
     }
+}
+
+// Only what the game thread needs before the next tick happens here. File reads run
+// on a worker; FinishDeferredLoad applies them and starts uploading.
+void RLTrainingJournalPlugin::onLoad()
+{
+    loadStarted_ = std::chrono::steady_clock::now();
+    dataRoot_ = ResolveDataRoot();
 
+    RegisterCVars();
+    RegisterNotifiers();
+    HookMatchEvents();
+    RecordLoadPhase("register", loadStarted_);
+
+    const auto clientStarted = std::chrono::steady_clock::now();
     try
     {
         std::string baseUrl = cvarManager ? cvarManager->getCvar(kBaseUrlCvarName).getStringValue() : std::string();
-        DiagnosticLogger::Log(std::string("onLoad: creating ApiClient with baseUrl=") + baseUrl);
         apiClient = std::make_unique<ApiClient>(baseUrl);
-        DiagnosticLogger::Log("onLoad: ApiClient created");
-        if (cvarManager)
-        {
-            cvarManager->log("RTJ: ApiClient created");
-        }
     }
     catch (const std::exception& ex)
     {
@@ -149,19 +334,187 @@ void RLTrainingJournalPlugin::onLoad()
         }
     }
 
-    DiagnosticLogger::Log("onLoad: complete");
+#if RTJ_HAVE_COROUTINES
+    uploadExecutor_ = std::make_unique<UploadExecutor>(2);
+#endif
+    uploadLanes_.Start();
+    lifetimeToken_ = std::make_shared<int>(0);
+    RecordLoadPhase("client", clientStarted);
+
+    StartDeferredLoad();
+}
+
+void RLTrainingJournalPlugin::StartDeferredLoad()
+{
+    const std::filesystem::path dataRoot = dataRoot_;
+    std::weak_ptr<int> alive = lifetimeToken_;
+    deferredLoad_ = std::async(std::launch::async, [this, dataRoot, alive]() {
+        const auto started = std::chrono::steady_clock::now();
+        DiagnosticLogger::Init(dataRoot / "rltrainingjournal_logs");
+        const std::filesystem::path dataDir = dataRoot / "rltrainingjournal";
+        settingsStore_.Load(dataDir / "settings.cfg");
+        PersistedSettings settings = ReadPersistedSettings(settingsStore_);
+        // Safe off the game thread: nothing stamps or reads the outbox or the replay
+        // queue until FinishDeferredLoad has run.
+        outbox_.Load(dataDir / "outbox.txt");
+        LoadReplayQueue();
+        {
+            std::lock_guard<std::mutex> historyLock(historyViewMutex_);
+            std::string historyError;
+            if (matchHistory_.Open(dataDir / "match_history.bin", historyError))
+            {
+                std::vector<MatchRecord> records = matchHistory_.RecentAny(matchHistory_.Size());
+                std::reverse(records.begin(), records.end());
+                historyTable_.AddMatches(records);
+            }
+            else
+            {
+                DiagnosticLogger::Log("onLoad: match history unavailable: " + historyError);
+            }
+        }
+        WarmState warm = ReadWarmState(settingsStore_);
+        const std::int64_t micros = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - started).count();
+
+        if (!alive.expired() && gameWrapper)
+        {
+            gameWrapper->Execute([this, alive, settings, warm, micros](GameWrapper*) {
+                if (!alive.expired())
+                {
+                    FinishDeferredLoad(settings, warm, micros);
+                }
+            });
+        }
+    });
+}
+
+void RLTrainingJournalPlugin::FinishDeferredLoad(const PersistedSettings& settings, const WarmState& warm, std::int64_t readMicros)
+{
+    const auto started = std::chrono::steady_clock::now();
+    loadPhases_.emplace_back("read", readMicros);
+
+    ApplyPersistedSettings(settings);
+    mmrCache_.Restore(SnapshotFromWarmState(warm));
+    if (warm.hasHealth)
+    {
+        std::lock_guard<std::mutex> lock(requestMutex);
+        if (!apiHealthKnown_)
+        {
+            apiHealthKnown_ = true;
+            apiReachable_ = warm.apiReachable;
+            apiCheckedAt_ = warm.healthCheckedAt;
+        }
+    }
+
+    loadReady_ = true;
+    ConfigureSinks();
+    ConfigureLiveStream();
+    // Stamped without dispatching; the load sync below sends them with the backlog.
+    for (const auto& [payload, contextTag] : deferredUploads_)
+    {
+        const OutboxEntry entry = outbox_.Stamp(payload);
+        if (contextTag)
+        {
+            CacheLastPayload(entry.body, contextTag);
+        }
+        PublishToSinks(entry);
+    }
+    deferredUploads_.clear();
+    deferredUploads_.shrink_to_fit();
+
+    SyncOutbox("load");
+    ScheduleSessionIdleCheck();
+    StartReplayUploads();
+    RecordLoadPhase("apply", started);
+
+    std::ostringstream line;
+    line << "ready after " << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - loadStarted_).count() << " ms (";
+    for (std::size_t i = 0; i < loadPhases_.size(); ++i)
+    {
+        line << (i > 0 ? ", " : "") << loadPhases_[i].first << ' ' << loadPhases_[i].second << " us";
+    }
+    line << ')';
+    DiagnosticLogger::Log("onLoad: " + line.str());
     if (cvarManager)
     {
         cvarManager->log("Hardstuck plugin loaded");
     }
 }
 
+void RLTrainingJournalPlugin::RecordLoadPhase(const char* name, std::chrono::steady_clock::time_point started)
+{
+    loadPhases_.emplace_back(name, std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - started).count());
+}
+
 void RLTrainingJournalPlugin::onUnload()
 {
-    SavePersistedSettings();
+    // The worker may still be reading the stores closed below. Its FinishDeferredLoad
+    // callback is dropped once lifetimeToken_ is reset.
+    if (deferredLoad_.valid())
+    {
+        deferredLoad_.wait();
+    }
+    // Before the deferred load has applied settings.cfg, saving would overwrite it
+    // with defaults.
+    if (loadReady_)
+    {
+        SavePersistedSettings();
+        SaveWarmState();
+    }
+    settingsStore_.Close();
+    matchHistory_.Close();
+    lifetimeToken_.reset();
+    CloseIdleSession(true);
+    StopReplayUploads();
+    TrainingStint stint;
+    if (trainingTracker_.EndMode(std::chrono::system_clock::now(), stint))
+    {
+        UploadTrainingStint(stint);
+    }
+    // The sinks drain their queues while the uploads below are waited for; sinks_.clear()
+    // then waits at most what is left of PayloadSink::kDrainTime.
+    for (const auto& sink : sinks_)
+    {
+        sink->BeginStop();
+    }
+    // Whatever is still queued starts now, so it is aborted or waited for below.
+    uploadLanes_.Stop();
+#if RTJ_HAVE_COROUTINES
+    // Aborted requests resume their coroutines with an error; Shutdown waits for them.
+    if (apiClient)
+    {
+        apiClient->ShutdownAsync();
+    }
+    if (uploadExecutor_)
+    {
+        uploadExecutor_->Shutdown();
+    }
+#endif
+    sinks_.clear();
+    liveStream_.reset();
     std::lock_guard<std::mutex> lock(requestMutex);
     pendingRequests.clear();
     apiClient.reset();
+    // Matches that ended before the deferred load finished. Its worker was waited for
+    // at the top, so the outbox is loaded; the next load's sync sends them.
+    if (!deferredUploads_.empty())
+    {
+        const std::string count = std::to_string(deferredUploads_.size());
+        if (outbox_.IsLoaded())
+        {
+            for (const auto& deferred : deferredUploads_)
+            {
+                outbox_.Stamp(deferred.first);
+            }
+            DiagnosticLogger::Log("onUnload: stamped " + count + " deferred upload(s) into the outbox");
+        }
+        else
+        {
+            DiagnosticLogger::Log("onUnload: dropped " + count + " deferred upload(s); the outbox never loaded");
+        }
+        deferredUploads_.clear();
+    }
+    // After the uploads, so their acknowledgements reach outbox.txt too.
+    outbox_.Close();
 
     if (gameWrapper)
     {
@@ -202,468 +555,2091 @@ void RLTrainingJournalPlugin::RegisterCVars()
 
     cvarManager->registerCvar(kUserIdCvarName, "test-player", "User identifier sent as X-User-Id when uploading matches");
     cvarManager->registerCvar(kGamesPlayedCvarName, "1", "Increment for gamesPlayedDiff payload field");
+    cvarManager->registerCvar(kSessionIdleCvarName, "30", "Minutes without a finished match before the play session is closed and summarized");
 
-    // notifier stub omitted
-}
+    auto payloadProfile = cvarManager->registerCvar(kPayloadProfileCvarName, PayloadProfileName(PayloadProfile::Standard),
+                                                    "Upload field set: minimal (MMR only), standard, or full (adds match metadata)");
+    payloadProfile.addOnValueChanged([this](std::string, CVarWrapper cvar) {
+        ApplyPayloadProfile(cvar.getStringValue());
+    });
+    ApplyPayloadProfile(payloadProfile.getStringValue());
 
-void RLTrainingJournalPlugin::HookMatchEvents()
-{
-    if (!gameWrapper)
-    {
-        DiagnosticLogger::Log("HookMatchEvents: gameWrapper unavailable");
-        return;
-    }
+    auto traceEnabled = cvarManager->registerCvar(kTraceEnabledCvarName, "0", "Record upload timing spans for rtj_trace_dump (1 = on)");
+    traceEnabled.addOnValueChanged([](std::string, CVarWrapper cvar) {
+        TraceRecorder::SetEnabled(cvar.getBoolValue());
+    });
+    TraceRecorder::SetEnabled(traceEnabled.getBoolValue());
 
-    using std::placeholders::_1;
+    auto memoryTracking = cvarManager->registerCvar(kMemoryTrackingCvarName, "0", "Count plugin allocations per subsystem (needs a build with RTJ_MEMORY_TRACKING)");
+    memoryTracking.addOnValueChanged([](std::string, CVarWrapper cvar) {
+        MemoryTracker::SetEnabled(cvar.getBoolValue());
+    });
+    MemoryTracker::SetEnabled(memoryTracking.getBoolValue());
+
+    cvarManager->registerCvar(kReplayUploadCvarName, "0", "Upload each match's saved .replay file to the journal (1 = on)");
+    cvarManager->registerCvar(kReplayUploadKbpsCvarName, "256", "Replay upload bandwidth cap in KiB/s", true, true, 16.0f, true, 10240.0f);
+    cvarManager->registerCvar(kReplayDirCvarName, "", "Folder Rocket League saves replays to (empty = Documents\\My Games\\Rocket League\\TAGame\\Demos)");
+    auto liveUploads = cvarManager->registerCvar(kLiveUploadsCvarName, LivePolicyName(LivePolicy::Pause),
+                                                 "Background uploads during a live match: pause, throttle (one request every 5 s) or run");
+    liveUploads.addOnValueChanged([this](std::string, CVarWrapper cvar) {
+        ApplyLivePolicy(cvar.getStringValue());
+    });
+    ApplyLivePolicy(liveUploads.getStringValue());
 
-    gameWrapper->HookEventPost("Function TAGame.GameEvent_Soccar_TA.EventMatchEnded",
-                               std::bind(&RLTrainingJournalPlugin::HandleGameEnd, this, _1));
-    gameWrapper->HookEventPost("Function TAGame.GameEvent_Soccar_TA.Destroyed",
-                               std::bind(&RLTrainingJournalPlugin::HandleGameEnd, this, _1));
-    gameWrapper->HookEventPost("Function TAGame.ReplayDirector_TA.EventReplayFinished",
-                               std::bind(&RLTrainingJournalPlugin::HandleReplayRecorded, this, _1));
-    gameWrapper->HookEventPost("Function TAGame.ReplayDirector_TA.EventStopReplay",
-                               std::bind(&RLTrainingJournalPlugin::HandleReplayRecorded, this, _1));
-    DiagnosticLogger::Log("HookMatchEvents: registered automatic upload hooks");
-}
+    cvarManager->registerCvar(kBulkSyncThresholdCvarName, "20", "Pending uploads at which the backlog is sent as one bulk import (0 = never)", true, true, 0.0f, true, 100000.0f);
 
-void RLTrainingJournalPlugin::HandleGameEnd(std::string eventName)
-{
-    DiagnosticLogger::Log(std::string("HandleGameEnd: received ") + eventName);
-    if (!gameWrapper)
-    {
-        return;
-    }
+    // Applied once the deferred load is done; until then nothing is stamped to send.
+    auto mirrorBaseUrl = cvarManager->registerCvar(kMirrorBaseUrlCvarName, "", "Second API that also receives every match upload (empty = off)");
+    mirrorBaseUrl.addOnValueChanged([this](std::string, CVarWrapper) {
+        if (loadReady_)
+        {
+            ConfigureSinks();
+        }
+    });
+    auto archive = cvarManager->registerCvar(kArchiveCvarName, "0", "Append every match upload to rltrainingjournal/archive.ndjson (1 = on)");
+    archive.addOnValueChanged([this](std::string, CVarWrapper) {
+        if (loadReady_)
+        {
+            ConfigureSinks();
+        }
+    });
 
-    gameWrapper->Execute([this](GameWrapper* gw) {
-        ServerWrapper server = ResolveActiveServer(gw);
-        if (!CaptureServerAndUpload(server, "match_end"))
+    auto liveStream = cvarManager->registerCvar(kLiveStreamCvarName, "0", "Stream live score, clock and boost to the journal's dashboard over a WebSocket (1 = on)");
+    liveStream.addOnValueChanged([this](std::string, CVarWrapper) {
+        if (loadReady_)
         {
-            DiagnosticLogger::Log("HandleGameEnd: no active server to capture");
+            ConfigureLiveStream();
+        }
+    });
+    auto liveStreamRate = cvarManager->registerCvar(kLiveStreamRateCvarName, std::to_string(kDefaultLiveStreamRate),
+                                                    "Live stream samples and frames per second", true, true,
+                                                    static_cast<float>(LiveStream::kMinRate), true, static_cast<float>(LiveStream::kMaxRate));
+    liveStreamRate.addOnValueChanged([this](std::string, CVarWrapper cvar) {
+        if (liveStream_)
+        {
+            liveStream_->SetRate(cvar.getIntValue());
         }
     });
 }
 
-void RLTrainingJournalPlugin::HandleReplayRecorded(std::string eventName)
+void RLTrainingJournalPlugin::RegisterNotifiers()
 {
-    DiagnosticLogger::Log(std::string("HandleReplayRecorded: received ") + eventName);
-    if (!gameWrapper)
+    if (!cvarManager)
     {
+        DiagnosticLogger::Log("RegisterNotifiers: cvarManager unavailable, skipping console commands");
         return;
     }
 
-    gameWrapper->Execute([this](GameWrapper* gw) {
-        ServerWrapper server = gw ? gw->GetGameEventAsServer() : ServerWrapper(0);
-        if (!CaptureServerAndUpload(server, "replay_recorded"))
+    cvarManager->registerNotifier(kTraceDumpCommand, [this](std::vector<std::string> args) {
+        DumpTrace(args.size() > 1 ? args[1] : std::string());
+    }, "Write recorded upload spans as Chrome trace JSON. Usage: rtj_trace_dump [path]", PERMISSION_ALL);
+
+    cvarManager->registerNotifier(kMemoryReportCommand, [this](std::vector<std::string> args) {
+        LogMemoryReport(args.size() > 1 && args[1] == "reset");
+    }, "Print per-subsystem allocation counts and high-water marks. Usage: rtj_memory_report [reset]", PERMISSION_ALL);
+
+    cvarManager->registerNotifier(kFlushCommand, [this](std::vector<std::string> args) {
+        double seconds = kDefaultFlushSeconds;
+        try
         {
-            DiagnosticLogger::Log("HandleReplayRecorded: unable to capture replay server");
+            seconds = args.size() > 1 ? std::stod(args[1]) : seconds;
         }
-    });
-}
+        catch (...)
+        {
+        }
+        FlushUploads(std::clamp(seconds, 0.0, kMaxFlushSeconds));
+    }, "Send pending uploads now and wait for them; the game pauses meanwhile. Usage: rtj_flush [seconds, default 5]", PERMISSION_ALL);
 
-std::string RLTrainingJournalPlugin::FormatTimestamp(const std::chrono::system_clock::time_point& timePoint) const
-{
-    std::time_t now = std::chrono::system_clock::to_time_t(timePoint);
-    std::tm tmUtc;
-#ifdef _WIN32
-    gmtime_s(&tmUtc, &now);
-#else
-    gmtime_r(&now, &tmUtc);
-#endif
+    cvarManager->registerNotifier(kStatsCommand, [this](std::vector<std::string>) {
+        LogUploadStats();
+    }, "Print transport, outbox, logger and capture counters", PERMISSION_ALL);
 
-    std::ostringstream oss;
-    oss << std::put_time(&tmUtc, "%Y-%m-%dT%H:%M:%SZ");
-    return oss.str();
+    cvarManager->registerNotifier(kBenchCommand, [this](std::vector<std::string> args) {
+        int iterations = kDefaultBenchIterations;
+        try
+        {
+            iterations = args.size() > 1 ? std::stoi(args[1]) : iterations;
+        }
+        catch (...)
+        {
+        }
+        RunBenchmark(std::clamp(iterations, 1, kMaxBenchIterations));
+    }, "Time payload building and API round trips on this machine. Usage: rtj_bench [iterations, default 100]", PERMISSION_ALL);
 }
 
-std::string RLTrainingJournalPlugin::Escape(const std::string& value) const
+void RLTrainingJournalPlugin::DumpTrace(const std::string& requestedPath)
 {
-    std::ostringstream oss;
-    oss << '"';
-    for (char c : value)
+    std::filesystem::path path = requestedPath.empty()
+        ? GetSettingsPath().parent_path() / "traces" / ("trace-" + FileTimestamp() + ".json")
+        : std::filesystem::path(requestedPath);
+
+    std::size_t spanCount = 0;
+    std::string error;
+    if (!TraceRecorder::WriteChromeTrace(path, spanCount, error))
     {
-        switch (c)
+        DiagnosticLogger::Log("DumpTrace: " + error);
+        if (cvarManager)
         {
-        case '\\':
-            oss << "\\\\";
-            break;
-        case '"':
-            oss << "\\\"";
-            break;
-        case '\n':
-            oss << "\\n";
-            break;
-        case '\r':
-            oss << "\\r";
-            break;
-        case '\t':
-            oss << "\\t";
-            break;
-        default:
-            oss << c;
-            break;
+            cvarManager->log("RTJ: trace dump failed: " + error);
         }
+        return;
+    }
+
+    DiagnosticLogger::Log("DumpTrace: wrote " + std::to_string(spanCount) + " spans to " + path.string());
+    if (cvarManager)
+    {
+        cvarManager->log("RTJ: wrote " + std::to_string(spanCount) + " spans to " + path.string() +
+                         (TraceRecorder::IsEnabled() ? "" : " (tracing is off; set rtj_trace_enabled 1)"));
     }
-    oss << '"';
-    return oss.str();
 }
 
-std::string RLTrainingJournalPlugin::PlaylistNameFromServer(ServerWrapper server) const
+void RLTrainingJournalPlugin::LogMemoryReport(bool resetPeaks)
 {
-    if (!server)
+    if (!cvarManager)
     {
-        return "Unknown";
+        return;
     }
-    GameSettingPlaylistWrapper playlist = server.GetPlaylist();
-    if (playlist)
-    {
-        std::string name;
-        try {
-            name = playlist.GetLocalizedName();
-        } catch(...) { }
-        if (name.empty()) {
-            try { name = playlist.GetName(); } catch(...) { }
-        }
 
-        if (!name.empty())
-        {
-            return name;
-        }
+    if (!MemoryTracker::IsCompiledIn())
+    {
+        cvarManager->log("RTJ: memory tracking is not compiled in; rebuild with RTJ_MEMORY_TRACKING defined");
+        return;
+    }
 
-        const int playlistId = playlist.GetPlaylistId();
-        static const std::unordered_map<int, std::string> playlistNames = {
-            {1, "Ranked Duel"},
-            {2, "Ranked Doubles"},
-            {3, "Ranked Standard"},
-            {4, "Ranked 4v4"},
-            {8, "Hoops"},
-            {10, "Rumble"},
-            {11, "Dropshot"},
-            {13, "Snow Day"},
-            {34, "Tournament"}
-        };
+    const MemorySnapshot snapshot = MemoryTracker::Snapshot();
+    for (std::size_t i = 0; i < snapshot.size(); ++i)
+    {
+        const MemorySubsystemStats& stats = snapshot[i];
+        std::ostringstream line;
+        line << "RTJ: mem " << MemoryTracker::SubsystemName(static_cast<MemorySubsystem>(i))
+             << " live=" << stats.liveBytes
+             << " peak=" << stats.peakBytes
+             << " allocs=" << stats.allocations
+             << " frees=" << stats.frees;
+        cvarManager->log(line.str());
+    }
+    cvarManager->log("RTJ: mem allocations during last match capture: " + std::to_string(lastCaptureAllocations_.load()) +
+                     (MemoryTracker::IsEnabled() ? "" : " (tracking is off; set rtj_memory_tracking 1)"));
 
-        auto it = playlistNames.find(playlistId);
-        if (it != playlistNames.end())
+    if (resetPeaks)
+    {
+        MemoryTracker::ResetPeaks();
+        cvarManager->log("RTJ: mem high-water marks reset to current live bytes");
+    }
+}
+
+// Replay chunks are left out: they resume on the next load, and a file can take
+// longer to send than any flush would wait.
+bool RLTrainingJournalPlugin::UploadsIdle()
+{
+    if (outboxSyncInFlight_.load() || uploadLanes_.Queued() > 0 ||
+        (apiClient && apiClient->Stats().inFlight > replayRequestsInFlight_.load()))
+    {
+        return false;
+    }
+#if RTJ_HAVE_COROUTINES
+    if (uploadExecutor_ && uploadExecutor_->Pending() > 0)
+    {
+        return false;
+    }
+#endif
+    std::lock_guard<std::mutex> lock(requestMutex);
+    return std::all_of(pendingRequests.begin(), pendingRequests.end(), [](std::future<void>& future) {
+        return !future.valid() || future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    });
+}
+
+// Blocks the game thread on purpose: run before quitting to know nothing is left
+// behind. Replay uploads are not waited for (see UploadsIdle).
+void RLTrainingJournalPlugin::FlushUploads(double seconds)
+{
+    if (!cvarManager)
+    {
+        return;
+    }
+    if (!apiClient)
+    {
+        cvarManager->log("RTJ: API client is not configured");
+        return;
+    }
+
+    const auto started = std::chrono::steady_clock::now();
+    const auto deadline = started + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(seconds));
+    SyncOutbox("flush");
+    while (!UploadsIdle() && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    CleanupFinishedRequests();
+
+    const bool drained = UploadsIdle() && outbox_.Size() == 0;
+    const long long elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started).count();
+    std::ostringstream line;
+    line << "flush " << (drained ? "finished" : "stopped") << " after " << elapsedMs << " ms: "
+         << outbox_.Size() << " upload(s) pending, " << apiClient->Stats().inFlight << " request(s) in flight";
+    DiagnosticLogger::Log("FlushUploads: " + line.str());
+    cvarManager->log("RTJ: " + line.str());
+}
+
+void RLTrainingJournalPlugin::LogUploadStats()
+{
+    if (!cvarManager)
+    {
+        return;
+    }
+
+    std::ostringstream line;
+    line << std::fixed << std::setprecision(1);
+    if (apiClient)
+    {
+        const TransportStats transport = apiClient->Stats();
+        line << "RTJ: transport: " << transport.requests << " requests (" << transport.failures << " failed), "
+             << transport.inFlight << " in flight, " << transport.bytesSent / 1024.0 << " KiB sent, "
+             << transport.bytesReceived / 1024.0 << " KiB received, latency avg "
+             << (transport.requests > 0 ? transport.totalMicros / 1000.0 / transport.requests : 0.0) << " ms, max "
+             << transport.maxMicros / 1000.0 << " ms";
+    }
+    else
+    {
+        line << "RTJ: transport: API client is not configured";
+    }
+    cvarManager->log(line.str());
+
+    line.str(std::string());
+    line << "RTJ: outbox: " << outbox_.Size() << " pending, acked through seq " << outbox_.AckedSeq()
+         << (outboxSyncInFlight_.load() ? ", sync running" : "") << (outboxNeedsSync_.load() ? ", sync due" : "");
+    cvarManager->log(line.str());
+
+    std::size_t replaysQueued = 0;
+    {
+        std::lock_guard<std::mutex> lock(replayMutex_);
+        replaysQueued = replayQueue_.size();
+    }
+    cvarManager->log("RTJ: replays queued: " + std::to_string(replaysQueued));
+
+    line.str(std::string());
+    line << "RTJ: game phase: " << GamePhaseName(uploadLanes_.Phase()) << ", background uploads during live play: "
+         << LivePolicyName(uploadLanes_.Policy());
+    cvarManager->log(line.str());
+    for (std::size_t i = 0; i < kUploadLaneCount; ++i)
+    {
+        const UploadLane lane = static_cast<UploadLane>(i);
+        const LaneStats stats = uploadLanes_.Stats(lane);
+        line.str(std::string());
+        line << "RTJ: lane " << UploadLaneName(lane) << ": " << stats.queued << " queued (peak " << stats.peakQueued << "), "
+             << stats.sent << " sent, " << stats.throttled << " throttled, " << stats.dropped << " dropped";
+        if (stats.deferrals > 0)
         {
-            return it->second;
+            line << ", held for live play " << stats.deferrals << " times, " << stats.deferredMillis / 1000.0 << " s";
         }
+        cvarManager->log(line.str());
     }
 
-    return "Unknown";
+    if (liveStream_)
+    {
+        const LiveStreamStats stats = liveStream_->Stats();
+        line.str(std::string());
+        line << "RTJ: live stream " << liveStream_->Url() << ": " << (stats.connected ? "connected" : "disconnected") << ", "
+             << stats.frames << " frames, " << stats.bytes / 1024.0 << " KiB, " << stats.coalesced << " states coalesced, "
+             << stats.droppedEvents << " events dropped, " << stats.reconnects << " reconnects";
+        if (!stats.connected && !stats.lastError.empty())
+        {
+            line << " (" << stats.lastError << ')';
+        }
+        cvarManager->log(line.str());
+    }
+
+    for (const auto& sink : sinks_)
+    {
+        const SinkStats stats = sink->Stats();
+        const std::uint64_t attempts = stats.delivered + stats.failures + stats.rejected;
+        line.str(std::string());
+        line << "RTJ: sink " << sink->Name() << ": " << stats.delivered << " delivered, " << stats.queued << " queued, "
+             << stats.failures << " failed attempts, " << stats.rejected << " rejected, " << stats.dropped << " dropped, "
+             << stats.bytes / 1024.0 << " KiB, latency avg "
+             << (attempts > 0 ? stats.totalMicros / 1000.0 / attempts : 0.0) << " ms, max " << stats.maxMicros / 1000.0 << " ms";
+        if (stats.backoff.count() > 0)
+        {
+            line << ", retrying every " << stats.backoff.count() << " ms";
+        }
+        cvarManager->log(line.str());
+    }
+
+    const DiagnosticLoggerStats logger = DiagnosticLogger::Stats();
+    line.str(std::string());
+    line << "RTJ: logger: " << logger.lines << " lines, " << logger.bytes / 1024.0 << " KiB, avg "
+         << (logger.lines > 0 ? static_cast<double>(logger.totalMicros) / logger.lines : 0.0) << " us per line, "
+         << logger.failures << " failed writes";
+    cvarManager->log(line.str());
+
+    line.str(std::string());
+    line << "RTJ: load:";
+    for (const auto& [phase, micros] : loadPhases_)
+    {
+        line << ' ' << phase << ' ' << micros << " us";
+    }
+    line << (loadReady_ ? "" : " (deferred load still running)");
+    cvarManager->log(line.str());
+
+    const SettingsStoreStats settings = settingsStore_.Stats();
+    line.str(std::string());
+    line << "RTJ: settings: " << settings.writes << " writes, " << settings.skipped << " unchanged, "
+         << settings.failures << " failed";
+    cvarManager->log(line.str());
+
+    line.str(std::string());
+    line << "RTJ: history: " << matchHistory_.Size() << " matches"
+         << (matchHistory_.IsOpen() ? "" : " (not open)");
+    cvarManager->log(line.str());
+
+    const MmrCacheStats mmr = mmrCache_.Stats();
+    const MmrSnapshot mmrSnapshot = mmrCache_.Latest();
+    line.str(std::string());
+    line << "RTJ: mmr: " << mmr.reads << " reads, " << mmr.hits << " served from cache, last read "
+         << mmrSnapshot.wrapperCalls << " wrapper calls in " << mmrSnapshot.micros << " us, avg "
+         << (mmr.reads > 0 ? static_cast<double>(mmr.totalMicros) / mmr.reads : 0.0) << " us";
+    cvarManager->log(line.str());
+
+    line.str(std::string());
+    line << "RTJ: last player capture: " << lastPlayerCaptureStats_.players << " players, "
+         << lastPlayerCaptureStats_.wrapperCalls << " wrapper calls, " << lastPlayerCaptureStats_.micros << " us";
+    if (MemoryTracker::IsCompiledIn())
+    {
+        line << ", " << lastCaptureAllocations_.load() << " allocations"
+             << (MemoryTracker::IsEnabled() ? "" : " (tracking is off)");
+    }
+    cvarManager->log(line.str());
 }
 
-std::string RLTrainingJournalPlugin::SerializeTeams(ServerWrapper server) const
+// Everything but the round trips runs here on the game thread, so the timings are
+// what a real capture costs in this process. Round trips go through the same client
+// as uploads but on a worker, and report back when done.
+void RLTrainingJournalPlugin::RunBenchmark(int iterations)
 {
-    std::ostringstream oss;
-    oss << '[';
+    if (!cvarManager)
+    {
+        return;
+    }
+
+    using Clock = std::chrono::steady_clock;
+    const auto microsSince = [](Clock::time_point started) {
+        return static_cast<double>(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - started).count());
+    };
+    std::ostringstream line;
+    line << std::fixed << std::setprecision(1);
 
+    ServerWrapper server = gameWrapper ? ResolveActiveServer(gameWrapper.get()) : ServerWrapper(0);
     if (server)
     {
-        ArrayWrapper<TeamWrapper> teams = server.GetTeams();
-        bool firstTeam = true;
-        for (int i = 0; i < teams.Count(); ++i)
+        benchmarking_ = true;
+        const float mmr = ReadMatchMmr(server);
+        std::size_t payloadBytes = 0;
+        const std::uint64_t allocationsBefore = MemoryTracker::ThreadAllocations();
+        const auto started = Clock::now();
+        for (int i = 0; i < iterations; ++i)
         {
-            TeamWrapper team = teams.Get(i);
-            if (!team)
+            payloadBytes = BuildMatchPayload(server, mmr).size();
+        }
+        const double micros = microsSince(started);
+        const std::uint64_t allocations = MemoryTracker::ThreadAllocations() - allocationsBefore;
+        benchmarking_ = false;
+
+        line << "RTJ: bench: match payload (" << PayloadProfileName(payloadProfile_.load()) << "): "
+             << micros / iterations << " us/build, " << payloadBytes << " bytes, "
+             << lastPlayerCaptureStats_.wrapperCalls << " wrapper calls/build";
+        if (MemoryTracker::IsCompiledIn() && MemoryTracker::IsEnabled())
+        {
+            line << ", " << static_cast<double>(allocations) / iterations << " allocations/build";
+        }
+        cvarManager->log(line.str());
+    }
+    else
+    {
+        cvarManager->log("RTJ: bench: not in a match, skipping the match payload");
+    }
+
+    SessionSummary summary;
+    summary.startedAt = std::chrono::system_clock::now() - std::chrono::hours(2);
+    summary.lastMatchAt = std::chrono::system_clock::now();
+    for (const int playlistId : {10, 11, 13})
+    {
+        PlaylistSessionStats stats;
+        stats.playlistName = "Bench " + std::to_string(playlistId);
+        for (int match = 0; match < 8; ++match)
+        {
+            const bool won = match % 3 != 0;
+            stats.matches++;
+            (won ? stats.wins : stats.losses)++;
+            stats.mmrDelta.Add(won ? 9.0 : -9.0);
+            stats.goals.Add(match % 4);
+        }
+        stats.firstMmr = 1000;
+        stats.lastMmr = 1030;
+        summary.matches += stats.matches;
+        summary.wins += stats.wins;
+        summary.losses += stats.losses;
+        summary.playlists.emplace_back(playlistId, std::move(stats));
+    }
+    std::size_t summaryBytes = 0;
+    auto started = Clock::now();
+    for (int i = 0; i < iterations; ++i)
+    {
+        summaryBytes = BuildSessionSummaryPayload(summary).size();
+    }
+    line.str(std::string());
+    line << "RTJ: bench: session summary: " << microsSince(started) / iterations << " us/build, " << summaryBytes << " bytes";
+    cvarManager->log(line.str());
+
+    std::vector<OutboxEntry> entries(kBenchBacklogEntries);
+    for (std::size_t i = 0; i < entries.size(); ++i)
+    {
+        entries[i].seq = i + 1;
+        entries[i].body = "{\"timestamp\":\"2024-01-01T00:00:00Z\",\"playlist\":\"Ranked Doubles 2v2\",\"mmr\":" +
+                          std::to_string(1000 + i % 50) + ",\"gamesPlayedDiff\":1,\"source\":\"bakkes\",\"clientSeq\":" +
+                          std::to_string(i + 1) + "}";
+    }
+    const int documentRuns = std::max(1, iterations / 10);
+    BacklogDocument document;
+    started = Clock::now();
+    for (int i = 0; i < documentRuns; ++i)
+    {
+        document = BuildBacklogDocument(entries, 0, entries.size());
+    }
+    line.str(std::string());
+    line << "RTJ: bench: backlog document (" << document.entries << " entries): " << microsSince(started) / documentRuns / 1000.0
+         << " ms/build, " << document.rawBytes << " -> " << document.bytes.size() << " bytes" << (document.gzip ? " gzip" : "");
+    cvarManager->log(line.str());
+
+    if (!apiClient)
+    {
+        cvarManager->log("RTJ: bench: API client is not configured, skipping round trips");
+        return;
+    }
+
+    // /api/health rather than a POST: it touches no data, so the bench can run against
+    // a real journal.
+    const std::string userId = cvarManager->getCvar(kUserIdCvarName).getStringValue();
+    std::vector<HttpHeader> headers;
+    headers.emplace_back("X-User-Id", userId);
+    headers.emplace_back("User-Agent", "RLTrainingJournalPlugin/1.0");
+    std::weak_ptr<int> alive = lifetimeToken_;
+    CleanupFinishedRequests();
+    auto future = std::async(std::launch::async, [this, headers, alive]() {
+        std::vector<double> samples;
+        int failures = 0;
+        for (int i = 0; i < kBenchRoundTrips && !alive.expired(); ++i)
+        {
+            std::string response;
+            const auto started = Clock::now();
+            if (!apiClient->Get("/api/health", headers, response))
             {
+                failures++;
                 continue;
             }
+            samples.push_back(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - started).count() / 1000.0);
+        }
 
-            if (!firstTeam)
-            {
-                oss << ',';
-            }
-            firstTeam = false;
+        std::ostringstream line;
+        line << std::fixed << std::setprecision(2) << "bench: " << samples.size() << " round trips";
+        if (!samples.empty())
+        {
+            std::sort(samples.begin(), samples.end());
+            line << ": min " << samples.front() << " ms, p50 " << samples[samples.size() / 2] << " ms, max " << samples.back() << " ms";
+        }
+        if (failures > 0)
+        {
+            line << " (" << failures << " failed)";
+        }
+        const std::string summary = line.str();
+        DiagnosticLogger::Log("RunBenchmark: " + summary);
+        if (!alive.expired())
+        {
+            gameWrapper->Execute([this, alive, summary](GameWrapper*) {
+                if (!alive.expired() && cvarManager)
+                {
+                    cvarManager->log("RTJ: " + summary);
+                }
+            });
+        }
+    });
 
-            const int teamIndex = team.GetTeamNum();
-            const int score = team.GetScore();
-            const std::string name = teamIndex == 1 ? "Orange" : "Blue";
+    std::lock_guard<std::mutex> lock(requestMutex);
+    pendingRequests.emplace_back(std::move(future));
+}
 
-            oss << '{'
-                << "\"teamIndex\":" << teamIndex << ','
-                << "\"name\":" << Escape(name) << ','
-                << "\"score\":" << score
-                << '}';
+void RLTrainingJournalPlugin::ApplyPayloadProfile(const std::string& name)
+{
+    std::string lowered = Trimmed(name);
+    std::transform(lowered.begin(), lowered.end(), lowered.begin(), [](unsigned char ch) {
+        return static_cast<char>(std::tolower(ch));
+    });
+
+    PayloadProfile profile = payloadProfile_.load();
+    if (!ParsePayloadProfile(lowered.c_str(), profile))
+    {
+        DiagnosticLogger::Log("ApplyPayloadProfile: unknown profile '" + name + "'");
+        if (cvarManager)
+        {
+            cvarManager->log(std::string("RTJ: unknown payload profile '") + name + "', keeping " + PayloadProfileName(profile) +
+                             " (expected minimal, standard or full)");
         }
+        return;
     }
 
-    oss << ']';
-    return oss.str();
+    payloadProfile_.store(profile);
+    DiagnosticLogger::Log(std::string("ApplyPayloadProfile: using ") + PayloadProfileName(profile));
 }
 
-std::string RLTrainingJournalPlugin::SerializeScoreboard(ServerWrapper server) const
+void RLTrainingJournalPlugin::ApplyLivePolicy(const std::string& name)
 {
-    std::ostringstream oss;
-    oss << '[';
+    std::string lowered = Trimmed(name);
+    std::transform(lowered.begin(), lowered.end(), lowered.begin(), [](unsigned char ch) {
+        return static_cast<char>(std::tolower(ch));
+    });
 
-    if (server)
+    LivePolicy policy = uploadLanes_.Policy();
+    if (!ParseLivePolicy(lowered.c_str(), policy))
     {
-        ArrayWrapper<CarWrapper> cars = server.GetCars();
-        bool first = true;
-        for (int i = 0; i < cars.Count(); ++i)
+        DiagnosticLogger::Log("ApplyLivePolicy: unknown policy '" + name + "'");
+        if (cvarManager)
         {
-            CarWrapper car = cars.Get(i);
-            if (!car)
-            {
-                continue;
-            }
+            cvarManager->log(std::string("RTJ: unknown live upload policy '") + name + "', keeping " + LivePolicyName(policy) +
+                             " (expected pause, throttle or run)");
+        }
+        return;
+    }
 
-            PriWrapper pri = car.GetPRI();
-            if (!pri)
-            {
-                continue;
-            }
+    uploadLanes_.SetLivePolicy(policy);
+    DiagnosticLogger::Log(std::string("ApplyLivePolicy: using ") + LivePolicyName(policy));
+}
+
+void RLTrainingJournalPlugin::HookMatchEvents()
+{
+    if (!gameWrapper)
+    {
+        DiagnosticLogger::Log("HookMatchEvents: gameWrapper unavailable");
+        return;
+    }
+
+    using std::placeholders::_1;
+
+    gameWrapper->HookEventPost("Function TAGame.GameEvent_Soccar_TA.EventMatchEnded",
+                               std::bind(&RLTrainingJournalPlugin::HandleGameEnd, this, _1));
+    gameWrapper->HookEventPost("Function TAGame.GameEvent_Soccar_TA.Destroyed",
+                               std::bind(&RLTrainingJournalPlugin::HandleGameEnd, this, _1));
+    gameWrapper->HookEventPost("Function TAGame.ReplayDirector_TA.EventReplayFinished",
+                               std::bind(&RLTrainingJournalPlugin::HandleReplayRecorded, this, _1));
+    gameWrapper->HookEventPost("Function TAGame.ReplayDirector_TA.EventStopReplay",
+                               std::bind(&RLTrainingJournalPlugin::HandleReplayRecorded, this, _1));
+    gameWrapper->HookEventWithCallerPost<ServerWrapper>("Function TAGame.GFxHUD_TA.HandleStatTickerMessage",
+                                                        [this](ServerWrapper, void* params, std::string) {
+                                                            HandleStatTickerMessage(params);
+                                                        });
+    gameWrapper->HookEventPost("Function TAGame.GameEvent_Soccar_TA.OnOvertimeUpdated",
+                               std::bind(&RLTrainingJournalPlugin::HandleOvertime, this, _1));
+
+    // Game phase for the upload lanes. The countdown starts every kickoff, including
+    // the one after each goal replay; HandleGameEnd covers the rest.
+    gameWrapper->HookEventPost("Function GameEvent_Soccar_TA.Countdown.BeginState",
+                               [this](std::string) { uploadLanes_.SetGamePhase(GamePhase::Live); });
+    gameWrapper->HookEventPost("Function GameEvent_Soccar_TA.ReplayPlayback.BeginState",
+                               [this](std::string) { uploadLanes_.SetGamePhase(GamePhase::Replay); });
+
+    // Training: counters only touch the in-memory tracker; the stint is posted once
+    // when the training event is destroyed.
+    gameWrapper->HookEventWithCallerPost<ServerWrapper>("Function TAGame.GameEvent_Tutorial_TA.OnInit",
+                                                        [this](ServerWrapper caller, void*, std::string) {
+                                                            HandleTrainingStarted(caller);
+                                                        });
+    gameWrapper->HookEventWithCallerPost<ServerWrapper>("Function TAGame.GameEvent_TrainingEditor_TA.OnInit",
+                                                        [this](ServerWrapper caller, void*, std::string) {
+                                                            HandleTrainingStarted(caller);
+                                                        });
+    gameWrapper->HookEventPost("Function TAGame.GameEvent_Tutorial_TA.Destroyed",
+                               std::bind(&RLTrainingJournalPlugin::HandleTrainingEnded, this, _1));
+    gameWrapper->HookEventPost("Function TAGame.GameEvent_TrainingEditor_TA.Destroyed",
+                               std::bind(&RLTrainingJournalPlugin::HandleTrainingEnded, this, _1));
+    gameWrapper->HookEventPost("Function TAGame.TrainingEditorMetrics_TA.TrainingShotAttempt",
+                               [this](std::string) { trainingTracker_.RecordAttempt(); });
+    gameWrapper->HookEventPost("Function TAGame.Ball_TA.OnHitGoal",
+                               [this](std::string) { trainingTracker_.RecordGoal(); });
+    gameWrapper->HookEventPost("Function TAGame.GameEvent_Soccar_TA.ResetPlayers",
+                               [this](std::string) {
+                                   trainingTracker_.RecordReset();
+                                   // Freeplay has no shots to count, so each reset is an attempt.
+                                   if (trainingTracker_.ActiveMode() == TrainingMode::Freeplay)
+                                   {
+                                       trainingTracker_.RecordAttempt();
+                                   }
+                               });
+    DiagnosticLogger::Log("HookMatchEvents: registered automatic upload hooks");
+}
+
+void RLTrainingJournalPlugin::HandleGameEnd(std::string eventName)
+{
+    DiagnosticLogger::Log(std::string("HandleGameEnd: received ") + eventName);
+    const bool matchEnded = eventName.find("EventMatchEnded") != std::string::npos;
+    uploadLanes_.SetGamePhase(matchEnded ? GamePhase::PostMatch : GamePhase::Menu);
+    if (liveStream_)
+    {
+        liveStream_->EndMatch();
+    }
+    if (!gameWrapper)
+    {
+        return;
+    }
+
+    gameWrapper->Execute([this](GameWrapper* gw) {
+        ServerWrapper server = ResolveActiveServer(gw);
+        if (!CaptureServerAndUpload(server, "match_end"))
+        {
+            DiagnosticLogger::Log("HandleGameEnd: no active server to capture");
+        }
+        // The timeline went out with the capture; a later match on the same server
+        // object (offline, or a GUID the game reuses) starts empty.
+        matchTimeline_.EndMatch();
+    });
 
-            if (!first)
+    bool uploadReplays = false;
+    try {
+        uploadReplays = cvarManager && cvarManager->getCvar(kReplayUploadCvarName).getBoolValue();
+    } catch(...) { uploadReplays = false; }
+    if (uploadReplays)
+    {
+        const auto notBefore = std::filesystem::file_time_type::clock::now() - kReplayMaxAge;
+        std::weak_ptr<int> alive = lifetimeToken_;
+        gameWrapper->SetTimeout([this, alive, notBefore](GameWrapper*) {
+            if (!alive.expired())
             {
-                oss << ',';
+                QueueLatestReplay(notBefore);
             }
-            first = false;
+        }, kReplayScanDelaySeconds);
+    }
+}
+
+// Game-time event hooks fire many times per match, so they avoid logging. Stat event
+// names are read once per event object (see ClassifyStatEvent), so ticker messages the
+// timeline ignores return without touching the heap. The goals, assists and
+// demolitions it records look up the match GUID; the timeline itself is a fixed arena.
+void RLTrainingJournalPlugin::HandleStatTickerMessage(void* params)
+{
+    if (!params || !gameWrapper)
+    {
+        return;
+    }
 
-            const std::string playerName = pri.GetPlayerName().IsNull() ? std::string("Unknown") : pri.GetPlayerName().ToString();
-            const int teamIndex = pri.GetTeamNum();
-            const int score = pri.GetMatchScore();
-            const int goals = pri.GetMatchGoals();
-            const int assists = pri.GetMatchAssists();
-            const int saves = pri.GetMatchSaves();
-            const int shots = pri.GetMatchShots();
+    const auto* ticker = static_cast<const StatTickerParams*>(params);
+    const TickerEventKind kind = ClassifyStatEvent(ticker->StatEvent);
+    if (kind == TickerEventKind::Other)
+    {
+        return;
+    }
+    const bool isGoal = kind == TickerEventKind::Goal;
+    const bool isAssist = kind == TickerEventKind::Assist;
+    const bool isDemolish = kind == TickerEventKind::Demolish;
 
-            oss << '{'
-                << "\"name\":" << Escape(playerName) << ','
-                << "\"teamIndex\":" << teamIndex << ','
-                << "\"score\":" << score << ','
-                << "\"goals\":" << goals << ','
-                << "\"assists\":" << assists << ','
-                << "\"saves\":" << saves << ','
-                << "\"shots\":" << shots
-                << '}';
-        }
+    ServerWrapper server = ResolveActiveServer(gameWrapper.get());
+    if (!server)
+    {
+        return;
     }
 
-    oss << ']';
-    return oss.str();
+    matchTimeline_.BeginMatch(MatchKeyFor(server));
+    const std::uint16_t seconds = MatchClockSeconds(server);
+    PriWrapper receiver(ticker->Receiver);
+    const std::uint8_t actor = TimelinePlayerSlot(receiver);
+    const std::uint8_t team = receiver ? receiver.GetTeamNum() : kTimelineNoPlayer;
+
+    if (isAssist)
+    {
+        matchTimeline_.AttachAssist(team, actor, seconds);
+        return;
+    }
+    if (isGoal && liveStream_)
+    {
+        liveStream_->PublishGoal(team, seconds);
+    }
+
+    TimelineEvent event{};
+    event.seconds = seconds;
+    event.type = isGoal ? TimelineEventType::Goal : TimelineEventType::Demolish;
+    event.team = team;
+    event.actor = actor;
+    event.other = isDemolish ? TimelinePlayerSlot(PriWrapper(ticker->Victim)) : kTimelineNoPlayer;
+    matchTimeline_.Append(event);
 }
 
-std::string RLTrainingJournalPlugin::BuildMatchPayload(ServerWrapper server) const
+void RLTrainingJournalPlugin::HandleOvertime(std::string /*eventName*/)
 {
-    const auto now = std::chrono::system_clock::now();
-    const std::string timestamp = FormatTimestamp(now);
-    const std::string playlistName = PlaylistNameFromServer(server);
-    const int gamesPlayedDiff = cvarManager ? cvarManager->getCvar(kGamesPlayedCvarName).getIntValue() : 1;
+    if (!gameWrapper)
+    {
+        return;
+    }
 
-    float mmr = 0.0f;
-    if (gameWrapper)
+    ServerWrapper server = ResolveActiveServer(gameWrapper.get());
+    if (!server || !server.GetbOverTime())
     {
-        auto mmrWrapper = gameWrapper->GetMMRWrapper();
-        if (mmrWrapper.memory_address != 0)
+        return;
+    }
+
+    matchTimeline_.BeginMatch(MatchKeyFor(server));
+    TimelineEvent event{};
+    event.seconds = MatchClockSeconds(server);
+    event.type = TimelineEventType::Overtime;
+    event.team = kTimelineNoPlayer;
+    event.actor = kTimelineNoPlayer;
+    event.other = kTimelineNoPlayer;
+    matchTimeline_.Append(event);
+}
+
+RLTrainingJournalPlugin::TickerEventKind RLTrainingJournalPlugin::ClassifyStatEvent(std::uintptr_t statEvent)
+{
+    for (std::size_t i = 0; i < statEventKindCount_; ++i)
+    {
+        if (statEventKinds_[i].first == statEvent)
         {
-            GameSettingPlaylistWrapper playlist = server.GetPlaylist();
-            const int playlistId = playlist ? playlist.GetPlaylistId() : 0;
-            UniqueIDWrapper uniqueId = gameWrapper->GetUniqueID();
-            bool hasUniqueId = false;
-            try {
-                hasUniqueId = (uniqueId.GetUID() != 0) || (!uniqueId.GetEpicAccountID().empty());
-            } catch(...) { hasUniqueId = false; }
-            if (hasUniqueId)
-            {
-                mmr = mmrWrapper.GetPlayerMMR(uniqueId, playlistId);
-            }
+            return statEventKinds_[i].second;
         }
     }
 
-    std::ostringstream oss;
-    oss << '{'
-        << "\"timestamp\":" << Escape(timestamp) << ','
-        << "\"playlist\":" << Escape(playlistName) << ','
-        << "\"mmr\":" << static_cast<int>(std::round(mmr)) << ','
-        << "\"gamesPlayedDiff\":" << gamesPlayedDiff << ','
-        << "\"source\":\"bakkes\",";
+    TickerEventKind kind = TickerEventKind::Other;
+    if (statEvent)
+    {
+        const std::string name = StatEventWrapper(statEvent).GetEventName();
+        if (name == "Goal")
+        {
+            kind = TickerEventKind::Goal;
+        }
+        else if (name == "Assist")
+        {
+            kind = TickerEventKind::Assist;
+        }
+        else if (name == "Demolish" || name == "Demolition")
+        {
+            kind = TickerEventKind::Demolish;
+        }
+        if (statEventKindCount_ < statEventKinds_.size())
+        {
+            statEventKinds_[statEventKindCount_++] = {statEvent, kind};
+        }
+    }
+    return kind;
+}
+
+std::uint8_t RLTrainingJournalPlugin::TimelinePlayerSlot(PriWrapper pri)
+{
+    if (!pri)
+    {
+        return kTimelineNoPlayer;
+    }
+
+    const std::uint8_t existing = matchTimeline_.FindPlayer(pri.memory_address);
+    if (existing != kTimelineNoPlayer)
+    {
+        return existing;
+    }
+
+    // First sighting of this player in the match; the only place a name is copied.
+    UnrealStringWrapper name = pri.GetPlayerName();
+    return matchTimeline_.AddPlayer(pri.memory_address, pri.GetTeamNum(), name.IsNull() ? std::string() : name.ToString());
+}
+
+std::uint16_t RLTrainingJournalPlugin::MatchClockSeconds(ServerWrapper server) const
+{
+    // Elapsed regulation time from the countdown clock, plus time played in overtime.
+    const int matchLength = static_cast<int>(server.GetGameTime());
+    int elapsed = std::max(0, matchLength - server.GetSecondsRemaining());
+    if (server.GetbOverTime())
+    {
+        elapsed = matchLength + static_cast<int>(server.GetOvertimeTimePlayed());
+    }
+    return static_cast<std::uint16_t>(std::min(elapsed, 0xFFFF));
+}
+
+void RLTrainingJournalPlugin::HandleTrainingStarted(ServerWrapper caller)
+{
+    if (!gameWrapper || !caller)
+    {
+        return;
+    }
+
+    // GameEvent_TrainingEditor_TA derives from the tutorial event, so both OnInit
+    // hooks can fire for one pack; BeginMode ignores a repeat of the active mode.
+    TrainingMode mode = TrainingMode::None;
+    try {
+        if (gameWrapper->IsInCustomTraining())
+        {
+            mode = TrainingMode::CustomTraining;
+        }
+        else if (gameWrapper->IsInFreeplay())
+        {
+            mode = TrainingMode::Freeplay;
+        }
+    } catch(...) { mode = TrainingMode::None; }
+    if (mode == TrainingMode::None)
+    {
+        return;
+    }
+
+    const auto now = std::chrono::system_clock::now();
+    TrainingStint closed;
+    if (trainingTracker_.BeginMode(mode, now, closed))
+    {
+        UploadTrainingStint(closed);
+    }
+
+    if (mode != TrainingMode::CustomTraining)
+    {
+        return;
+    }
+
+    std::string code;
+    std::string name;
+    try {
+        TrainingEditorWrapper editor(caller.memory_address);
+        GameEditorSaveDataWrapper saveData = editor.GetTrainingData();
+        TrainingEditorSaveDataWrapper pack = saveData ? saveData.GetTrainingData() : TrainingEditorSaveDataWrapper(0);
+        if (pack)
+        {
+            UnrealStringWrapper packCode = pack.GetCode();
+            UnrealStringWrapper packName = pack.GetTM_Name();
+            code = packCode.IsNull() ? std::string() : packCode.ToString();
+            name = packName.IsNull() ? std::string() : packName.ToString();
+        }
+    } catch(...) { code.clear(); name.clear(); }
+
+    trainingTracker_.SetActivePack(code, name, now);
+    DiagnosticLogger::Log(std::string("HandleTrainingStarted: custom training pack=") + (code.empty() ? "<local>" : code));
+}
+
+void RLTrainingJournalPlugin::HandleTrainingEnded(std::string eventName)
+{
+    TrainingStint stint;
+    if (trainingTracker_.EndMode(std::chrono::system_clock::now(), stint))
+    {
+        DiagnosticLogger::Log(std::string("HandleTrainingEnded: received ") + eventName);
+        UploadTrainingStint(stint);
+    }
+}
+
+void RLTrainingJournalPlugin::HandleReplayRecorded(std::string eventName)
+{
+    DiagnosticLogger::Log(std::string("HandleReplayRecorded: received ") + eventName);
+    if (!gameWrapper)
+    {
+        return;
+    }
+
+    gameWrapper->Execute([this](GameWrapper* gw) {
+        ServerWrapper server = gw ? gw->GetGameEventAsServer() : ServerWrapper(0);
+        if (!CaptureServerAndUpload(server, "replay_recorded"))
+        {
+            DiagnosticLogger::Log("HandleReplayRecorded: unable to capture replay server");
+        }
+    });
+}
+
+std::string RLTrainingJournalPlugin::FormatTimestamp(const std::chrono::system_clock::time_point& timePoint) const
+{
+    std::time_t now = std::chrono::system_clock::to_time_t(timePoint);
+    std::tm tmUtc;
+#ifdef _WIN32
+    gmtime_s(&tmUtc, &now);
+#else
+    gmtime_r(&now, &tmUtc);
+#endif
+
+    std::ostringstream oss;
+    oss << std::put_time(&tmUtc, "%Y-%m-%dT%H:%M:%SZ");
+    return oss.str();
+}
+
+std::string RLTrainingJournalPlugin::Escape(const std::string& value) const
+{
+    std::ostringstream oss;
+    oss << '"';
+    for (char c : value)
+    {
+        switch (c)
+        {
+        case '\\':
+            oss << "\\\\";
+            break;
+        case '"':
+            oss << "\\\"";
+            break;
+        case '\n':
+            oss << "\\n";
+            break;
+        case '\r':
+            oss << "\\r";
+            break;
+        case '\t':
+            oss << "\\t";
+            break;
+        default:
+            oss << c;
+            break;
+        }
+    }
+    oss << '"';
+    return oss.str();
+}
+
+std::string RLTrainingJournalPlugin::PlaylistNameFromServer(ServerWrapper server) const
+{
+    if (!server)
+    {
+        return "Unknown";
+    }
+    GameSettingPlaylistWrapper playlist = server.GetPlaylist();
+    if (playlist)
+    {
+        std::string name;
+        try {
+            name = playlist.GetLocalizedName();
+        } catch(...) { }
+        if (name.empty()) {
+            try { name = playlist.GetName(); } catch(...) { }
+        }
+
+        if (!name.empty())
+        {
+            return name;
+        }
+
+        if (const PlaylistInfo* info = PlaylistRegistry::FindById(playlist.GetPlaylistId()))
+        {
+            return info->name;
+        }
+    }
+
+    return "Unknown";
+}
+
+std::string RLTrainingJournalPlugin::SerializeTeams(ServerWrapper server) const
+{
+    RTJ_TRACE_SCOPE("SerializeTeams");
+    RTJ_MEMORY_SCOPE(Serializer);
+    TrackedOStringStream oss;
+    oss << '[';
+
+    if (server)
+    {
+        ArrayWrapper<TeamWrapper> teams = server.GetTeams();
+        bool firstTeam = true;
+        for (int i = 0; i < teams.Count(); ++i)
+        {
+            TeamWrapper team = teams.Get(i);
+            if (!team)
+            {
+                continue;
+            }
+
+            if (!firstTeam)
+            {
+                oss << ',';
+            }
+            firstTeam = false;
+
+            const int teamIndex = team.GetTeamNum();
+            const int score = team.GetScore();
+            const std::string name = teamIndex == 1 ? "Orange" : "Blue";
+
+            oss << '{'
+                << "\"teamIndex\":" << teamIndex << ','
+                << "\"name\":" << Escape(name) << ','
+                << "\"score\":" << score
+                << '}';
+        }
+    }
+
+    oss << ']';
+    return ToStdString(oss);
+}
+
+std::string RLTrainingJournalPlugin::SerializeScoreboard(const PlayerTable& table) const
+{
+    RTJ_TRACE_SCOPE("SerializeScoreboard");
+    RTJ_MEMORY_SCOPE(Serializer);
+    TrackedOStringStream oss;
+    oss << '[';
+
+    for (std::size_t i = 0; i < table.count; ++i)
+    {
+        if (i > 0)
+        {
+            oss << ',';
+        }
+
+        oss << '{'
+            << "\"name\":" << Escape(table.names[i]) << ','
+            << "\"teamIndex\":" << static_cast<int>(table.teamIndex[i]) << ','
+            << "\"score\":" << table.score[i] << ','
+            << "\"goals\":" << table.goals[i] << ','
+            << "\"assists\":" << table.assists[i] << ','
+            << "\"saves\":" << table.saves[i] << ','
+            << "\"shots\":" << table.shots[i];
+
+        if (table.hasExtended)
+        {
+            oss << ",\"demos\":" << table.demos[i]
+                << ",\"touches\":" << table.touches[i]
+                << ",\"boostPickups\":" << table.boostPickups[i]
+                << ",\"mvp\":" << (table.mvp[i] ? "true" : "false")
+                << ",\"bot\":" << (table.bot[i] ? "true" : "false")
+                << ",\"platformId\":" << Escape(table.platformIds[i]);
+        }
+        oss << '}';
+    }
+
+    oss << ']';
+    return ToStdString(oss);
+}
+
+std::string RLTrainingJournalPlugin::SerializeTimeline(ServerWrapper server) const
+{
+    RTJ_TRACE_SCOPE("SerializeTimeline");
+    RTJ_MEMORY_SCOPE(Serializer);
+    std::string matchGuid;
+    try {
+        matchGuid = server.GetMatchGUID();
+    } catch(...) { matchGuid.clear(); }
+
+    TrackedOStringStream oss;
+    oss << "{\"guid\":" << Escape(matchGuid) << ",\"players\":[";
+    for (std::size_t i = 0; i < matchTimeline_.PlayerCount(); ++i)
+    {
+        const TimelinePlayer& player = matchTimeline_.Player(i);
+        if (i > 0)
+        {
+            oss << ',';
+        }
+        oss << "{\"name\":" << Escape(player.name) << ",\"team\":" << static_cast<int>(player.team) << '}';
+    }
+
+    std::string events;
+    matchTimeline_.AppendEncodedEvents(events);
+    oss << "],\"events\":\"" << events << "\"";
+    if (matchTimeline_.DroppedEvents() > 0)
+    {
+        oss << ",\"dropped\":" << matchTimeline_.DroppedEvents();
+    }
+    oss << '}';
+    return ToStdString(oss);
+}
+
+float RLTrainingJournalPlugin::ReadMatchMmr(ServerWrapper server) const
+{
+    RTJ_TRACE_SCOPE("ReadMatchMmr");
+    float mmr = 0.0f;
+    if (!gameWrapper || !server)
+    {
+        return mmr;
+    }
+
+    GameSettingPlaylistWrapper playlist = server.GetPlaylist();
+    const int playlistId = playlist ? playlist.GetPlaylistId() : 0;
+    if (PlaylistRegistry::FindById(playlistId))
+    {
+        return mmrCache_.Get(*gameWrapper).Rating(playlistId);
+    }
+
+    // Casual and private playlists are not in the snapshot; read just this one.
+    auto mmrWrapper = gameWrapper->GetMMRWrapper();
+    if (mmrWrapper.memory_address != 0)
+    {
+        UniqueIDWrapper uniqueId = gameWrapper->GetUniqueID();
+        if (HasValidUniqueId(uniqueId))
+        {
+            try
+            {
+                mmr = mmrWrapper.GetPlayerMMR(uniqueId, playlistId);
+            }
+            catch (...)
+            {
+                mmr = 0.0f;
+            }
+        }
+    }
+    return mmr;
+}
+
+std::string RLTrainingJournalPlugin::BuildMatchPayload(ServerWrapper server, float mmr, std::string* rankProgress) const
+{
+    switch (payloadProfile_.load())
+    {
+    case PayloadProfile::Minimal:
+        return BuildMatchPayloadFor<MinimalPayloadPolicy>(server, mmr, rankProgress);
+    case PayloadProfile::Full:
+        return BuildMatchPayloadFor<FullPayloadPolicy>(server, mmr, rankProgress);
+    case PayloadProfile::Standard:
+    default:
+        return BuildMatchPayloadFor<StandardPayloadPolicy>(server, mmr, rankProgress);
+    }
+}
+
+template <typename Policy>
+std::string RLTrainingJournalPlugin::BuildMatchPayloadFor(ServerWrapper server, float mmr, std::string* rankProgress) const
+{
+    RTJ_TRACE_SCOPE("BuildMatchPayload");
+    RTJ_MEMORY_SCOPE(Serializer);
+    const auto now = std::chrono::system_clock::now();
+    const std::string timestamp = FormatTimestamp(now);
+    const std::string playlistName = PlaylistNameFromServer(server);
+    const int gamesPlayedDiff = cvarManager ? cvarManager->getCvar(kGamesPlayedCvarName).getIntValue() : 1;
+
+    const int roundedMmr = static_cast<int>(std::round(mmr));
+
+    TrackedOStringStream oss;
+    oss << '{'
+        << "\"timestamp\":" << Escape(timestamp) << ','
+        << "\"playlist\":" << Escape(playlistName) << ','
+        << "\"mmr\":" << roundedMmr << ','
+        << "\"gamesPlayedDiff\":" << gamesPlayedDiff << ','
+        << "\"source\":\"bakkes\"";
+
+    if constexpr (Policy::kRank)
+    {
+        GameSettingPlaylistWrapper playlist = server.GetPlaylist();
+        const int playlistId = playlist ? playlist.GetPlaylistId() : 0;
+        AppendRankFields(oss, PlaylistRegistry::FindById(playlistId), roundedMmr, rankProgress);
+    }
+    else
+    {
+        (void)rankProgress;
+    }
+
+    if constexpr (Policy::kUserId)
+    {
+        const std::string userId = cvarManager ? cvarManager->getCvar(kUserIdCvarName).getStringValue() : std::string("unknown");
+        oss << ",\"userId\":" << Escape(userId);
+    }
+
+    if constexpr (Policy::kMatchMetadata)
+    {
+        std::string matchGuid;
+        bool overtime = false;
+        float gameTime = 0.0f;
+        int winnerTeam = -1;
+        try {
+            matchGuid = server.GetMatchGUID();
+            overtime = server.GetbOverTime() != 0;
+            gameTime = server.GetGameTime();
+            TeamWrapper winner = server.GetMatchWinner();
+            winnerTeam = winner ? winner.GetTeamNum() : -1;
+        } catch(...) {}
+
+        oss << ",\"match\":{"
+            << "\"guid\":" << Escape(matchGuid) << ','
+            << "\"overtime\":" << (overtime ? "true" : "false") << ','
+            << "\"gameTimeSeconds\":" << static_cast<int>(std::round(gameTime)) << ','
+            << "\"winnerTeam\":" << winnerTeam
+            << '}';
+    }
+
+    if constexpr (Policy::kTeams)
+    {
+        oss << ",\"teams\":" << SerializeTeams(server);
+    }
+
+    if constexpr (Policy::kTimeline)
+    {
+        if (matchTimeline_.EventCount() > 0 && matchTimeline_.IsMatch(MatchKeyFor(server)))
+        {
+            oss << ",\"timeline\":" << SerializeTimeline(server);
+        }
+    }
+
+    if constexpr (Policy::kScoreboard)
+    {
+        const PlayerTableCaptureStats captureStats = CapturePlayerTable(server, Policy::kExtendedPlayerStats, playerTable_);
+        lastPlayerCaptureStats_ = captureStats;
+        if (!benchmarking_)
+        {
+            DiagnosticLogger::Log("BuildMatchPayload: captured " + std::to_string(captureStats.players) + " players (" +
+                                  std::to_string(playerTable_.skipped) + " skipped) with " +
+                                  std::to_string(captureStats.wrapperCalls) + " wrapper calls in " +
+                                  std::to_string(captureStats.micros) + "us");
+        }
+        oss << ",\"scoreboard\":" << SerializeScoreboard(playerTable_);
+    }
+
+    oss << '}';
+    return ToStdString(oss);
+}
+
+void RLTrainingJournalPlugin::AppendRankFields(std::ostream& out,
+                                              const PlaylistInfo* playlist,
+                                              int mmr,
+                                              std::string* rankProgress) const
+{
+    RankLookupResult rank;
+    if (!playlist || mmr <= 0 || !RankTable::Lookup(playlist->rankColumn, mmr, rank))
+    {
+        return;
+    }
+
+    out << ",\"rank\":" << Escape(rank.tier)
+        << ",\"division\":" << rank.division;
+
+    if (rankProgress)
+    {
+        *rankProgress = std::string(playlist->name) + ": " + RankTable::FormatRank(rank.tier, rank.division);
+        if (rank.hasNext)
+        {
+            *rankProgress += " (" + std::to_string(rank.mmrToNext) + " MMR to " +
+                             RankTable::FormatRank(rank.nextTier, rank.nextDivision) + ")";
+        }
+    }
+}
+
+bool RLTrainingJournalPlugin::HasValidUniqueId(UniqueIDWrapper& uniqueId) const
+{
+    bool hasUniqueId = false;
+    try
+    {
+        hasUniqueId = (uniqueId.GetUID() != 0);
+    }
+    catch (...)
+    {
+        hasUniqueId = false;
+    }
+
+    if (!hasUniqueId)
+    {
+        try
+        {
+            hasUniqueId = !uniqueId.GetEpicAccountID().empty();
+        }
+        catch (...)
+        {
+            hasUniqueId = false;
+        }
+    }
+
+    return hasUniqueId;
+}
+
+std::vector<std::string> RLTrainingJournalPlugin::BuildMmrSnapshotPayloads() const
+{
+    switch (payloadProfile_.load())
+    {
+    case PayloadProfile::Minimal:
+        return BuildMmrSnapshotPayloadsFor<MinimalPayloadPolicy>();
+    case PayloadProfile::Full:
+        return BuildMmrSnapshotPayloadsFor<FullPayloadPolicy>();
+    case PayloadProfile::Standard:
+    default:
+        return BuildMmrSnapshotPayloadsFor<StandardPayloadPolicy>();
+    }
+}
+
+template <typename Policy>
+std::vector<std::string> RLTrainingJournalPlugin::BuildMmrSnapshotPayloadsFor() const
+{
+    RTJ_TRACE_SCOPE("BuildMmrSnapshotPayloads");
+    RTJ_MEMORY_SCOPE(Serializer);
+    std::vector<std::string> payloads;
+
+    if (!gameWrapper)
+    {
+        DiagnosticLogger::Log("BuildMmrSnapshotPayloads: gameWrapper unavailable");
+        return payloads;
+    }
+
+    const MmrSnapshot snapshot = mmrCache_.Get(*gameWrapper);
+    if (!snapshot.valid)
+    {
+        DiagnosticLogger::Log("BuildMmrSnapshotPayloads: MMR wrapper or unique id not available");
+        return payloads;
+    }
+
+    const auto now = std::chrono::system_clock::now();
+    const std::string timestamp = FormatTimestamp(now);
+    std::string userId;
+    if constexpr (Policy::kUserId)
+    {
+        userId = cvarManager ? cvarManager->getCvar(kUserIdCvarName).getStringValue() : std::string("unknown");
+    }
+
+    for (std::size_t i = 0; i < PlaylistRegistry::kPlaylistCount; ++i)
+    {
+        const PlaylistInfo& target = PlaylistRegistry::kPlaylists[i];
+        const float rating = snapshot.ratings[i];
+        if (rating <= 0.0f)
+        {
+            continue;
+        }
+
+        const int roundedRating = static_cast<int>(std::round(rating));
+
+        TrackedOStringStream oss;
+        oss << '{'
+            << "\"timestamp\":" << Escape(timestamp) << ','
+            << "\"playlist\":" << Escape(target.name) << ','
+            << "\"mmr\":" << roundedRating << ','
+            << "\"gamesPlayedDiff\":0,"
+            << "\"source\":\"bakkes_snapshot\"";
+        if constexpr (Policy::kRank)
+        {
+            AppendRankFields(oss, &target, roundedRating, nullptr);
+        }
+        if constexpr (Policy::kUserId)
+        {
+            oss << ",\"userId\":" << Escape(userId);
+        }
+        // Snapshots are not tied to a match; the empty arrays only keep the
+        // standard shape identical to match uploads.
+        if constexpr (Policy::kTeams)
+        {
+            oss << ",\"teams\":[]";
+        }
+        if constexpr (Policy::kScoreboard)
+        {
+            oss << ",\"scoreboard\":[]";
+        }
+        oss << '}';
 
-    const std::string userId = cvarManager ? cvarManager->getCvar(kUserIdCvarName).getStringValue() : std::string("unknown");
-    oss << "\"userId\":" << Escape(userId) << ',';
+        payloads.emplace_back(ToStdString(oss));
+    }
+
+    if (payloads.empty())
+    {
+        DiagnosticLogger::Log("BuildMmrSnapshotPayloads: no playlists produced valid ratings");
+    }
+
+    return payloads;
+}
+
+bool RLTrainingJournalPlugin::UploadMmrSnapshot(const char* contextTag)
+{
+    ScopedTraceUploadId traceUpload(TraceRecorder::NextUploadId());
+    RTJ_TRACE_SCOPE("UploadMmrSnapshot");
+    const std::vector<std::string> payloads = BuildMmrSnapshotPayloads();
+    if (payloads.empty())
+    {
+        DiagnosticLogger::Log(std::string("UploadMmrSnapshot: no payloads generated for context ") + (contextTag ? contextTag : "n/a"));
+        return false;
+    }
+
+    DiagnosticLogger::Log(std::string("UploadMmrSnapshot: sending ") + std::to_string(payloads.size()) +
+                          " playlist snapshots for context " + (contextTag ? contextTag : "n/a"));
+    for (const auto& payload : payloads)
+    {
+        QueueMmrLog(payload);
+    }
+    return true;
+}
+
+void RLTrainingJournalPlugin::DispatchPayloadAsync(const std::string& endpoint, const std::string& body, UploadLane lane,
+                                                  UploadCallback onComplete)
+{
+    if (!apiClient)
+    {
+        if (cvarManager)
+        {
+            cvarManager->log("RTJ: API client is not configured");
+        }
+        return;
+    }
+
+    RTJ_TRACE_SCOPE("DispatchPayloadAsync");
+    RTJ_MEMORY_SCOPE(Transport);
+    DiagnosticLogger::Log(std::string("DispatchPayloadAsync: endpoint=") + endpoint + ", lane=" + UploadLaneName(lane) +
+                          ", body_len=" + std::to_string(body.size()));
+
+    CleanupFinishedRequests();
+
+    const std::uint64_t uploadId = TraceRecorder::CurrentUploadId() != 0 ? TraceRecorder::CurrentUploadId() : TraceRecorder::NextUploadId();
+    const std::int64_t queuedMicros = TraceRecorder::IsEnabled() ? TraceRecorder::NowMicros() : 0;
+
+    const std::string userId = cvarManager ? cvarManager->getCvar(kUserIdCvarName).getStringValue() : std::string();
+    std::vector<HttpHeader> headers;
+    headers.emplace_back("X-User-Id", userId);
+    headers.emplace_back("User-Agent", "RLTrainingJournalPlugin/1.0");
+
+    // Runs on the lane dispatcher once the lane has a token; only hands the request on.
+    UploadLanes::Job job;
+#if RTJ_HAVE_COROUTINES
+    (void)queuedMicros;
+    job.start = [this, endpoint, body, headers = std::move(headers), uploadId, onComplete]() {
+        Spawn(*uploadExecutor_, UploadPayload(endpoint, body, headers, uploadId, onComplete));
+    };
+#else
+    job.start = [this, endpoint, body, headers = std::move(headers), uploadId, queuedMicros, onComplete]() {
+        auto future = std::async(std::launch::async, [this, endpoint, body, headers, uploadId, queuedMicros, onComplete]() {
+            ScopedTraceUploadId traceUpload(uploadId);
+            TraceRecorder::Record("ThreadStartup", uploadId, queuedMicros, TraceRecorder::NowMicros() - queuedMicros);
+            RTJ_TRACE_SCOPE("UploadWorker");
+            RTJ_MEMORY_SCOPE(Transport);
+
+            const auto started = std::chrono::steady_clock::now();
+            std::string response;
+            bool success = apiClient->PostJson(endpoint, body, headers, response);
+            if (onComplete)
+            {
+                onComplete(success, response);
+            }
+            RecordUploadResult(success, response);
+            RecordUploadAttempt(endpoint, success, success ? 0 : StatusFromResponse(response), started, body.size());
+        });
+
+        std::lock_guard<std::mutex> lock(requestMutex);
+        pendingRequests.emplace_back(std::move(future));
+    };
+#endif
+    // Only mmr-log uploads are kept in the outbox; any other payload would be lost.
+    job.droppable = endpoint == "/api/mmr-log";
+    // Not an HTTP error, so an outbox entry counts as unsent and the next sync resends it.
+    job.dropped = [onComplete]() {
+        if (onComplete)
+        {
+            onComplete(false, "dropped: upload lane full");
+        }
+    };
+    uploadLanes_.Submit(lane, std::move(job));
+}
+
+void RLTrainingJournalPlugin::RecordUploadResult(bool success, const std::string& response)
+{
+    // An HTTP error status still means the API answered.
+    RecordApiHealth(success || response.rfind("HTTP ", 0) == 0);
+    std::lock_guard<std::mutex> lock(requestMutex);
+    if (success)
+    {
+        lastResponseMessage = response.empty() ? "HTTP 2xx" : response;
+        lastErrorMessage.clear();
+    }
+    else
+    {
+        lastErrorMessage = response;
+    }
+}
+
+void RLTrainingJournalPlugin::RecordUploadAttempt(const std::string& endpoint, bool success, unsigned long status,
+                                                  std::chrono::steady_clock::time_point started, std::size_t bytes)
+{
+    const auto latency = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started);
+    const std::int64_t now = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    historyTable_.AddUpload(now, endpoint, success, status, latency.count(), bytes);
+}
+
+void RLTrainingJournalPlugin::RecordApiHealth(bool reachable)
+{
+    std::lock_guard<std::mutex> lock(requestMutex);
+    apiHealthKnown_ = true;
+    apiReachable_ = reachable;
+    apiCheckedAt_ = std::chrono::system_clock::now();
+}
+
+#if RTJ_HAVE_COROUTINES
+// Suspends on the executor while the request is on the wire; no thread waits for it.
+Task<void> RLTrainingJournalPlugin::UploadPayload(std::string endpoint,
+                                                  std::string body,
+                                                  std::vector<HttpHeader> headers,
+                                                  std::uint64_t uploadId,
+                                                  UploadCallback onComplete)
+{
+    const std::int64_t startMicros = TraceRecorder::IsEnabled() ? TraceRecorder::NowMicros() : 0;
+    const auto started = std::chrono::steady_clock::now();
+    const std::string attemptEndpoint = endpoint;
+    const std::size_t bytes = body.size();
+
+    HttpRequest request;
+    request.method = "POST";
+    request.endpoint = std::move(endpoint);
+    request.contentType = "application/json";
+    request.body = std::move(body);
+    request.headers = std::move(headers);
+    const HttpResult result = co_await Request(*apiClient, *uploadExecutor_, std::move(request));
+
+    if (TraceRecorder::IsEnabled())
+    {
+        TraceRecorder::Record("UploadRoundTrip", uploadId, startMicros, TraceRecorder::NowMicros() - startMicros);
+    }
+
+    const std::string& response = result.success ? result.body : result.error;
+    if (onComplete)
+    {
+        onComplete(result.success, response);
+    }
+    RecordUploadResult(result.success, response);
+    RecordUploadAttempt(attemptEndpoint, result.success, result.status, started, bytes);
+}
+#endif
+
+void RLTrainingJournalPlugin::QueueMmrLog(const std::string& payload, const char* contextTag)
+{
+    if (!loadReady_)
+    {
+        deferredUploads_.emplace_back(payload, contextTag);
+        return;
+    }
+    const OutboxEntry entry = outbox_.Stamp(payload);
+    if (contextTag)
+    {
+        CacheLastPayload(entry.body, contextTag);
+    }
+    DispatchOutboxEntry(entry, LaneForContext(contextTag));
+    PublishToSinks(entry);
+}
+
+// Sinks whose settings are unchanged keep their queue; the others are stopped on a
+// worker, since a mirror may be in the middle of a request.
+void RLTrainingJournalPlugin::ConfigureSinks()
+{
+    std::string mirrorUrl;
+    bool archive = false;
+    std::string userId;
+    if (cvarManager)
+    {
+        try {
+            mirrorUrl = EnsureHttpScheme(cvarManager->getCvar(kMirrorBaseUrlCvarName).getStringValue());
+            archive = cvarManager->getCvar(kArchiveCvarName).getBoolValue();
+            userId = cvarManager->getCvar(kUserIdCvarName).getStringValue();
+        } catch(...) { mirrorUrl.clear(); archive = false; }
+    }
+
+    std::vector<std::string> wanted;
+    if (!mirrorUrl.empty())
+    {
+        wanted.push_back("mirror " + mirrorUrl);
+    }
+    if (archive)
+    {
+        wanted.push_back("archive");
+    }
+
+    std::vector<std::unique_ptr<PayloadSink>> kept;
+    std::vector<std::unique_ptr<PayloadSink>> retired;
+    for (auto& sink : sinks_)
+    {
+        const bool keep = std::find(wanted.begin(), wanted.end(), sink->Name()) != wanted.end();
+        (keep ? kept : retired).push_back(std::move(sink));
+    }
+    for (const std::string& name : wanted)
+    {
+        const bool exists = std::any_of(kept.begin(), kept.end(), [&name](const std::unique_ptr<PayloadSink>& sink) {
+            return sink->Name() == name;
+        });
+        if (exists)
+        {
+            continue;
+        }
+        if (name == "archive")
+        {
+            kept.push_back(std::make_unique<ArchiveSink>(name, dataRoot_ / "rltrainingjournal" / "archive.ndjson"));
+        }
+        else
+        {
+            std::vector<HttpHeader> headers;
+            headers.emplace_back("X-User-Id", userId);
+            headers.emplace_back("User-Agent", "RLTrainingJournalPlugin/1.0");
+            kept.push_back(std::make_unique<HttpSink>(name, mirrorUrl, "/api/mmr-log", std::move(headers)));
+        }
+        DiagnosticLogger::Log("ConfigureSinks: added " + name);
+    }
+    sinks_ = std::move(kept);
+
+    if (!retired.empty())
+    {
+        // Their queues drain for up to PayloadSink::kDrainTime on this worker.
+        auto future = std::async(std::launch::async, [retired = std::move(retired)]() mutable {
+            retired.clear();
+        });
+        std::lock_guard<std::mutex> lock(requestMutex);
+        pendingRequests.emplace_back(std::move(future));
+    }
+}
+
+// One copy of the stamped body, shared by every sink's queue.
+void RLTrainingJournalPlugin::PublishToSinks(const OutboxEntry& entry)
+{
+    if (sinks_.empty())
+    {
+        return;
+    }
+    const SharedPayload payload = std::make_shared<const std::string>(entry.body);
+    for (const auto& sink : sinks_)
+    {
+        sink->Submit(payload);
+    }
+}
+
+// The stream follows the API base URL; changing it reconnects to the new one.
+void RLTrainingJournalPlugin::ConfigureLiveStream()
+{
+    bool enabled = false;
+    std::string baseUrl;
+    std::string userId;
+    if (cvarManager)
+    {
+        try {
+            enabled = cvarManager->getCvar(kLiveStreamCvarName).getBoolValue();
+            baseUrl = EnsureHttpScheme(cvarManager->getCvar(kBaseUrlCvarName).getStringValue());
+            userId = cvarManager->getCvar(kUserIdCvarName).getStringValue();
+        } catch(...) { enabled = false; }
+    }
+    while (!baseUrl.empty() && baseUrl.back() == '/')
+    {
+        baseUrl.pop_back();
+    }
+
+    const std::string url = baseUrl + "/api/live";
+    std::unique_ptr<LiveStream> retired;
+    if (!enabled || baseUrl.empty())
+    {
+        retired = std::move(liveStream_);
+    }
+    else if (!liveStream_ || liveStream_->Url() != url)
+    {
+        retired = std::move(liveStream_);
+        std::vector<HttpHeader> headers;
+        headers.emplace_back("X-User-Id", userId);
+        headers.emplace_back("User-Agent", "RLTrainingJournalPlugin/1.0");
+        liveStream_ = std::make_unique<LiveStream>(url, std::move(headers), LiveStreamRate());
+        DiagnosticLogger::Log("ConfigureLiveStream: streaming to " + url);
+        ScheduleLiveSample();
+    }
+
+    // Stopping waits for a send in progress, which can take the full socket timeout.
+    if (retired)
+    {
+        auto future = std::async(std::launch::async, [retired = std::move(retired)]() mutable {
+            retired.reset();
+        });
+        std::lock_guard<std::mutex> lock(requestMutex);
+        pendingRequests.emplace_back(std::move(future));
+    }
+}
+
+int RLTrainingJournalPlugin::LiveStreamRate() const
+{
+    int rate = kDefaultLiveStreamRate;
+    if (cvarManager)
+    {
+        try {
+            rate = cvarManager->getCvar(kLiveStreamRateCvarName).getIntValue();
+        } catch(...) { rate = kDefaultLiveStreamRate; }
+    }
+    return std::clamp(rate, LiveStream::kMinRate, LiveStream::kMaxRate);
+}
+
+// One sample per frame interval rather than per game tick, so the cost on the game
+// thread does not grow with the frame rate. The chain ends when the stream is turned off.
+void RLTrainingJournalPlugin::ScheduleLiveSample()
+{
+    if (!gameWrapper || liveSamplerScheduled_)
+    {
+        return;
+    }
+
+    liveSamplerScheduled_ = true;
+    std::weak_ptr<int> alive = lifetimeToken_;
+    gameWrapper->SetTimeout([this, alive](GameWrapper*) {
+        if (alive.expired())
+        {
+            return;
+        }
+        liveSamplerScheduled_ = false;
+        if (!liveStream_)
+        {
+            return;
+        }
+        SampleLiveState();
+        ScheduleLiveSample();
+    }, 1.0f / static_cast<float>(LiveStreamRate()));
+}
+
+void RLTrainingJournalPlugin::SampleLiveState()
+{
+    const GamePhase phase = uploadLanes_.Phase();
+    if (phase != GamePhase::Live && phase != GamePhase::Replay)
+    {
+        return;
+    }
+    ServerWrapper server = ResolveActiveServer(gameWrapper.get());
+    if (!server)
+    {
+        return;
+    }
+
+    LiveState state;
+    state.matchGuid = MatchKeyFor(server);
+    GameSettingPlaylistWrapper playlist = server.GetPlaylist();
+    state.playlistId = playlist ? playlist.GetPlaylistId() : 0;
+
+    PlayerControllerWrapper localPlayer = server.GetLocalPrimaryPlayer();
+    PriWrapper localPri = localPlayer ? localPlayer.GetPRI() : PriWrapper(0);
+    state.team = localPri ? localPri.GetTeamNum() : -1;
+    ArrayWrapper<TeamWrapper> teams = server.GetTeams();
+    for (int i = 0; i < teams.Count(); ++i)
+    {
+        TeamWrapper team = teams.Get(i);
+        const int teamNum = team ? team.GetTeamNum() : -1;
+        if (teamNum == 0 || teamNum == 1)
+        {
+            state.score[teamNum] = team.GetScore();
+        }
+    }
+    state.clock = MatchClockSeconds(server);
+    state.overtime = server.GetbOverTime() != 0;
+
+    CarWrapper car = gameWrapper->GetLocalCar();
+    BoostWrapper boost = car ? car.GetBoostComponent() : BoostWrapper(0);
+    state.boost = boost ? static_cast<int>(std::lround(std::clamp(boost.GetCurrentBoostAmount(), 0.0f, 1.0f) * 100.0f)) : -1;
+
+    liveStream_->Publish(state);
+}
+
+void RLTrainingJournalPlugin::DispatchOutboxEntry(const OutboxEntry& entry, UploadLane lane)
+{
+    const std::uint64_t seq = entry.seq;
+    DispatchPayloadAsync("/api/mmr-log", entry.body, lane, [this, seq](bool success, const std::string& response) {
+        HandleOutboxResponse(seq, success, response);
+    });
+}
+
+// Runs on upload workers. Every sequenced response carries the watermark, so one
+// acknowledgement can also clear earlier entries whose own responses were lost. The
+// entry itself is held even when a gap below it keeps the watermark back.
+void RLTrainingJournalPlugin::HandleOutboxResponse(std::uint64_t seq, bool success, const std::string& response)
+{
+    std::uint64_t ackedSeq = 0;
+    if (success && UploadOutbox::ReadUnsigned(response, "ackedSeq", ackedSeq))
+    {
+        outbox_.Acknowledge(ackedSeq, {seq});
+        return;
+    }
+
+    // The API rejected the payload itself; keeping it would only fail again.
+    const bool rejected = response.rfind("HTTP 4", 0) == 0 && response.rfind("HTTP 408", 0) != 0 &&
+                          response.rfind("HTTP 429", 0) != 0;
+    if (rejected && seq != 0)
+    {
+        DiagnosticLogger::Log("HandleOutboxResponse: dropping rejected upload seq=" + std::to_string(seq) + ": " + response);
+        outbox_.Discard(seq);
+        return;
+    }
+
+    if (!success)
+    {
+        outboxNeedsSync_.store(true);
+    }
+}
+
+// One GET discovers what the API already holds; only the gap is resent, in order,
+// on a single worker.
+void RLTrainingJournalPlugin::SyncOutbox(const char* reason)
+{
+    if (!apiClient || outbox_.Size() == 0)
+    {
+        outboxNeedsSync_.store(false);
+        return;
+    }
+    if (outboxSyncInFlight_.exchange(true))
+    {
+        return;
+    }
+
+    CleanupFinishedRequests();
+    DiagnosticLogger::Log(std::string("SyncOutbox: reason=") + (reason ? reason : "n/a") +
+                          ", pending=" + std::to_string(outbox_.Size()));
+
+    const std::string userId = cvarManager ? cvarManager->getCvar(kUserIdCvarName).getStringValue() : std::string();
+    std::vector<HttpHeader> headers;
+    headers.emplace_back("X-User-Id", userId);
+    headers.emplace_back("User-Agent", "RLTrainingJournalPlugin/1.0");
+    int bulkThreshold = 20;
+    try
+    {
+        bulkThreshold = cvarManager ? cvarManager->getCvar(kBulkSyncThresholdCvarName).getIntValue() : bulkThreshold;
+    }
+    catch (...)
+    {
+    }
+    outboxNeedsSync_.store(false);
+
+#if RTJ_HAVE_COROUTINES
+    Spawn(*uploadExecutor_, RunOutboxSync(std::move(headers), bulkThreshold));
+#else
+    auto future = std::async(std::launch::async, [this, headers, bulkThreshold]() {
+        RTJ_TRACE_SCOPE("SyncOutbox");
+        RTJ_MEMORY_SCOPE(Transport);
+        RunOutboxSyncBlocking(headers, bulkThreshold);
+    });
+
+    std::lock_guard<std::mutex> lock(requestMutex);
+    pendingRequests.emplace_back(std::move(future));
+#endif
+}
+
+// The steps below are shared by RunOutboxSync and RunOutboxSyncBlocking, which only
+// differ in how they wait: the sequence is probe, watermark, bulk import, then the
+// per-entry tail. Each Apply* returns whether the sync goes on.
+HttpRequest RLTrainingJournalPlugin::OutboxProbeRequest(const std::vector<HttpHeader>& headers) const
+{
+    return SyncRequest("GET", "/api/health", headers);
+}
+
+HttpRequest RLTrainingJournalPlugin::OutboxWatermarkRequest(const std::vector<HttpHeader>& headers) const
+{
+    return SyncRequest("GET", "/api/ingest/watermark?installId=" + outbox_.InstallId(), headers);
+}
+
+bool RLTrainingJournalPlugin::ApplyOutboxProbe(const HttpResult& result)
+{
+    const bool reachable = result.success && result.body.find("\"ok\":true") != std::string::npos;
+    RecordApiHealth(reachable);
+    return reachable;
+}
+
+bool RLTrainingJournalPlugin::ApplyOutboxWatermark(bool reachable, const HttpResult& result)
+{
+    if (!reachable || !result.success)
+    {
+        DiagnosticLogger::Log("SyncOutbox: API unreachable, will retry: " + result.error);
+        outboxNeedsSync_.store(true);
+        outboxSyncInFlight_.store(false);
+        return false;
+    }
+
+    std::uint64_t ackedSeq = 0;
+    UploadOutbox::ReadUnsigned(result.body, "ackedSeq", ackedSeq);
+    outbox_.Acknowledge(ackedSeq, UploadOutbox::ReadUnsignedArray(result.body, "receivedSeqs"));
+    return true;
+}
 
-    oss << "\"teams\":" << SerializeTeams(server) << ',';
-    oss << "\"scoreboard\":" << SerializeScoreboard(server);
-    oss << '}';
+bool RLTrainingJournalPlugin::ApplyOutboxResend(std::uint64_t seq, const HttpResult& result)
+{
+    HandleOutboxResponse(seq, result.success, result.success ? result.body : result.error);
+    return result.success || !outboxNeedsSync_.load();
+}
 
-    return oss.str();
+void RLTrainingJournalPlugin::FinishOutboxSync(std::size_t resent)
+{
+    DiagnosticLogger::Log("SyncOutbox: acked=" + std::to_string(outbox_.AckedSeq()) + ", resent=" + std::to_string(resent) +
+                          ", pending=" + std::to_string(outbox_.Size()));
+    outboxSyncInFlight_.store(false);
 }
 
-bool RLTrainingJournalPlugin::HasValidUniqueId(UniqueIDWrapper& uniqueId) const
+// Runs on the SyncOutbox worker. A large backlog goes up as NDJSON documents, one
+// SQLite transaction each on the API, instead of one POST per entry. Whatever is
+// left afterwards (a failed batch, or the tail below the threshold) takes the
+// per-entry path.
+bool RLTrainingJournalPlugin::NextImportRequest(const std::vector<OutboxEntry>& pending,
+                                                std::size_t begin,
+                                                const std::vector<HttpHeader>& headers,
+                                                HttpRequest& request,
+                                                ImportProgress& progress) const
 {
-    bool hasUniqueId = false;
-    try
+    BacklogDocument document = BuildBacklogDocument(pending, begin, kBulkSyncBatchSize);
+    if (document.entries == 0)
     {
-        hasUniqueId = (uniqueId.GetUID() != 0);
+        return false;
     }
-    catch (...)
+    progress.batchEntries = document.entries;
+    progress.rawBytes += document.rawBytes;
+    progress.sentBytes += document.bytes.size();
+    request = SyncPost("/api/history/import", "application/x-ndjson", std::move(document.bytes), headers);
+    if (document.gzip)
     {
-        hasUniqueId = false;
+        request.headers.emplace_back("Content-Encoding", "gzip");
     }
+    return true;
+}
 
-    if (!hasUniqueId)
+bool RLTrainingJournalPlugin::ApplyImportBatch(std::size_t begin, const HttpResult& result, ImportProgress& progress)
+{
+    if (!result.success)
     {
-        try
-        {
-            hasUniqueId = !uniqueId.GetEpicAccountID().empty();
-        }
-        catch (...)
-        {
-            hasUniqueId = false;
-        }
+        DiagnosticLogger::Log("ImportBacklog: batch at " + std::to_string(begin) + " failed: " + result.error);
+        return false;
     }
+    ApplyImportResponse(result.body);
+    progress.imported += progress.batchEntries;
+    return true;
+}
 
-    return hasUniqueId;
+void RLTrainingJournalPlugin::ApplyImportResponse(const std::string& response)
+{
+    std::uint64_t ackedSeq = 0;
+    UploadOutbox::ReadUnsigned(response, "ackedSeq", ackedSeq);
+    outbox_.Acknowledge(ackedSeq, UploadOutbox::ReadUnsignedArray(response, "receivedSeqs"));
+    // Rejected lines would fail the same way one at a time.
+    for (std::uint64_t seq : UploadOutbox::ReadUnsignedArray(response, "rejectedSeqs"))
+    {
+        outbox_.Discard(seq);
+    }
 }
 
-std::vector<std::string> RLTrainingJournalPlugin::BuildMmrSnapshotPayloads() const
+void RLTrainingJournalPlugin::FinishImportBacklog(std::size_t total, const ImportProgress& progress)
 {
-    std::vector<std::string> payloads;
+    DiagnosticLogger::Log("ImportBacklog: sent " + std::to_string(progress.imported) + " of " + std::to_string(total) +
+                          " entries, " + std::to_string(progress.rawBytes) + " bytes as " + std::to_string(progress.sentBytes) +
+                          ", pending=" + std::to_string(outbox_.Size()));
+}
 
-    if (!gameWrapper)
+#if RTJ_HAVE_COROUTINES
+// The sync as one coroutine, each step awaiting the last without holding a thread.
+Task<void> RLTrainingJournalPlugin::RunOutboxSync(std::vector<HttpHeader> headers, int bulkThreshold)
+{
+    // Not even the health probe goes out during live play.
+    co_await WaitForLane(UploadLane::Bulk, 0.0);
+
+    // While the API is still down each attempt costs one small GET, not a resend.
+    bool reachable = false;
+    std::chrono::milliseconds backoff = kOutboxProbeBackoff;
+    for (int attempt = 0; attempt < kOutboxProbeAttempts && !uploadExecutor_->IsShuttingDown(); ++attempt)
     {
-        DiagnosticLogger::Log("BuildMmrSnapshotPayloads: gameWrapper unavailable");
-        return payloads;
+        if (attempt > 0)
+        {
+            co_await Delay(*uploadExecutor_, backoff);
+            backoff *= 2;
+        }
+        reachable = ApplyOutboxProbe(co_await Request(*apiClient, *uploadExecutor_, OutboxProbeRequest(headers)));
+        if (reachable)
+        {
+            break;
+        }
     }
 
-    auto mmrWrapper = gameWrapper->GetMMRWrapper();
-    if (mmrWrapper.memory_address == 0)
+    HttpResult result;
+    if (reachable)
     {
-        DiagnosticLogger::Log("BuildMmrSnapshotPayloads: mmrWrapper invalid");
-        return payloads;
+        result = co_await Request(*apiClient, *uploadExecutor_, OutboxWatermarkRequest(headers));
     }
-
-    UniqueIDWrapper uniqueId = gameWrapper->GetUniqueID();
-    if (!HasValidUniqueId(uniqueId))
+    if (!ApplyOutboxWatermark(reachable, result))
     {
-        DiagnosticLogger::Log("BuildMmrSnapshotPayloads: unique id not available");
-        return payloads;
+        co_return;
     }
 
-    struct PlaylistTarget
+    if (bulkThreshold > 0 && outbox_.Size() >= static_cast<std::size_t>(bulkThreshold))
     {
-        int playlistId;
-        const char* name;
-    };
-
-    static const PlaylistTarget kPlaylistTargets[] = {
-        {1, "Ranked Duel"},
-        {2, "Ranked Doubles"},
-        {3, "Ranked Standard"},
-        {4, "Ranked 4v4"},
-        {7, "Duel (Legacy)"},
-        {8, "Hoops"},
-        {10, "Rumble"},
-        {11, "Dropshot"},
-        {12, "Faceoff"},
-        {13, "Snow Day"},
-        {27, "Tournament (2v2)"},
-        {28, "Tournament (3v3)"},
-        {34, "Tournament"},
-    };
-
-    const auto now = std::chrono::system_clock::now();
-    const std::string timestamp = FormatTimestamp(now);
-    const std::string userId = cvarManager ? cvarManager->getCvar(kUserIdCvarName).getStringValue() : std::string("unknown");
+        co_await ImportBacklogAsync(headers);
+    }
 
-    for (const auto& target : kPlaylistTargets)
+    std::size_t resent = 0;
+    for (const OutboxEntry& entry : outbox_.Pending())
     {
-        float rating = 0.0f;
-        try
+        co_await WaitForLane(UploadLane::Bulk);
+        result = co_await Request(*apiClient, *uploadExecutor_, SyncPost("/api/mmr-log", "application/json", entry.body, headers));
+        if (!ApplyOutboxResend(entry.seq, result))
         {
-            rating = mmrWrapper.GetPlayerMMR(uniqueId, target.playlistId);
+            break;
         }
-        catch (...)
+        ++resent;
+    }
+    FinishOutboxSync(resent);
+}
+
+Task<void> RLTrainingJournalPlugin::ImportBacklogAsync(std::vector<HttpHeader> headers)
+{
+    const std::vector<OutboxEntry> pending = outbox_.Pending();
+    ImportProgress progress;
+    for (std::size_t begin = 0; begin < pending.size(); begin += kBulkSyncBatchSize)
+    {
+        // Before the build, so compressing a batch waits out live play too.
+        co_await WaitForLane(UploadLane::Bulk);
+        HttpRequest request;
+        if (!NextImportRequest(pending, begin, headers, request, progress))
+        {
+            break;
+        }
+        if (!ApplyImportBatch(begin, co_await Request(*apiClient, *uploadExecutor_, std::move(request)), progress))
         {
-            rating = 0.0f;
+            break;
         }
+    }
+    FinishImportBacklog(pending.size(), progress);
+}
+#else
+// The same sequence for C++17 builds, blocking its std::async thread at each step.
+void RLTrainingJournalPlugin::RunOutboxSyncBlocking(const std::vector<HttpHeader>& headers, int bulkThreshold)
+{
+    uploadLanes_.Acquire(UploadLane::Bulk, 0.0);
 
-        if (rating <= 0.0f)
+    bool reachable = false;
+    std::chrono::milliseconds backoff = kOutboxProbeBackoff;
+    for (int attempt = 0; attempt < kOutboxProbeAttempts; ++attempt)
+    {
+        if (attempt > 0)
         {
-            continue;
+            if (!uploadLanes_.Sleep(backoff))
+            {
+                break;
+            }
+            backoff *= 2;
+        }
+        reachable = ApplyOutboxProbe(SendBlocking(*apiClient, OutboxProbeRequest(headers)));
+        if (reachable)
+        {
+            break;
         }
-
-        std::ostringstream oss;
-        oss << '{'
-            << "\"timestamp\":" << Escape(timestamp) << ','
-            << "\"playlist\":" << Escape(target.name) << ','
-            << "\"mmr\":" << static_cast<int>(std::round(rating)) << ','
-            << "\"gamesPlayedDiff\":0,"
-            << "\"source\":\"bakkes_snapshot\","
-            << "\"userId\":" << Escape(userId) << ','
-            << "\"teams\":[],"
-            << "\"scoreboard\":[]"
-            << '}';
-
-        payloads.emplace_back(oss.str());
     }
 
-    if (payloads.empty())
+    HttpResult result;
+    if (reachable)
     {
-        DiagnosticLogger::Log("BuildMmrSnapshotPayloads: no playlists produced valid ratings");
+        result = SendBlocking(*apiClient, OutboxWatermarkRequest(headers));
     }
-
-    return payloads;
-}
-
-bool RLTrainingJournalPlugin::UploadMmrSnapshot(const char* contextTag)
-{
-    const std::vector<std::string> payloads = BuildMmrSnapshotPayloads();
-    if (payloads.empty())
+    if (!ApplyOutboxWatermark(reachable, result))
     {
-        DiagnosticLogger::Log(std::string("UploadMmrSnapshot: no payloads generated for context ") + (contextTag ? contextTag : "n/a"));
-        return false;
+        return;
     }
 
-    DiagnosticLogger::Log(std::string("UploadMmrSnapshot: sending ") + std::to_string(payloads.size()) +
-                          " playlist snapshots for context " + (contextTag ? contextTag : "n/a"));
-    for (const auto& payload : payloads)
+    if (bulkThreshold > 0 && outbox_.Size() >= static_cast<std::size_t>(bulkThreshold))
     {
-        DispatchPayloadAsync("/api/mmr-log", payload);
+        ImportBacklog(headers);
     }
-    return true;
-}
 
-void RLTrainingJournalPlugin::DispatchPayloadAsync(const std::string& endpoint, const std::string& body)
-{
-    if (!apiClient)
+    std::size_t resent = 0;
+    for (const OutboxEntry& entry : outbox_.Pending())
     {
-        if (cvarManager)
+        uploadLanes_.Acquire(UploadLane::Bulk);
+        if (!ApplyOutboxResend(entry.seq, SendBlocking(*apiClient, SyncPost("/api/mmr-log", "application/json", entry.body, headers))))
         {
-            cvarManager->log("RTJ: API client is not configured");
+            break;
         }
-        return;
+        ++resent;
     }
+    FinishOutboxSync(resent);
+}
 
-    DiagnosticLogger::Log(std::string("DispatchPayloadAsync: endpoint=") + endpoint + ", body_len=" + std::to_string(body.size()));
-
-    CleanupFinishedRequests();
-
-    const std::string userId = cvarManager ? cvarManager->getCvar(kUserIdCvarName).getStringValue() : std::string();
-    std::vector<HttpHeader> headers;
-    headers.emplace_back("X-User-Id", userId);
-    headers.emplace_back("User-Agent", "RLTrainingJournalPlugin/1.0");
-
-    auto future = std::async(std::launch::async, [this, endpoint, body, headers]() {
-        std::string response;
-        bool success = apiClient->PostJson(endpoint, body, headers, response);
-
-        std::lock_guard<std::mutex> lock(requestMutex);
-        if (success)
+void RLTrainingJournalPlugin::ImportBacklog(const std::vector<HttpHeader>& headers)
+{
+    RTJ_TRACE_SCOPE("ImportBacklog");
+    const std::vector<OutboxEntry> pending = outbox_.Pending();
+    ImportProgress progress;
+    for (std::size_t begin = 0; begin < pending.size(); begin += kBulkSyncBatchSize)
+    {
+        uploadLanes_.Acquire(UploadLane::Bulk);
+        HttpRequest request;
+        if (!NextImportRequest(pending, begin, headers, request, progress))
         {
-            lastResponseMessage = response.empty() ? "HTTP 2xx" : response;
-            lastErrorMessage.clear();
+            break;
         }
-        else
+        if (!ApplyImportBatch(begin, SendBlocking(*apiClient, request), progress))
         {
-            lastErrorMessage = response;
+            break;
         }
-    });
+    }
+    FinishImportBacklog(pending.size(), progress);
+}
+#endif
 
-    std::lock_guard<std::mutex> lock(requestMutex);
-    pendingRequests.emplace_back(std::move(future));
+#if RTJ_HAVE_COROUTINES
+// UploadLanes::Acquire without holding an executor thread while the lane refills.
+Task<void> RLTrainingJournalPlugin::WaitForLane(UploadLane lane, double cost)
+{
+    for (auto wait = uploadLanes_.Admit(lane, cost); wait.count() > 0 && !uploadExecutor_->IsShuttingDown();
+         wait = uploadLanes_.Admit(lane, cost))
+    {
+        co_await Delay(*uploadExecutor_, wait);
+    }
 }
+#endif
 
 void RLTrainingJournalPlugin::CleanupFinishedRequests()
 {
@@ -696,6 +2672,7 @@ void RLTrainingJournalPlugin::OnClose()
 
 void RLTrainingJournalPlugin::Render()
 {
+    RTJ_MEMORY_SCOPE(UI);
     DiagnosticLogger::Log("Render: entered");
     if (!menuOpen_)
     {
@@ -704,61 +2681,387 @@ void RLTrainingJournalPlugin::Render()
     }
     std::string lastResponse;
     std::string lastError;
+    std::string rankProgress;
     {
         std::lock_guard<std::mutex> lock(requestMutex);
         lastResponse = lastResponseMessage;
         lastError = lastErrorMessage;
     }
+    {
+        std::lock_guard<std::mutex> lock(payloadMutex_);
+        rankProgress = lastRankProgress_;
+    }
     if (imguiContext_)
     {
         DiagnosticLogger::Log(std::string("Render: setting context ptr=") + std::to_string(reinterpret_cast<uintptr_t>(imguiContext_)));
         ImGui::SetCurrentContext(imguiContext_);
     }
 
-    if (ImGui::GetCurrentContext() == nullptr)
+    if (ImGui::GetCurrentContext() == nullptr)
+    {
+        DiagnosticLogger::Log("Render: ImGui context not available, skipping UI calls");
+        return;
+    }
+
+    bool showDemo = false;
+    if (cvarManager)
+    {
+        try {
+            showDemo = cvarManager->getCvar("rtj_ui_debug_show_demo").getBoolValue();
+        } catch(...) { showDemo = false; }
+    }
+    if (showDemo)
+    {
+        DiagnosticLogger::Log("Render: showing ImGui demo window");
+        ImGui::ShowDemoWindow(&showDemo);
+    }
+
+    DiagnosticLogger::Log("Render: calling ImGui::Begin");
+    bool beginResult = ImGui::Begin("Hardstuck — Rocket League Training Journal##overlay", nullptr, ImGuiWindowFlags_AlwaysAutoResize);
+    DiagnosticLogger::Log(std::string("Render: ImGui::Begin returned ") + (beginResult ? "true" : "false"));
+    if (!beginResult)
+    {
+        ImGui::End();
+        return;
+    }
+
+    ImGui::TextWrapped("Uploads match summaries to the Hardstuck (Rocket League Training Journal) API.");
+    if (!rankProgress.empty())
+    {
+        ImGui::TextWrapped("Rank: %s", rankProgress.c_str());
+    }
+    if (!lastResponse.empty())
+    {
+        ImGui::TextWrapped("Last response: %s", lastResponse.c_str());
+    }
+    if (!lastError.empty())
+    {
+        ImGui::TextWrapped("Last error: %s", lastError.c_str());
+    }
+
+    const std::size_t pendingUploads = outbox_.Size();
+    if (pendingUploads > 0)
+    {
+        ImGui::TextWrapped("Waiting to upload: %zu (acknowledged through #%llu)",
+                           pendingUploads,
+                           static_cast<unsigned long long>(outbox_.AckedSeq()));
+    }
+
+    RenderApiHealth();
+    RenderMmr();
+    RenderMatchHistory();
+    RenderHistoryTable();
+    RenderSessionStats();
+    RenderTrainingStats();
+    RenderMemoryStats();
+
+    if (ImGui::Button("Gather && Upload Now"))
+    {
+        TriggerManualUpload();
+    }
+
+    ImGui::End();
+}
+
+void RLTrainingJournalPlugin::RenderApiHealth()
+{
+    bool known = false;
+    bool reachable = false;
+    std::chrono::system_clock::time_point checkedAt;
+    {
+        std::lock_guard<std::mutex> lock(requestMutex);
+        known = apiHealthKnown_;
+        reachable = apiReachable_;
+        checkedAt = apiCheckedAt_;
+    }
+    if (known)
+    {
+        const long long minutes = std::chrono::duration_cast<std::chrono::minutes>(std::chrono::system_clock::now() - checkedAt).count();
+        ImGui::TextWrapped("API: %s (checked %lldm ago)", reachable ? "reachable" : "unreachable", minutes);
+    }
+}
+
+// Render runs off the game thread, so it only shows the last cached read.
+void RLTrainingJournalPlugin::RenderMmr()
+{
+    const MmrSnapshot snapshot = mmrCache_.Latest();
+    if (!snapshot.valid)
+    {
+        return;
+    }
+
+    TrackedOStringStream ratings;
+    for (std::size_t i = 0; i < PlaylistRegistry::kPlaylistCount; ++i)
+    {
+        if (PlaylistRegistry::kPlaylists[i].rankColumn != RankTableData::RankColumn::None && snapshot.ratings[i] > 0.0f)
+        {
+            ratings << (ratings.tellp() > 0 ? ", " : "") << PlaylistRegistry::kPlaylists[i].name << ' '
+                    << static_cast<int>(std::round(snapshot.ratings[i]));
+        }
+    }
+    const long long ageSeconds = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - snapshot.readAt).count();
+    if (snapshot.wrapperCalls == 0)
+    {
+        // Restored from settings.cfg; nothing has been read this session yet.
+        ImGui::TextWrapped("MMR: %s (saved %lldm ago)", ratings.str().c_str(), ageSeconds / 60);
+    }
+    else
+    {
+        ImGui::TextWrapped("MMR: %s (read %llds ago in %lldus)", ratings.str().c_str(), ageSeconds, static_cast<long long>(snapshot.micros));
+    }
+}
+
+// Shows the playlist of the most recent match; the per-playlist chain makes this a
+// read of kHistoryOverlayMatches records however long the history is.
+void RLTrainingJournalPlugin::RenderMatchHistory()
+{
+    const std::vector<MatchRecord> newest = matchHistory_.RecentAny(1);
+    if (newest.empty())
+    {
+        return;
+    }
+    const int playlistId = newest.front().playlistId;
+    const std::vector<MatchRecord> recent = matchHistory_.Recent(playlistId, kHistoryOverlayMatches);
+    if (recent.empty())
+    {
+        return;
+    }
+
+    int wins = 0;
+    int losses = 0;
+    TrackedOStringStream results;
+    for (const MatchRecord& record : recent)
+    {
+        wins += (record.flags & kMatchWon) ? 1 : 0;
+        losses += (record.flags & kMatchLost) ? 1 : 0;
+        results << ((record.flags & kMatchWon) ? 'W' : (record.flags & kMatchLost) ? 'L' : '-');
+    }
+    const PlaylistInfo* info = PlaylistRegistry::FindById(playlistId);
+    TrackedString name(info ? info->name : "Playlist ");
+    if (!info)
+    {
+        name += std::to_string(playlistId).c_str();
+    }
+    ImGui::TextWrapped("Last %zu in %s: %d-%d %s", recent.size(), name.c_str(), wins, losses, results.str().c_str());
+    // recent is newest first.
+    if (recent.back().mmr > 0 && recent.front().mmr > 0)
+    {
+        ImGui::TextWrapped("MMR %d -> %d (%+d)", recent.back().mmr, recent.front().mmr, recent.front().mmr - recent.back().mmr);
+    }
+    RenderMmrTrend(playlistId);
+}
+
+// PlotLines spaces points evenly; a kept point is never more than one bucket away
+// from its true position, which is under a pixel at kTrendPlotPoints.
+void RLTrainingJournalPlugin::RenderMmrTrend(int playlistId)
+{
+    std::size_t matches = 0;
+    {
+        std::lock_guard<std::mutex> lock(historyViewMutex_);
+        auto it = mmrTrends_.find(playlistId);
+        if (it == mmrTrends_.end())
+        {
+            MmrTrend trend;
+            const std::vector<MatchRecord> records = matchHistory_.Recent(playlistId, matchHistory_.PlaylistSize(playlistId));
+            for (auto record = records.rbegin(); record != records.rend(); ++record)
+            {
+                if (record->mmr > 0)
+                {
+                    trend.Append(record->mmr);
+                }
+            }
+            it = mmrTrends_.emplace(playlistId, std::move(trend)).first;
+        }
+        matches = it->second.Size();
+        it->second.Sample(trendWindow_, kTrendPlotPoints, trendSamples_);
+    }
+    if (trendSamples_.size() < 2)
+    {
+        return;
+    }
+
+    if (ImGui::RadioButton("Last 50", trendWindow_ == 50))
+    {
+        trendWindow_ = 50;
+    }
+    ImGui::SameLine();
+    if (ImGui::RadioButton("Last 500", trendWindow_ == 500))
+    {
+        trendWindow_ = 500;
+    }
+    ImGui::SameLine();
+    if (ImGui::RadioButton("All", trendWindow_ == 0))
+    {
+        trendWindow_ = 0;
+    }
+
+    const auto [low, high] = std::minmax_element(trendSamples_.begin(), trendSamples_.end());
+    const float padding = std::max(10.0f, (*high - *low) * 0.1f);
+    TrackedString overlay(std::to_string(std::min(matches, trendWindow_ == 0 ? matches : trendWindow_)).c_str());
+    overlay += " matches";
+    ImGui::PlotLines("##mmr_trend", trendSamples_.data(), static_cast<int>(trendSamples_.size()), 0, overlay.c_str(),
+                     *low - padding, *high + padding, ImVec2(0.0f, 80.0f));
+}
+
+// Rows are formatted only inside the clipper's visible range, and each comes from a
+// sort order the table keeps current, so a frame costs the same at any table size.
+void RLTrainingJournalPlugin::RenderHistoryTable()
+{
+    if (!ImGui::CollapsingHeader("Match and upload history"))
+    {
+        return;
+    }
+    const std::size_t rows = historyTable_.Size();
+    const std::size_t dropped = historyTable_.DroppedUploads();
+    ImGui::TextWrapped("%zu rows%s", rows, dropped > 0 ? " (upload log full; newer attempts not listed)" : "");
+
+    ImGui::Columns(static_cast<int>(kHistoryColumnCount), "##history_header", true);
+    for (std::size_t column = 0; column < kHistoryColumnCount; ++column)
     {
-        DiagnosticLogger::Log("Render: ImGui context not available, skipping UI calls");
-        return;
+        ImGui::SetColumnWidth(static_cast<int>(column), kHistoryColumnWidths[column]);
+        const bool sorted = static_cast<std::size_t>(historySortColumn_) == column;
+        TrackedString label(kHistoryColumnNames[column]);
+        label += sorted ? (historySortDescending_ ? " v" : " ^") : "";
+        if (ImGui::Selectable(label.c_str(), sorted))
+        {
+            // A second click on the sorted column reverses it.
+            historySortDescending_ = sorted ? !historySortDescending_ : true;
+            historySortColumn_ = static_cast<HistoryColumn>(column);
+        }
+        ImGui::NextColumn();
     }
+    ImGui::Columns(1);
 
-    bool showDemo = false;
-    if (cvarManager)
+    ImGui::BeginChild("##history_rows", ImVec2(0.0f, kHistoryTableHeight), true);
+    ImGui::Columns(static_cast<int>(kHistoryColumnCount), "##history_rows_columns", true);
+    for (std::size_t column = 0; column < kHistoryColumnCount; ++column)
     {
-        try {
-            showDemo = cvarManager->getCvar("rtj_ui_debug_show_demo").getBoolValue();
-        } catch(...) { showDemo = false; }
+        ImGui::SetColumnWidth(static_cast<int>(column), kHistoryColumnWidths[column]);
     }
-    if (showDemo)
+
+    HistoryRow row;
+    ImGuiListClipper clipper;
+    clipper.Begin(static_cast<int>(rows));
+    while (clipper.Step())
     {
-        DiagnosticLogger::Log("Render: showing ImGui demo window");
-        ImGui::ShowDemoWindow(&showDemo);
+        for (int position = clipper.DisplayStart; position < clipper.DisplayEnd; ++position)
+        {
+            if (!historyTable_.RowAt(static_cast<std::size_t>(position), historySortColumn_, historySortDescending_, row))
+            {
+                break;
+            }
+            ImGui::TextUnformatted(ShortLocalTime(row.timestamp).c_str());
+            ImGui::NextColumn();
+            ImGui::TextUnformatted(row.upload ? "Upload" : "Match");
+            ImGui::NextColumn();
+            ImGui::TextUnformatted(row.label.c_str());
+            ImGui::NextColumn();
+            if (row.upload)
+            {
+                if (row.status != 0)
+                {
+                    ImGui::Text("%s (HTTP %u)", row.flags ? "ok" : "failed", static_cast<unsigned>(row.status));
+                }
+                else
+                {
+                    ImGui::TextUnformatted(row.flags ? "ok" : "failed");
+                }
+            }
+            else
+            {
+                const char* result = (row.flags & kMatchWon) ? "Win" : (row.flags & kMatchLost) ? "Loss" : "-";
+                ImGui::Text("%s %u-%u%s%s", result, static_cast<unsigned>(row.teamGoals), static_cast<unsigned>(row.opponentGoals),
+                            (row.flags & kMatchOvertime) ? " OT" : "", (row.flags & kMatchMvp) ? " MVP" : "");
+            }
+            ImGui::NextColumn();
+            if (row.mmr > 0)
+            {
+                ImGui::Text("%d", static_cast<int>(row.mmr));
+            }
+            ImGui::NextColumn();
+            if (row.latencyMillis >= 0)
+            {
+                ImGui::Text("%d ms", static_cast<int>(row.latencyMillis));
+            }
+            ImGui::NextColumn();
+            if (row.bytes >= 0)
+            {
+                ImGui::Text("%.1f KiB", row.bytes / 1024.0);
+            }
+            ImGui::NextColumn();
+        }
     }
+    clipper.End();
+    ImGui::Columns(1);
+    ImGui::EndChild();
+}
 
-    DiagnosticLogger::Log("Render: calling ImGui::Begin");
-    bool beginResult = ImGui::Begin("Hardstuck — Rocket League Training Journal##overlay", nullptr, ImGuiWindowFlags_AlwaysAutoResize);
-    DiagnosticLogger::Log(std::string("Render: ImGui::Begin returned ") + (beginResult ? "true" : "false"));
-    if (!beginResult)
+void RLTrainingJournalPlugin::RenderSessionStats()
+{
+    if (!sessionTracker_.HasActiveSession())
     {
-        ImGui::End();
         return;
     }
 
-    ImGui::TextWrapped("Uploads match summaries to the Hardstuck (Rocket League Training Journal) API.");
-    if (!lastResponse.empty())
+    const SessionSummary session = sessionTracker_.Snapshot();
+    ImGui::Spacing();
+    ImGui::TextWrapped("Session: %d matches (%dW / %dL)", session.matches, session.wins, session.losses);
+    for (const auto& entry : session.playlists)
+    {
+        const PlaylistSessionStats& stats = entry.second;
+        const char streakLabel = stats.currentStreak >= 0 ? 'W' : 'L';
+        ImGui::TextWrapped("%s: %dW %dL, net %+d MMR, streak %c%d, goals/game %.2f (sd %.2f)",
+                           stats.playlistName.c_str(),
+                           stats.wins,
+                           stats.losses,
+                           stats.NetMmr(),
+                           streakLabel,
+                           std::abs(stats.currentStreak),
+                           stats.goals.mean,
+                           stats.goals.StdDev());
+    }
+}
+
+void RLTrainingJournalPlugin::RenderTrainingStats()
+{
+    TrainingPackStats pack;
+    if (!trainingTracker_.ActivePack(pack))
     {
-        ImGui::TextWrapped("Last response: %s", lastResponse.c_str());
+        return;
     }
-    if (!lastError.empty())
+
+    ImGui::Spacing();
+    if (trainingTracker_.ActiveMode() == TrainingMode::Freeplay)
     {
-        ImGui::TextWrapped("Last error: %s", lastError.c_str());
+        ImGui::TextWrapped("Freeplay: %d resets, %d goals", pack.resets, pack.goals);
+        return;
     }
+    ImGui::TextWrapped("Training: %s, %d/%d goals",
+                       pack.name.empty() ? "custom pack" : pack.name.c_str(),
+                       pack.goals,
+                       pack.attempts);
+}
 
-    if (ImGui::Button("Gather && Upload Now"))
+void RLTrainingJournalPlugin::RenderMemoryStats()
+{
+    if (!MemoryTracker::IsCompiledIn() || !MemoryTracker::IsEnabled())
     {
-        TriggerManualUpload();
+        return;
     }
 
-    ImGui::End();
+    const MemorySnapshot snapshot = MemoryTracker::Snapshot();
+    ImGui::Spacing();
+    ImGui::TextWrapped("Memory (live / peak KiB, allocs); last match capture: %llu allocs",
+                       static_cast<unsigned long long>(lastCaptureAllocations_.load()));
+    for (std::size_t i = 0; i < snapshot.size(); ++i)
+    {
+        const MemorySubsystemStats& stats = snapshot[i];
+        ImGui::TextWrapped("%s: %.1f / %.1f, %llu",
+                           MemoryTracker::SubsystemName(static_cast<MemorySubsystem>(i)),
+                           static_cast<double>(stats.liveBytes) / 1024.0,
+                           static_cast<double>(stats.peakBytes) / 1024.0,
+                           static_cast<unsigned long long>(stats.allocations));
+    }
 }
 
 void RLTrainingJournalPlugin::RenderSettings()
@@ -897,145 +3200,682 @@ void RLTrainingJournalPlugin::RenderSettings()
         } catch(...) {
             DiagnosticLogger::Log("RenderSettings: failed to set force_localhost cvar (not registered)");
         }
-        forceLocalhost_ = true;
-        localhostToggle = true;
-        SavePersistedSettings();
+        forceLocalhost_ = true;
+        localhostToggle = true;
+        SavePersistedSettings();
+    }
+    ImGui::SameLine();
+    ImGui::TextWrapped("Use only when the API runs on this Rocket League PC.");
+
+    ImGui::Spacing();
+    ImGui::TextWrapped("Upload fields:");
+    const PayloadProfile currentProfile = payloadProfile_.load();
+    for (PayloadProfile profile : {PayloadProfile::Minimal, PayloadProfile::Standard, PayloadProfile::Full})
+    {
+        ImGui::SameLine();
+        if (ImGui::RadioButton(PayloadProfileName(profile), currentProfile == profile) && currentProfile != profile)
+        {
+            try {
+                cvarManager->getCvar(kPayloadProfileCvarName).setValue(std::string(PayloadProfileName(profile)));
+            } catch(...) {
+                DiagnosticLogger::Log("RenderSettings: failed to set payload profile cvar (not registered)");
+            }
+            SavePersistedSettings();
+        }
+    }
+    ImGui::TextWrapped("Minimal sends only MMR; standard adds teams and scoreboard; full adds match metadata.");
+
+    ImGui::Spacing();
+    if (ImGui::Button("Gather && Upload Now"))
+    {
+        TriggerManualUpload();
+    }
+    ImGui::SameLine();
+    ImGui::TextWrapped("Captures the active match/replay and immediately syncs it.");
+
+    ImGui::Spacing();
+    ImGui::TextWrapped("Tip: Set the API URL to the LAN IP of the machine running the training app (for example: http://192.168.1.236:4000) when streaming data across devices.");
+
+}
+
+std::string RLTrainingJournalPlugin::GetPluginName()
+{
+    return "Hardstuck";
+}
+
+std::string RLTrainingJournalPlugin::GetMenuName()
+{
+    return "rltrainingjournal"; // internal menu name (no spaces)
+}
+
+std::string RLTrainingJournalPlugin::GetMenuTitle()
+{
+    return "Hardstuck"; // title shown in the BakkesMod menu
+}
+
+void RLTrainingJournalPlugin::SetImGuiContext(uintptr_t ctx)
+{
+    // Store the context pointer so we can bind it on whichever thread renders.
+    imguiContext_ = reinterpret_cast<ImGuiContext*>(ctx);
+    ImGui::SetCurrentContext(imguiContext_);
+    DiagnosticLogger::Log(std::string("SetImGuiContext: set context ptr=") + std::to_string(reinterpret_cast<uintptr_t>(imguiContext_)));
+}
+
+void RLTrainingJournalPlugin::ApplyBaseUrl(const std::string& newUrl)
+{
+    const std::string sanitized = EnsureHttpScheme(newUrl);
+
+    if (cvarManager)
+    {
+        try
+        {
+            auto baseCvar = cvarManager->getCvar(kBaseUrlCvarName);
+            baseCvar.setValue(sanitized);
+        }
+        catch (...)
+        {
+        }
+    }
+
+    if (apiClient)
+    {
+        apiClient->SetBaseUrl(sanitized);
+    }
+    if (loadReady_)
+    {
+        ConfigureLiveStream();
+    }
+}
+
+void RLTrainingJournalPlugin::TriggerManualUpload()
+{
+    if (!gameWrapper)
+    {
+        if (cvarManager)
+        {
+            cvarManager->log("RTJ: no game wrapper");
+        }
+        return;
+    }
+
+    gameWrapper->Execute([this](GameWrapper* gw) {
+        ServerWrapper server = ResolveActiveServer(gw);
+        if (CaptureServerAndUpload(server, "manual_sync"))
+        {
+            if (cvarManager)
+            {
+                cvarManager->log("RTJ: manual sync uploaded active match data");
+            }
+            return;
+        }
+
+        if (UploadMmrSnapshot("manual_sync"))
+        {
+            if (cvarManager)
+            {
+                cvarManager->log("RTJ: manual sync uploaded current ranked MMR snapshot");
+            }
+            return;
+        }
+
+        if (DispatchCachedPayload("manual_sync"))
+        {
+            if (cvarManager)
+            {
+                cvarManager->log("RTJ: manual sync used last cached match payload");
+            }
+        }
+        else if (cvarManager)
+        {
+            cvarManager->log("RTJ: manual sync could not gather any match or snapshot data");
+        }
+    });
+}
+
+ServerWrapper RLTrainingJournalPlugin::ResolveActiveServer(GameWrapper* gw) const
+{
+    if (!gw)
+    {
+        return ServerWrapper(0);
+    }
+
+    ServerWrapper server = gw->GetOnlineGame();
+    if (!server)
+    {
+        server = gw->GetGameEventAsServer();
+    }
+    return server;
+}
+
+bool RLTrainingJournalPlugin::CaptureServerAndUpload(ServerWrapper server, const char* contextTag)
+{
+    const char* tag = contextTag ? contextTag : "unknown";
+    if (!server)
+    {
+        DiagnosticLogger::Log(std::string("CaptureServerAndUpload: server invalid for context ") + tag);
+        return false;
+    }
+
+    ScopedTraceUploadId traceUpload(TraceRecorder::NextUploadId());
+    RTJ_TRACE_SCOPE("CaptureServerAndUpload");
+    const std::uint64_t allocationsBefore = MemoryTracker::ThreadAllocations();
+
+    const float mmr = ReadMatchMmr(server);
+    std::string rankProgress;
+    const std::string payload = BuildMatchPayload(server, mmr, &rankProgress);
+    DiagnosticLogger::Log(std::string("CaptureServerAndUpload: context=") + tag + ", payload_len=" + std::to_string(payload.size()));
+    if (!rankProgress.empty())
+    {
+        std::lock_guard<std::mutex> lock(payloadMutex_);
+        lastRankProgress_ = rankProgress;
+    }
+    QueueMmrLog(payload, tag);
+
+    if (std::strcmp(tag, "match_end") == 0)
+    {
+        RecordSessionMatch(server, mmr);
+    }
+    lastCaptureAllocations_.store(MemoryTracker::ThreadAllocations() - allocationsBefore);
+    return true;
+}
+
+std::chrono::minutes RLTrainingJournalPlugin::SessionIdleTimeout() const
+{
+    int minutes = 30;
+    if (cvarManager)
+    {
+        try {
+            minutes = cvarManager->getCvar(kSessionIdleCvarName).getIntValue();
+        } catch(...) { minutes = 30; }
+    }
+    return std::chrono::minutes(std::max(1, minutes));
+}
+
+void RLTrainingJournalPlugin::RecordSessionMatch(ServerWrapper server, float mmr)
+{
+    // EventMatchEnded and Destroyed both fire for the same match; count it once.
+    std::string matchGuid;
+    try {
+        matchGuid = server.GetMatchGUID();
+    } catch(...) { matchGuid.clear(); }
+    if (!matchGuid.empty())
+    {
+        if (matchGuid == lastSessionMatchGuid_)
+        {
+            DiagnosticLogger::Log("RecordSessionMatch: match already counted for session");
+            return;
+        }
+        lastSessionMatchGuid_ = matchGuid;
+    }
+
+    MatchOutcome outcome;
+    GameSettingPlaylistWrapper playlist = server.GetPlaylist();
+    outcome.playlistId = playlist ? playlist.GetPlaylistId() : 0;
+    outcome.playlistName = PlaylistNameFromServer(server);
+    outcome.mmr = static_cast<int>(std::round(mmr));
+
+    PlayerControllerWrapper localPlayer = server.GetLocalPrimaryPlayer();
+    PriWrapper localPri = localPlayer ? localPlayer.GetPRI() : PriWrapper(0);
+    if (localPri)
+    {
+        outcome.goals = localPri.GetMatchGoals();
+        TeamWrapper winner = server.GetMatchWinner();
+        if (winner)
+        {
+            outcome.hasResult = true;
+            outcome.won = winner.GetTeamNum() == localPri.GetTeamNum();
+        }
+        AppendMatchHistory(server, localPri, outcome);
+    }
+
+    sessionTracker_.SetIdleTimeout(SessionIdleTimeout());
+    SessionSummary closed;
+    if (sessionTracker_.RecordMatch(outcome, std::chrono::system_clock::now(), closed))
+    {
+        UploadSessionSummary(closed);
+    }
+}
+
+void RLTrainingJournalPlugin::AppendMatchHistory(ServerWrapper server, PriWrapper localPri, const MatchOutcome& outcome)
+{
+    MatchRecord record;
+    record.timestamp = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    record.playlistId = outcome.playlistId;
+    record.mmr = static_cast<std::int16_t>(std::clamp(outcome.mmr, 0, 32767));
+    record.score = static_cast<std::uint16_t>(std::clamp(localPri.GetMatchScore(), 0, 65535));
+    record.team = ClampByte(localPri.GetTeamNum());
+    record.goals = ClampByte(localPri.GetMatchGoals());
+    record.assists = ClampByte(localPri.GetMatchAssists());
+    record.saves = ClampByte(localPri.GetMatchSaves());
+    record.shots = ClampByte(localPri.GetMatchShots());
+    record.demos = ClampByte(localPri.GetMatchDemolishes());
+    if (outcome.hasResult)
+    {
+        record.flags |= outcome.won ? kMatchWon : kMatchLost;
+    }
+    if (server.GetbOverTime())
+    {
+        record.flags |= kMatchOvertime;
+    }
+    if (localPri.GetbMatchMVP())
+    {
+        record.flags |= kMatchMvp;
+    }
+
+    ArrayWrapper<TeamWrapper> teams = server.GetTeams();
+    for (int i = 0; i < teams.Count(); ++i)
+    {
+        TeamWrapper team = teams.Get(i);
+        if (!team)
+        {
+            continue;
+        }
+        if (team.GetTeamNum() == record.team)
+        {
+            record.teamGoals = ClampByte(team.GetScore());
+        }
+        else
+        {
+            record.opponentGoals = ClampByte(team.GetScore());
+        }
     }
-    ImGui::SameLine();
-    ImGui::TextWrapped("Use only when the API runs on this Rocket League PC.");
 
-    ImGui::Spacing();
-    if (ImGui::Button("Gather && Upload Now"))
+    // Held across both appends so a series built from the file meanwhile cannot
+    // count this record twice.
+    std::lock_guard<std::mutex> lock(historyViewMutex_);
+    std::string error;
+    if (!matchHistory_.Append(record, error))
     {
-        TriggerManualUpload();
+        DiagnosticLogger::Log("AppendMatchHistory: " + error);
+        return;
     }
-    ImGui::SameLine();
-    ImGui::TextWrapped("Captures the active match/replay and immediately syncs it.");
+    historyTable_.AddMatch(record);
+    if (record.mmr > 0)
+    {
+        // A playlist not drawn yet has no series; it is built from the file when it is.
+        auto it = mmrTrends_.find(record.playlistId);
+        if (it != mmrTrends_.end())
+        {
+            it->second.Append(record.mmr);
+        }
+    }
+}
 
-    ImGui::Spacing();
-    ImGui::TextWrapped("Tip: Set the API URL to the LAN IP of the machine running the training app (for example: http://192.168.1.236:4000) when streaming data across devices.");
+void RLTrainingJournalPlugin::ScheduleSessionIdleCheck()
+{
+    if (!gameWrapper)
+    {
+        return;
+    }
 
+    std::weak_ptr<int> alive = lifetimeToken_;
+    gameWrapper->SetTimeout([this, alive](GameWrapper*) {
+        if (alive.expired())
+        {
+            return;
+        }
+        CloseIdleSession(false);
+        // Keeps the overlay's MMR line current between matches.
+        mmrCache_.Get(*gameWrapper);
+        if (outboxNeedsSync_.load())
+        {
+            SyncOutbox("retry");
+        }
+        ScheduleSessionIdleCheck();
+    }, kSessionIdleCheckSeconds);
 }
 
-std::string RLTrainingJournalPlugin::GetPluginName()
+void RLTrainingJournalPlugin::CloseIdleSession(bool force)
 {
-    return "Hardstuck";
+    sessionTracker_.SetIdleTimeout(SessionIdleTimeout());
+    SessionSummary closed;
+    if (sessionTracker_.CloseIfIdle(std::chrono::system_clock::now(), force, closed))
+    {
+        UploadSessionSummary(closed);
+    }
 }
 
-std::string RLTrainingJournalPlugin::GetMenuName()
+void RLTrainingJournalPlugin::UploadSessionSummary(const SessionSummary& summary)
 {
-    return "rltrainingjournal"; // internal menu name (no spaces)
+    if (summary.matches <= 0)
+    {
+        return;
+    }
+
+    const std::string payload = BuildSessionSummaryPayload(summary);
+    DiagnosticLogger::Log(std::string("UploadSessionSummary: matches=") + std::to_string(summary.matches) +
+                          ", payload_len=" + std::to_string(payload.size()));
+    DispatchPayloadAsync("/api/session-summaries", payload, UploadLane::Snapshot);
 }
 
-std::string RLTrainingJournalPlugin::GetMenuTitle()
+std::string RLTrainingJournalPlugin::BuildSessionSummaryPayload(const SessionSummary& summary) const
 {
-    return "Hardstuck"; // title shown in the BakkesMod menu
+    RTJ_MEMORY_SCOPE(Serializer);
+    const std::string userId = cvarManager ? cvarManager->getCvar(kUserIdCvarName).getStringValue() : std::string("unknown");
+
+    TrackedOStringStream oss;
+    oss << std::fixed << std::setprecision(2);
+    oss << '{'
+        << "\"startedTime\":" << Escape(FormatTimestamp(summary.startedAt)) << ','
+        << "\"finishedTime\":" << Escape(FormatTimestamp(summary.lastMatchAt)) << ','
+        << "\"userId\":" << Escape(userId) << ','
+        << "\"matches\":" << summary.matches << ','
+        << "\"wins\":" << summary.wins << ','
+        << "\"losses\":" << summary.losses << ','
+        << "\"playlists\":[";
+
+    bool first = true;
+    for (const auto& entry : summary.playlists)
+    {
+        const PlaylistSessionStats& stats = entry.second;
+        if (!first)
+        {
+            oss << ',';
+        }
+        first = false;
+
+        oss << '{'
+            << "\"playlist\":" << Escape(stats.playlistName) << ','
+            << "\"matches\":" << stats.matches << ','
+            << "\"wins\":" << stats.wins << ','
+            << "\"losses\":" << stats.losses << ','
+            << "\"netMmr\":" << stats.NetMmr() << ','
+            << "\"mmrDeltaMean\":" << stats.mmrDelta.mean << ','
+            << "\"mmrDeltaStdDev\":" << stats.mmrDelta.StdDev() << ','
+            << "\"mmrDeltaMin\":" << stats.mmrDelta.min << ','
+            << "\"mmrDeltaMax\":" << stats.mmrDelta.max << ','
+            << "\"goalsPerGame\":" << stats.goals.mean << ','
+            << "\"goalsStdDev\":" << stats.goals.StdDev() << ','
+            << "\"currentStreak\":" << stats.currentStreak << ','
+            << "\"longestWinStreak\":" << stats.longestWinStreak << ','
+            << "\"longestLossStreak\":" << stats.longestLossStreak
+            << '}';
+    }
+
+    oss << "]}";
+    return ToStdString(oss);
 }
 
-void RLTrainingJournalPlugin::SetImGuiContext(uintptr_t ctx)
+void RLTrainingJournalPlugin::UploadTrainingStint(const TrainingStint& stint)
 {
-    // Store the context pointer so we can bind it on whichever thread renders.
-    imguiContext_ = reinterpret_cast<ImGuiContext*>(ctx);
-    ImGui::SetCurrentContext(imguiContext_);
-    DiagnosticLogger::Log(std::string("SetImGuiContext: set context ptr=") + std::to_string(reinterpret_cast<uintptr_t>(imguiContext_)));
+    int attempts = 0;
+    for (const auto& pack : stint.packs)
+    {
+        attempts += pack.attempts;
+    }
+
+    const double seconds = std::chrono::duration<double>(stint.finishedAt - stint.startedAt).count();
+    if (stint.packs.empty() || (seconds < kMinTrainingStintSeconds && attempts == 0))
+    {
+        DiagnosticLogger::Log("UploadTrainingStint: skipping empty training stint");
+        return;
+    }
+
+    const std::string payload = BuildTrainingSessionPayload(stint);
+    DiagnosticLogger::Log(std::string("UploadTrainingStint: packs=") + std::to_string(stint.packs.size()) +
+                          ", attempts=" + std::to_string(attempts) +
+                          ", payload_len=" + std::to_string(payload.size()));
+    DispatchPayloadAsync("/api/sessions", payload, UploadLane::Snapshot);
 }
 
-void RLTrainingJournalPlugin::ApplyBaseUrl(const std::string& newUrl)
+std::string RLTrainingJournalPlugin::BuildTrainingSessionPayload(const TrainingStint& stint) const
 {
-    const std::string sanitized = EnsureHttpScheme(newUrl);
+    RTJ_MEMORY_SCOPE(Serializer);
+    const bool freeplay = stint.mode == TrainingMode::Freeplay;
 
-    if (cvarManager)
+    int attempts = 0;
+    int goals = 0;
+    for (const auto& pack : stint.packs)
     {
-        try
+        attempts += pack.attempts;
+        goals += pack.goals;
+    }
+
+    std::ostringstream sessionNotes;
+    sessionNotes << (freeplay ? "Freeplay" : "Custom training") << ": "
+                 << goals << " goals from " << attempts << (freeplay ? " resets" : " attempts");
+
+    TrackedOStringStream oss;
+    oss << '{'
+        << "\"startedTime\":" << Escape(FormatTimestamp(stint.startedAt)) << ','
+        << "\"finishedTime\":" << Escape(FormatTimestamp(stint.finishedAt)) << ','
+        << "\"source\":\"bakkes_training\","
+        << "\"notes\":" << Escape(sessionNotes.str()) << ','
+        << "\"blocks\":[";
+
+    bool first = true;
+    for (const auto& pack : stint.packs)
+    {
+        if (!first)
         {
-            auto baseCvar = cvarManager->getCvar(kBaseUrlCvarName);
-            baseCvar.setValue(sanitized);
+            oss << ',';
         }
-        catch (...)
+        first = false;
+
+        std::ostringstream blockNotes;
+        if (freeplay)
         {
+            blockNotes << pack.resets << " resets, " << pack.goals << " goals";
         }
+        else
+        {
+            blockNotes << (pack.name.empty() ? std::string("Training pack") : pack.name);
+            if (!pack.code.empty())
+            {
+                blockNotes << " (" << pack.code << ')';
+            }
+            blockNotes << ": " << pack.goals << '/' << pack.attempts << " goals";
+        }
+
+        // The journal stores whole seconds; time played is both planned and actual.
+        const long long seconds = std::llround(pack.seconds);
+        oss << '{'
+            << "\"type\":" << (freeplay ? "\"freeplay\"" : "\"training_pack\"") << ','
+            << "\"skillIds\":[],";
+        if (!pack.code.empty())
+        {
+            oss << "\"packCode\":" << Escape(pack.code) << ',';
+        }
+        oss << "\"plannedDuration\":" << seconds << ','
+            << "\"actualDuration\":" << seconds << ','
+            << "\"notes\":" << Escape(blockNotes.str())
+            << '}';
     }
 
-    if (apiClient)
+    oss << "]}";
+    return ToStdString(oss);
+}
+
+std::filesystem::path RLTrainingJournalPlugin::ReplayDirectory() const
+{
+    std::string configured;
+    try {
+        configured = cvarManager ? Trimmed(cvarManager->getCvar(kReplayDirCvarName).getStringValue()) : std::string();
+    } catch(...) { configured.clear(); }
+    if (!configured.empty())
     {
-        apiClient->SetBaseUrl(sanitized);
+        return std::filesystem::path(configured);
     }
+
+    std::filesystem::path base;
+#ifdef _WIN32
+    char* profile_env = nullptr;
+    size_t env_len = 0;
+    if (_dupenv_s(&profile_env, &env_len, "USERPROFILE") == 0 && profile_env && profile_env[0] != '\0')
+    {
+        base = profile_env;
+    }
+    if (profile_env)
+    {
+        free(profile_env);
+    }
+#else
+    const char* profile_env = std::getenv("HOME");
+    if (profile_env && profile_env[0] != '\0')
+    {
+        base = profile_env;
+    }
+#endif
+    return base / "Documents" / "My Games" / "Rocket League" / "TAGame" / "Demos";
 }
 
-void RLTrainingJournalPlugin::TriggerManualUpload()
+void RLTrainingJournalPlugin::QueueLatestReplay(std::filesystem::file_time_type notBefore)
 {
-    if (!gameWrapper)
+    const std::filesystem::path replay = FindLatestReplay(ReplayDirectory(), notBefore);
+    if (replay.empty())
     {
-        if (cvarManager)
+        DiagnosticLogger::Log("QueueLatestReplay: no new replay file found");
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(replayMutex_);
+        // EventMatchEnded and Destroyed both schedule a scan for the same match.
+        if (std::find(replayQueue_.begin(), replayQueue_.end(), replay) != replayQueue_.end())
         {
-            cvarManager->log("RTJ: no game wrapper");
+            return;
         }
+        replayQueue_.push_back(replay);
+        SaveReplayQueueLocked();
+    }
+
+    DiagnosticLogger::Log(std::string("QueueLatestReplay: queued ") + replay.string());
+    StartReplayUploads();
+}
+
+void RLTrainingJournalPlugin::StartReplayUploads()
+{
+    bool enabled = false;
+    try {
+        enabled = cvarManager && cvarManager->getCvar(kReplayUploadCvarName).getBoolValue();
+    } catch(...) { enabled = false; }
+    if (!apiClient || !enabled)
+    {
         return;
     }
 
-    gameWrapper->Execute([this](GameWrapper* gw) {
-        ServerWrapper server = ResolveActiveServer(gw);
-        if (CaptureServerAndUpload(server, "manual_sync"))
+    std::lock_guard<std::mutex> lock(replayMutex_);
+    if (replayQueue_.empty() ||
+        (replayUploadTask_.valid() && replayUploadTask_.wait_for(std::chrono::seconds(0)) != std::future_status::ready))
+    {
+        return;
+    }
+
+    // Cvars are read here on the game thread; the worker only sees copies.
+    ReplayUploadOptions options;
+    std::string userId;
+    try {
+        options.bytesPerSecond = static_cast<std::uint32_t>(std::max(16, cvarManager->getCvar(kReplayUploadKbpsCvarName).getIntValue())) * 1024u;
+        userId = cvarManager->getCvar(kUserIdCvarName).getStringValue();
+    } catch(...) { userId.clear(); }
+
+    std::vector<HttpHeader> headers;
+    headers.emplace_back("X-User-Id", userId);
+    headers.emplace_back("User-Agent", "RLTrainingJournalPlugin/1.0");
+
+    // Chunks take no token, as the byte cap already paces them; they only wait while
+    // a higher lane has uploads queued.
+    options.admit = [this]() { return uploadLanes_.Admit(UploadLane::Bulk, 0.0); };
+    options.inFlight = &replayRequestsInFlight_;
+
+    replayUploadCancel_.store(false);
+    replayUploadTask_ = std::async(std::launch::async, [this, options, headers]() {
+        RTJ_TRACE_SCOPE("ReplayUploadWorker");
+        RTJ_MEMORY_SCOPE(Transport);
+
+        while (!replayUploadCancel_.load())
         {
-            if (cvarManager)
+            std::filesystem::path next;
             {
-                cvarManager->log("RTJ: manual sync uploaded active match data");
+                std::lock_guard<std::mutex> queueLock(replayMutex_);
+                if (replayQueue_.empty())
+                {
+                    return;
+                }
+                next = replayQueue_.front();
             }
-            return;
-        }
 
-        if (UploadMmrSnapshot("manual_sync"))
-        {
-            if (cvarManager)
+            std::error_code ec;
+            const bool exists = std::filesystem::exists(next, ec);
+            const ReplayUploadResult result = exists ? UploadReplayFile(*apiClient, next, headers, options, replayUploadCancel_)
+                                                     : ReplayUploadResult{};
+            DiagnosticLogger::Log(std::string("ReplayUploadWorker: ") + next.filename().string() +
+                                  " acked=" + std::to_string(result.acknowledged) + "/" + std::to_string(result.size) +
+                                  ", resumed_from=" + std::to_string(result.resumedFrom) +
+                                  ", chunks=" + std::to_string(result.chunks) +
+                                  (result.error.empty() ? std::string() : ", error=" + result.error));
+            if (exists && !result.complete)
             {
-                cvarManager->log("RTJ: manual sync uploaded current ranked MMR snapshot");
+                // Stay queued; the next match end or plugin load resumes from the acked offset.
+                std::lock_guard<std::mutex> resultLock(requestMutex);
+                lastErrorMessage = "Replay upload paused: " + result.error;
+                return;
             }
-            return;
-        }
 
-        if (DispatchCachedPayload("manual_sync"))
-        {
-            if (cvarManager)
             {
-                cvarManager->log("RTJ: manual sync used last cached match payload");
+                std::lock_guard<std::mutex> queueLock(replayMutex_);
+                replayQueue_.erase(std::remove(replayQueue_.begin(), replayQueue_.end(), next), replayQueue_.end());
+                SaveReplayQueueLocked();
+            }
+            if (exists)
+            {
+                std::lock_guard<std::mutex> resultLock(requestMutex);
+                lastResponseMessage = "Replay uploaded: " + next.filename().string();
+                lastErrorMessage.clear();
             }
-        }
-        else if (cvarManager)
-        {
-            cvarManager->log("RTJ: manual sync could not gather any match or snapshot data");
         }
     });
 }
 
-ServerWrapper RLTrainingJournalPlugin::ResolveActiveServer(GameWrapper* gw) const
+void RLTrainingJournalPlugin::StopReplayUploads()
 {
-    if (!gw)
+    replayUploadCancel_.store(true);
+    std::future<void> task;
     {
-        return ServerWrapper(0);
+        std::lock_guard<std::mutex> lock(replayMutex_);
+        task = std::move(replayUploadTask_);
     }
-
-    ServerWrapper server = gw->GetOnlineGame();
-    if (!server)
+    if (task.valid())
     {
-        server = gw->GetGameEventAsServer();
+        task.wait();
     }
-    return server;
 }
 
-bool RLTrainingJournalPlugin::CaptureServerAndUpload(ServerWrapper server, const char* contextTag)
+void RLTrainingJournalPlugin::LoadReplayQueue()
 {
-    const char* tag = contextTag ? contextTag : "unknown";
-    if (!server)
+    std::ifstream input(GetSettingsPath().parent_path() / "replay_queue.txt");
+    std::string line;
+    std::lock_guard<std::mutex> lock(replayMutex_);
+    replayQueue_.clear();
+    while (std::getline(input, line))
     {
-        DiagnosticLogger::Log(std::string("CaptureServerAndUpload: server invalid for context ") + tag);
-        return false;
+        const std::string trimmedLine = Trimmed(line);
+        if (!trimmedLine.empty())
+        {
+            replayQueue_.emplace_back(std::filesystem::u8path(trimmedLine));
+        }
     }
+}
 
-    const std::string payload = BuildMatchPayload(server);
-    DiagnosticLogger::Log(std::string("CaptureServerAndUpload: context=") + tag + ", payload_len=" + std::to_string(payload.size()));
-    CacheLastPayload(payload, tag);
-    DispatchPayloadAsync("/api/mmr-log", payload);
-    return true;
+void RLTrainingJournalPlugin::SaveReplayQueueLocked() const
+{
+    const std::filesystem::path path = GetSettingsPath().parent_path() / "replay_queue.txt";
+    std::error_code ec;
+    std::filesystem::create_directories(path.parent_path(), ec);
+
+    std::ofstream output(path, std::ios::out | std::ios::trunc);
+    if (!output.is_open())
+    {
+        DiagnosticLogger::Log(std::string("SaveReplayQueueLocked: failed to open ") + path.string());
+        return;
+    }
+    for (const auto& replay : replayQueue_)
+    {
+        // u8string is std::u8string under C++20, which ofstream cannot print directly.
+        const auto utf8 = replay.u8string();
+        output.write(reinterpret_cast<const char*>(utf8.data()), static_cast<std::streamsize>(utf8.size()));
+        output << "\n";
+    }
 }
 
 void RLTrainingJournalPlugin::CacheLastPayload(const std::string& payload, const char* contextTag)
@@ -1063,95 +3903,51 @@ bool RLTrainingJournalPlugin::DispatchCachedPayload(const char* reason)
 
     DiagnosticLogger::Log(std::string("DispatchCachedPayload: sending cached payload captured during ") + context +
                           ", reason=" + (reason ? reason : "n/a"));
-    DispatchPayloadAsync("/api/mmr-log", cached);
+    // The cached payload keeps its clientSeq, so resending a delivered match is a no-op.
+    OutboxEntry entry;
+    entry.body = cached;
+    UploadOutbox::ReadUnsigned(cached, "clientSeq", entry.seq);
+    DispatchOutboxEntry(entry, UploadLane::Correction);
     return true;
 }
 
 std::filesystem::path RLTrainingJournalPlugin::GetSettingsPath() const
 {
-    std::filesystem::path base;
-#ifdef _WIN32
-    char* appdata_env = nullptr;
-    size_t env_len = 0;
-    if (_dupenv_s(&appdata_env, &env_len, "APPDATA") == 0 && appdata_env && appdata_env[0] != '\0')
-    {
-        base = appdata_env;
-    }
-    if (appdata_env)
-    {
-        free(appdata_env);
-    }
-#else
-    const char* appdata_env = std::getenv("APPDATA");
-    if (appdata_env && appdata_env[0] != '\0')
-    {
-        base = appdata_env;
-    }
-#endif
-    if (base.empty())
-    {
-        base = std::filesystem::temp_directory_path();
-    }
-
-    return base / "bakkesmod" / "rltrainingjournal" / "settings.cfg";
+    return dataRoot_ / "rltrainingjournal" / "settings.cfg";
 }
 
-void RLTrainingJournalPlugin::LoadPersistedSettings()
+// Runs on the load worker, so it only reads the store; ApplyPersistedSettings touches the cvars.
+RLTrainingJournalPlugin::PersistedSettings RLTrainingJournalPlugin::ReadPersistedSettings(const SettingsStore& store)
 {
-    const std::filesystem::path path = GetSettingsPath();
-    std::ifstream input(path);
-    if (!input.is_open())
+    PersistedSettings settings;
+    if (store.LoadedVersion() == 0)
     {
-        DiagnosticLogger::Log(std::string("LoadPersistedSettings: missing settings file at ") + path.string());
-        SavePersistedSettings();
-        return;
+        // Written once a setting changes, or on unload.
+        DiagnosticLogger::Log("ReadPersistedSettings: no settings file yet");
+        return settings;
     }
 
-    std::string line;
-    std::string fileBaseUrl;
-    std::string fileUserId;
-    bool hasForce = false;
-    bool forcedValue = forceLocalhost_;
-
-    while (std::getline(input, line))
+    settings.baseUrl = store.Get("base_url");
+    settings.userId = store.Get("user_id");
+    settings.payloadProfile = store.Get("payload_profile");
+    const std::string force = store.Get("force_localhost");
+    if (!force.empty())
     {
-        const std::string trimmedLine = Trimmed(line);
-        if (trimmedLine.empty() || trimmedLine[0] == '#')
-        {
-            continue;
-        }
-
-        const auto eqPos = trimmedLine.find('=');
-        if (eqPos == std::string::npos)
-        {
-            continue;
-        }
-
-        const std::string key = Trimmed(trimmedLine.substr(0, eqPos));
-        const std::string value = Trimmed(trimmedLine.substr(eqPos + 1));
-
-        if (key == "base_url")
-        {
-            fileBaseUrl = value;
-        }
-        else if (key == "user_id")
-        {
-            fileUserId = value;
-        }
-        else if (key == "force_localhost")
-        {
-            hasForce = true;
-            std::string lowered = value;
-            std::transform(lowered.begin(), lowered.end(), lowered.begin(), [](unsigned char ch) {
-                return static_cast<char>(std::tolower(ch));
-            });
-            forcedValue = (lowered == "1" || lowered == "true" || lowered == "yes");
-        }
+        settings.hasForceLocalhost = true;
+        std::string lowered = force;
+        std::transform(lowered.begin(), lowered.end(), lowered.begin(), [](unsigned char ch) {
+            return static_cast<char>(std::tolower(ch));
+        });
+        settings.forceLocalhost = (lowered == "1" || lowered == "true" || lowered == "yes");
     }
+    return settings;
+}
 
-    if (hasForce)
+void RLTrainingJournalPlugin::ApplyPersistedSettings(const PersistedSettings& settings)
+{
+    if (settings.hasForceLocalhost)
     {
-        forceLocalhost_ = forcedValue;
+        forceLocalhost_ = settings.forceLocalhost;
         if (cvarManager)
         {
             try
@@ -1164,9 +3960,9 @@ void RLTrainingJournalPlugin::LoadPersistedSettings()
         }
     }
 
-    if (!fileBaseUrl.empty())
+    if (!settings.baseUrl.empty())
     {
-        const std::string sanitized = EnsureHttpScheme(fileBaseUrl);
+        const std::string sanitized = EnsureHttpScheme(settings.baseUrl);
         ApplyBaseUrl(sanitized);
         if (cvarManager)
         {
@@ -1180,31 +3976,33 @@ void RLTrainingJournalPlugin::LoadPersistedSettings()
         }
     }
 
-    if (!fileUserId.empty() && cvarManager)
+    if (!settings.userId.empty() && cvarManager)
     {
         try
         {
-            cvarManager->getCvar(kUserIdCvarName).setValue(fileUserId);
+            cvarManager->getCvar(kUserIdCvarName).setValue(settings.userId);
         }
         catch (...)
         {
         }
     }
-}
-
-void RLTrainingJournalPlugin::SavePersistedSettings()
-{
-    const std::filesystem::path path = GetSettingsPath();
-    std::error_code ec;
-    std::filesystem::create_directories(path.parent_path(), ec);
 
-    std::ofstream output(path, std::ios::out | std::ios::trunc);
-    if (!output.is_open())
+    if (!settings.payloadProfile.empty() && cvarManager)
     {
-        DiagnosticLogger::Log(std::string("SavePersistedSettings: failed to open settings file at ") + path.string());
-        return;
+        try
+        {
+            cvarManager->getCvar(kPayloadProfileCvarName).setValue(settings.payloadProfile);
+        }
+        catch (...)
+        {
+        }
     }
+}
 
+// Cheap enough for the settings page to call on every change: the store only
+// updates its map, and its writer thread coalesces the file write.
+void RLTrainingJournalPlugin::SavePersistedSettings()
+{
     std::string baseValue;
     std::string userValue;
     if (cvarManager)
@@ -1228,7 +4026,20 @@ void RLTrainingJournalPlugin::SavePersistedSettings()
         }
     }
 
-    output << "base_url=" << baseValue << "\n";
-    output << "force_localhost=" << (forceLocalhost_ ? "1" : "0") << "\n";
-    output << "user_id=" << userValue << "\n";
+    settingsStore_.Set("base_url", baseValue);
+    settingsStore_.Set("force_localhost", forceLocalhost_ ? "1" : "0");
+    settingsStore_.Set("user_id", userValue);
+    settingsStore_.Set("payload_profile", PayloadProfileName(payloadProfile_.load()));
+}
+
+void RLTrainingJournalPlugin::SaveWarmState()
+{
+    WarmState state = WarmStateFromSnapshot(mmrCache_.Latest());
+    {
+        std::lock_guard<std::mutex> lock(requestMutex);
+        state.hasHealth = apiHealthKnown_;
+        state.apiReachable = apiReachable_;
+        state.healthCheckedAt = apiCheckedAt_;
+    }
+    WriteWarmState(settingsStore_, state);
 }
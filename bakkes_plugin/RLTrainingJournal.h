@@ -7,6 +7,13 @@
 #include <memory>
 #include <chrono>
 #include <filesystem>
+#include <iosfwd>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <array>
+#include <utility>
 
 // Forward declarations for trimmed SDK types / helpers
 class CVarManagerWrapper;
@@ -14,8 +21,28 @@ class CVarWrapper;
 class GameWrapper;
 class ServerWrapper;
 class UniqueIDWrapper;
+class PriWrapper;
+struct PlaylistInfo;
 
 #include "ApiClient.h"
+#include "AsyncApi.h"
+#include "HistoryTable.h"
+#include "LiveStream.h"
+#include "MatchHistory.h"
+#include "MatchTimeline.h"
+#include "MmrCache.h"
+#include "MmrTrend.h"
+#include "PayloadProfile.h"
+#include "PayloadSink.h"
+#include "PlayerTable.h"
+#include "ReplayUploader.h"
+#include "SessionStats.h"
+#include "SettingsStore.h"
+#include "TrainingSession.h"
+#include "UploadExecutor.h"
+#include "UploadLanes.h"
+#include "UploadOutbox.h"
+#include "WarmState.h"
 
 struct ImGuiContext;
 
@@ -48,42 +75,225 @@ public:
 
     // Functionality used in implementation
     void RegisterCVars();
+    void RegisterNotifiers();
+    void ApplyPayloadProfile(const std::string& name);
+    void ApplyLivePolicy(const std::string& name);
+    void DumpTrace(const std::string& requestedPath);
+    void LogMemoryReport(bool resetPeaks);
+    void FlushUploads(double seconds);
+    bool UploadsIdle();
+    void LogUploadStats();
+    void RunBenchmark(int iterations);
     void HookMatchEvents();
     void HandleGameEnd(std::string eventName);
     void HandleReplayRecorded(std::string eventName);
+    void HandleStatTickerMessage(void* params);
+    enum class TickerEventKind : std::uint8_t { Other, Goal, Assist, Demolish };
+    TickerEventKind ClassifyStatEvent(std::uintptr_t statEvent);
+    void HandleOvertime(std::string eventName);
+    void HandleTrainingStarted(ServerWrapper caller);
+    void HandleTrainingEnded(std::string eventName);
+    std::uint8_t TimelinePlayerSlot(PriWrapper pri);
+    std::uint16_t MatchClockSeconds(ServerWrapper server) const;
     ServerWrapper ResolveActiveServer(GameWrapper* gw) const;
     bool CaptureServerAndUpload(ServerWrapper server, const char* contextTag);
     void CacheLastPayload(const std::string& payload, const char* contextTag);
     bool DispatchCachedPayload(const char* reason);
     std::vector<std::string> BuildMmrSnapshotPayloads() const;
+    template <typename Policy>
+    std::vector<std::string> BuildMmrSnapshotPayloadsFor() const;
     bool UploadMmrSnapshot(const char* contextTag);
     bool HasValidUniqueId(UniqueIDWrapper& uniqueId) const;
-    void LoadPersistedSettings();
+    // The settings.cfg keys the cvars are restored from; read off the game thread
+    // during load and applied on it.
+    struct PersistedSettings {
+        std::string baseUrl;
+        std::string userId;
+        std::string payloadProfile;
+        bool hasForceLocalhost = false;
+        bool forceLocalhost = true;
+    };
+    static PersistedSettings ReadPersistedSettings(const SettingsStore& store);
+    void ApplyPersistedSettings(const PersistedSettings& settings);
     void SavePersistedSettings();
     std::filesystem::path GetSettingsPath() const;
+    void StartDeferredLoad();
+    void FinishDeferredLoad(const PersistedSettings& settings, const WarmState& warm, std::int64_t readMicros);
+    void RecordLoadPhase(const char* name, std::chrono::steady_clock::time_point started);
+    void SaveWarmState();
+    void RecordApiHealth(bool reachable);
     std::string FormatTimestamp(const std::chrono::system_clock::time_point& tp) const;
     std::string Escape(const std::string& value) const;
     std::string PlaylistNameFromServer(ServerWrapper server) const;
     std::string SerializeTeams(ServerWrapper server) const;
-    std::string SerializeScoreboard(ServerWrapper server) const;
-    std::string BuildMatchPayload(ServerWrapper server) const;
-    void DispatchPayloadAsync(const std::string& endpoint, const std::string& body);
+    std::string SerializeScoreboard(const PlayerTable& table) const;
+    std::string SerializeTimeline(ServerWrapper server) const;
+    float ReadMatchMmr(ServerWrapper server) const;
+    std::string BuildMatchPayload(ServerWrapper server, float mmr, std::string* rankProgress = nullptr) const;
+    template <typename Policy>
+    std::string BuildMatchPayloadFor(ServerWrapper server, float mmr, std::string* rankProgress) const;
+    void AppendRankFields(std::ostream& out, const PlaylistInfo* playlist, int mmr, std::string* rankProgress) const;
+    using UploadCallback = std::function<void(bool success, const std::string& response)>;
+    void DispatchPayloadAsync(const std::string& endpoint, const std::string& body, UploadLane lane,
+                              UploadCallback onComplete = {});
+    void QueueMmrLog(const std::string& payload, const char* contextTag = nullptr);
+    void ConfigureSinks();
+    void PublishToSinks(const OutboxEntry& entry);
+    void ConfigureLiveStream();
+    int LiveStreamRate() const;
+    void ScheduleLiveSample();
+    void SampleLiveState();
+    void DispatchOutboxEntry(const OutboxEntry& entry, UploadLane lane);
+    void HandleOutboxResponse(std::uint64_t seq, bool success, const std::string& response);
+    void SyncOutbox(const char* reason);
+    // Steps of an outbox sync shared by the coroutine and blocking paths.
+    struct ImportProgress {
+        std::size_t batchEntries = 0;
+        std::size_t imported = 0;
+        std::size_t rawBytes = 0;
+        std::size_t sentBytes = 0;
+    };
+    HttpRequest OutboxProbeRequest(const std::vector<HttpHeader>& headers) const;
+    HttpRequest OutboxWatermarkRequest(const std::vector<HttpHeader>& headers) const;
+    bool ApplyOutboxProbe(const HttpResult& result);
+    bool ApplyOutboxWatermark(bool reachable, const HttpResult& result);
+    bool ApplyOutboxResend(std::uint64_t seq, const HttpResult& result);
+    void FinishOutboxSync(std::size_t resent);
+    bool NextImportRequest(const std::vector<OutboxEntry>& pending,
+                           std::size_t begin,
+                           const std::vector<HttpHeader>& headers,
+                           HttpRequest& request,
+                           ImportProgress& progress) const;
+    bool ApplyImportBatch(std::size_t begin, const HttpResult& result, ImportProgress& progress);
+    void ApplyImportResponse(const std::string& response);
+    void FinishImportBacklog(std::size_t total, const ImportProgress& progress);
+    void RecordUploadResult(bool success, const std::string& response);
+    void RecordUploadAttempt(const std::string& endpoint, bool success, unsigned long status,
+                             std::chrono::steady_clock::time_point started, std::size_t bytes);
+#if RTJ_HAVE_COROUTINES
+    Task<void> UploadPayload(std::string endpoint,
+                             std::string body,
+                             std::vector<HttpHeader> headers,
+                             std::uint64_t uploadId,
+                             UploadCallback onComplete);
+    Task<void> RunOutboxSync(std::vector<HttpHeader> headers, int bulkThreshold);
+    Task<void> ImportBacklogAsync(std::vector<HttpHeader> headers);
+    Task<void> WaitForLane(UploadLane lane, double cost = 1.0);
+#else
+    void RunOutboxSyncBlocking(const std::vector<HttpHeader>& headers, int bulkThreshold);
+    void ImportBacklog(const std::vector<HttpHeader>& headers);
+#endif
     void CleanupFinishedRequests();
+    std::chrono::minutes SessionIdleTimeout() const;
+    void RecordSessionMatch(ServerWrapper server, float mmr);
+    void AppendMatchHistory(ServerWrapper server, PriWrapper localPri, const MatchOutcome& outcome);
+    void ScheduleSessionIdleCheck();
+    void CloseIdleSession(bool force);
+    void UploadSessionSummary(const SessionSummary& summary);
+    std::string BuildSessionSummaryPayload(const SessionSummary& summary) const;
+    void UploadTrainingStint(const TrainingStint& stint);
+    std::string BuildTrainingSessionPayload(const TrainingStint& stint) const;
+    std::filesystem::path ReplayDirectory() const;
+    void QueueLatestReplay(std::filesystem::file_time_type notBefore);
+    void StartReplayUploads();
+    void StopReplayUploads();
+    void LoadReplayQueue();
+    void SaveReplayQueueLocked() const;
+    void RenderApiHealth();
+    void RenderMmr();
+    void RenderMatchHistory();
+    void RenderMmrTrend(int playlistId);
+    void RenderHistoryTable();
+    void RenderSessionStats();
+    void RenderTrainingStats();
+    void RenderMemoryStats();
     void ApplyBaseUrl(const std::string& newUrl);
     void TriggerManualUpload();
 
     // State
     std::unique_ptr<ApiClient> apiClient;
+#if RTJ_HAVE_COROUTINES
+    // Runs upload coroutines; requests wait in WinHTTP, not on these threads.
+    std::unique_ptr<UploadExecutor> uploadExecutor_;
+#endif
 
+    // Orders and rate-limits everything sent to the API; started and stopped with the plugin.
+    UploadLanes uploadLanes_;
     std::mutex requestMutex;
     std::vector<std::future<void>> pendingRequests;
     std::string lastResponseMessage;
     std::string lastErrorMessage;
+    // Last time any request reached (or failed to reach) the API; guarded by requestMutex.
+    bool apiHealthKnown_ = false;
+    bool apiReachable_ = false;
+    std::chrono::system_clock::time_point apiCheckedAt_;
     std::mutex payloadMutex_;
     std::string lastPayload_;
     std::string lastPayloadContext_;
+    std::string lastRankProgress_;
+
+    // Game thread only; reused by every match capture so its columns stay allocated.
+    mutable PlayerTable playerTable_;
+    mutable PlayerTableCaptureStats lastPlayerCaptureStats_;
+    bool benchmarking_ = false; // game thread only; quiets per-capture logging during rtj_bench
+    MatchTimeline matchTimeline_; // game thread only
+    // Stat events are archetypes that live for the session, so each one's name is
+    // read once and its kind cached by address. Game thread only.
+    std::array<std::pair<std::uintptr_t, TickerEventKind>, 64> statEventKinds_{};
+    std::size_t statEventKindCount_ = 0;
+    mutable MmrCache mmrCache_{[this](UniqueIDWrapper& uniqueId) { return HasValidUniqueId(uniqueId); }};
+    // match_history.bin; opened by the deferred load, appended on the game thread.
+    MatchHistory matchHistory_;
+    // Views of matchHistory_: the per-playlist MMR series for the overlay chart, built
+    // the first time a playlist is drawn, and the history table, seeded on load.
+    // historyViewMutex_ is held while a view reads the file and while a match is
+    // appended to both, so no view sees a match twice.
+    std::mutex historyViewMutex_;
+    std::unordered_map<int, MmrTrend> mmrTrends_;
+    HistoryTable historyTable_; // also records upload attempts; thread-safe
+    HistoryColumn historySortColumn_ = HistoryColumn::Time; // render thread only
+    bool historySortDescending_ = true;                     // render thread only
+    std::vector<float> trendSamples_; // render thread only; reused every frame
+    std::size_t trendWindow_ = 0;     // render thread only; matches shown, 0 = all
+
+    SessionTracker sessionTracker_;
+    std::string lastSessionMatchGuid_;
+    TrainingSessionTracker trainingTracker_;
+
+    // Replay files still to upload, oldest first; mirrored to replay_queue.txt so an
+    // interrupted upload resumes (from the server's offset) after a restart.
+    std::mutex replayMutex_;
+    std::vector<std::filesystem::path> replayQueue_;
+    std::future<void> replayUploadTask_;
+    std::atomic<bool> replayUploadCancel_{false};
+    std::atomic<std::uint32_t> replayRequestsInFlight_{0}; // part of apiClient's in-flight count
+
+    UploadOutbox outbox_;
+    // Mirror API and NDJSON archive; every stamped mmr-log upload goes to each as well
+    // as to the outbox. Game thread only.
+    std::vector<std::unique_ptr<PayloadSink>> sinks_;
+    // Live match state for the journal's dashboard, sampled at the stream's rate while
+    // a match is live. Game thread only.
+    std::unique_ptr<LiveStream> liveStream_;
+    bool liveSamplerScheduled_ = false;
+    SettingsStore settingsStore_;
+    // Game thread only. Until the deferred load has read outbox.txt, mmr-log payloads
+    // wait here instead of being stamped.
+    bool loadReady_ = false;
+    std::vector<std::pair<std::string, const char*>> deferredUploads_;
+    // The worker reading settings.cfg, outbox.txt and match_history.bin; onUnload waits
+    // for it before closing any of them.
+    std::future<void> deferredLoad_;
+    std::chrono::steady_clock::time_point loadStarted_;
+    std::vector<std::pair<const char*, std::int64_t>> loadPhases_; // microseconds per onLoad phase
+    std::filesystem::path dataRoot_; // %APPDATA%/bakkesmod, resolved once on load
+    std::atomic<bool> outboxNeedsSync_{false};
+    std::atomic<bool> outboxSyncInFlight_{false};
+    std::shared_ptr<int> lifetimeToken_;
+    std::atomic<std::uint64_t> lastCaptureAllocations_{0};
 
     bool forceLocalhost_ = true;
+    std::atomic<PayloadProfile> payloadProfile_{PayloadProfile::Standard};
     ImGuiContext* imguiContext_ = nullptr;
     bool menuOpen_ = false;
 };
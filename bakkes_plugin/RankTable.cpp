@@ -0,0 +1,96 @@
+#include "pch.h"
+#include "RankTable.h"
+
+#include <algorithm>
+
+namespace
+{
+    using RankTableData::RankColumnTable;
+    using RankTableData::RankInterval;
+
+    constexpr std::size_t kTierCount = sizeof(RankTableData::kTierNames) / sizeof(RankTableData::kTierNames[0]);
+
+    // Each interval ends one below the next floor, so an MMR between the lowest floor
+    // and the top ceiling is inside exactly one interval.
+    constexpr bool IsContiguous(const RankColumnTable& table)
+    {
+        for (std::size_t i = 0; i < table.count; ++i)
+        {
+            if (table.intervals[i].tier >= kTierCount || table.intervals[i].floor > table.intervals[i].ceiling)
+            {
+                return false;
+            }
+            if (i > 0 && table.intervals[i - 1].ceiling + 1 != table.intervals[i].floor)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    constexpr bool AllTablesContiguous()
+    {
+        for (const auto& table : RankTableData::kColumnTables)
+        {
+            if (!IsContiguous(table))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static_assert(sizeof(RankTableData::kColumnTables) / sizeof(RankColumnTable) ==
+                      static_cast<std::size_t>(RankTableData::RankColumn::Count),
+                  "RankTable.generated.h is out of sync; run npm run generate:ranks");
+    static_assert(AllTablesContiguous(), "rank intervals must be sorted and contiguous; run npm run generate:ranks");
+}
+
+bool RankTable::Lookup(RankTableData::RankColumn column, int mmr, RankLookupResult& result)
+{
+    if (column >= RankTableData::RankColumn::Count)
+    {
+        return false;
+    }
+
+    const RankColumnTable& table = RankTableData::kColumnTables[static_cast<std::size_t>(column)];
+    const RankInterval* begin = table.intervals;
+    const RankInterval* end = table.intervals + table.count;
+
+    // First interval whose floor is above mmr; the one before it is the current division.
+    // Intervals are contiguous, so mmr is within its ceiling unless it is above the top one.
+    const RankInterval* next = std::upper_bound(begin, end, mmr, [](int value, const RankInterval& interval) {
+        return value < interval.floor;
+    });
+    if (next == begin)
+    {
+        return false;
+    }
+
+    const RankInterval& current = *(next - 1);
+    result = RankLookupResult{};
+    result.tier = RankTableData::kTierNames[current.tier];
+    result.division = current.division;
+    result.floor = current.floor;
+    result.ceiling = current.ceiling;
+
+    if (next != end)
+    {
+        result.hasNext = true;
+        result.nextTier = RankTableData::kTierNames[next->tier];
+        result.nextDivision = next->division;
+        result.mmrToNext = next->floor - mmr;
+    }
+
+    return true;
+}
+
+std::string RankTable::FormatRank(const char* tier, int division)
+{
+    std::string formatted = tier ? tier : "";
+    if (division > 0)
+    {
+        formatted += " Div " + std::to_string(division);
+    }
+    return formatted;
+}
@@ -0,0 +1,647 @@
+// Generated by tools/generate-rank-table.js from ranks.csv. Do not edit by hand.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace RankTableData
+{
+    enum class RankColumn : std::uint8_t
+    {
+        Duel,
+        Doubles,
+        Standard,
+        Hoops,
+        Rumble,
+        Dropshot,
+        SnowDay,
+        Quads,
+        Count,
+        None = Count
+    };
+
+    struct RankInterval
+    {
+        std::int16_t floor;
+        std::int16_t ceiling;
+        std::uint8_t tier;
+        std::uint8_t division;
+    };
+
+    struct RankColumnTable
+    {
+        const RankInterval* intervals;
+        std::size_t count;
+    };
+
+    constexpr const char* kTierNames[] = {"B1", "B2", "B3", "S1", "S2", "S3", "G1", "G2", "G3", "P1", "P2", "P3", "D1", "D2", "D3", "C1", "C2", "C3", "GC1", "GC2", "GC3", "SSL"};
+
+    constexpr RankInterval kDuelIntervals[] = {
+        {560, 578, 0, 1},
+        {579, 597, 0, 2},
+        {598, 616, 0, 3},
+        {617, 634, 0, 4},
+        {635, 638, 9, 1},
+        {639, 657, 9, 2},
+        {658, 676, 9, 3},
+        {677, 694, 9, 4},
+        {695, 698, 10, 1},
+        {699, 717, 10, 2},
+        {718, 736, 10, 3},
+        {737, 754, 10, 4},
+        {755, 758, 11, 1},
+        {759, 777, 11, 2},
+        {778, 796, 11, 3},
+        {797, 814, 11, 4},
+        {815, 818, 12, 1},
+        {819, 837, 12, 2},
+        {838, 856, 12, 3},
+        {857, 874, 12, 4},
+        {875, 878, 13, 1},
+        {879, 897, 13, 2},
+        {898, 916, 13, 3},
+        {917, 934, 13, 4},
+        {935, 938, 14, 1},
+        {939, 957, 14, 2},
+        {958, 976, 14, 3},
+        {977, 994, 14, 4},
+        {995, 998, 15, 1},
+        {999, 1017, 15, 2},
+        {1018, 1036, 15, 3},
+        {1037, 1054, 15, 4},
+        {1055, 1058, 16, 1},
+        {1059, 1077, 16, 2},
+        {1078, 1096, 16, 3},
+        {1097, 1107, 16, 4},
+        {1108, 1118, 17, 1},
+        {1119, 1137, 17, 2},
+        {1138, 1156, 17, 3},
+        {1157, 1174, 17, 4},
+        {1175, 1178, 18, 1},
+        {1179, 1197, 18, 2},
+        {1198, 1216, 18, 3},
+        {1217, 1232, 18, 4},
+        {1233, 1240, 19, 1},
+        {1241, 1257, 19, 2},
+        {1258, 1276, 19, 3},
+        {1277, 1294, 19, 4},
+        {1295, 1298, 20, 1},
+        {1299, 1317, 20, 2},
+        {1318, 1336, 20, 3},
+        {1337, 1349, 20, 4},
+        {1350, 1660, 21, 0},
+    };
+
+    constexpr RankInterval kDoublesIntervals[] = {
+        {0, 0, 0, 1},
+        {1, 18, 0, 3},
+        {19, 34, 0, 4},
+        {35, 50, 1, 1},
+        {51, 66, 1, 2},
+        {67, 81, 1, 3},
+        {82, 97, 1, 4},
+        {98, 113, 2, 1},
+        {114, 129, 2, 2},
+        {130, 145, 2, 3},
+        {146, 160, 2, 4},
+        {161, 176, 3, 1},
+        {177, 192, 3, 2},
+        {193, 208, 3, 3},
+        {209, 223, 3, 4},
+        {224, 239, 4, 1},
+        {240, 255, 4, 2},
+        {256, 271, 4, 3},
+        {272, 287, 4, 4},
+        {288, 303, 5, 1},
+        {304, 319, 5, 2},
+        {320, 335, 5, 3},
+        {336, 350, 5, 4},
+        {351, 366, 6, 1},
+        {367, 382, 6, 2},
+        {383, 398, 6, 3},
+        {399, 413, 6, 4},
+        {414, 429, 7, 1},
+        {430, 445, 7, 2},
+        {446, 461, 7, 3},
+        {462, 478, 7, 4},
+        {479, 494, 8, 1},
+        {495, 510, 8, 2},
+        {511, 527, 8, 3},
+        {528, 546, 8, 4},
+        {547, 566, 9, 1},
+        {567, 584, 9, 2},
+        {585, 603, 9, 3},
+        {604, 622, 9, 4},
+        {623, 644, 10, 1},
+        {645, 663, 10, 2},
+        {664, 682, 10, 3},
+        {683, 701, 10, 4},
+        {702, 722, 11, 1},
+        {723, 741, 11, 2},
+        {742, 760, 11, 3},
+        {761, 779, 11, 4},
+        {780, 801, 12, 1},
+        {802, 820, 12, 2},
+        {821, 839, 12, 3},
+        {840, 859, 12, 4},
+        {860, 877, 13, 1},
+        {878, 896, 13, 2},
+        {897, 915, 13, 3},
+        {916, 934, 13, 4},
+        {935, 944, 14, 1},
+        {945, 977, 14, 2},
+        {978, 1007, 14, 3},
+        {1008, 1043, 14, 4},
+        {1044, 1080, 15, 1},
+        {1081, 1114, 15, 2},
+        {1115, 1147, 15, 3},
+        {1148, 1179, 15, 4},
+        {1180, 1213, 16, 1},
+        {1214, 1247, 16, 2},
+        {1248, 1281, 16, 3},
+        {1282, 1314, 16, 4},
+        {1315, 1333, 17, 1},
+        {1334, 1367, 17, 2},
+        {1368, 1401, 17, 3},
+        {1402, 1434, 17, 4},
+        {1435, 1461, 18, 1},
+        {1462, 1497, 18, 2},
+        {1498, 1536, 18, 3},
+        {1537, 1574, 18, 4},
+        {1575, 1599, 19, 1},
+        {1600, 1637, 19, 2},
+        {1638, 1676, 19, 3},
+        {1677, 1714, 19, 4},
+        {1715, 1743, 20, 1},
+        {1744, 1787, 20, 2},
+        {1788, 1831, 20, 3},
+        {1832, 1860, 20, 4},
+        {1861, 2101, 21, 0},
+    };
+
+    constexpr RankInterval kStandardIntervals[] = {
+        {0, 0, 0, 1},
+        {1, 10, 1, 2},
+        {11, 26, 1, 3},
+        {27, 42, 1, 4},
+        {43, 57, 2, 1},
+        {58, 73, 2, 2},
+        {74, 89, 2, 3},
+        {90, 105, 2, 4},
+        {106, 121, 3, 1},
+        {122, 136, 3, 2},
+        {137, 152, 3, 3},
+        {153, 168, 3, 4},
+        {169, 184, 4, 1},
+        {185, 200, 4, 2},
+        {201, 216, 4, 3},
+        {217, 232, 4, 4},
+        {233, 248, 5, 1},
+        {249, 263, 5, 2},
+        {264, 279, 5, 3},
+        {280, 294, 5, 4},
+        {295, 311, 6, 1},
+        {312, 326, 6, 2},
+        {327, 342, 6, 3},
+        {343, 358, 6, 4},
+        {359, 373, 7, 1},
+        {374, 389, 7, 2},
+        {390, 405, 7, 3},
+        {406, 420, 7, 4},
+        {421, 436, 8, 1},
+        {437, 452, 8, 2},
+        {453, 468, 8, 3},
+        {469, 482, 8, 4},
+        {483, 503, 9, 1},
+        {504, 523, 9, 2},
+        {524, 542, 9, 3},
+        {543, 562, 9, 4},
+        {563, 585, 10, 1},
+        {586, 605, 10, 2},
+        {606, 626, 10, 3},
+        {627, 647, 10, 4},
+        {648, 669, 11, 1},
+        {670, 690, 11, 2},
+        {691, 711, 11, 3},
+        {712, 733, 11, 4},
+        {734, 755, 12, 1},
+        {756, 776, 12, 2},
+        {777, 798, 12, 3},
+        {799, 822, 12, 4},
+        {823, 846, 13, 1},
+        {847, 871, 13, 2},
+        {872, 897, 13, 3},
+        {898, 922, 13, 4},
+        {923, 949, 14, 1},
+        {950, 988, 14, 2},
+        {989, 1016, 14, 3},
+        {1017, 1044, 14, 4},
+        {1045, 1080, 15, 1},
+        {1081, 1113, 15, 2},
+        {1114, 1147, 15, 3},
+        {1148, 1179, 15, 4},
+        {1180, 1213, 16, 1},
+        {1214, 1247, 16, 2},
+        {1248, 1281, 16, 3},
+        {1282, 1300, 16, 4},
+        {1301, 1332, 17, 1},
+        {1333, 1367, 17, 2},
+        {1368, 1401, 17, 3},
+        {1402, 1434, 17, 4},
+        {1435, 1459, 18, 1},
+        {1460, 1497, 18, 2},
+        {1498, 1536, 18, 3},
+        {1537, 1574, 18, 4},
+        {1575, 1600, 19, 1},
+        {1601, 1638, 19, 2},
+        {1639, 1676, 19, 3},
+        {1677, 1707, 19, 4},
+        {1708, 1744, 20, 1},
+        {1745, 1787, 20, 2},
+        {1788, 1830, 20, 3},
+        {1831, 1868, 20, 4},
+        {1869, 2002, 21, 0},
+    };
+
+    constexpr RankInterval kHoopsIntervals[] = {
+        {245, 280, 0, 1},
+        {281, 317, 1, 1},
+        {318, 353, 2, 1},
+        {354, 389, 3, 1},
+        {390, 425, 4, 1},
+        {426, 461, 5, 1},
+        {462, 498, 6, 1},
+        {499, 534, 7, 1},
+        {535, 571, 8, 1},
+        {572, 607, 9, 1},
+        {608, 644, 9, 3},
+        {645, 680, 10, 1},
+        {681, 716, 10, 3},
+        {717, 753, 11, 1},
+        {754, 788, 11, 3},
+        {789, 825, 12, 1},
+        {826, 861, 12, 3},
+        {862, 900, 13, 3},
+        {901, 936, 14, 1},
+        {937, 976, 15, 1},
+        {977, 1020, 16, 1},
+        {1021, 1076, 17, 1},
+        {1077, 1094, 17, 4},
+        {1095, 1098, 18, 1},
+        {1099, 1117, 18, 2},
+        {1118, 1136, 18, 3},
+        {1137, 1149, 18, 4},
+        {1150, 1159, 19, 1},
+        {1160, 1177, 19, 2},
+        {1178, 1196, 19, 3},
+        {1197, 1204, 19, 4},
+        {1205, 1220, 20, 1},
+        {1221, 1237, 20, 2},
+        {1238, 1256, 20, 3},
+        {1257, 1274, 20, 4},
+        {1275, 1316, 21, 0},
+    };
+
+    constexpr RankInterval kRumbleIntervals[] = {
+        {0, 17, 0, 1},
+        {18, 33, 0, 2},
+        {34, 49, 0, 3},
+        {50, 65, 0, 4},
+        {66, 81, 1, 1},
+        {82, 97, 1, 2},
+        {98, 113, 1, 3},
+        {114, 129, 1, 4},
+        {130, 145, 2, 1},
+        {146, 161, 2, 2},
+        {162, 177, 2, 3},
+        {178, 193, 2, 4},
+        {194, 209, 3, 1},
+        {210, 225, 3, 2},
+        {226, 241, 3, 3},
+        {242, 257, 3, 4},
+        {258, 273, 4, 1},
+        {274, 289, 4, 2},
+        {290, 305, 4, 3},
+        {306, 321, 4, 4},
+        {322, 337, 5, 1},
+        {338, 353, 5, 2},
+        {354, 369, 5, 3},
+        {370, 385, 5, 4},
+        {386, 401, 6, 1},
+        {402, 417, 6, 2},
+        {418, 433, 6, 3},
+        {434, 449, 6, 4},
+        {450, 465, 7, 1},
+        {466, 481, 7, 2},
+        {482, 498, 7, 3},
+        {499, 515, 7, 4},
+        {516, 534, 8, 1},
+        {535, 552, 8, 2},
+        {553, 570, 8, 3},
+        {571, 589, 8, 4},
+        {590, 607, 9, 1},
+        {608, 625, 9, 2},
+        {626, 643, 9, 3},
+        {644, 661, 9, 4},
+        {662, 679, 10, 1},
+        {680, 697, 10, 2},
+        {698, 715, 10, 3},
+        {716, 733, 10, 4},
+        {734, 751, 11, 1},
+        {752, 769, 11, 2},
+        {770, 787, 11, 3},
+        {788, 805, 11, 4},
+        {806, 823, 12, 1},
+        {824, 841, 12, 2},
+        {842, 859, 12, 3},
+        {860, 877, 12, 4},
+        {878, 896, 13, 1},
+        {897, 915, 13, 2},
+        {916, 933, 13, 3},
+        {934, 949, 13, 4},
+        {950, 965, 14, 1},
+        {966, 982, 14, 2},
+        {983, 999, 14, 3},
+        {1000, 1019, 14, 4},
+        {1020, 1040, 15, 1},
+        {1041, 1061, 15, 2},
+        {1062, 1082, 15, 3},
+        {1083, 1099, 15, 4},
+        {1100, 1100, 16, 1},
+        {1101, 1123, 17, 1},
+        {1124, 1147, 17, 2},
+        {1148, 1171, 17, 3},
+        {1172, 1194, 17, 4},
+        {1195, 1203, 18, 1},
+        {1204, 1227, 18, 2},
+        {1228, 1251, 18, 3},
+        {1252, 1274, 18, 4},
+        {1275, 1284, 19, 1},
+        {1285, 1307, 19, 2},
+        {1308, 1331, 19, 3},
+        {1332, 1349, 19, 4},
+        {1350, 1368, 20, 1},
+        {1369, 1397, 20, 2},
+        {1398, 1426, 20, 3},
+        {1427, 1454, 20, 4},
+        {1455, 1545, 21, 0},
+    };
+
+    constexpr RankInterval kDropshotIntervals[] = {
+        {212, 221, 0, 1},
+        {222, 231, 0, 2},
+        {232, 241, 0, 3},
+        {242, 251, 0, 4},
+        {252, 261, 1, 1},
+        {262, 271, 1, 2},
+        {272, 281, 1, 3},
+        {282, 291, 1, 4},
+        {292, 301, 2, 1},
+        {302, 311, 2, 2},
+        {312, 321, 2, 3},
+        {322, 331, 2, 4},
+        {332, 341, 3, 1},
+        {342, 351, 3, 2},
+        {352, 361, 3, 3},
+        {362, 371, 3, 4},
+        {372, 381, 4, 1},
+        {382, 391, 4, 2},
+        {392, 401, 4, 3},
+        {402, 411, 4, 4},
+        {412, 421, 5, 1},
+        {422, 431, 5, 2},
+        {432, 441, 5, 3},
+        {442, 451, 5, 4},
+        {452, 461, 6, 1},
+        {462, 471, 6, 2},
+        {472, 481, 6, 3},
+        {482, 491, 6, 4},
+        {492, 501, 7, 1},
+        {502, 511, 7, 2},
+        {512, 521, 7, 3},
+        {522, 531, 7, 4},
+        {532, 541, 8, 1},
+        {542, 551, 8, 2},
+        {552, 561, 8, 3},
+        {562, 571, 8, 4},
+        {572, 581, 9, 1},
+        {582, 591, 9, 2},
+        {592, 601, 9, 3},
+        {602, 611, 9, 4},
+        {612, 621, 10, 1},
+        {622, 631, 10, 2},
+        {632, 641, 10, 3},
+        {642, 651, 10, 4},
+        {652, 661, 11, 1},
+        {662, 671, 11, 2},
+        {672, 682, 11, 3},
+        {683, 692, 11, 4},
+        {693, 702, 12, 1},
+        {703, 712, 12, 2},
+        {713, 723, 12, 3},
+        {724, 733, 12, 4},
+        {734, 743, 13, 1},
+        {744, 753, 13, 2},
+        {754, 765, 13, 3},
+        {766, 785, 13, 4},
+        {786, 793, 14, 1},
+        {794, 803, 14, 2},
+        {804, 814, 14, 3},
+        {815, 834, 14, 4},
+        {835, 848, 15, 1},
+        {849, 860, 15, 2},
+        {861, 874, 15, 3},
+        {875, 894, 15, 4},
+        {895, 906, 16, 1},
+        {907, 926, 16, 2},
+        {927, 940, 16, 3},
+        {941, 994, 16, 4},
+        {995, 998, 17, 1},
+        {999, 1017, 17, 2},
+        {1018, 1036, 17, 3},
+        {1037, 1054, 17, 4},
+        {1055, 1058, 18, 1},
+        {1059, 1080, 18, 2},
+        {1081, 1096, 18, 3},
+        {1097, 1107, 18, 4},
+        {1108, 1118, 19, 1},
+        {1119, 1137, 19, 2},
+        {1138, 1156, 19, 3},
+        {1157, 1169, 19, 4},
+        {1170, 1179, 20, 1},
+        {1180, 1197, 20, 2},
+        {1198, 1216, 20, 3},
+        {1217, 1234, 20, 4},
+        {1235, 1271, 21, 0},
+    };
+
+    constexpr RankInterval kSnowDayIntervals[] = {
+        {146, 157, 0, 1},
+        {158, 169, 0, 2},
+        {170, 181, 0, 3},
+        {182, 193, 0, 4},
+        {194, 205, 1, 1},
+        {206, 217, 1, 2},
+        {218, 229, 1, 3},
+        {230, 241, 1, 4},
+        {242, 253, 2, 1},
+        {254, 265, 2, 2},
+        {266, 277, 2, 3},
+        {278, 289, 2, 4},
+        {290, 301, 3, 1},
+        {302, 313, 3, 2},
+        {314, 325, 3, 3},
+        {326, 337, 3, 4},
+        {338, 349, 4, 1},
+        {350, 361, 4, 2},
+        {362, 373, 4, 3},
+        {374, 385, 4, 4},
+        {386, 397, 5, 1},
+        {398, 409, 5, 2},
+        {410, 421, 5, 3},
+        {422, 433, 5, 4},
+        {434, 445, 6, 1},
+        {446, 457, 6, 2},
+        {458, 469, 6, 3},
+        {470, 481, 6, 4},
+        {482, 493, 7, 1},
+        {494, 505, 7, 2},
+        {506, 517, 7, 3},
+        {518, 529, 7, 4},
+        {530, 541, 8, 1},
+        {542, 553, 8, 2},
+        {554, 565, 8, 3},
+        {566, 577, 8, 4},
+        {578, 589, 9, 1},
+        {590, 601, 9, 2},
+        {602, 613, 9, 3},
+        {614, 625, 9, 4},
+        {626, 637, 10, 1},
+        {638, 649, 10, 2},
+        {650, 661, 10, 3},
+        {662, 673, 10, 4},
+        {674, 685, 11, 1},
+        {686, 697, 11, 2},
+        {698, 709, 11, 3},
+        {710, 721, 11, 4},
+        {722, 733, 12, 1},
+        {734, 744, 12, 2},
+        {745, 755, 12, 3},
+        {756, 767, 12, 4},
+        {768, 779, 13, 1},
+        {780, 791, 13, 2},
+        {792, 803, 13, 3},
+        {804, 815, 13, 4},
+        {816, 827, 14, 1},
+        {828, 841, 14, 2},
+        {842, 855, 14, 3},
+        {856, 871, 14, 4},
+        {872, 885, 15, 1},
+        {886, 899, 15, 2},
+        {900, 913, 15, 3},
+        {914, 929, 15, 4},
+        {930, 939, 16, 1},
+        {940, 959, 16, 2},
+        {960, 979, 16, 3},
+        {980, 1035, 16, 4},
+        {1036, 1038, 17, 1},
+        {1039, 1057, 17, 2},
+        {1058, 1077, 17, 3},
+        {1078, 1095, 17, 4},
+        {1096, 1098, 18, 1},
+        {1099, 1117, 18, 2},
+        {1118, 1136, 18, 3},
+        {1137, 1155, 18, 4},
+        {1156, 1158, 19, 1},
+        {1159, 1160, 19, 2},
+    };
+
+    constexpr RankInterval kQuadsIntervals[] = {
+        {0, 0, 0, 1},
+        {1, 18, 0, 3},
+        {19, 34, 0, 4},
+        {35, 50, 1, 1},
+        {51, 66, 1, 2},
+        {67, 81, 1, 3},
+        {82, 97, 1, 4},
+        {98, 113, 2, 1},
+        {114, 129, 2, 2},
+        {130, 145, 2, 3},
+        {146, 160, 2, 4},
+        {161, 176, 3, 1},
+        {177, 192, 3, 2},
+        {193, 208, 3, 3},
+        {209, 223, 3, 4},
+        {224, 239, 4, 1},
+        {240, 255, 4, 2},
+        {256, 271, 4, 3},
+        {272, 287, 4, 4},
+        {288, 303, 5, 1},
+        {304, 319, 5, 2},
+        {320, 335, 5, 3},
+        {336, 350, 5, 4},
+        {351, 366, 6, 1},
+        {367, 382, 6, 2},
+        {383, 398, 6, 3},
+        {399, 413, 6, 4},
+        {414, 429, 7, 1},
+        {430, 445, 7, 2},
+        {446, 461, 7, 3},
+        {462, 478, 7, 4},
+        {479, 494, 8, 1},
+        {495, 510, 8, 2},
+        {511, 527, 8, 3},
+        {528, 546, 8, 4},
+        {547, 566, 9, 1},
+        {567, 584, 9, 2},
+        {585, 603, 9, 3},
+        {604, 622, 9, 4},
+        {623, 644, 10, 1},
+        {645, 663, 10, 2},
+        {664, 682, 10, 3},
+        {683, 701, 10, 4},
+        {702, 722, 11, 1},
+        {723, 741, 11, 2},
+        {742, 760, 11, 3},
+        {761, 779, 11, 4},
+        {780, 801, 12, 1},
+        {802, 820, 12, 2},
+        {821, 839, 12, 3},
+        {840, 859, 12, 4},
+        {860, 877, 13, 1},
+        {878, 896, 13, 2},
+        {897, 915, 13, 3},
+        {916, 934, 13, 4},
+        {935, 944, 14, 1},
+        {945, 977, 14, 2},
+        {978, 1007, 14, 3},
+        {1008, 1043, 14, 4},
+        {1044, 1080, 15, 1},
+        {1081, 1114, 15, 2},
+        {1115, 1147, 15, 3},
+        {1148, 1179, 15, 4},
+        {1180, 1213, 16, 1},
+        {1214, 1247, 16, 2},
+        {1248, 1281, 16, 3},
+        {1282, 1300, 16, 4},
+        {1301, 1335, 17, 1},
+        {1336, 1367, 17, 2},
+        {1368, 1402, 17, 3},
+        {1403, 1435, 17, 4},
+        {1436, 1467, 18, 1},
+        {1468, 1520, 18, 2},
+        {1521, 1545, 18, 3},
+        {1546, 1549, 18, 4},
+    };
+
+    constexpr RankColumnTable kColumnTables[] = {
+        {kDuelIntervals, sizeof(kDuelIntervals) / sizeof(RankInterval)},
+        {kDoublesIntervals, sizeof(kDoublesIntervals) / sizeof(RankInterval)},
+        {kStandardIntervals, sizeof(kStandardIntervals) / sizeof(RankInterval)},
+        {kHoopsIntervals, sizeof(kHoopsIntervals) / sizeof(RankInterval)},
+        {kRumbleIntervals, sizeof(kRumbleIntervals) / sizeof(RankInterval)},
+        {kDropshotIntervals, sizeof(kDropshotIntervals) / sizeof(RankInterval)},
+        {kSnowDayIntervals, sizeof(kSnowDayIntervals) / sizeof(RankInterval)},
+        {kQuadsIntervals, sizeof(kQuadsIntervals) / sizeof(RankInterval)},
+    };
+} // namespace RankTableData
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "RankTable.generated.h"
+
+#include <string>
+
+struct RankLookupResult {
+    const char* tier = "";
+    int division = 0;
+    int floor = 0;
+    int ceiling = 0;
+
+    // Next division up; hasNext is false at the top of the table.
+    bool hasNext = false;
+    const char* nextTier = "";
+    int nextDivision = 0;
+    int mmrToNext = 0;
+};
+
+class RankTable {
+public:
+    // O(log n) lookup against the generated interval tables. Returns false when the
+    // column has no ranks (e.g. Tournament) or the MMR sits below the lowest floor.
+    static bool Lookup(RankTableData::RankColumn column, int mmr, RankLookupResult& result);
+
+    // "GC1 Div 2", or just the tier for undivided ranks such as SSL.
+    static std::string FormatRank(const char* tier, int division);
+};
@@ -0,0 +1,247 @@
+#include "pch.h"
+#include "ReplayUploader.h"
+#include "MappedFile.h"
+#include "MemoryTracker.h"
+#include "TraceRecorder.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <system_error>
+#include <thread>
+
+namespace
+{
+    constexpr auto kCancelPollInterval = std::chrono::milliseconds(100);
+
+    // Sleeps until deadline in short slices; false if cancelled first.
+    bool SleepUntil(std::chrono::steady_clock::time_point deadline, const std::atomic<bool>& cancel)
+    {
+        while (std::chrono::steady_clock::now() < deadline)
+        {
+            if (cancel.load())
+            {
+                return false;
+            }
+            const auto remaining = deadline - std::chrono::steady_clock::now();
+            std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(remaining, kCancelPollInterval));
+        }
+        return !cancel.load();
+    }
+
+    // Every replay response, success or 409, carries the server's "received" offset.
+    bool ParseReceived(const std::string& response, std::uint64_t& received)
+    {
+        static constexpr char kKey[] = "\"received\":";
+        const std::size_t pos = response.find(kKey);
+        if (pos == std::string::npos)
+        {
+            return false;
+        }
+
+        const char* start = response.c_str() + pos + sizeof(kKey) - 1;
+        char* end = nullptr;
+        const unsigned long long value = std::strtoull(start, &end, 10);
+        if (end == start)
+        {
+            return false;
+        }
+        received = value;
+        return true;
+    }
+
+    class InFlightGuard
+    {
+    public:
+        explicit InFlightGuard(std::atomic<std::uint32_t>* counter)
+            : counter_(counter)
+        {
+            if (counter_)
+            {
+                counter_->fetch_add(1);
+            }
+        }
+        ~InFlightGuard()
+        {
+            if (counter_)
+            {
+                counter_->fetch_sub(1);
+            }
+        }
+
+        InFlightGuard(const InFlightGuard&) = delete;
+        InFlightGuard& operator=(const InFlightGuard&) = delete;
+
+    private:
+        std::atomic<std::uint32_t>* counter_;
+    };
+}
+
+std::string ReplayIdFromPath(const std::filesystem::path& path)
+{
+    std::string id = path.stem().string();
+    id.erase(std::remove_if(id.begin(), id.end(), [](unsigned char ch) {
+                 return !std::isalnum(ch) && ch != '-' && ch != '_';
+             }),
+             id.end());
+    if (id.size() > 64)
+    {
+        id.resize(64);
+    }
+    return id;
+}
+
+std::filesystem::path FindLatestReplay(const std::filesystem::path& dir, std::filesystem::file_time_type notBefore)
+{
+    std::error_code ec;
+    std::filesystem::path latest;
+    std::filesystem::file_time_type latestTime = notBefore;
+    for (std::filesystem::directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec))
+    {
+        const std::filesystem::directory_entry& entry = *it;
+        if (entry.path().extension() != ".replay" || !entry.is_regular_file(ec))
+        {
+            continue;
+        }
+
+        const auto written = entry.last_write_time(ec);
+        if (!ec && written >= latestTime)
+        {
+            latestTime = written;
+            latest = entry.path();
+        }
+    }
+    return latest;
+}
+
+ReplayUploadResult UploadReplayFile(const ApiClient& client,
+                                    const std::filesystem::path& path,
+                                    const std::vector<HttpHeader>& headers,
+                                    const ReplayUploadOptions& options,
+                                    const std::atomic<bool>& cancel)
+{
+    RTJ_TRACE_SCOPE("UploadReplayFile");
+    RTJ_MEMORY_SCOPE(Transport);
+
+    ReplayUploadResult result;
+    const std::string replayId = ReplayIdFromPath(path);
+    if (replayId.empty())
+    {
+        result.error = "replay file name is not a usable id";
+        return result;
+    }
+
+    MappedFile file;
+    if (!file.Open(path, result.error))
+    {
+        return result;
+    }
+    result.size = file.Size();
+
+    const std::string base = "/api/replays/" + replayId;
+    std::string response;
+    std::uint64_t offset = 0;
+    bool fetched = false;
+    {
+        InFlightGuard guard(options.inFlight);
+        fetched = client.Get(base, headers, response);
+    }
+    if (fetched && ParseReceived(response, offset))
+    {
+        offset = std::min<std::uint64_t>(offset, result.size);
+    }
+    result.resumedFrom = offset;
+
+    const std::size_t chunkBytes = std::max<std::size_t>(options.chunkBytes, 4096);
+    // Pacing runs from here; time spent held by admit or backing off moves it forward,
+    // so the budget is not spent in a burst once the upload may continue.
+    auto paceFrom = std::chrono::steady_clock::now();
+    std::uint64_t sent = 0;
+    int failures = 0;
+
+    while (offset < result.size)
+    {
+        if (cancel.load())
+        {
+            result.error = "cancelled";
+            break;
+        }
+
+        const std::chrono::milliseconds wait = options.admit ? options.admit() : std::chrono::milliseconds(0);
+        if (wait.count() > 0)
+        {
+            const auto heldFrom = std::chrono::steady_clock::now();
+            if (!SleepUntil(heldFrom + wait, cancel))
+            {
+                result.error = "cancelled";
+                break;
+            }
+            paceFrom += std::chrono::steady_clock::now() - heldFrom;
+            continue;
+        }
+
+        const std::size_t length = static_cast<std::size_t>(std::min<std::uint64_t>(chunkBytes, result.size - offset));
+        const std::string endpoint = base + "/chunks?offset=" + std::to_string(offset) + "&size=" + std::to_string(result.size);
+
+        std::uint64_t received = 0;
+        bool ok = false;
+        {
+            InFlightGuard guard(options.inFlight);
+            ok = client.PutBytes(endpoint, file.Data() + offset, length, headers, response);
+        }
+        const bool synced = ParseReceived(response, received) && received <= result.size;
+        if (ok || synced)
+        {
+            // A 409 means the server holds a different offset (an earlier attempt landed
+            // after we gave up on it); continue from whatever it acknowledged.
+            const std::uint64_t next = synced ? received : offset + length;
+            failures = next > offset ? 0 : failures + 1;
+            if (ok)
+            {
+                sent += length;
+                ++result.chunks;
+            }
+            offset = next;
+        }
+        else
+        {
+            ++failures;
+        }
+
+        if (failures > options.maxRetries)
+        {
+            result.error = response.empty() ? std::string("replay upload failed") : response;
+            break;
+        }
+
+        if (failures > 0)
+        {
+            const auto backoff = std::chrono::seconds(1 << std::min(failures, 5));
+            const auto heldFrom = std::chrono::steady_clock::now();
+            if (!SleepUntil(heldFrom + backoff, cancel))
+            {
+                result.error = "cancelled";
+                break;
+            }
+            paceFrom += std::chrono::steady_clock::now() - heldFrom;
+            continue;
+        }
+
+        // Pace to the byte budget rather than sleeping a fixed gap, so slow requests
+        // do not compound the delay.
+        if (options.bytesPerSecond > 0 && offset < result.size)
+        {
+            const auto due = paceFrom + std::chrono::microseconds(sent * 1000000ull / options.bytesPerSecond);
+            if (!SleepUntil(due, cancel))
+            {
+                result.error = "cancelled";
+                break;
+            }
+        }
+    }
+
+    result.acknowledged = offset;
+    result.complete = offset >= result.size;
+    return result;
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "ApiClient.h"
+
+struct ReplayUploadOptions {
+    std::size_t chunkBytes = 256 * 1024;
+    std::uint32_t bytesPerSecond = 256 * 1024; // 0 disables the cap
+    int maxRetries = 4;
+    // Asked before each chunk; a non-zero wait defers the chunk and it asks again.
+    std::function<std::chrono::milliseconds()> admit;
+    // Raised while one of this upload's requests is in flight, so callers can tell
+    // replay traffic apart in ApiClient::Stats().inFlight.
+    std::atomic<std::uint32_t>* inFlight = nullptr;
+};
+
+struct ReplayUploadResult {
+    bool complete = false;
+    std::uint64_t resumedFrom = 0; // offset the server had already acknowledged
+    std::uint64_t acknowledged = 0;
+    std::uint64_t size = 0;
+    int chunks = 0;
+    std::string error;
+};
+
+// Replay ids are the file stem, restricted to what the API accepts in a URL segment.
+std::string ReplayIdFromPath(const std::filesystem::path& path);
+
+// Newest .replay in dir written at or after notBefore, or an empty path.
+std::filesystem::path FindLatestReplay(const std::filesystem::path& dir, std::filesystem::file_time_type notBefore);
+
+// Streams a replay to PUT /api/replays/<id>/chunks from a memory-mapped view,
+// starting at the offset the server already holds. The server's acknowledged offset
+// is authoritative, so a later call after a failure or cancel resumes where this
+// one stopped. Blocks the calling thread; paced to options.bytesPerSecond.
+ReplayUploadResult UploadReplayFile(const ApiClient& client,
+                                    const std::filesystem::path& path,
+                                    const std::vector<HttpHeader>& headers,
+                                    const ReplayUploadOptions& options,
+                                    const std::atomic<bool>& cancel);
@@ -0,0 +1,164 @@
+#include "pch.h"
+#include "SessionStats.h"
+
+#include <algorithm>
+#include <cmath>
+
+void RunningStat::Add(double value)
+{
+    ++count;
+    if (count == 1)
+    {
+        min = value;
+        max = value;
+    }
+    else
+    {
+        min = std::min(min, value);
+        max = std::max(max, value);
+    }
+
+    const double delta = value - mean;
+    mean += delta / static_cast<double>(count);
+    m2 += delta * (value - mean);
+}
+
+double RunningStat::Variance() const
+{
+    return count > 1 ? m2 / static_cast<double>(count - 1) : 0.0;
+}
+
+double RunningStat::StdDev() const
+{
+    return std::sqrt(Variance());
+}
+
+SessionTracker::SessionTracker(std::chrono::minutes idleTimeout)
+    : idleTimeout_(idleTimeout)
+{
+}
+
+void SessionTracker::SetIdleTimeout(std::chrono::minutes idleTimeout)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    idleTimeout_ = idleTimeout;
+}
+
+bool SessionTracker::RecordMatch(const MatchOutcome& outcome,
+                                 std::chrono::system_clock::time_point now,
+                                 SessionSummary& closedSession)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    bool closed = false;
+    if (active_ && now - lastMatchAt_ >= idleTimeout_)
+    {
+        closedSession = BuildSummaryLocked();
+        ResetLocked();
+        closed = true;
+    }
+
+    if (!active_)
+    {
+        active_ = true;
+        startedAt_ = now;
+    }
+    lastMatchAt_ = now;
+    ++matches_;
+
+    PlaylistSessionStats& stats = playlists_[outcome.playlistId];
+    if (stats.matches == 0)
+    {
+        stats.playlistName = outcome.playlistName;
+        stats.firstMmr = outcome.mmr;
+    }
+    else if (outcome.mmr > 0 && stats.lastMmr > 0)
+    {
+        stats.mmrDelta.Add(static_cast<double>(outcome.mmr - stats.lastMmr));
+    }
+    if (outcome.mmr > 0)
+    {
+        if (stats.firstMmr <= 0)
+        {
+            stats.firstMmr = outcome.mmr;
+        }
+        stats.lastMmr = outcome.mmr;
+    }
+
+    ++stats.matches;
+    stats.goals.Add(static_cast<double>(outcome.goals));
+
+    if (outcome.hasResult)
+    {
+        if (outcome.won)
+        {
+            ++stats.wins;
+            stats.currentStreak = stats.currentStreak > 0 ? stats.currentStreak + 1 : 1;
+            stats.longestWinStreak = std::max(stats.longestWinStreak, stats.currentStreak);
+        }
+        else
+        {
+            ++stats.losses;
+            stats.currentStreak = stats.currentStreak < 0 ? stats.currentStreak - 1 : -1;
+            stats.longestLossStreak = std::max(stats.longestLossStreak, -stats.currentStreak);
+        }
+    }
+
+    return closed;
+}
+
+bool SessionTracker::CloseIfIdle(std::chrono::system_clock::time_point now, bool force, SessionSummary& closedSession)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!active_)
+    {
+        return false;
+    }
+
+    if (!force && now - lastMatchAt_ < idleTimeout_)
+    {
+        return false;
+    }
+
+    closedSession = BuildSummaryLocked();
+    ResetLocked();
+    return true;
+}
+
+bool SessionTracker::HasActiveSession() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return active_;
+}
+
+SessionSummary SessionTracker::Snapshot() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return BuildSummaryLocked();
+}
+
+SessionSummary SessionTracker::BuildSummaryLocked() const
+{
+    SessionSummary summary;
+    summary.startedAt = startedAt_;
+    summary.lastMatchAt = lastMatchAt_;
+    summary.matches = matches_;
+    summary.playlists.reserve(playlists_.size());
+    for (const auto& entry : playlists_)
+    {
+        summary.wins += entry.second.wins;
+        summary.losses += entry.second.losses;
+        summary.playlists.emplace_back(entry.first, entry.second);
+    }
+    std::sort(summary.playlists.begin(), summary.playlists.end(), [](const auto& a, const auto& b) {
+        return a.first < b.first;
+    });
+    return summary;
+}
+
+void SessionTracker::ResetLocked()
+{
+    active_ = false;
+    matches_ = 0;
+    playlists_.clear();
+}
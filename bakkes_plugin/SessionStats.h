@@ -0,0 +1,89 @@
+#pragma once
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Welford running mean/variance plus min/max; O(1) per sample, no sample storage.
+struct RunningStat {
+    long long count = 0;
+    double mean = 0.0;
+    double m2 = 0.0;
+    double min = 0.0;
+    double max = 0.0;
+
+    void Add(double value);
+    double Variance() const;
+    double StdDev() const;
+};
+
+// What the session tracker needs from one finished match.
+struct MatchOutcome {
+    int playlistId = 0;
+    std::string playlistName;
+    int mmr = 0;
+    bool hasResult = false; // false when the match ended without a winner (e.g. left early)
+    bool won = false;
+    int goals = 0;
+};
+
+struct PlaylistSessionStats {
+    std::string playlistName;
+    int matches = 0;
+    int wins = 0;
+    int losses = 0;
+    int currentStreak = 0; // > 0 win streak, < 0 loss streak
+    int longestWinStreak = 0;
+    int longestLossStreak = 0;
+    int firstMmr = 0;
+    int lastMmr = 0;
+    RunningStat mmrDelta;
+    RunningStat goals;
+
+    int NetMmr() const { return lastMmr - firstMmr; }
+};
+
+struct SessionSummary {
+    std::chrono::system_clock::time_point startedAt;
+    std::chrono::system_clock::time_point lastMatchAt;
+    int matches = 0;
+    int wins = 0;
+    int losses = 0;
+    std::vector<std::pair<int, PlaylistSessionStats>> playlists; // ordered by playlist id
+};
+
+// Aggregates matches into play sessions. A session closes once no match has been
+// recorded for the idle timeout; the closed summary is handed back to the caller.
+class SessionTracker {
+public:
+    explicit SessionTracker(std::chrono::minutes idleTimeout = std::chrono::minutes(30));
+
+    void SetIdleTimeout(std::chrono::minutes idleTimeout);
+
+    // Records a match. If the previous session had gone idle it is closed first and
+    // copied into closedSession; returns true in that case.
+    bool RecordMatch(const MatchOutcome& outcome,
+                     std::chrono::system_clock::time_point now,
+                     SessionSummary& closedSession);
+
+    // Closes the active session when it has been idle long enough (or always when
+    // force is set, e.g. on unload). Returns true if a session was closed.
+    bool CloseIfIdle(std::chrono::system_clock::time_point now, bool force, SessionSummary& closedSession);
+
+    bool HasActiveSession() const;
+    SessionSummary Snapshot() const;
+
+private:
+    SessionSummary BuildSummaryLocked() const;
+    void ResetLocked();
+
+    mutable std::mutex mutex_;
+    std::chrono::minutes idleTimeout_;
+    bool active_ = false;
+    std::chrono::system_clock::time_point startedAt_;
+    std::chrono::system_clock::time_point lastMatchAt_;
+    int matches_ = 0;
+    std::unordered_map<int, PlaylistSessionStats> playlists_;
+};
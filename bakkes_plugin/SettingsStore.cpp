@@ -0,0 +1,303 @@
+#include "pch.h"
+#include "SettingsStore.h"
+#include "DiagnosticLogger.h"
+
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <system_error>
+
+namespace
+{
+    std::string Trim(const std::string& value)
+    {
+        std::size_t begin = 0;
+        std::size_t end = value.size();
+        while (begin < end && std::isspace(static_cast<unsigned char>(value[begin])))
+        {
+            ++begin;
+        }
+        while (end > begin && std::isspace(static_cast<unsigned char>(value[end - 1])))
+        {
+            --end;
+        }
+        return value.substr(begin, end - begin);
+    }
+}
+
+SettingsStore::SettingsStore(std::chrono::milliseconds debounce)
+    : debounce_(debounce)
+{
+}
+
+SettingsStore::~SettingsStore()
+{
+    Close();
+}
+
+void SettingsStore::Load(const std::filesystem::path& path)
+{
+    std::string content;
+    {
+        std::ifstream input(path, std::ios::in | std::ios::binary);
+        content.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+    }
+
+    std::map<std::string, std::string> values;
+    int version = content.empty() ? 0 : 1;
+    std::istringstream lines(content);
+    std::string line;
+    while (std::getline(lines, line))
+    {
+        const std::string trimmed = Trim(line);
+        const std::size_t eq = trimmed.find('=');
+        if (trimmed.empty() || trimmed[0] == '#' || eq == std::string::npos)
+        {
+            continue;
+        }
+        std::string key = Trim(trimmed.substr(0, eq));
+        std::string value = Trim(trimmed.substr(eq + 1));
+        if (key == "version")
+        {
+            version = std::atoi(value.c_str());
+            continue;
+        }
+        values[std::move(key)] = std::move(value);
+    }
+
+    {
+        std::lock_guard<std::mutex> writeLock(writeMutex_);
+        written_ = content;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    path_ = path;
+    values_ = std::move(values);
+    loaded_ = true;
+    loadedVersion_ = version;
+    dirty_ = false;
+    if (!writer_.joinable() && !stopping_)
+    {
+        writer_ = std::thread([this]() { Run(); });
+    }
+}
+
+bool SettingsStore::IsLoaded() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return loaded_;
+}
+
+int SettingsStore::LoadedVersion() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return loadedVersion_;
+}
+
+std::string SettingsStore::Get(const std::string& key, const std::string& fallback) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = values_.find(key);
+    return it != values_.end() ? it->second : fallback;
+}
+
+void SettingsStore::Set(const std::string& key, std::string value)
+{
+    // One line per key; a newline in a value would start a new key.
+    for (char& ch : value)
+    {
+        if (ch == '\r' || ch == '\n')
+        {
+            ch = ' ';
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!loaded_)
+    {
+        return;
+    }
+    auto it = values_.find(key);
+    if (it != values_.end() && it->second == value)
+    {
+        return;
+    }
+    values_[key] = std::move(value);
+    MarkDirtyLocked();
+}
+
+std::vector<std::pair<std::string, std::string>> SettingsStore::WithPrefix(const std::string& prefix) const
+{
+    std::vector<std::pair<std::string, std::string>> matches;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = values_.lower_bound(prefix); it != values_.end() && it->first.compare(0, prefix.size(), prefix) == 0; ++it)
+    {
+        matches.emplace_back(*it);
+    }
+    return matches;
+}
+
+void SettingsStore::ErasePrefix(const std::string& prefix)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!loaded_)
+    {
+        return;
+    }
+    auto it = values_.lower_bound(prefix);
+    bool erased = false;
+    while (it != values_.end() && it->first.compare(0, prefix.size(), prefix) == 0)
+    {
+        it = values_.erase(it);
+        erased = true;
+    }
+    if (erased)
+    {
+        MarkDirtyLocked();
+    }
+}
+
+void SettingsStore::Flush()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (dirty_)
+    {
+        WritePendingLocked(lock);
+    }
+}
+
+void SettingsStore::Close()
+{
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (dirty_)
+        {
+            WritePendingLocked(lock);
+        }
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    if (writer_.joinable())
+    {
+        writer_.join();
+    }
+}
+
+SettingsStoreStats SettingsStore::Stats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void SettingsStore::Run()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_)
+    {
+        if (!dirty_)
+        {
+            wake_.wait(lock);
+        }
+        else if (std::chrono::steady_clock::now() < due_)
+        {
+            // By value: a Set during the wait moves due_.
+            const auto due = due_;
+            wake_.wait_until(lock, due);
+        }
+        else
+        {
+            WritePendingLocked(lock);
+        }
+    }
+}
+
+void SettingsStore::MarkDirtyLocked()
+{
+    dirty_ = true;
+    due_ = std::chrono::steady_clock::now() + debounce_;
+    wake_.notify_all();
+}
+
+void SettingsStore::WritePendingLocked(std::unique_lock<std::mutex>& lock)
+{
+    const std::string content = SerializeLocked();
+    const std::uint64_t generation = ++generation_;
+    const std::filesystem::path path = path_;
+    dirty_ = false;
+
+    // The file is written without holding mutex_, so Get and Set never wait on disk.
+    // A Flush that serialized later may get writeMutex_ first; the older content is
+    // then skipped instead of overwriting it.
+    lock.unlock();
+    bool skipped = false;
+    bool written = false;
+    {
+        std::lock_guard<std::mutex> writeLock(writeMutex_);
+        if (generation < writtenGeneration_)
+        {
+            skipped = true;
+        }
+        else if (content == written_)
+        {
+            skipped = true;
+            writtenGeneration_ = generation;
+        }
+        else
+        {
+            std::error_code ec;
+            std::filesystem::create_directories(path.parent_path(), ec);
+            std::filesystem::path temp = path;
+            temp += ".tmp";
+            {
+                std::ofstream output(temp, std::ios::out | std::ios::binary | std::ios::trunc);
+                output << content;
+                written = static_cast<bool>(output.flush());
+            }
+            if (written)
+            {
+                std::filesystem::rename(temp, path, ec);
+                written = !ec;
+            }
+            if (written)
+            {
+                written_ = content;
+                writtenGeneration_ = generation;
+            }
+            else
+            {
+                std::filesystem::remove(temp, ec);
+                DiagnosticLogger::Log("SettingsStore: failed to write " + path.string());
+            }
+        }
+    }
+    lock.lock();
+
+    if (skipped)
+    {
+        ++stats_.skipped;
+    }
+    else if (written)
+    {
+        ++stats_.writes;
+    }
+    else
+    {
+        ++stats_.failures;
+        // values_ still holds what failed to reach the disk; try again after the debounce.
+        MarkDirtyLocked();
+    }
+}
+
+std::string SettingsStore::SerializeLocked() const
+{
+    std::ostringstream output;
+    output << "# RLTrainingJournal settings; written by the plugin\n";
+    output << "version=" << kFormatVersion << "\n";
+    for (const auto& [key, value] : values_)
+    {
+        output << key << '=' << value << "\n";
+    }
+    return output.str();
+}
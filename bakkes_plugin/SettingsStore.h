@@ -0,0 +1,80 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+struct SettingsStoreStats {
+    std::uint64_t writes = 0;
+    std::uint64_t skipped = 0; // flushes whose content matched the file already on disk
+    std::uint64_t failures = 0;
+};
+
+// settings.cfg as an in-memory key/value map. Set only updates the map; a background
+// thread writes the file once changes have stopped for the debounce interval, to a
+// temp file that is then renamed over the old one, so a crash mid-write leaves the
+// previous file intact. Grouped state uses dotted keys ("warm.mmr.2") so new plugin
+// state can live here without a format change.
+class SettingsStore {
+public:
+    // Version 1 files were the same key=value lines without a version line.
+    static constexpr int kFormatVersion = 2;
+
+    explicit SettingsStore(std::chrono::milliseconds debounce = std::chrono::milliseconds(1000));
+    ~SettingsStore();
+
+    SettingsStore(const SettingsStore&) = delete;
+    SettingsStore& operator=(const SettingsStore&) = delete;
+
+    // Reads path and makes it the write target. Sets made before this are ignored:
+    // they would overwrite values that have not been read yet.
+    void Load(const std::filesystem::path& path);
+    bool IsLoaded() const;
+    // Version of the file as read; 0 when there was no file.
+    int LoadedVersion() const;
+
+    std::string Get(const std::string& key, const std::string& fallback = std::string()) const;
+    void Set(const std::string& key, std::string value);
+    // Every key starting with prefix, in key order.
+    std::vector<std::pair<std::string, std::string>> WithPrefix(const std::string& prefix) const;
+    void ErasePrefix(const std::string& prefix);
+
+    // Writes pending changes now instead of after the debounce; used on unload.
+    void Flush();
+    // Flushes, then stops the writer thread.
+    void Close();
+
+    SettingsStoreStats Stats() const;
+
+private:
+    void Run();
+    void MarkDirtyLocked();
+    void WritePendingLocked(std::unique_lock<std::mutex>& lock);
+    std::string SerializeLocked() const;
+
+    std::chrono::milliseconds debounce_;
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    std::filesystem::path path_;
+    std::map<std::string, std::string> values_;
+    bool loaded_ = false;
+    int loadedVersion_ = 0;
+    bool dirty_ = false;
+    bool stopping_ = false;
+    std::chrono::steady_clock::time_point due_;
+    SettingsStoreStats stats_;
+    std::uint64_t generation_ = 0; // bumped each time the values are serialized
+
+    std::mutex writeMutex_;               // serializes file writes between Flush and the writer thread
+    std::string written_;                 // file content last read or written; guarded by writeMutex_
+    std::uint64_t writtenGeneration_ = 0; // generation of written_; guarded by writeMutex_
+
+    std::thread writer_;
+};
@@ -0,0 +1,236 @@
+#include "pch.h"
+#include "TraceRecorder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <vector>
+
+std::atomic<bool> TraceRecorder::enabled_{false};
+
+namespace
+{
+    struct TraceSpan
+    {
+        const char* name;
+        std::uint64_t uploadId;
+        std::int64_t startMicros;
+        std::int64_t durationMicros;
+        std::uint32_t threadId;
+    };
+
+    constexpr std::size_t kThreadBufferCapacity = 1024;
+    constexpr std::size_t kRetiredCapacity = 16384;
+
+    // Fixed-capacity ring; once full the oldest span is overwritten.
+    class SpanRing
+    {
+    public:
+        explicit SpanRing(std::size_t capacity) : capacity_(capacity) {}
+
+        void Push(const TraceSpan& span)
+        {
+            if (spans_.size() < capacity_)
+            {
+                spans_.push_back(span);
+                return;
+            }
+            spans_[next_] = span;
+            next_ = (next_ + 1) % capacity_;
+        }
+
+        void AppendTo(std::vector<TraceSpan>& out) const
+        {
+            out.insert(out.end(), spans_.begin(), spans_.end());
+        }
+
+        void Clear()
+        {
+            spans_.clear();
+            next_ = 0;
+        }
+
+    private:
+        std::size_t capacity_;
+        std::size_t next_ = 0;
+        std::vector<TraceSpan> spans_;
+    };
+
+    struct ThreadBuffer
+    {
+        std::mutex mutex;
+        SpanRing ring{kThreadBufferCapacity};
+        std::uint32_t threadId = 0;
+    };
+
+    // Lock order: Registry::mutex before ThreadBuffer::mutex.
+    struct Registry
+    {
+        std::mutex mutex;
+        std::vector<ThreadBuffer*> live;
+        SpanRing retired{kRetiredCapacity};
+        std::uint32_t nextThreadId = 1;
+    };
+
+    Registry& GetRegistry()
+    {
+        // Leaked on purpose so thread_local destructors running at shutdown can still use it.
+        static Registry* registry = new Registry();
+        return *registry;
+    }
+
+    // Owns the calling thread's buffer. Upload threads are short-lived, so on thread
+    // exit the spans move into the bounded retired ring and the buffer is freed.
+    class ThreadBufferHandle
+    {
+    public:
+        ~ThreadBufferHandle()
+        {
+            if (!buffer_)
+            {
+                return;
+            }
+
+            Registry& registry = GetRegistry();
+            std::lock_guard<std::mutex> registryLock(registry.mutex);
+            registry.live.erase(std::remove(registry.live.begin(), registry.live.end(), buffer_), registry.live.end());
+            {
+                std::lock_guard<std::mutex> bufferLock(buffer_->mutex);
+                std::vector<TraceSpan> spans;
+                buffer_->ring.AppendTo(spans);
+                for (const auto& span : spans)
+                {
+                    registry.retired.Push(span);
+                }
+            }
+            delete buffer_;
+            buffer_ = nullptr;
+        }
+
+        ThreadBuffer& Get()
+        {
+            if (!buffer_)
+            {
+                buffer_ = new ThreadBuffer();
+                Registry& registry = GetRegistry();
+                std::lock_guard<std::mutex> lock(registry.mutex);
+                buffer_->threadId = registry.nextThreadId++;
+                registry.live.push_back(buffer_);
+            }
+            return *buffer_;
+        }
+
+    private:
+        ThreadBuffer* buffer_ = nullptr;
+    };
+
+    thread_local ThreadBufferHandle t_buffer;
+    thread_local std::uint64_t t_uploadId = 0;
+    std::atomic<std::uint64_t> g_nextUploadId{1};
+    const std::chrono::steady_clock::time_point g_epoch = std::chrono::steady_clock::now();
+}
+
+void TraceRecorder::SetEnabled(bool enabled)
+{
+    enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+std::int64_t TraceRecorder::NowMicros()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - g_epoch).count();
+}
+
+std::uint64_t TraceRecorder::NextUploadId()
+{
+    return g_nextUploadId.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::uint64_t TraceRecorder::CurrentUploadId()
+{
+    return t_uploadId;
+}
+
+void TraceRecorder::SetCurrentUploadId(std::uint64_t uploadId)
+{
+    t_uploadId = uploadId;
+}
+
+void TraceRecorder::Record(const char* name, std::uint64_t uploadId, std::int64_t startMicros, std::int64_t durationMicros)
+{
+    if (!IsEnabled())
+    {
+        return;
+    }
+
+    ThreadBuffer& buffer = t_buffer.Get();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    buffer.ring.Push(TraceSpan{name, uploadId, startMicros, durationMicros, buffer.threadId});
+}
+
+bool TraceRecorder::WriteChromeTrace(const std::filesystem::path& path, std::size_t& spanCount, std::string& error)
+{
+    std::vector<TraceSpan> spans;
+    {
+        Registry& registry = GetRegistry();
+        std::lock_guard<std::mutex> registryLock(registry.mutex);
+        registry.retired.AppendTo(spans);
+        for (ThreadBuffer* buffer : registry.live)
+        {
+            std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+            buffer->ring.AppendTo(spans);
+        }
+    }
+
+    std::sort(spans.begin(), spans.end(), [](const TraceSpan& a, const TraceSpan& b) {
+        return a.startMicros < b.startMicros;
+    });
+
+    std::error_code ec;
+    std::filesystem::create_directories(path.parent_path(), ec);
+    std::ofstream output(path, std::ios::out | std::ios::trunc);
+    if (!output.is_open())
+    {
+        error = "unable to open " + path.string();
+        return false;
+    }
+
+    output << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    for (const auto& span : spans)
+    {
+        if (!first)
+        {
+            output << ',';
+        }
+        first = false;
+
+        output << "{\"name\":\"" << span.name << "\","
+               << "\"cat\":\"rtj\",\"ph\":\"X\",\"pid\":1,"
+               << "\"tid\":" << span.threadId << ','
+               << "\"ts\":" << span.startMicros << ','
+               << "\"dur\":" << span.durationMicros << ','
+               << "\"args\":{\"uploadId\":" << span.uploadId << "}}";
+    }
+    output << "]}\n";
+
+    spanCount = spans.size();
+    if (!output)
+    {
+        error = "failed writing " + path.string();
+        return false;
+    }
+    return true;
+}
+
+void TraceRecorder::Clear()
+{
+    Registry& registry = GetRegistry();
+    std::lock_guard<std::mutex> registryLock(registry.mutex);
+    registry.retired.Clear();
+    for (ThreadBuffer* buffer : registry.live)
+    {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        buffer->ring.Clear();
+    }
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+// Lightweight span recorder for upload latency work. Spans land in per-thread
+// buffers and are exported as Chrome trace-event JSON (chrome://tracing, Perfetto).
+// When tracing is off a span costs one relaxed atomic load.
+class TraceRecorder {
+public:
+    static void SetEnabled(bool enabled);
+    static bool IsEnabled() { return enabled_.load(std::memory_order_relaxed); }
+
+    // Microseconds on a steady clock shared by every span.
+    static std::int64_t NowMicros();
+
+    // Upload IDs correlate spans from the game thread, the dispatch thread and the
+    // HTTP client. The current ID is thread-local; see ScopedTraceUploadId.
+    static std::uint64_t NextUploadId();
+    static std::uint64_t CurrentUploadId();
+    static void SetCurrentUploadId(std::uint64_t uploadId);
+
+    // name must outlive the recorder (string literals only).
+    static void Record(const char* name, std::uint64_t uploadId, std::int64_t startMicros, std::int64_t durationMicros);
+
+    static bool WriteChromeTrace(const std::filesystem::path& path, std::size_t& spanCount, std::string& error);
+    static void Clear();
+
+private:
+    static std::atomic<bool> enabled_;
+};
+
+class ScopedTraceSpan {
+public:
+    explicit ScopedTraceSpan(const char* name)
+        : name_(name), active_(TraceRecorder::IsEnabled())
+    {
+        if (active_)
+        {
+            startMicros_ = TraceRecorder::NowMicros();
+        }
+    }
+
+    ~ScopedTraceSpan()
+    {
+        if (active_)
+        {
+            TraceRecorder::Record(name_, TraceRecorder::CurrentUploadId(), startMicros_, TraceRecorder::NowMicros() - startMicros_);
+        }
+    }
+
+    ScopedTraceSpan(const ScopedTraceSpan&) = delete;
+    ScopedTraceSpan& operator=(const ScopedTraceSpan&) = delete;
+
+private:
+    const char* name_;
+    bool active_;
+    std::int64_t startMicros_ = 0;
+};
+
+class ScopedTraceUploadId {
+public:
+    explicit ScopedTraceUploadId(std::uint64_t uploadId)
+        : previous_(TraceRecorder::CurrentUploadId())
+    {
+        TraceRecorder::SetCurrentUploadId(uploadId);
+    }
+
+    ~ScopedTraceUploadId() { TraceRecorder::SetCurrentUploadId(previous_); }
+
+    ScopedTraceUploadId(const ScopedTraceUploadId&) = delete;
+    ScopedTraceUploadId& operator=(const ScopedTraceUploadId&) = delete;
+
+private:
+    std::uint64_t previous_;
+};
+
+#define RTJ_TRACE_CONCAT_INNER(a, b) a##b
+#define RTJ_TRACE_CONCAT(a, b) RTJ_TRACE_CONCAT_INNER(a, b)
+#define RTJ_TRACE_SCOPE(name) ScopedTraceSpan RTJ_TRACE_CONCAT(rtjTraceSpan_, __LINE__)(name)
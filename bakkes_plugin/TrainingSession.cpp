@@ -0,0 +1,152 @@
+#include "pch.h"
+#include "TrainingSession.h"
+
+bool TrainingSessionTracker::BeginMode(TrainingMode mode,
+                                       std::chrono::system_clock::time_point now,
+                                       TrainingStint& closed)
+{
+    bool hadStint = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (mode_ == mode)
+        {
+            return false;
+        }
+    }
+
+    hadStint = EndMode(now, closed);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    mode_ = mode;
+    startedAt_ = now;
+    activeSince_ = now;
+    packIndex_.clear();
+    packs_.clear();
+
+    // Freeplay has no pack; everything lands in a single unnamed entry.
+    packs_.emplace_back();
+    packIndex_.emplace(std::string(), 0);
+    activePack_ = 0;
+    return hadStint;
+}
+
+bool TrainingSessionTracker::EndMode(std::chrono::system_clock::time_point now, TrainingStint& closed)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (mode_ == TrainingMode::None)
+    {
+        return false;
+    }
+
+    CreditTimeLocked(now);
+
+    closed = TrainingStint{};
+    closed.mode = mode_;
+    closed.startedAt = startedAt_;
+    closed.finishedAt = now;
+    closed.packs.reserve(packs_.size());
+    for (auto& pack : packs_)
+    {
+        // The placeholder entry only matters if something was credited to it.
+        if (pack.code.empty() && mode_ == TrainingMode::CustomTraining && pack.attempts == 0 && pack.goals == 0)
+        {
+            continue;
+        }
+        closed.packs.push_back(std::move(pack));
+    }
+
+    mode_ = TrainingMode::None;
+    packIndex_.clear();
+    packs_.clear();
+    activePack_ = 0;
+    return true;
+}
+
+void TrainingSessionTracker::SetActivePack(const std::string& code,
+                                           const std::string& name,
+                                           std::chrono::system_clock::time_point now)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (mode_ == TrainingMode::None)
+    {
+        return;
+    }
+
+    CreditTimeLocked(now);
+
+    auto found = packIndex_.find(code);
+    if (found == packIndex_.end())
+    {
+        TrainingPackStats stats;
+        stats.code = code;
+        stats.name = name;
+        packs_.push_back(std::move(stats));
+        found = packIndex_.emplace(code, packs_.size() - 1).first;
+    }
+    activePack_ = found->second;
+}
+
+void TrainingSessionTracker::RecordAttempt()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (TrainingPackStats* pack = ActivePackLocked())
+    {
+        ++pack->attempts;
+    }
+}
+
+void TrainingSessionTracker::RecordGoal()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (TrainingPackStats* pack = ActivePackLocked())
+    {
+        ++pack->goals;
+    }
+}
+
+void TrainingSessionTracker::RecordReset()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (TrainingPackStats* pack = ActivePackLocked())
+    {
+        ++pack->resets;
+    }
+}
+
+TrainingMode TrainingSessionTracker::ActiveMode() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return mode_;
+}
+
+bool TrainingSessionTracker::ActivePack(TrainingPackStats& stats) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (mode_ == TrainingMode::None || activePack_ >= packs_.size())
+    {
+        return false;
+    }
+    stats = packs_[activePack_];
+    return true;
+}
+
+TrainingPackStats* TrainingSessionTracker::ActivePackLocked()
+{
+    if (mode_ == TrainingMode::None || activePack_ >= packs_.size())
+    {
+        return nullptr;
+    }
+    return &packs_[activePack_];
+}
+
+void TrainingSessionTracker::CreditTimeLocked(std::chrono::system_clock::time_point now)
+{
+    if (TrainingPackStats* pack = ActivePackLocked())
+    {
+        if (now > activeSince_)
+        {
+            pack->seconds += std::chrono::duration<double>(now - activeSince_).count();
+        }
+    }
+    activeSince_ = now;
+}
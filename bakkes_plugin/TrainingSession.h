@@ -0,0 +1,63 @@
+#pragma once
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+enum class TrainingMode {
+    None,
+    CustomTraining,
+    Freeplay
+};
+
+struct TrainingPackStats {
+    std::string code; // empty in freeplay
+    std::string name;
+    int attempts = 0;
+    int goals = 0;
+    int resets = 0;
+    double seconds = 0.0;
+};
+
+// One continuous stretch in custom training or freeplay, ready to post as a session.
+struct TrainingStint {
+    TrainingMode mode = TrainingMode::None;
+    std::chrono::system_clock::time_point startedAt;
+    std::chrono::system_clock::time_point finishedAt;
+    std::vector<TrainingPackStats> packs; // in the order they were first played
+};
+
+// Counts attempts, goals, resets and time per training pack while the player is in
+// custom training or freeplay. Nothing is sent per event; the caller posts the whole
+// stint once the mode ends.
+class TrainingSessionTracker {
+public:
+    // Starts a stint, closing any other one first (returned through closed).
+    bool BeginMode(TrainingMode mode, std::chrono::system_clock::time_point now, TrainingStint& closed);
+    bool EndMode(std::chrono::system_clock::time_point now, TrainingStint& closed);
+
+    // Switches the pack that subsequent events and time are credited to.
+    void SetActivePack(const std::string& code, const std::string& name, std::chrono::system_clock::time_point now);
+
+    void RecordAttempt();
+    void RecordGoal();
+    void RecordReset();
+
+    TrainingMode ActiveMode() const;
+    // Stats of the pack currently being played, for the overlay.
+    bool ActivePack(TrainingPackStats& stats) const;
+
+private:
+    TrainingPackStats* ActivePackLocked();
+    void CreditTimeLocked(std::chrono::system_clock::time_point now);
+
+    mutable std::mutex mutex_;
+    TrainingMode mode_ = TrainingMode::None;
+    std::chrono::system_clock::time_point startedAt_;
+    std::chrono::system_clock::time_point activeSince_;
+    std::unordered_map<std::string, std::size_t> packIndex_;
+    std::vector<TrainingPackStats> packs_;
+    std::size_t activePack_ = 0;
+};
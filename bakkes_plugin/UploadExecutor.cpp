@@ -0,0 +1,147 @@
+#include "pch.h"
+#include "UploadExecutor.h"
+
+UploadExecutor::UploadExecutor(std::size_t threads)
+{
+    threads_.reserve(threads == 0 ? 1 : threads);
+    for (std::size_t i = 0; i < (threads == 0 ? 1 : threads); ++i)
+    {
+        threads_.emplace_back([this]() { Run(); });
+    }
+}
+
+UploadExecutor::~UploadExecutor()
+{
+    Shutdown();
+}
+
+void UploadExecutor::Post(Work work)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopped_)
+        {
+            return;
+        }
+        ready_.push(std::move(work));
+    }
+    wake_.notify_one();
+}
+
+void UploadExecutor::PostAfter(std::chrono::milliseconds delay, Work work)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopped_)
+        {
+            return;
+        }
+        if (stopping_ || delay.count() <= 0)
+        {
+            ready_.push(std::move(work));
+        }
+        else
+        {
+            delayed_.push(DelayedWork{std::chrono::steady_clock::now() + delay, delayedOrder_++, std::move(work)});
+        }
+    }
+    wake_.notify_one();
+}
+
+void UploadExecutor::BeginOperation()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++operations_;
+}
+
+void UploadExecutor::EndOperation()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (operations_ > 0)
+        {
+            --operations_;
+        }
+    }
+    idle_.notify_all();
+}
+
+void UploadExecutor::Shutdown()
+{
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (stopped_)
+        {
+            return;
+        }
+        stopping_ = true;
+        while (!delayed_.empty())
+        {
+            ready_.push(std::move(const_cast<DelayedWork&>(delayed_.top()).work));
+            delayed_.pop();
+        }
+        wake_.notify_all();
+        idle_.wait(lock, [this]() { return operations_ == 0 && ready_.empty(); });
+        stopped_ = true;
+    }
+    wake_.notify_all();
+
+    for (auto& thread : threads_)
+    {
+        if (thread.joinable() && thread.get_id() != std::this_thread::get_id())
+        {
+            thread.join();
+        }
+    }
+    threads_.clear();
+}
+
+bool UploadExecutor::IsShuttingDown() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stopping_;
+}
+
+std::size_t UploadExecutor::Pending() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return operations_ + ready_.size() + delayed_.size();
+}
+
+void UploadExecutor::Run()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopped_)
+    {
+        while (!delayed_.empty() && delayed_.top().due <= std::chrono::steady_clock::now())
+        {
+            ready_.push(std::move(const_cast<DelayedWork&>(delayed_.top()).work));
+            delayed_.pop();
+        }
+
+        if (!ready_.empty())
+        {
+            Work work = std::move(ready_.front());
+            ready_.pop();
+            lock.unlock();
+            work();
+            lock.lock();
+            if (ready_.empty())
+            {
+                idle_.notify_all();
+            }
+            continue;
+        }
+
+        if (delayed_.empty())
+        {
+            wake_.wait(lock);
+        }
+        else
+        {
+            // By value: the heap may reallocate while this thread waits.
+            const auto due = delayed_.top().due;
+            wake_.wait_until(lock, due);
+        }
+    }
+}
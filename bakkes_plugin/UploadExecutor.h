@@ -0,0 +1,65 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+// A couple of worker threads that run upload continuations. Nothing posted here
+// should block for long: requests wait inside WinHTTP, not on these threads, so many
+// can be in flight at once.
+class UploadExecutor {
+public:
+    using Work = std::function<void()>;
+
+    explicit UploadExecutor(std::size_t threads = 2);
+    ~UploadExecutor();
+
+    UploadExecutor(const UploadExecutor&) = delete;
+    UploadExecutor& operator=(const UploadExecutor&) = delete;
+
+    void Post(Work work);
+    // Runs work after delay. Once Shutdown has begun, delayed work runs right away so
+    // whatever is waiting on it can finish.
+    void PostAfter(std::chrono::milliseconds delay, Work work);
+
+    // Counts a detached operation; Shutdown waits until every one has ended.
+    void BeginOperation();
+    void EndOperation();
+
+    // Drains queued and delayed work, waits for open operations, joins the threads.
+    void Shutdown();
+    bool IsShuttingDown() const;
+    // Open operations plus queued work; zero once everything posted has finished.
+    std::size_t Pending() const;
+
+private:
+    struct DelayedWork {
+        std::chrono::steady_clock::time_point due;
+        std::uint64_t order;
+        Work work;
+
+        bool operator>(const DelayedWork& other) const
+        {
+            return due != other.due ? due > other.due : order > other.order;
+        }
+    };
+
+    void Run();
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable idle_;
+    std::queue<Work> ready_;
+    std::priority_queue<DelayedWork, std::vector<DelayedWork>, std::greater<DelayedWork>> delayed_;
+    std::uint64_t delayedOrder_ = 0;
+    std::size_t operations_ = 0;
+    bool stopping_ = false;
+    bool stopped_ = false;
+    std::vector<std::thread> threads_;
+};
@@ -0,0 +1,472 @@
+#include "pch.h"
+#include "UploadLanes.h"
+#include "DiagnosticLogger.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <utility>
+
+namespace
+{
+    // How soon a sender that yielded to a higher lane asks again.
+    constexpr std::chrono::milliseconds kYieldWait{50};
+    // How often a paused sender checks again; a phase change also wakes the dispatcher.
+    constexpr std::chrono::seconds kPausedWait{1};
+
+    std::size_t Index(UploadLane lane)
+    {
+        return static_cast<std::size_t>(lane);
+    }
+}
+
+const char* UploadLaneName(UploadLane lane)
+{
+    switch (lane)
+    {
+    case UploadLane::Match:
+        return "match";
+    case UploadLane::Correction:
+        return "correction";
+    case UploadLane::Snapshot:
+        return "snapshot";
+    case UploadLane::Bulk:
+        return "bulk";
+    }
+    return "unknown";
+}
+
+const char* GamePhaseName(GamePhase phase)
+{
+    switch (phase)
+    {
+    case GamePhase::Menu:
+        return "menu";
+    case GamePhase::Live:
+        return "live";
+    case GamePhase::Replay:
+        return "replay";
+    case GamePhase::PostMatch:
+        return "post-match";
+    }
+    return "unknown";
+}
+
+const char* LivePolicyName(LivePolicy policy)
+{
+    switch (policy)
+    {
+    case LivePolicy::Run:
+        return "run";
+    case LivePolicy::Throttle:
+        return "throttle";
+    case LivePolicy::Pause:
+        return "pause";
+    }
+    return "unknown";
+}
+
+bool ParseLivePolicy(const char* text, LivePolicy& policy)
+{
+    if (!text)
+    {
+        return false;
+    }
+    for (LivePolicy candidate : {LivePolicy::Run, LivePolicy::Throttle, LivePolicy::Pause})
+    {
+        if (std::strcmp(text, LivePolicyName(candidate)) == 0)
+        {
+            policy = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Queued mmr-log uploads are already in the outbox, so a dropped one is resent by the
+// next sync rather than lost; session posts are submitted as not droppable. The
+// snapshot lane still holds a full 13-playlist burst. Bulk senders ask for a token
+// per request and never queue.
+LaneLimits UploadLanes::DefaultLimits(UploadLane lane)
+{
+    switch (lane)
+    {
+    case UploadLane::Match:
+        return {2.0, 4.0, 64, LaneDropPolicy::DropOldest};
+    case UploadLane::Correction:
+        return {1.0, 2.0, 32, LaneDropPolicy::DropOldest};
+    case UploadLane::Snapshot:
+        return {1.0, 3.0, 32, LaneDropPolicy::DropOldest};
+    case UploadLane::Bulk:
+        return {5.0, 5.0, 0, LaneDropPolicy::DropNewest};
+    }
+    return {};
+}
+
+UploadLanes::UploadLanes()
+{
+    const auto now = Clock::now();
+    for (std::size_t i = 0; i < kUploadLaneCount; ++i)
+    {
+        lanes_[i].limits = DefaultLimits(static_cast<UploadLane>(i));
+        lanes_[i].tokens = lanes_[i].limits.burst;
+        lanes_[i].refilled = now;
+    }
+    phaseSince_ = now;
+}
+
+UploadLanes::~UploadLanes()
+{
+    Stop();
+}
+
+void UploadLanes::Start()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (worker_.joinable())
+    {
+        return;
+    }
+    stopping_ = false;
+    worker_ = std::thread([this]() { Run(); });
+}
+
+void UploadLanes::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    if (worker_.joinable())
+    {
+        worker_.join();
+    }
+
+    // Also covers jobs submitted after the dispatcher exited, or with none started.
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (Lane& lane : lanes_)
+    {
+        EndDeferralLocked(lane, Clock::now());
+        while (!lane.queue.empty())
+        {
+            Job job = std::move(lane.queue.front());
+            lane.queue.pop_front();
+            ++lane.stats.sent;
+            lock.unlock();
+            job.start();
+            lock.lock();
+        }
+    }
+}
+
+bool UploadLanes::Submit(UploadLane lane, Job job)
+{
+    Job dropped;
+    bool accepted = true;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Lane& current = lanes_[Index(lane)];
+        RefillLocked(current, Clock::now());
+        if (!current.queue.empty() || current.tokens < 1.0)
+        {
+            ++current.stats.throttled;
+        }
+
+        bool keep = true;
+        if (current.queue.size() >= current.limits.maxQueued)
+        {
+            const auto oldest = current.limits.dropPolicy == LaneDropPolicy::DropOldest
+                                    ? std::find_if(current.queue.begin(), current.queue.end(), [](const Job& queued) {
+                                          return queued.droppable;
+                                      })
+                                    : current.queue.end();
+            if (oldest != current.queue.end())
+            {
+                dropped = std::move(*oldest);
+                current.queue.erase(oldest);
+                accepted = false;
+            }
+            else if (job.droppable)
+            {
+                dropped = std::move(job);
+                accepted = false;
+                keep = false;
+            }
+            if (!accepted)
+            {
+                ++current.stats.dropped;
+            }
+        }
+        if (keep)
+        {
+            current.queue.push_back(std::move(job));
+            current.stats.peakQueued = std::max(current.stats.peakQueued, current.queue.size());
+        }
+    }
+    wake_.notify_all();
+
+    if (!accepted)
+    {
+        DiagnosticLogger::Log(std::string("UploadLanes: ") + UploadLaneName(lane) + " lane full, dropped an upload");
+        if (dropped.dropped)
+        {
+            dropped.dropped();
+        }
+    }
+    return accepted;
+}
+
+std::chrono::milliseconds UploadLanes::Admit(UploadLane lane, double cost)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return AdmitLocked(lane, cost);
+}
+
+void UploadLanes::Acquire(UploadLane lane, double cost)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (auto wait = AdmitLocked(lane, cost); wait.count() > 0; wait = AdmitLocked(lane, cost))
+    {
+        wake_.wait_for(lock, wait, [this]() { return stopping_; });
+    }
+}
+
+bool UploadLanes::Sleep(std::chrono::milliseconds delay)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    return !wake_.wait_for(lock, delay, [this]() { return stopping_; });
+}
+
+void UploadLanes::SetGamePhase(GamePhase phase)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto now = Clock::now();
+        const bool wasGated = GatedLocked(now);
+        // Every kickoff restarts Live, so kMaxLiveHold counts from the latest one.
+        phase_ = phase;
+        phaseSince_ = now;
+        if (wasGated && !GatedLocked(now))
+        {
+            for (Lane& lane : lanes_)
+            {
+                EndDeferralLocked(lane, now);
+            }
+        }
+    }
+    wake_.notify_all();
+}
+
+void UploadLanes::SetLivePolicy(LivePolicy policy)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto now = Clock::now();
+        livePolicy_ = policy;
+        if (!GatedLocked(now))
+        {
+            for (Lane& lane : lanes_)
+            {
+                EndDeferralLocked(lane, now);
+            }
+        }
+    }
+    wake_.notify_all();
+}
+
+GamePhase UploadLanes::Phase() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return phase_;
+}
+
+LivePolicy UploadLanes::Policy() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return livePolicy_;
+}
+
+LaneStats UploadLanes::Stats(UploadLane lane) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    const Lane& current = lanes_[Index(lane)];
+    LaneStats stats = current.stats;
+    stats.queued = current.queue.size();
+    if (current.deferredSince != Clock::time_point{})
+    {
+        stats.deferredMillis += static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - current.deferredSince).count());
+    }
+    return stats;
+}
+
+std::size_t UploadLanes::Queued() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::size_t queued = 0;
+    for (const Lane& lane : lanes_)
+    {
+        queued += lane.queue.size();
+    }
+    return queued;
+}
+
+void UploadLanes::Run()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_)
+    {
+        const auto now = Clock::now();
+        auto wait = Clock::duration::max();
+        Lane* ready = nullptr;
+        for (Lane& lane : lanes_)
+        {
+            if (lane.queue.empty())
+            {
+                continue;
+            }
+            const auto hold = LiveWaitLocked(static_cast<UploadLane>(&lane - lanes_.data()), now);
+            if (hold.count() > 0)
+            {
+                DeferLocked(lane, now);
+                wait = std::min(wait, hold);
+                continue;
+            }
+            RefillLocked(lane, now);
+            if (lane.tokens >= 1.0)
+            {
+                ready = &lane;
+                break;
+            }
+            const double seconds = (1.0 - lane.tokens) / lane.limits.ratePerSecond;
+            wait = std::min(wait, std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds)));
+        }
+
+        if (ready)
+        {
+            ReleaseLocked(static_cast<UploadLane>(ready - lanes_.data()), now);
+            ready->tokens -= 1.0;
+            ++ready->stats.sent;
+            Job job = std::move(ready->queue.front());
+            ready->queue.pop_front();
+            lock.unlock();
+            job.start();
+            lock.lock();
+            // Start over from the highest lane; something may have arrived meanwhile.
+            continue;
+        }
+
+        if (wait == Clock::duration::max())
+        {
+            wake_.wait(lock);
+        }
+        else
+        {
+            wake_.wait_for(lock, wait);
+        }
+    }
+}
+
+void UploadLanes::RefillLocked(Lane& lane, Clock::time_point now)
+{
+    const double elapsed = std::chrono::duration<double>(now - lane.refilled).count();
+    lane.tokens = std::min(lane.limits.burst, lane.tokens + elapsed * lane.limits.ratePerSecond);
+    lane.refilled = now;
+}
+
+std::chrono::milliseconds UploadLanes::AdmitLocked(UploadLane lane, double cost)
+{
+    if (stopping_)
+    {
+        return std::chrono::milliseconds(0);
+    }
+    Lane& current = lanes_[Index(lane)];
+    const auto now = Clock::now();
+    const auto hold = LiveWaitLocked(lane, now);
+    if (hold.count() > 0)
+    {
+        DeferLocked(current, now);
+        return std::chrono::ceil<std::chrono::milliseconds>(hold);
+    }
+    // Callers poll until let through, so a wait is counted once, not once per poll.
+    const auto throttle = [&current]() {
+        if (!current.admitWaiting)
+        {
+            current.admitWaiting = true;
+            ++current.stats.throttled;
+        }
+    };
+    for (std::size_t i = 0; i < Index(lane); ++i)
+    {
+        if (!lanes_[i].queue.empty())
+        {
+            throttle();
+            return kYieldWait;
+        }
+    }
+
+    RefillLocked(current, now);
+    if (current.tokens >= cost)
+    {
+        ReleaseLocked(lane, now);
+        current.tokens -= cost;
+        if (cost > 0.0)
+        {
+            ++current.stats.sent;
+        }
+        current.admitWaiting = false;
+        return std::chrono::milliseconds(0);
+    }
+    throttle();
+    const double millis = std::ceil((cost - current.tokens) * 1000.0 / current.limits.ratePerSecond);
+    return std::chrono::milliseconds(std::max<long long>(1, static_cast<long long>(millis)));
+}
+
+bool UploadLanes::GatedLocked(Clock::time_point now) const
+{
+    return (phase_ == GamePhase::Live || phase_ == GamePhase::Replay) && livePolicy_ != LivePolicy::Run &&
+           now - phaseSince_ < kMaxLiveHold;
+}
+
+UploadLanes::Clock::duration UploadLanes::LiveWaitLocked(UploadLane lane, Clock::time_point now) const
+{
+    if (lane < UploadLane::Snapshot || !GatedLocked(now))
+    {
+        return Clock::duration::zero();
+    }
+    if (livePolicy_ == LivePolicy::Pause)
+    {
+        return kPausedWait;
+    }
+    return nextLiveRelease_ > now ? nextLiveRelease_ - now : Clock::duration::zero();
+}
+
+void UploadLanes::DeferLocked(Lane& lane, Clock::time_point now)
+{
+    if (lane.deferredSince == Clock::time_point{})
+    {
+        lane.deferredSince = now;
+        ++lane.stats.deferrals;
+    }
+}
+
+void UploadLanes::ReleaseLocked(UploadLane lane, Clock::time_point now)
+{
+    EndDeferralLocked(lanes_[Index(lane)], now);
+    if (lane >= UploadLane::Snapshot && GatedLocked(now))
+    {
+        nextLiveRelease_ = now + kLiveThrottleInterval;
+    }
+}
+
+void UploadLanes::EndDeferralLocked(Lane& lane, Clock::time_point now)
+{
+    if (lane.deferredSince != Clock::time_point{})
+    {
+        lane.stats.deferredMillis += static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::milliseconds>(now - lane.deferredSince).count());
+        lane.deferredSince = Clock::time_point{};
+    }
+}
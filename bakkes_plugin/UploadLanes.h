@@ -0,0 +1,156 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+// Highest priority first.
+enum class UploadLane : std::uint8_t {
+    Match,      // a match result as it ends
+    Correction, // a later capture of the same match, e.g. once the replay is saved
+    Snapshot,   // MMR snapshots and session summaries
+    Bulk,       // outbox resends, backlog imports and replay files
+};
+constexpr std::size_t kUploadLaneCount = 4;
+
+const char* UploadLaneName(UploadLane lane);
+
+// What the game is doing, as far as uploads care.
+enum class GamePhase : std::uint8_t {
+    Menu,
+    Live,      // from each kickoff countdown until a goal or the end of the match
+    Replay,    // goal replay; the next kickoff follows within seconds
+    PostMatch, // scoreboard after the final whistle
+};
+
+const char* GamePhaseName(GamePhase phase);
+
+// What the snapshot and bulk lanes do while a match is live or in a goal replay.
+// Match results and corrections are never held.
+enum class LivePolicy : std::uint8_t {
+    Run,
+    Throttle, // one request across those lanes every kLiveThrottleInterval
+    Pause,
+};
+
+const char* LivePolicyName(LivePolicy policy);
+bool ParseLivePolicy(const char* text, LivePolicy& policy);
+
+enum class LaneDropPolicy : std::uint8_t {
+    DropOldest, // a newer payload supersedes what is waiting
+    DropNewest, // what is waiting keeps its place
+};
+
+struct LaneLimits {
+    double ratePerSecond = 1.0; // token refill
+    double burst = 1.0;         // bucket size; a full bucket sends this many at once
+    std::size_t maxQueued = 32; // 0 for lanes whose senders only use Admit/Acquire
+    LaneDropPolicy dropPolicy = LaneDropPolicy::DropOldest;
+};
+
+struct LaneStats {
+    std::size_t queued = 0;
+    std::size_t peakQueued = 0;
+    std::uint64_t sent = 0;
+    std::uint64_t dropped = 0;
+    std::uint64_t throttled = 0; // requests that had to wait for a token or a higher lane, once per request
+    std::uint64_t deferrals = 0;      // times the lane had work held back by the live policy
+    std::uint64_t deferredMillis = 0; // total time it was held back
+};
+
+// Orders and paces uploads. Each lane has a token bucket and a bounded queue; one
+// dispatcher thread starts the highest-priority queued upload that has a token, so a
+// match result never waits behind a burst of snapshots. Long-running senders (the
+// outbox sync, replay files) ask for a token before each request instead of queueing,
+// and also wait while a higher lane has uploads queued. The game phase can hold the
+// lower lanes back during live play; see LivePolicy. Thread-safe.
+class UploadLanes {
+public:
+    static constexpr std::chrono::seconds kLiveThrottleInterval{5};
+    // A missed end-of-match event cannot hold uploads back for longer than this.
+    static constexpr std::chrono::minutes kMaxLiveHold{20};
+
+    // start begins the upload, typically by handing it to a worker; it should not
+    // block. dropped runs instead when the lane's queue overflows. A job that is not
+    // droppable (its payload exists nowhere else) is kept past maxQueued.
+    struct Job {
+        std::function<void()> start;
+        std::function<void()> dropped;
+        bool droppable = true;
+    };
+
+    static LaneLimits DefaultLimits(UploadLane lane);
+
+    UploadLanes();
+    ~UploadLanes();
+
+    UploadLanes(const UploadLanes&) = delete;
+    UploadLanes& operator=(const UploadLanes&) = delete;
+
+    void Start();
+    // Starts whatever is still queued, ignoring the limits, then joins the dispatcher.
+    // Admit and Acquire return at once from here on.
+    void Stop();
+
+    // False when the job, or the oldest droppable one queued, was dropped to make
+    // room; the dropped callback runs on this thread.
+    bool Submit(UploadLane lane, Job job);
+
+    // Takes cost tokens and returns zero, or returns how long to wait before asking
+    // again. A cost of zero only yields to higher lanes.
+    std::chrono::milliseconds Admit(UploadLane lane, double cost = 1.0);
+    // Admit, blocking until it succeeds.
+    void Acquire(UploadLane lane, double cost = 1.0);
+    // Blocks for delay, or until Stop; false once stopped.
+    bool Sleep(std::chrono::milliseconds delay);
+
+    // Held lanes resume, and catch up at their normal rate, as soon as the phase
+    // leaves Live and Replay.
+    void SetGamePhase(GamePhase phase);
+    void SetLivePolicy(LivePolicy policy);
+    GamePhase Phase() const;
+    LivePolicy Policy() const;
+
+    LaneStats Stats(UploadLane lane) const;
+    std::size_t Queued() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Lane {
+        LaneLimits limits;
+        double tokens = 0.0;
+        Clock::time_point refilled;
+        std::deque<Job> queue;
+        LaneStats stats;
+        Clock::time_point deferredSince{}; // epoch when not held back
+        bool admitWaiting = false;          // an Admit caller was told to wait and has not been let through
+    };
+
+    void Run();
+    void RefillLocked(Lane& lane, Clock::time_point now);
+    std::chrono::milliseconds AdmitLocked(UploadLane lane, double cost);
+    bool GatedLocked(Clock::time_point now) const;
+    // Zero when the live policy lets lane send now, else how long until it may.
+    Clock::duration LiveWaitLocked(UploadLane lane, Clock::time_point now) const;
+    void DeferLocked(Lane& lane, Clock::time_point now);
+    // The lane sent: closes its deferral and, when throttled, starts the next interval.
+    void ReleaseLocked(UploadLane lane, Clock::time_point now);
+    void EndDeferralLocked(Lane& lane, Clock::time_point now);
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    std::array<Lane, kUploadLaneCount> lanes_;
+    GamePhase phase_ = GamePhase::Menu;
+    Clock::time_point phaseSince_;
+    LivePolicy livePolicy_ = LivePolicy::Pause;
+    Clock::time_point nextLiveRelease_;
+    bool stopping_ = false;
+    std::thread worker_;
+};
@@ -0,0 +1,334 @@
+#include "pch.h"
+#include "UploadOutbox.h"
+#include "DiagnosticLogger.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <system_error>
+
+namespace
+{
+    // Oldest entries are dropped past this; the server skips them via oldestPendingSeq.
+    constexpr std::size_t kMaxOutboxEntries = 2000;
+
+    std::string GenerateInstallId()
+    {
+        std::random_device device;
+        std::mt19937_64 engine((static_cast<std::uint64_t>(device()) << 32) ^ device());
+        static constexpr char kHex[] = "0123456789abcdef";
+        std::string id;
+        id.reserve(32);
+        for (int i = 0; i < 32; ++i)
+        {
+            id.push_back(kHex[engine() & 0xF]);
+        }
+        return id;
+    }
+
+    const char* FindValue(const std::string& json, const char* key)
+    {
+        const std::string needle = std::string("\"") + key + "\":";
+        const std::size_t pos = json.find(needle);
+        return pos == std::string::npos ? nullptr : json.c_str() + pos + needle.size();
+    }
+}
+
+UploadOutbox::~UploadOutbox()
+{
+    Close();
+}
+
+void UploadOutbox::Load(const std::filesystem::path& path)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    path_ = path;
+    entries_.clear();
+
+    // Format: key=value header lines, then one "<seq>\t<body>" line per entry.
+    std::ifstream input(path);
+    std::string line;
+    while (std::getline(input, line))
+    {
+        if (line.rfind("install_id=", 0) == 0)
+        {
+            installId_ = line.substr(11);
+        }
+        else if (line.rfind("next_seq=", 0) == 0)
+        {
+            nextSeq_ = std::max<std::uint64_t>(1, std::strtoull(line.c_str() + 9, nullptr, 10));
+        }
+        else if (line.rfind("acked_seq=", 0) == 0)
+        {
+            ackedSeq_ = std::strtoull(line.c_str() + 10, nullptr, 10);
+        }
+        else
+        {
+            const std::size_t tab = line.find('\t');
+            if (tab == std::string::npos)
+            {
+                continue;
+            }
+            OutboxEntry entry;
+            entry.seq = std::strtoull(line.c_str(), nullptr, 10);
+            entry.body = line.substr(tab + 1);
+            if (entry.seq > ackedSeq_ && !entry.body.empty())
+            {
+                nextSeq_ = std::max(nextSeq_, entry.seq + 1);
+                entries_.push_back(std::move(entry));
+            }
+        }
+    }
+
+    if (installId_.empty())
+    {
+        installId_ = GenerateInstallId();
+        MarkDirtyLocked();
+    }
+    if (!writer_.joinable() && !stopping_)
+    {
+        writer_ = std::thread([this]() { Run(); });
+    }
+    DiagnosticLogger::Log("UploadOutbox::Load: install=" + installId_ + ", pending=" + std::to_string(entries_.size()) +
+                          ", next_seq=" + std::to_string(nextSeq_));
+}
+
+bool UploadOutbox::IsLoaded() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return !path_.empty();
+}
+
+OutboxEntry UploadOutbox::Stamp(const std::string& body)
+{
+    const std::size_t close = body.find_last_of('}');
+    if (close == std::string::npos)
+    {
+        return OutboxEntry{0, body};
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    const std::uint64_t seq = nextSeq_++;
+    const std::uint64_t oldest = entries_.empty() ? seq : entries_.front().seq;
+
+    std::string stamped = body.substr(0, close);
+    const std::size_t last = stamped.find_last_not_of(" \t\r\n");
+    stamped += last != std::string::npos && stamped[last] == '{' ? "" : ",";
+    stamped += "\"installId\":\"" + installId_ + "\",\"clientSeq\":" + std::to_string(seq) +
+               ",\"oldestPendingSeq\":" + std::to_string(oldest) + "}";
+
+    entries_.push_back(OutboxEntry{seq, stamped});
+    while (entries_.size() > kMaxOutboxEntries)
+    {
+        entries_.pop_front();
+    }
+    MarkDirtyLocked();
+    return entries_.back();
+}
+
+void UploadOutbox::Acknowledge(std::uint64_t ackedSeq, const std::vector<std::uint64_t>& receivedSeqs)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    const std::size_t before = entries_.size();
+    const bool advanced = ackedSeq > ackedSeq_;
+    ackedSeq_ = std::max(ackedSeq_, ackedSeq);
+    entries_.erase(std::remove_if(entries_.begin(), entries_.end(), [&](const OutboxEntry& entry) {
+                       return entry.seq <= ackedSeq_ ||
+                              std::find(receivedSeqs.begin(), receivedSeqs.end(), entry.seq) != receivedSeqs.end();
+                   }),
+                   entries_.end());
+    if (advanced || entries_.size() != before)
+    {
+        MarkDirtyLocked();
+    }
+}
+
+void UploadOutbox::Discard(std::uint64_t seq)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto found = std::find_if(entries_.begin(), entries_.end(), [seq](const OutboxEntry& entry) {
+        return entry.seq == seq;
+    });
+    if (found != entries_.end())
+    {
+        entries_.erase(found);
+        MarkDirtyLocked();
+    }
+}
+
+std::vector<OutboxEntry> UploadOutbox::Pending() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return std::vector<OutboxEntry>(entries_.begin(), entries_.end());
+}
+
+std::size_t UploadOutbox::Size() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+std::uint64_t UploadOutbox::AckedSeq() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return ackedSeq_;
+}
+
+std::string UploadOutbox::InstallId() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return installId_;
+}
+
+bool UploadOutbox::ReadUnsigned(const std::string& json, const char* key, std::uint64_t& value)
+{
+    const char* start = FindValue(json, key);
+    if (!start)
+    {
+        return false;
+    }
+    char* end = nullptr;
+    const unsigned long long parsed = std::strtoull(start, &end, 10);
+    if (end == start)
+    {
+        return false;
+    }
+    value = parsed;
+    return true;
+}
+
+std::vector<std::uint64_t> UploadOutbox::ReadUnsignedArray(const std::string& json, const char* key)
+{
+    std::vector<std::uint64_t> values;
+    const char* cursor = FindValue(json, key);
+    if (!cursor || *cursor != '[')
+    {
+        return values;
+    }
+
+    ++cursor;
+    while (*cursor && *cursor != ']')
+    {
+        char* end = nullptr;
+        const unsigned long long parsed = std::strtoull(cursor, &end, 10);
+        if (end == cursor)
+        {
+            ++cursor;
+            continue;
+        }
+        values.push_back(parsed);
+        cursor = end;
+    }
+    return values;
+}
+
+void UploadOutbox::Flush()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (dirty_)
+    {
+        WritePendingLocked(lock);
+    }
+}
+
+void UploadOutbox::Close()
+{
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (dirty_)
+        {
+            WritePendingLocked(lock);
+        }
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    if (writer_.joinable())
+    {
+        writer_.join();
+    }
+}
+
+void UploadOutbox::Run()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_)
+    {
+        if (dirty_)
+        {
+            WritePendingLocked(lock);
+        }
+        else
+        {
+            wake_.wait(lock);
+        }
+    }
+}
+
+void UploadOutbox::MarkDirtyLocked()
+{
+    dirty_ = true;
+    wake_.notify_all();
+}
+
+void UploadOutbox::WritePendingLocked(std::unique_lock<std::mutex>& lock)
+{
+    const std::string content = SerializeLocked();
+    const std::uint64_t generation = ++generation_;
+    const std::filesystem::path path = path_;
+    dirty_ = false;
+    if (path.empty())
+    {
+        return;
+    }
+
+    // The file is written without holding mutex_, so Stamp and Acknowledge never wait
+    // on disk. A Flush that serialized later may get writeMutex_ first; the older
+    // content is then dropped instead of overwriting it.
+    lock.unlock();
+    {
+        std::lock_guard<std::mutex> writeLock(writeMutex_);
+        if (generation > writtenGeneration_)
+        {
+            std::error_code ec;
+            std::filesystem::create_directories(path.parent_path(), ec);
+            std::filesystem::path temp = path;
+            temp += ".tmp";
+            bool written = false;
+            {
+                std::ofstream output(temp, std::ios::out | std::ios::binary | std::ios::trunc);
+                output << content;
+                written = static_cast<bool>(output.flush());
+            }
+            if (written)
+            {
+                std::filesystem::rename(temp, path, ec);
+                written = !ec;
+            }
+            if (written)
+            {
+                writtenGeneration_ = generation;
+            }
+            else
+            {
+                std::filesystem::remove(temp, ec);
+                DiagnosticLogger::Log("UploadOutbox: failed to write " + path.string());
+            }
+        }
+    }
+    lock.lock();
+}
+
+std::string UploadOutbox::SerializeLocked() const
+{
+    std::ostringstream output;
+    output << "install_id=" << installId_ << "\n";
+    output << "next_seq=" << nextSeq_ << "\n";
+    output << "acked_seq=" << ackedSeq_ << "\n";
+    for (const auto& entry : entries_)
+    {
+        output << entry.seq << '\t' << entry.body << "\n";
+    }
+    return output.str();
+}
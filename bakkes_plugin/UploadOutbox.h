@@ -0,0 +1,79 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct OutboxEntry {
+    std::uint64_t seq = 0;
+    std::string body; // already stamped with installId/clientSeq
+};
+
+// Uploads to /api/mmr-log that the API has not yet acknowledged. Each upload is
+// stamped with this install's id and the next sequence number and kept (on disk)
+// until the server's watermark passes it, so a retry can never be stored twice and
+// nothing is lost when the API is unreachable. Changes are written by a background
+// thread, to a temp file that is then renamed over outbox.txt; changes made while a
+// write is in progress are coalesced into the next one.
+class UploadOutbox {
+public:
+    UploadOutbox() = default;
+    ~UploadOutbox();
+
+    UploadOutbox(const UploadOutbox&) = delete;
+    UploadOutbox& operator=(const UploadOutbox&) = delete;
+
+    // Reads path, makes it the write target and starts the writer thread.
+    void Load(const std::filesystem::path& path);
+    bool IsLoaded() const;
+
+    // Adds installId, clientSeq and oldestPendingSeq to a JSON object payload and queues it.
+    OutboxEntry Stamp(const std::string& body);
+
+    // Drops entries at or below the watermark and any the server listed as received.
+    void Acknowledge(std::uint64_t ackedSeq, const std::vector<std::uint64_t>& receivedSeqs = {});
+    // The API rejected the payload itself (4xx); resending cannot help.
+    void Discard(std::uint64_t seq);
+
+    std::vector<OutboxEntry> Pending() const;
+    std::size_t Size() const;
+    std::uint64_t AckedSeq() const;
+    std::string InstallId() const;
+
+    // Writes pending changes now instead of on the writer thread.
+    void Flush();
+    // Flushes, then stops the writer thread.
+    void Close();
+
+    // Reads "key":<unsigned> and "key":[<unsigned>,...] out of an API response.
+    static bool ReadUnsigned(const std::string& json, const char* key, std::uint64_t& value);
+    static std::vector<std::uint64_t> ReadUnsignedArray(const std::string& json, const char* key);
+
+private:
+    void Run();
+    void MarkDirtyLocked();
+    void WritePendingLocked(std::unique_lock<std::mutex>& lock);
+    std::string SerializeLocked() const;
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    std::filesystem::path path_;
+    std::string installId_;
+    std::uint64_t nextSeq_ = 1;
+    std::uint64_t ackedSeq_ = 0;
+    std::deque<OutboxEntry> entries_;
+    bool dirty_ = false;
+    bool stopping_ = false;
+    std::uint64_t generation_ = 0; // bumped each time the entries are serialized
+
+    std::mutex writeMutex_;              // serializes file writes between Flush and the writer thread
+    std::uint64_t writtenGeneration_ = 0; // newest generation on disk; guarded by writeMutex_
+
+    std::thread writer_;
+};
@@ -0,0 +1,95 @@
+#include "pch.h"
+#include "WarmState.h"
+#include "SettingsStore.h"
+
+#include <cstdlib>
+#include <string>
+
+namespace
+{
+    std::chrono::system_clock::time_point FromUnixSeconds(const std::string& value)
+    {
+        return std::chrono::system_clock::time_point(std::chrono::seconds(std::strtoll(value.c_str(), nullptr, 10)));
+    }
+
+    long long ToUnixSeconds(std::chrono::system_clock::time_point time)
+    {
+        return std::chrono::duration_cast<std::chrono::seconds>(time.time_since_epoch()).count();
+    }
+}
+
+WarmState ReadWarmState(const SettingsStore& store)
+{
+    WarmState state;
+    const std::string readAt = store.Get("warm.mmr_read_at");
+    if (!readAt.empty())
+    {
+        state.hasMmr = true;
+        state.mmrReadAt = FromUnixSeconds(readAt);
+        for (const auto& [key, value] : store.WithPrefix("warm.mmr."))
+        {
+            const PlaylistInfo* info = PlaylistRegistry::FindById(std::atoi(key.c_str() + 9));
+            if (info)
+            {
+                state.ratings[static_cast<std::size_t>(info - PlaylistRegistry::kPlaylists)] = std::strtof(value.c_str(), nullptr);
+            }
+        }
+    }
+
+    const std::string checkedAt = store.Get("warm.api_checked_at");
+    if (!checkedAt.empty())
+    {
+        state.hasHealth = true;
+        state.apiReachable = store.Get("warm.api_reachable") == "1";
+        state.healthCheckedAt = FromUnixSeconds(checkedAt);
+    }
+    return state;
+}
+
+void WriteWarmState(SettingsStore& store, const WarmState& state)
+{
+    if (state.hasMmr)
+    {
+        store.ErasePrefix("warm.mmr.");
+        store.Set("warm.mmr_read_at", std::to_string(ToUnixSeconds(state.mmrReadAt)));
+        for (std::size_t i = 0; i < PlaylistRegistry::kPlaylistCount; ++i)
+        {
+            if (state.ratings[i] > 0.0f)
+            {
+                store.Set("warm.mmr." + std::to_string(PlaylistRegistry::kPlaylists[i].playlistId),
+                          std::to_string(static_cast<int>(state.ratings[i] + 0.5f)));
+            }
+        }
+    }
+    if (state.hasHealth)
+    {
+        store.Set("warm.api_reachable", state.apiReachable ? "1" : "0");
+        store.Set("warm.api_checked_at", std::to_string(ToUnixSeconds(state.healthCheckedAt)));
+    }
+}
+
+WarmState WarmStateFromSnapshot(const MmrSnapshot& snapshot)
+{
+    WarmState state;
+    if (snapshot.valid)
+    {
+        state.hasMmr = true;
+        state.mmrReadAt = std::chrono::system_clock::now() -
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::steady_clock::now() - snapshot.readAt);
+        state.ratings = snapshot.ratings;
+    }
+    return state;
+}
+
+MmrSnapshot SnapshotFromWarmState(const WarmState& state)
+{
+    MmrSnapshot snapshot;
+    if (state.hasMmr)
+    {
+        snapshot.valid = true;
+        snapshot.ratings = state.ratings;
+        snapshot.readAt = std::chrono::steady_clock::now() -
+            std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::system_clock::now() - state.mmrReadAt);
+    }
+    return snapshot;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <chrono>
+
+#include "MmrCache.h"
+
+class SettingsStore;
+
+// What the overlay shows before this run has read the game or reached the API: the
+// last MMR snapshot and the last API health result, saved on unload.
+struct WarmState {
+    bool hasMmr = false;
+    std::chrono::system_clock::time_point mmrReadAt;
+    std::array<float, PlaylistRegistry::kPlaylistCount> ratings{}; // indexed like kPlaylists
+
+    bool hasHealth = false;
+    bool apiReachable = false;
+    std::chrono::system_clock::time_point healthCheckedAt;
+};
+
+// Kept in settings.cfg under "warm." keys; missing keys yield an empty state.
+WarmState ReadWarmState(const SettingsStore& store);
+void WriteWarmState(SettingsStore& store, const WarmState& state);
+
+// Snapshot read times are steady_clock, which does not survive a restart; these map
+// them to wall-clock time and back.
+WarmState WarmStateFromSnapshot(const MmrSnapshot& snapshot);
+MmrSnapshot SnapshotFromWarmState(const WarmState& state);
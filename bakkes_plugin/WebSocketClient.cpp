@@ -0,0 +1,449 @@
+#include "pch.h"
+#include "WebSocketClient.h"
+
+#include <cstdint>
+#include <cstring>
+#include <random>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <winhttp.h>
+#pragma comment(lib, "winhttp.lib")
+#else
+#include <cerrno>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+namespace
+{
+    std::wstring ToWide(const std::string& value)
+    {
+        if (value.empty())
+        {
+            return std::wstring();
+        }
+        const int sizeNeeded = MultiByteToWideChar(CP_UTF8, 0, value.data(), static_cast<int>(value.size()), nullptr, 0);
+        if (sizeNeeded <= 0)
+        {
+            return std::wstring();
+        }
+        std::wstring result;
+        result.resize(sizeNeeded);
+        MultiByteToWideChar(CP_UTF8, 0, value.data(), static_cast<int>(value.size()), result.data(), sizeNeeded);
+        return result;
+    }
+}
+
+struct WebSocketClient::Impl
+{
+    HINTERNET session = nullptr;
+    HINTERNET connection = nullptr;
+    HINTERNET socket = nullptr;
+
+    void CloseHandles()
+    {
+        for (HINTERNET* handle : {&socket, &connection, &session})
+        {
+            if (*handle)
+            {
+                WinHttpCloseHandle(*handle);
+                *handle = nullptr;
+            }
+        }
+    }
+};
+
+bool WebSocketClient::Connect(const std::string& url, const std::vector<HttpHeader>& headers, std::string& error)
+{
+    Close();
+
+    const std::wstring wideUrl = ToWide(url);
+    URL_COMPONENTS parts{};
+    parts.dwStructSize = sizeof(parts);
+    parts.dwHostNameLength = static_cast<DWORD>(-1);
+    parts.dwUrlPathLength = static_cast<DWORD>(-1);
+    parts.dwExtraInfoLength = static_cast<DWORD>(-1);
+    if (!WinHttpCrackUrl(wideUrl.c_str(), 0, 0, &parts))
+    {
+        error = "invalid URL: " + url;
+        return false;
+    }
+    const std::wstring host(parts.lpszHostName, parts.dwHostNameLength);
+    std::wstring path = parts.dwUrlPathLength > 0 ? std::wstring(parts.lpszUrlPath, parts.dwUrlPathLength) : std::wstring(L"/");
+    if (parts.dwExtraInfoLength > 0)
+    {
+        path.append(parts.lpszExtraInfo, parts.dwExtraInfoLength);
+    }
+
+    Impl& impl = *impl_;
+    impl.session = WinHttpOpen(L"RLTrainingJournalPlugin/1.0",
+                               WINHTTP_ACCESS_TYPE_AUTOMATIC_PROXY,
+                               WINHTTP_NO_PROXY_NAME,
+                               WINHTTP_NO_PROXY_BYPASS,
+                               0);
+    if (!impl.session)
+    {
+        error = "WinHttpOpen failed: " + std::to_string(GetLastError());
+        return false;
+    }
+    const int timeout = static_cast<int>(kTimeout.count());
+    WinHttpSetTimeouts(impl.session, timeout, timeout, timeout, timeout);
+
+    impl.connection = WinHttpConnect(impl.session, host.c_str(), parts.nPort, 0);
+    if (!impl.connection)
+    {
+        error = "WinHttpConnect failed: " + std::to_string(GetLastError());
+        impl.CloseHandles();
+        return false;
+    }
+
+    HINTERNET request = WinHttpOpenRequest(impl.connection,
+                                           L"GET",
+                                           path.c_str(),
+                                           nullptr,
+                                           WINHTTP_NO_REFERER,
+                                           WINHTTP_DEFAULT_ACCEPT_TYPES,
+                                           parts.nScheme == INTERNET_SCHEME_HTTPS ? WINHTTP_FLAG_SECURE : 0);
+    if (!request || !WinHttpSetOption(request, WINHTTP_OPTION_UPGRADE_TO_WEB_SOCKET, nullptr, 0))
+    {
+        error = "WinHttpOpenRequest failed: " + std::to_string(GetLastError());
+        if (request)
+        {
+            WinHttpCloseHandle(request);
+        }
+        impl.CloseHandles();
+        return false;
+    }
+    for (const auto& header : headers)
+    {
+        if (header.name.empty())
+        {
+            continue;
+        }
+        const std::wstring line = ToWide(header.name + ": " + header.value + "\r\n");
+        WinHttpAddRequestHeaders(request, line.c_str(), static_cast<DWORD>(-1L), WINHTTP_ADDREQ_FLAG_ADD | WINHTTP_ADDREQ_FLAG_REPLACE);
+    }
+
+    DWORD status = 0;
+    DWORD statusSize = sizeof(status);
+    if (!WinHttpSendRequest(request, WINHTTP_NO_ADDITIONAL_HEADERS, 0, WINHTTP_NO_REQUEST_DATA, 0, 0, 0) ||
+        !WinHttpReceiveResponse(request, nullptr) ||
+        !WinHttpQueryHeaders(request, WINHTTP_QUERY_STATUS_CODE | WINHTTP_QUERY_FLAG_NUMBER, WINHTTP_HEADER_NAME_BY_INDEX,
+                             &status, &statusSize, WINHTTP_NO_HEADER_INDEX))
+    {
+        error = "WebSocket upgrade failed: " + std::to_string(GetLastError());
+        WinHttpCloseHandle(request);
+        impl.CloseHandles();
+        return false;
+    }
+    if (status != 101)
+    {
+        error = "WebSocket upgrade refused: HTTP " + std::to_string(status);
+        WinHttpCloseHandle(request);
+        impl.CloseHandles();
+        return false;
+    }
+
+    impl.socket = WinHttpWebSocketCompleteUpgrade(request, 0);
+    WinHttpCloseHandle(request);
+    if (!impl.socket)
+    {
+        error = "WinHttpWebSocketCompleteUpgrade failed: " + std::to_string(GetLastError());
+        impl.CloseHandles();
+        return false;
+    }
+    return true;
+}
+
+bool WebSocketClient::SendText(const std::string& message, std::string& error)
+{
+    Impl& impl = *impl_;
+    if (!impl.socket)
+    {
+        error = "WebSocket is not connected";
+        return false;
+    }
+    const DWORD result = WinHttpWebSocketSend(impl.socket,
+                                              WINHTTP_WEB_SOCKET_UTF8_MESSAGE_BUFFER_TYPE,
+                                              const_cast<char*>(message.data()),
+                                              static_cast<DWORD>(message.size()));
+    if (result != 0)
+    {
+        error = "WinHttpWebSocketSend failed: " + std::to_string(result);
+        impl.CloseHandles();
+        return false;
+    }
+    return true;
+}
+
+void WebSocketClient::Close()
+{
+    Impl& impl = *impl_;
+    if (impl.socket)
+    {
+        WinHttpWebSocketClose(impl.socket, WINHTTP_WEB_SOCKET_SUCCESS_CLOSE_STATUS, nullptr, 0);
+    }
+    impl.CloseHandles();
+}
+
+bool WebSocketClient::IsOpen() const
+{
+    return impl_->socket != nullptr;
+}
+
+#else
+
+namespace
+{
+    constexpr std::size_t kMaxHandshakeBytes = 8 * 1024;
+
+    std::string Base64(const unsigned char* data, std::size_t size)
+    {
+        static constexpr char kAlphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        std::string out;
+        for (std::size_t i = 0; i < size; i += 3)
+        {
+            const std::uint32_t chunk = (static_cast<std::uint32_t>(data[i]) << 16) |
+                                        (i + 1 < size ? static_cast<std::uint32_t>(data[i + 1]) << 8 : 0) |
+                                        (i + 2 < size ? static_cast<std::uint32_t>(data[i + 2]) : 0);
+            out += kAlphabet[(chunk >> 18) & 63];
+            out += kAlphabet[(chunk >> 12) & 63];
+            out += i + 1 < size ? kAlphabet[(chunk >> 6) & 63] : '=';
+            out += i + 2 < size ? kAlphabet[chunk & 63] : '=';
+        }
+        return out;
+    }
+
+    bool SendAll(int fd, const char* data, std::size_t size)
+    {
+        while (size > 0)
+        {
+            const ssize_t sent = ::send(fd, data, size, MSG_NOSIGNAL);
+            if (sent < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (sent <= 0)
+            {
+                return false;
+            }
+            data += sent;
+            size -= static_cast<std::size_t>(sent);
+        }
+        return true;
+    }
+}
+
+struct WebSocketClient::Impl
+{
+    int fd = -1;
+    std::mt19937 random{std::random_device{}()};
+    std::string frame; // reused by every send
+
+    void CloseSocket()
+    {
+        if (fd >= 0)
+        {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+
+    // Client frames are always masked (RFC 6455 5.3).
+    bool SendFrame(std::uint8_t opcode, const char* data, std::size_t size)
+    {
+        frame.clear();
+        frame += static_cast<char>(0x80 | opcode);
+        if (size < 126)
+        {
+            frame += static_cast<char>(0x80 | size);
+        }
+        else if (size <= 0xFFFF)
+        {
+            frame += static_cast<char>(0x80 | 126);
+            frame += static_cast<char>((size >> 8) & 0xFF);
+            frame += static_cast<char>(size & 0xFF);
+        }
+        else
+        {
+            frame += static_cast<char>(0x80 | 127);
+            for (int shift = 56; shift >= 0; shift -= 8)
+            {
+                frame += static_cast<char>((static_cast<std::uint64_t>(size) >> shift) & 0xFF);
+            }
+        }
+        const std::uint32_t key = random();
+        char mask[4];
+        std::memcpy(mask, &key, sizeof(mask));
+        frame.append(mask, sizeof(mask));
+        const std::size_t payloadStart = frame.size();
+        frame.append(data, size);
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            frame[payloadStart + i] ^= mask[i % 4];
+        }
+        return SendAll(fd, frame.data(), frame.size());
+    }
+};
+
+bool WebSocketClient::Connect(const std::string& url, const std::vector<HttpHeader>& headers, std::string& error)
+{
+    Close();
+
+    const std::string http = "http://";
+    if (url.rfind(http, 0) != 0)
+    {
+        error = url.rfind("https://", 0) == 0 ? "wss is not supported on Linux" : "URL must start with http://";
+        return false;
+    }
+    const std::string rest = url.substr(http.size());
+    const std::string::size_type slashPos = rest.find('/');
+    const std::string hostPort = slashPos == std::string::npos ? rest : rest.substr(0, slashPos);
+    const std::string path = slashPos == std::string::npos ? "/" : rest.substr(slashPos);
+    const std::string::size_type colonPos = hostPort.find(':');
+    const std::string host = hostPort.substr(0, colonPos);
+    const std::string port = colonPos == std::string::npos ? "80" : hostPort.substr(colonPos + 1);
+    if (host.empty())
+    {
+        error = "URL missing host";
+        return false;
+    }
+
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* results = nullptr;
+    if (getaddrinfo(host.c_str(), port.c_str(), &hints, &results) != 0 || !results)
+    {
+        error = "cannot resolve " + host;
+        return false;
+    }
+
+    Impl& impl = *impl_;
+    timeval timeout{};
+    timeout.tv_sec = static_cast<long>(kTimeout.count() / 1000);
+    timeout.tv_usec = static_cast<long>((kTimeout.count() % 1000) * 1000);
+    for (addrinfo* candidate = results; candidate && impl.fd < 0; candidate = candidate->ai_next)
+    {
+        impl.fd = ::socket(candidate->ai_family, candidate->ai_socktype, candidate->ai_protocol);
+        if (impl.fd < 0)
+        {
+            continue;
+        }
+        // SO_SNDTIMEO also bounds connect(), so a stalled link fails instead of blocking.
+        setsockopt(impl.fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+        setsockopt(impl.fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        const int noDelay = 1;
+        setsockopt(impl.fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+        if (::connect(impl.fd, candidate->ai_addr, candidate->ai_addrlen) != 0)
+        {
+            impl.CloseSocket();
+        }
+    }
+    freeaddrinfo(results);
+    if (impl.fd < 0)
+    {
+        error = "cannot connect to " + hostPort;
+        return false;
+    }
+
+    unsigned char nonce[16];
+    for (unsigned char& byte : nonce)
+    {
+        byte = static_cast<unsigned char>(impl.random());
+    }
+    std::string request = "GET " + path + " HTTP/1.1\r\nHost: " + hostPort +
+                          "\r\nUpgrade: websocket\r\nConnection: Upgrade\r\nSec-WebSocket-Version: 13\r\nSec-WebSocket-Key: " +
+                          Base64(nonce, sizeof(nonce)) + "\r\n";
+    for (const auto& header : headers)
+    {
+        if (!header.name.empty())
+        {
+            request += header.name + ": " + header.value + "\r\n";
+        }
+    }
+    request += "\r\n";
+    if (!SendAll(impl.fd, request.data(), request.size()))
+    {
+        error = "cannot send the WebSocket upgrade";
+        impl.CloseSocket();
+        return false;
+    }
+
+    // Read only up to the blank line: nothing the server sends after it is consumed.
+    std::string response;
+    char byte = 0;
+    while (response.size() < kMaxHandshakeBytes && (response.size() < 4 || response.compare(response.size() - 4, 4, "\r\n\r\n") != 0))
+    {
+        const ssize_t received = ::recv(impl.fd, &byte, 1, 0);
+        if (received < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (received <= 0)
+        {
+            error = "connection closed during the WebSocket upgrade";
+            impl.CloseSocket();
+            return false;
+        }
+        response += byte;
+    }
+    if (response.rfind("HTTP/1.1 101", 0) != 0)
+    {
+        error = "WebSocket upgrade refused: " + response.substr(0, response.find('\r'));
+        impl.CloseSocket();
+        return false;
+    }
+    return true;
+}
+
+bool WebSocketClient::SendText(const std::string& message, std::string& error)
+{
+    Impl& impl = *impl_;
+    if (impl.fd < 0)
+    {
+        error = "WebSocket is not connected";
+        return false;
+    }
+    if (!impl.SendFrame(0x1, message.data(), message.size()))
+    {
+        error = std::string("WebSocket send failed: ") + std::strerror(errno);
+        impl.CloseSocket();
+        return false;
+    }
+    return true;
+}
+
+void WebSocketClient::Close()
+{
+    Impl& impl = *impl_;
+    if (impl.fd >= 0)
+    {
+        const char status[2] = {static_cast<char>(1000 >> 8), static_cast<char>(1000 & 0xFF)};
+        impl.SendFrame(0x8, status, sizeof(status));
+    }
+    impl.CloseSocket();
+}
+
+bool WebSocketClient::IsOpen() const
+{
+    return impl_->fd >= 0;
+}
+
+#endif
+
+WebSocketClient::WebSocketClient()
+    : impl_(std::make_unique<Impl>())
+{
+}
+
+WebSocketClient::~WebSocketClient()
+{
+    Close();
+}
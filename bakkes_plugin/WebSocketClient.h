@@ -0,0 +1,36 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ApiClient.h"
+
+// A blocking, send-only WebSocket connection for one thread: WinHTTP's WebSocket
+// API on Windows, a plain socket on Linux (ws:// only, like EpollHttpTransport).
+// Messages from the server are never read; a closed or stalled link shows up as a
+// failed send.
+class WebSocketClient {
+public:
+    WebSocketClient();
+    ~WebSocketClient();
+
+    WebSocketClient(const WebSocketClient&) = delete;
+    WebSocketClient& operator=(const WebSocketClient&) = delete;
+
+    // url is http(s)://host[:port]/path; the upgrade request carries headers.
+    bool Connect(const std::string& url, const std::vector<HttpHeader>& headers, std::string& error);
+    // One text message. Fails, and closes the connection, if it cannot be written
+    // within the send timeout.
+    bool SendText(const std::string& message, std::string& error);
+    void Close();
+    bool IsOpen() const;
+
+    static constexpr std::chrono::milliseconds kTimeout{5000};
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
@@ -0,0 +1,61 @@
+// http_cli.cpp : rtj_http, the Linux driver for ApiClient over EpollHttpTransport.
+//   rtj_http <base-url> <endpoint> [json-body]
+// Sends the request once through the blocking Send and once through SendAsync, and
+// prints both results. A body makes it a POST; without one it is a GET.
+#include "pch.h"
+#include "ApiClient.h"
+
+#include <cstdio>
+#include <future>
+#include <string>
+
+namespace
+{
+    void Print(const char* path, bool success, unsigned long status, const std::string& body, const std::string& error)
+    {
+        std::printf("%s: %s, status %lu\n", path, success ? "ok" : "failed", status);
+        std::printf("%s\n", success ? body.c_str() : error.c_str());
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 3 || argc > 4)
+    {
+        std::fprintf(stderr, "usage: %s <base-url> <endpoint> [json-body]\n", argv[0]);
+        return 2;
+    }
+
+    HttpRequest request;
+    request.endpoint = argv[2];
+    request.headers.emplace_back("User-Agent", "rtj_http/1.0");
+    if (argc == 4)
+    {
+        request.method = "POST";
+        request.contentType = "application/json";
+        request.body = argv[3];
+    }
+
+    ApiClient client(argv[1]);
+    const HttpResponse response = client.Send(request.method.c_str(),
+                                              request.endpoint,
+                                              request.contentType.empty() ? nullptr : request.contentType.c_str(),
+                                              request.body.data(),
+                                              request.body.size(),
+                                              request.headers);
+    Print("blocking", response.success, response.status, std::string(response.body), response.error);
+
+    std::promise<HttpResult> done;
+    std::future<HttpResult> pending = done.get_future();
+    client.SendAsync(request, [&done](HttpResult result) { done.set_value(std::move(result)); });
+    const HttpResult result = pending.get();
+    Print("async", result.success, result.status, result.body, result.error);
+
+    const TransportStats stats = client.Stats();
+    std::printf("requests %llu, failures %llu, sent %llu B, received %llu B\n",
+                static_cast<unsigned long long>(stats.requests),
+                static_cast<unsigned long long>(stats.failures),
+                static_cast<unsigned long long>(stats.bytesSent),
+                static_cast<unsigned long long>(stats.bytesReceived));
+    return response.success && result.success ? 0 : 1;
+}
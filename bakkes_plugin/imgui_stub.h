@@ -1,11 +1,19 @@
 #pragma once
 #include <cstddef>
 #include <cstdarg>
+#include <cfloat>
 
 // Provide a global ImGuiContext type so the plugin's forward declarations and
 // reinterpret_casts between uintptr_t and ImGuiContext* are compatible.
 struct ImGuiContext {};
 
+struct ImVec2 {
+    float x = 0.0f;
+    float y = 0.0f;
+    ImVec2() = default;
+    ImVec2(float x_, float y_) : x(x_), y(y_) {}
+};
+
 namespace ImGui {
     // Alias the namespace ImGuiContext to the global one so both refer to same type.
     using ImGuiContext = ::ImGuiContext;
@@ -27,13 +35,34 @@ namespace ImGui {
 
     inline bool Button(const char*) { return false; }
     inline bool Checkbox(const char*, bool*) { return false; }
+    inline bool RadioButton(const char*, bool) { return false; }
     inline void SameLine() {}
     inline bool InputText(const char*, char*, std::size_t) { return false; }
     inline void Spacing() {}
+    template<typename... Args>
+    inline void Text(const char*, Args...) {}
+    inline bool CollapsingHeader(const char*) { return false; }
+    inline bool Selectable(const char*, bool = false) { return false; }
+    inline bool BeginChild(const char*, ImVec2 = ImVec2(), bool = false, int = 0) { return true; }
+    inline void EndChild() {}
+    inline void Columns(int = 1, const char* = nullptr, bool = true) {}
+    inline void NextColumn() {}
+    inline void SetColumnWidth(int, float) {}
+    inline void PlotLines(const char*, const float*, int, int = 0, const char* = nullptr,
+                          float = FLT_MAX, float = FLT_MAX, ImVec2 = ImVec2(), int = sizeof(float)) {}
 
     constexpr int ImGuiWindowFlags_AlwaysAutoResize = 1;
 }
 
+// Reports no visible rows, so loops over it draw nothing.
+struct ImGuiListClipper {
+    int DisplayStart = 0;
+    int DisplayEnd = 0;
+    void Begin(int, float = -1.0f) {}
+    bool Step() { return false; }
+    void End() {}
+};
+
 // Some code refers to ImGuiWindowFlags_AlwaysAutoResize without the ImGui:: prefix.
 // Expose it in the global namespace as well.
 constexpr int ImGuiWindowFlags_AlwaysAutoResize = ImGui::ImGuiWindowFlags_AlwaysAutoResize;
@@ -0,0 +1,189 @@
+#!/usr/bin/env node
+const fs = require('fs');
+const path = require('path');
+
+// Turns ranks.csv into a constexpr header for the BakkesMod plugin so rank lookups
+// never parse the CSV at runtime. Re-run after editing ranks.csv:
+//   npm run generate:ranks
+
+const DEFAULT_CSV_PATH = path.join(__dirname, '..', 'ranks.csv');
+const DEFAULT_HEADER_PATH = path.join(__dirname, '..', 'bakkes_plugin', 'RankTable.generated.h');
+
+// CSV header -> RankColumn enumerator. Order here is the enum order in the header.
+const COLUMN_IDENTIFIERS = [
+  { header: '1v1', identifier: 'Duel' },
+  { header: '2v2', identifier: 'Doubles' },
+  { header: '3v3', identifier: 'Standard' },
+  { header: 'hoops', identifier: 'Hoops' },
+  { header: 'rumble', identifier: 'Rumble' },
+  { header: 'dropshot', identifier: 'Dropshot' },
+  { header: 'snowday', identifier: 'SnowDay' },
+  { header: '4v4', identifier: 'Quads' },
+];
+
+function parseRange(value) {
+  const trimmed = (value || '').replace(/\s/g, '');
+  if (!trimmed) {
+    return null;
+  }
+
+  const parts = trimmed.split(/[–—-]/).filter(Boolean);
+  const numbers = parts.map((part) => Number(part));
+  if (!numbers.length || numbers.some((num) => !Number.isInteger(num))) {
+    return null;
+  }
+
+  if (numbers.length === 1) {
+    return { min: numbers[0], max: numbers[0] };
+  }
+
+  return { min: Math.min(numbers[0], numbers[1]), max: Math.max(numbers[0], numbers[1]) };
+}
+
+function parseRankName(value) {
+  const match = /^([A-Za-z]+\d?)(?:\s+Div\s+(\d+))?$/i.exec(value.trim());
+  if (!match) {
+    throw new Error(`Unrecognized rank name: ${value}`);
+  }
+  return { tier: match[1].toUpperCase(), division: match[2] ? Number(match[2]) : 0 };
+}
+
+function parseRanksCsv(contents) {
+  const lines = contents
+    .split(/\r?\n/)
+    .map((line) => line.trim())
+    .filter((line) => line.length);
+
+  if (!lines.length) {
+    throw new Error('ranks.csv is empty');
+  }
+
+  const headers = lines[0].split(',').map((value) => value.trim().toLowerCase());
+  const columns = COLUMN_IDENTIFIERS.map(({ header, identifier }) => {
+    const index = headers.indexOf(header);
+    if (index === -1) {
+      throw new Error(`ranks.csv is missing the ${header} column`);
+    }
+    return { identifier, index };
+  });
+
+  // Rows are listed from SSL down; walk them bottom-up so tiers come out ascending.
+  const rows = lines
+    .slice(1)
+    .map((line) => line.split(',').map((value) => value.trim()))
+    .filter((cells) => cells[0])
+    .reverse();
+
+  const tiers = [];
+  const entries = rows.map((cells) => {
+    const { tier, division } = parseRankName(cells[0]);
+    if (!tiers.includes(tier)) {
+      tiers.push(tier);
+    }
+    return { tier, division, cells };
+  });
+
+  // The source data overlaps some neighbouring divisions. Overlaps are resolved the
+  // same way everywhere: a division starts one above the ceiling of the one below it,
+  // and a division left with no MMR of its own is dropped and reported. A gap between
+  // two divisions belongs to the lower one, since the next floor has not been reached,
+  // so every interval ends one below the next floor and lookups never land in a gap.
+  const warnings = [];
+  const tables = columns.map(({ identifier, index }) => {
+    const intervals = [];
+    for (const { tier, division, cells } of entries) {
+      const range = parseRange(cells[index]);
+      if (!range) {
+        continue;
+      }
+      const previous = intervals[intervals.length - 1];
+      const floor = previous ? Math.max(range.min, previous.ceiling + 1) : range.min;
+      if (floor > range.max) {
+        warnings.push(`${identifier}: ${cells[0]} (${range.min}-${range.max}) lies within the divisions below it; skipped`);
+        continue;
+      }
+      intervals.push({ floor, ceiling: range.max, tier: tiers.indexOf(tier), division });
+    }
+    for (let i = 0; i + 1 < intervals.length; i += 1) {
+      intervals[i].ceiling = intervals[i + 1].floor - 1;
+    }
+    return { identifier, intervals };
+  });
+
+  return { tiers, tables, warnings };
+}
+
+function renderHeader({ tiers, tables }) {
+  const lines = [];
+  lines.push('// Generated by tools/generate-rank-table.js from ranks.csv. Do not edit by hand.');
+  lines.push('#pragma once');
+  lines.push('');
+  lines.push('#include <cstddef>');
+  lines.push('#include <cstdint>');
+  lines.push('');
+  lines.push('namespace RankTableData');
+  lines.push('{');
+  lines.push('    enum class RankColumn : std::uint8_t');
+  lines.push('    {');
+  for (const { identifier } of tables) {
+    lines.push(`        ${identifier},`);
+  }
+  lines.push('        Count,');
+  lines.push('        None = Count');
+  lines.push('    };');
+  lines.push('');
+  lines.push('    struct RankInterval');
+  lines.push('    {');
+  lines.push('        std::int16_t floor;');
+  lines.push('        std::int16_t ceiling;');
+  lines.push('        std::uint8_t tier;');
+  lines.push('        std::uint8_t division;');
+  lines.push('    };');
+  lines.push('');
+  lines.push('    struct RankColumnTable');
+  lines.push('    {');
+  lines.push('        const RankInterval* intervals;');
+  lines.push('        std::size_t count;');
+  lines.push('    };');
+  lines.push('');
+  lines.push(`    constexpr const char* kTierNames[] = {${tiers.map((tier) => `"${tier}"`).join(', ')}};`);
+  for (const { identifier, intervals } of tables) {
+    lines.push('');
+    lines.push(`    constexpr RankInterval k${identifier}Intervals[] = {`);
+    for (const interval of intervals) {
+      lines.push(`        {${interval.floor}, ${interval.ceiling}, ${interval.tier}, ${interval.division}},`);
+    }
+    lines.push('    };');
+  }
+  lines.push('');
+  lines.push('    constexpr RankColumnTable kColumnTables[] = {');
+  for (const { identifier } of tables) {
+    lines.push(`        {k${identifier}Intervals, sizeof(k${identifier}Intervals) / sizeof(RankInterval)},`);
+  }
+  lines.push('    };');
+  lines.push('} // namespace RankTableData');
+  lines.push('');
+  return lines.join('\n');
+}
+
+function generate({ csvPath = DEFAULT_CSV_PATH, headerPath = DEFAULT_HEADER_PATH } = {}) {
+  const contents = fs.readFileSync(csvPath, 'utf8');
+  const parsed = parseRanksCsv(contents);
+  for (const warning of parsed.warnings) {
+    console.warn(warning);
+  }
+  fs.writeFileSync(headerPath, renderHeader(parsed));
+  return headerPath;
+}
+
+if (require.main === module) {
+  try {
+    const written = generate();
+    console.log(`Wrote ${path.relative(process.cwd(), written)}`);
+  } catch (error) {
+    console.error(error.message);
+    process.exit(1);
+  }
+}
+
+module.exports = { parseRange, parseRankName, parseRanksCsv, renderHeader, generate, DEFAULT_CSV_PATH, DEFAULT_HEADER_PATH };
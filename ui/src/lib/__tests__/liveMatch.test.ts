@@ -0,0 +1,59 @@
+import { describe, it, expect, beforeEach } from 'vitest';
+import { get } from 'svelte/store';
+import type { LiveMatch } from '../api';
+import {
+  LIVE_MATCH_LINGER_MS,
+  applyLiveUpdate,
+  currentLiveMatch,
+  formatMatchClock,
+  liveMatches,
+  parseLiveMessage,
+  pickCurrentMatch,
+} from '../liveMatch';
+
+function liveMatch(overrides: Partial<LiveMatch> = {}): LiveMatch {
+  return {
+    userId: 'player-1',
+    match: 'm1',
+    playlist: 11,
+    team: 0,
+    score: [1, 0],
+    clock: 95,
+    overtime: false,
+    boost: 42,
+    goals: [{ team: 0, clock: 60 }],
+    ended: false,
+    updatedAt: new Date().toISOString(),
+    ...overrides,
+  };
+}
+
+beforeEach(() => {
+  liveMatches.set({});
+});
+
+describe('live match store', () => {
+  it('applies parsed live events per user', () => {
+    const update = parseLiveMessage(JSON.stringify({ userId: 'player-1', type: 'state', state: liveMatch() }));
+    expect(update).not.toBeNull();
+    applyLiveUpdate(update!);
+
+    expect(get(currentLiveMatch)).toMatchObject({ userId: 'player-1', score: [1, 0], boost: 42 });
+    expect(parseLiveMessage('not json')).toBeNull();
+  });
+
+  it('prefers the most recent match and hides finished ones after a while', () => {
+    const now = Date.now();
+    const older = liveMatch({ userId: 'a', updatedAt: new Date(now - 5000).toISOString() });
+    const newer = liveMatch({ userId: 'b', updatedAt: new Date(now - 1000).toISOString() });
+    expect(pickCurrentMatch({ a: older, b: newer }, now)?.userId).toBe('b');
+
+    const finished = liveMatch({ ended: true, updatedAt: new Date(now - LIVE_MATCH_LINGER_MS - 1).toISOString() });
+    expect(pickCurrentMatch({ a: finished }, now)).toBeNull();
+  });
+
+  it('formats elapsed match time', () => {
+    expect(formatMatchClock(0)).toBe('0:00');
+    expect(formatMatchClock(305)).toBe('5:05');
+  });
+});
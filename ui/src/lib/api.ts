@@ -142,6 +142,20 @@ export type BakkesmodHistoryFilters = {
   sessionEnd?: string;
 };
 
+export type LiveMatch = {
+  userId: string;
+  match: string;
+  playlist: number;
+  team: number;
+  score: [number, number];
+  clock: number;
+  overtime: boolean;
+  boost: number;
+  goals: { team: number; clock: number }[];
+  ended: boolean;
+  updatedAt: string;
+};
+
 export type PresetBlock = {
   id: number;
   presetId: number;
@@ -209,6 +223,15 @@ export async function getMmrRecords(filters: { playlist?: string; from?: string;
   return data;
 }
 
+export async function getLiveMatches(): Promise<LiveMatch[]> {
+  const response = await fetch(buildUrl('/api/live'));
+  if (!response.ok) {
+    throw new Error('Unable to load live matches');
+  }
+  const data = (await response.json()) as { matches: LiveMatch[] };
+  return data.matches;
+}
+
 export async function getBakkesmodHistory(filters: BakkesmodHistoryFilters = {}): Promise<BakkesmodHistoryPayload> {
   const params = new URLSearchParams();
   if (filters.mmrLimit !== undefined) params.set('mmrLimit', String(filters.mmrLimit));
@@ -0,0 +1,64 @@
+import { derived, writable } from 'svelte/store';
+import { getLiveMatches, type LiveMatch } from './api';
+
+// Live match state streamed by the plugin, one entry per user. Fed by 'live' events on
+// the server update stream; unlike 'update' events they never trigger a data refresh.
+export const liveMatches = writable<Record<string, LiveMatch>>({});
+
+// Shown for a little while after the final whistle, then hidden.
+export const LIVE_MATCH_LINGER_MS = 2 * 60 * 1000;
+
+export type LiveUpdate = {
+  userId: string;
+  type: string;
+  state: LiveMatch;
+};
+
+export function parseLiveMessage(rawData: string): LiveUpdate | null {
+  try {
+    const parsed = JSON.parse(rawData);
+    if (parsed && typeof parsed.userId === 'string' && parsed.state && typeof parsed.state === 'object') {
+      return parsed as LiveUpdate;
+    }
+  } catch (error) {
+    console.warn('Unable to parse live match update', error);
+  }
+  return null;
+}
+
+export function applyLiveUpdate(update: LiveUpdate) {
+  liveMatches.update((matches) => ({ ...matches, [update.userId]: { ...update.state, userId: update.userId } }));
+}
+
+export async function loadLiveMatches() {
+  const matches = await getLiveMatches();
+  liveMatches.set(Object.fromEntries(matches.map((match) => [match.userId, match])));
+}
+
+export function pickCurrentMatch(matches: Record<string, LiveMatch>, now = Date.now()): LiveMatch | null {
+  let current: LiveMatch | null = null;
+  for (const match of Object.values(matches)) {
+    const updated = Date.parse(match.updatedAt);
+    if (match.ended && now - updated > LIVE_MATCH_LINGER_MS) {
+      continue;
+    }
+    if (!current || updated > Date.parse(current.updatedAt)) {
+      current = match;
+    }
+  }
+  return current;
+}
+
+// Rechecked now and then, so a finished match goes away without another event.
+export const currentLiveMatch = derived<typeof liveMatches, LiveMatch | null>(liveMatches, (matches, set) => {
+  set(pickCurrentMatch(matches));
+  const timer = setInterval(() => set(pickCurrentMatch(matches)), 30 * 1000);
+  return () => clearInterval(timer);
+});
+
+// The plugin sends elapsed match time, overtime included, as the match timeline does.
+export function formatMatchClock(seconds: number) {
+  const minutes = Math.floor(seconds / 60);
+  const remainder = String(seconds % 60).padStart(2, '0');
+  return `${minutes}:${remainder}`;
+}
@@ -1,5 +1,6 @@
 import { mmrLogQuery, sessionsQuery, weeklySkillSummaryQuery, skillsQuery, presetsQuery } from './queries';
 import { profileStore } from './profileStore';
+import { applyLiveUpdate, parseLiveMessage } from './liveMatch';
 
 type UpdateListener = (event: ServerUpdateEvent) => void;
 
@@ -72,6 +73,13 @@ if (typeof window !== 'undefined' && 'EventSource' in window) {
     handleServerUpdate(update);
   });
 
+  eventSource.addEventListener('live', (event: MessageEvent) => {
+    const update = parseLiveMessage(event.data);
+    if (update) {
+      applyLiveUpdate(update);
+    }
+  });
+
   eventSource.addEventListener('error', () => {
     emitUpdate({ type: 'error', payload: null, timestamp: new Date().toISOString() });
   });